@@ -120,6 +120,22 @@ float valueNoise2D(float2 pCoordinates)
 	return valueNoise2DWithSeed(COMMON_SEED, pCoordinates);
 }
 
+// Interpolate between the values at the corners of a cell of the lattice of valueNoise3D. The value at the corner with the offset (x, y, z) from the bottom left corner,
+// where x, y and z are 0 or 1, is component (x + 2 * y + 4 * z) of the corner values. The hashes of the corners can be shared by all the coordinates in the same cell
+float interpolateValueNoise3DCorners(float8 pCornerValues, float3 pFractionalParts)
+{
+	float3 lerpParams = pFractionalParts * pFractionalParts * (3.0f - 2.0f * pFractionalParts);
+
+	float bottomBackLerpedParam = mix(pCornerValues.s0, pCornerValues.s1, lerpParams.x);
+	float topBackLerpedParam = mix(pCornerValues.s2, pCornerValues.s3, lerpParams.x);
+	float bottomFrontLerpedParam = mix(pCornerValues.s4, pCornerValues.s5, lerpParams.x);
+	float topFrontLerpedParam = mix(pCornerValues.s6, pCornerValues.s7, lerpParams.x);
+	float backLerpedParam = mix(bottomBackLerpedParam, topBackLerpedParam, lerpParams.y);
+	float frontLerpedParam = mix(bottomFrontLerpedParam, topFrontLerpedParam, lerpParams.y);
+
+	return mix(backLerpedParam, frontLerpedParam, lerpParams.z);
+}
+
 float valueNoise3D(const ulong pSeed, float3 pCoordinates)
 {
 	float3 fractionalParts;
@@ -128,24 +144,16 @@ float valueNoise3D(const ulong pSeed, float3 pCoordinates)
 	int3 bottomLeftIntegerCoords;
 	bottomLeftIntegerCoords = convert_int3(integerParts);
 
-	float3 lerpParams = fractionalParts * fractionalParts * (3.0f - 2.0f * fractionalParts);
-
-	float bottomBackLerpedParam = mix(hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(0, 0, 0)),
-									  hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(1, 0, 0)),
-									  lerpParams.x);
-	float topBackLerpedParam = mix(hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(0, 1, 0)),
-								   hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(1, 1, 0)),
-								   lerpParams.x);
-	float bottomFrontLerpedParam = mix(hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(0, 0, 1)),
-									   hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(1, 0, 1)),
-									   lerpParams.x);
-	float topFrontLerpedParam = mix(hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(0, 1, 1)),
-								    hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(1, 1, 1)),
-								    lerpParams.x);
-	float backLerpedParam = mix(bottomBackLerpedParam, topBackLerpedParam, lerpParams.y);
-	float frontLerpedParam = mix(bottomFrontLerpedParam, topFrontLerpedParam, lerpParams.y);
+	const float8 cornerValues = (float8)(hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(0, 0, 0)),
+										 hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(1, 0, 0)),
+										 hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(0, 1, 0)),
+										 hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(1, 1, 0)),
+										 hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(0, 0, 1)),
+										 hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(1, 0, 1)),
+										 hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(0, 1, 1)),
+										 hash3DGrid(pSeed, bottomLeftIntegerCoords + (int3)(1, 1, 1)));
 
-	return mix(backLerpedParam, frontLerpedParam, lerpParams.z);
+	return interpolateValueNoise3DCorners(cornerValues, fractionalParts);
 }
 
 #endif
\ No newline at end of file
@@ -37,4 +37,34 @@ struct Ray getCameraRayForPixel(float3 pCameraPosition, // The position of the c
 	return cameraRay;
 }
 
+// Get the coordinates of the pixel that the camera sees a point through, which is the inverse of getCameraRayForPixel.
+// The coordinates are not rounded, and may be outside of the image. Returns false if the point is not in front of the camera
+bool getPixelCoordsForCameraDirection(float3 pDirectionToPoint, // The direction from the camera to the point in world space, which need not be normalized
+									  float3 pCameraOrientationXAxis, // The x axis basis vector of the camera orientation
+									  float3 pCameraOrientationYAxis, // The y axis basis vector of the camera orientation
+									  float3 pCameraOrientationZAxis, // The z axis basis vector of the camera orientation
+									  float pCameraVerticalFieldOfViewInDegrees, // The vertical field of view of the camera, specified in degrees
+									  int2 pImageResolution, // The resolution of the image
+									  float2 *pOutputPixelCoords)
+{
+	const float depthInCameraSpace = dot(pDirectionToPoint, pCameraOrientationZAxis);
+	if(depthInCameraSpace <= 0.0f)
+	{
+		return false;
+	}
+
+	const float verticalViewExtent = tan(radians(pCameraVerticalFieldOfViewInDegrees / 2.0f));
+	const float heightToWidthMultiplier = (float)(pImageResolution.x) / (float)(pImageResolution.y);
+	const float horizontalViewExtent = verticalViewExtent * heightToWidthMultiplier;
+
+	// Find the point on the plane in front of the camera that the directions of the camera rays are on before they are normalized
+	float2 imagePlanePoint;
+	imagePlanePoint.x = dot(pDirectionToPoint, pCameraOrientationXAxis) / depthInCameraSpace;
+	imagePlanePoint.y = dot(pDirectionToPoint, pCameraOrientationYAxis) / depthInCameraSpace;
+
+	pOutputPixelCoords->x = (imagePlanePoint.x + horizontalViewExtent) / (2.0f * horizontalViewExtent) * (float)(pImageResolution.x - 1);
+	pOutputPixelCoords->y = (imagePlanePoint.y + verticalViewExtent) / (2.0f * verticalViewExtent) * (float)(pImageResolution.y - 1);
+	return true;
+}
+
 #endif
\ No newline at end of file
@@ -155,12 +155,8 @@ namespace forge
 		// Delete the old array
 		if(this->numberOfElements > 0)
 		{
-			// Destroy all the existing elements
-			for(SizeType i = 0; i < this->numberOfElements; ++i)
-			{
-				this->elementArray[i].~ElementType();
-			}
-			// Deallocate the memory that was used to store the elements
+			// Destroy all the existing elements and deallocate the memory that was used to store them.
+			// NOTE: delete[] calls the destructors, so they must not be called explicitly as well
 			delete[] this->elementArray;
 		}
 
@@ -19,7 +19,7 @@ namespace forge
 	/// <param name="degrees">The angle to convert, specified in degrees</param>
 	/// <returns>The angle in radians</returns>
 	inline
-	const Float convertDegreesToRadians(Float pDegrees)
+	Float convertDegreesToRadians(Float pDegrees)
 	{
 		return piOver180 * pDegrees;
 	}
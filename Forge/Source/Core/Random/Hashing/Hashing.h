@@ -0,0 +1,94 @@
+#ifndef FORGE_HASHING_H
+#define FORGE_HASHING_H
+
+#include <Forge/Source/Core/Forge.h>
+
+// NOTE: These functions mirror the ones in ForgeData/OpenCL/Include/Random.cl, so that the host can produce the same values as the OpenCL kernels.
+// Any change made here must also be made there, and vice versa
+
+namespace forge
+{
+	// The seed that is used when no seed is explicitly given
+	constexpr UInt32 commonHashSeed = 5;
+
+	// Constants used for hashing
+	constexpr UInt32 hashPrime32_2 = 0x85EBCA77U;  // 0b10000101111010111100101001110111
+	constexpr UInt32 hashPrime32_3 = 0xC2B2AE3DU;  // 0b11000010101100101010111000111101
+	constexpr UInt32 hashPrime32_4 = 0x27D4EB2FU;  // 0b00100111110101001110101100101111
+	constexpr UInt32 hashPrime32_5 = 0x165667B1U;  // 0b00010110010101100110011110110001
+
+	UInt32 rotateLeft(UInt32 pValueToRotate, UInt32 pAmountToRotateBy);
+
+	UInt32 hashAvalanche(UInt32 pAccumulatedValue);
+
+	UInt32 initializeHashAccumulator(UInt32 pSeed);
+
+	void hashAccumulate(UInt32 &pAccumulator, UInt32 pValueToAccumulate);
+
+	/// <summary>
+	/// Get a pseudo random value for a point on a 2D integer grid
+	/// </summary>
+	/// <param name="pSeed">The seed</param>
+	/// <param name="pXCoord">The x coordinate of the grid point</param>
+	/// <param name="pYCoord">The y coordinate of the grid point</param>
+	/// <returns>A value in the range [0.0f, 1.0f]</returns>
+	Float hash2DGridWithSeed(UInt32 pSeed, Int32 pXCoord, Int32 pYCoord);
+
+	Float hash2DGrid(Int32 pXCoord, Int32 pYCoord);
+
+	inline
+	UInt32 rotateLeft(UInt32 pValueToRotate, UInt32 pAmountToRotateBy)
+	{
+		return (pValueToRotate << pAmountToRotateBy) | (pValueToRotate >> (32 - pAmountToRotateBy));
+	}
+
+	inline
+	UInt32 hashAvalanche(UInt32 pAccumulatedValue)
+	{
+		// NOTE: Using a variation of the 32-bit xxHash algorithm for hashing
+
+		UInt32 result = pAccumulatedValue;
+		result ^= result >> 15;
+		result *= hashPrime32_2;
+		result ^= result >> 13;
+		result *= hashPrime32_3;
+		result ^= result >> 16;
+
+		return result;
+	}
+
+	inline
+	UInt32 initializeHashAccumulator(UInt32 pSeed)
+	{
+		return pSeed + hashPrime32_5;
+	}
+
+	inline
+	void hashAccumulate(UInt32 &pAccumulator, UInt32 pValueToAccumulate)
+	{
+		pAccumulator = rotateLeft(pAccumulator + pValueToAccumulate * hashPrime32_3, 17) * hashPrime32_4;
+		pAccumulator = hashAvalanche(pAccumulator);
+	}
+
+	inline
+	Float hash2DGridWithSeed(UInt32 pSeed, Int32 pXCoord, Int32 pYCoord)
+	{
+		// Initialize the accumulator
+		UInt32 accumulator = initializeHashAccumulator(pSeed);
+
+		// Eat first coordinate
+		hashAccumulate(accumulator, static_cast<UInt32>(pXCoord) + 2147482647U);
+		// Eat second coordinate
+		hashAccumulate(accumulator, static_cast<UInt32>(pYCoord) + 2147482647U);
+
+		return static_cast<Float>(accumulator & 0x0000ffff) / 65535.0f;
+	}
+
+	inline
+	Float hash2DGrid(Int32 pXCoord, Int32 pYCoord)
+	{
+		return hash2DGridWithSeed(commonHashSeed, pXCoord, pYCoord);
+	}
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef FORGE_UTILITY_H
 #define FORGE_UTILITY_H
 
+#include <Forge/Source/Core/Forge.h>
+
 namespace forge
 {
 	/// <summary>
@@ -69,6 +71,46 @@ namespace forge
 	{
 		return pInteger >> pAmountToShift;
 	}
+
+	/// <summary>
+	/// Counts the number of bits that are set to 1 in the given integer
+	/// </summary>
+	/// <typeparam name="UnsignedIntegerType">The type of the integer. Must be unsigned</typeparam>
+	/// <param name="pInteger">The integer</param>
+	/// <returns>The number of bits that are set to 1</returns>
+	template <typename UnsignedIntegerType>
+	inline
+	UInt32 countSetBits(UnsignedIntegerType pInteger)
+	{
+		UInt32 numberOfSetBits = 0;
+		while(pInteger != 0)
+		{
+			// Clear the lowest bit that is set
+			pInteger &= pInteger - 1;
+			++numberOfSetBits;
+		}
+
+		return numberOfSetBits;
+	}
+
+	/// <summary>
+	/// Finds the index of the highest bit that is set to 1 in the given integer
+	/// </summary>
+	/// <typeparam name="UnsignedIntegerType">The type of the integer. Must be unsigned</typeparam>
+	/// <param name="pInteger">The integer. Must not be 0</param>
+	/// <returns>The index of the highest bit that is set to 1, where the lowest bit has the index 0</returns>
+	template <typename UnsignedIntegerType>
+	inline
+	UInt32 getHighestSetBitIndex(UnsignedIntegerType pInteger)
+	{
+		UInt32 highestSetBitIndex = 0;
+		while(pInteger >>= 1)
+		{
+			++highestSetBitIndex;
+		}
+
+		return highestSetBitIndex;
+	}
 }
 
 #endif
\ No newline at end of file
@@ -5,7 +5,7 @@
 
 namespace forge
 {
-	void OpenCLKernel::createProgramWithSourceString(OpenCLManager *pOpenCLManager, const char *pSourceTextString)
+	void OpenCLKernel::createProgramWithSourceString(OpenCLManager *pOpenCLManager, const char *pSourceTextString, const char *pBuildOptions)
 	{
 		// Used to store the return code from OpenCL functions
 		cl_int returnCode;
@@ -21,6 +21,11 @@ namespace forge
 		
 		std::filesystem::path currentDirectory = std::filesystem::current_path();
 		std::string programBuildOptionsString = "-I " + currentDirectory.string();
+		if(pBuildOptions)
+		{
+			programBuildOptionsString += " ";
+			programBuildOptionsString += pBuildOptions;
+		}
 		returnCode = clBuildProgram(this->openCLProgram, 1, &deviceID, programBuildOptionsString.c_str(), NULL, NULL);
 		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
 
@@ -16,7 +16,8 @@ namespace forge
 	{
 	public:
 
-		OpenCLKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName);
+		// The build options, if given, are passed to the OpenCL compiler along with the include directory. They can be used to define macros that select variants of a kernel
+		OpenCLKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName, const char *pBuildOptions = nullptr);
 
 		~OpenCLKernel();
 
@@ -46,16 +47,16 @@ namespace forge
 
 	private:
 
-		void createProgramWithSourceString(OpenCLManager *pOpenCLManager, const char *pSourceTextString);
+		void createProgramWithSourceString(OpenCLManager *pOpenCLManager, const char *pSourceTextString, const char *pBuildOptions);
 
 		cl_program openCLProgram;
 		cl_kernel kernel;
 	};
 
 	inline
-	OpenCLKernel::OpenCLKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName)
+	OpenCLKernel::OpenCLKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName, const char *pBuildOptions)
 	{
-		this->createProgramWithSourceString(pOpenCLManager, pTextFileEditor->getTextString());
+		this->createProgramWithSourceString(pOpenCLManager, pTextFileEditor->getTextString(), pBuildOptions);
 
 		// Used to store the return code from OpenCL functions
 		cl_int returnCode;
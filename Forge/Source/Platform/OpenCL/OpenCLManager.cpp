@@ -5,7 +5,7 @@
 
 namespace forge
 {
-	void OpenCLManager::startup()
+	void OpenCLManager::startup(bool pIsProfilingEnabled)
 	{
 		// Used to store the return code from various OpenCL functions
 		cl_int returnCode;
@@ -20,6 +20,11 @@ namespace forge
 		cl_platform_id bestDevicePlatformID = cl_platform_id();
 		cl_device_id bestDeviceID = cl_device_id();
 
+		// The first device of any type that was found. This is used if there is no GPU in the system
+		bool fallbackDeviceFound = false;
+		cl_platform_id fallbackDevicePlatformID = cl_platform_id();
+		cl_device_id fallbackDeviceID = cl_device_id();
+
 		// For each of available platforms
 		for(SizeType i = 0; i < platformIDs.getNumberOfElements(); ++i)
 		{
@@ -39,13 +44,21 @@ namespace forge
 				FORGE_OPENCL_ERROR_CODE_CHECK(clGetDeviceInfo(deviceIDs[i2], CL_DEVICE_TYPE, deviceTypeValueSize, &deviceType, NULL));
 
 				// NOTE: Choosing the first GPU
-				if(deviceType == CL_DEVICE_TYPE_GPU)
+				if(deviceType & CL_DEVICE_TYPE_GPU)
 				{
 					bestDevicePlatformID = platformIDs[i];
 					bestDeviceID = deviceIDs[i2];
 					suitableDeviceFound = true;
 					break;
 				}
+
+				// Remember the first device of any other type, in case the system does not have a GPU
+				if(!fallbackDeviceFound)
+				{
+					fallbackDevicePlatformID = platformIDs[i];
+					fallbackDeviceID = deviceIDs[i2];
+					fallbackDeviceFound = true;
+				}
 			}
 
 			if (suitableDeviceFound)
@@ -54,6 +67,18 @@ namespace forge
 			}
 		}
 
+		this->isDeviceAGPU = suitableDeviceFound;
+
+		// If there is no GPU, then fall back to the first device that was found, which will usually be the CPU
+		if(!suitableDeviceFound && fallbackDeviceFound)
+		{
+			bestDevicePlatformID = fallbackDevicePlatformID;
+			bestDeviceID = fallbackDeviceID;
+			suitableDeviceFound = true;
+
+			FORGE_DEBUG_LOG("OpenCLManager could not find a GPU, so falling back to a non GPU device");
+		}
+
 		if(suitableDeviceFound)
 		{
 			this->platformID = bestDevicePlatformID;
@@ -80,13 +105,18 @@ namespace forge
 				FORGE_DEBUG_LOG("Selected OpenCL device : ", &devicename[0]);
 			}
 
+			FORGE_OPENCL_ERROR_CODE_CHECK(clGetDeviceInfo(bestDeviceID, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(this->numberOfComputeUnits), &this->numberOfComputeUnits, NULL));
+
 			// Create the context
 			this->context = clCreateContext(NULL, 1, &bestDeviceID, NULL, NULL, &returnCode);
 			FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
 
 			// Create the command queue
-			this->commandQueue = clCreateCommandQueue(this->context, bestDeviceID, 0, &returnCode);
+			const cl_command_queue_properties commandQueueProperties = pIsProfilingEnabled? CL_QUEUE_PROFILING_ENABLE : 0;
+			this->commandQueue = clCreateCommandQueue(this->context, bestDeviceID, commandQueueProperties, &returnCode);
 			FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+
+			this->profiler.startup(pIsProfilingEnabled);
 		}
 		else
 		{
@@ -96,6 +126,8 @@ namespace forge
 
 	void OpenCLManager::shutdown()
 	{
+		this->profiler.shutdown();
+
 		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseCommandQueue(this->commandQueue));
 		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseContext(this->context));
 	}
@@ -2,6 +2,7 @@
 #define FORGE_OPENCL_MANAGER_H
 
 #include <CL/cl.h>
+#include "OpenCLProfiler.h"
 
 namespace forge
 {
@@ -9,7 +10,8 @@ namespace forge
 	{
 	public:
 
-		void startup();
+		// If profiling is enabled, the command queue records the device timestamps of the commands, and they can be collected with the profiler
+		void startup(bool pIsProfilingEnabled = false);
 
 		void shutdown();
 
@@ -19,12 +21,23 @@ namespace forge
 
 		cl_command_queue getCommandQueue() const;
 
+		// Whether the selected device is a GPU. If the system does not have a GPU, some other device is selected
+		bool getIsDeviceAGPU() const;
+
+		// The number of parallel compute units of the selected device, which is the number of work groups that it can run side by side, at least
+		cl_uint getNumberOfComputeUnits() const;
+
+		OpenCLProfiler* getProfiler();
+
 	private:
 
 		cl_platform_id platformID;
 		cl_device_id deviceID;
 		cl_context context;
 		cl_command_queue commandQueue;
+		bool isDeviceAGPU = false;
+		cl_uint numberOfComputeUnits = 1;
+		OpenCLProfiler profiler;
 	};
 
 	inline
@@ -44,6 +57,24 @@ namespace forge
 	{
 		return this->commandQueue;
 	}
+
+	inline
+	bool OpenCLManager::getIsDeviceAGPU() const
+	{
+		return this->isDeviceAGPU;
+	}
+
+	inline
+	cl_uint OpenCLManager::getNumberOfComputeUnits() const
+	{
+		return this->numberOfComputeUnits;
+	}
+
+	inline
+	OpenCLProfiler* OpenCLManager::getProfiler()
+	{
+		return &this->profiler;
+	}
 }
 
 #endif
\ No newline at end of file
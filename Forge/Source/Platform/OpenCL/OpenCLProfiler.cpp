@@ -0,0 +1,169 @@
+#include "OpenCLProfiler.h"
+#include <Forge/Source/Platform/OpenCL/OpenCLUtility.h>
+#include <Forge/Source/Core/Math/MathUtility.h>
+
+namespace forge
+{
+	void OpenCLProfiler::startup(bool pIsEnabled)
+	{
+		this->isEnabled = pIsEnabled;
+		this->numberOfPendingEvents = 0;
+		this->numberOfRecordedFrames.set(0);
+
+		if(this->isEnabled)
+		{
+			this->frameProfileSlots = new FrameProfileSlot[numberOfFramesInHistory];
+		}
+	}
+
+	void OpenCLProfiler::shutdown()
+	{
+		// Release the events of the frame that was not ended
+		for(SizeType i = 0; i < this->numberOfPendingEvents; ++i)
+		{
+			if(this->pendingEvents[i] != NULL)
+			{
+				FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseEvent(this->pendingEvents[i]));
+			}
+		}
+		this->numberOfPendingEvents = 0;
+
+		delete[] this->frameProfileSlots;
+		this->frameProfileSlots = nullptr;
+	}
+
+	cl_event* OpenCLProfiler::getEventForCommand(const char *pCommandName)
+	{
+		if(!this->isEnabled || this->numberOfPendingEvents == maxNumberOfCommandsPerFrame)
+		{
+			return NULL;
+		}
+
+		this->pendingCommandNames[this->numberOfPendingEvents] = pCommandName;
+		cl_event *event = &this->pendingEvents[this->numberOfPendingEvents];
+		// Stays NULL if the command fails to be enqueued
+		*event = NULL;
+		++this->numberOfPendingEvents;
+
+		return event;
+	}
+
+	void OpenCLProfiler::endFrame()
+	{
+		if(!this->isEnabled)
+		{
+			return;
+		}
+
+		// Remove the events of the commands that failed to be enqueued
+		SizeType numberOfValidEvents = 0;
+		for(SizeType i = 0; i < this->numberOfPendingEvents; ++i)
+		{
+			if(this->pendingEvents[i] != NULL)
+			{
+				this->pendingEvents[numberOfValidEvents] = this->pendingEvents[i];
+				this->pendingCommandNames[numberOfValidEvents] = this->pendingCommandNames[i];
+				++numberOfValidEvents;
+			}
+		}
+		this->numberOfPendingEvents = numberOfValidEvents;
+
+		if(this->numberOfPendingEvents > 0)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clWaitForEvents(static_cast<cl_uint>(this->numberOfPendingEvents), this->pendingEvents));
+		}
+
+		const Int32 frameIndex = this->numberOfRecordedFrames.get();
+		FrameProfileSlot &slot = this->frameProfileSlots[static_cast<SizeType>(frameIndex) % numberOfFramesInHistory];
+
+		// Readers retry while the sequence number is odd, or if it changes while they copy the frame profile
+		slot.sequenceNumber.increment();
+
+		slot.frameProfile.frameIndex = frameIndex;
+		slot.frameProfile.numberOfCommands = this->numberOfPendingEvents;
+		for(SizeType i = 0; i < this->numberOfPendingEvents; ++i)
+		{
+			CommandTimings &commandTimings = slot.frameProfile.commandTimings[i];
+			commandTimings.name = this->pendingCommandNames[i];
+			FORGE_OPENCL_ERROR_CODE_CHECK(clGetEventProfilingInfo(this->pendingEvents[i], CL_PROFILING_COMMAND_QUEUED, sizeof(cl_ulong), &commandTimings.queuedTime, NULL));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clGetEventProfilingInfo(this->pendingEvents[i], CL_PROFILING_COMMAND_SUBMIT, sizeof(cl_ulong), &commandTimings.submitTime, NULL));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clGetEventProfilingInfo(this->pendingEvents[i], CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &commandTimings.startTime, NULL));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clGetEventProfilingInfo(this->pendingEvents[i], CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &commandTimings.endTime, NULL));
+
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseEvent(this->pendingEvents[i]));
+		}
+
+		slot.sequenceNumber.increment();
+
+		// Publish the frame
+		this->numberOfRecordedFrames.increment();
+
+		this->numberOfPendingEvents = 0;
+	}
+
+	bool OpenCLProfiler::getRecordedFrame(SizeType pNumberOfFramesAgo, FrameProfile &pFrameProfile) const
+	{
+		if(!this->isEnabled)
+		{
+			return false;
+		}
+
+		const Int32 numberOfRecordedFramesLocalCopy = this->numberOfRecordedFrames.get();
+		if(pNumberOfFramesAgo >= static_cast<SizeType>(numberOfRecordedFramesLocalCopy) || pNumberOfFramesAgo >= numberOfFramesInHistory)
+		{
+			return false;
+		}
+
+		const Int32 frameIndex = numberOfRecordedFramesLocalCopy - 1 - static_cast<Int32>(pNumberOfFramesAgo);
+		const FrameProfileSlot &slot = this->frameProfileSlots[static_cast<SizeType>(frameIndex) % numberOfFramesInHistory];
+
+		while(true)
+		{
+			const Int32 sequenceNumberBeforeCopy = slot.sequenceNumber.get();
+			if((sequenceNumberBeforeCopy & 1) != 0)
+			{
+				// The slot is being written
+				continue;
+			}
+
+			pFrameProfile = slot.frameProfile;
+
+			if(slot.sequenceNumber.get() == sequenceNumberBeforeCopy)
+			{
+				break;
+			}
+		}
+
+		// The slot may have been reused for a newer frame since the number of recorded frames was read
+		return pFrameProfile.frameIndex == frameIndex;
+	}
+
+	void OpenCLProfiler::dump(std::ostream &pStream) const
+	{
+		const SizeType numberOfFramesToDump = min<SizeType>(static_cast<SizeType>(this->getNumberOfRecordedFrames()), numberOfFramesInHistory);
+
+		FrameProfile frameProfile;
+		for(SizeType i = numberOfFramesToDump; i != 0; --i)
+		{
+			if(!this->getRecordedFrame(i - 1, frameProfile))
+			{
+				continue;
+			}
+
+			pStream << "Frame " << frameProfile.frameIndex << "\n";
+
+			// The times are written in microseconds relative to when the first command of the frame was enqueued
+			const cl_ulong frameStartTime = (frameProfile.numberOfCommands > 0)? frameProfile.commandTimings[0].queuedTime : 0;
+			for(SizeType i2 = 0; i2 < frameProfile.numberOfCommands; ++i2)
+			{
+				const CommandTimings &commandTimings = frameProfile.commandTimings[i2];
+				pStream << "\t" << commandTimings.name
+						<< " : queued " << static_cast<Double>(commandTimings.queuedTime - frameStartTime) / 1000.0
+						<< " us, submitted " << static_cast<Double>(commandTimings.submitTime - frameStartTime) / 1000.0
+						<< " us, started " << static_cast<Double>(commandTimings.startTime - frameStartTime) / 1000.0
+						<< " us, ended " << static_cast<Double>(commandTimings.endTime - frameStartTime) / 1000.0
+						<< " us, executed for " << static_cast<Double>(commandTimings.endTime - commandTimings.startTime) / 1000.0 << " us\n";
+			}
+		}
+	}
+}
@@ -0,0 +1,113 @@
+#ifndef FORGE_OPENCL_PROFILER_H
+#define FORGE_OPENCL_PROFILER_H
+
+#include <ostream>
+#include <CL/cl.h>
+#include <Forge/Source/Core/Forge.h>
+#include <Forge/Source/Platform/Windows/Threading/AtomicInteger.h>
+
+namespace forge
+{
+	/// <summary>
+	/// Records the device timestamps of named OpenCL commands. The commands enqueued during a frame are collected, and when the frame ends
+	/// their timestamps are stored in a ring buffer that holds the most recent frames. The ring buffer is written by a single thread,
+	/// and can be read by any number of threads without a lock.
+	/// The command queue must be created with CL_QUEUE_PROFILING_ENABLE for the profiler to be enabled
+	/// </summary>
+	class OpenCLProfiler
+	{
+	public:
+
+		static constexpr SizeType maxNumberOfCommandsPerFrame = 32;
+		static constexpr SizeType numberOfFramesInHistory = 128;
+
+		// The device timestamps of a command, in nanoseconds
+		struct CommandTimings
+		{
+			// Must point to a string that outlives the profiler. String literals are expected
+			const char *name;
+			// When the command was enqueued
+			cl_ulong queuedTime;
+			// When the command was submitted to the device
+			cl_ulong submitTime;
+			// When the command started executing on the device
+			cl_ulong startTime;
+			// When the command finished executing on the device
+			cl_ulong endTime;
+		};
+
+		struct FrameProfile
+		{
+			// The index of the frame, counting from the first frame that was recorded
+			Int32 frameIndex;
+			SizeType numberOfCommands;
+			CommandTimings commandTimings[maxNumberOfCommandsPerFrame];
+		};
+
+		void startup(bool pIsEnabled);
+
+		void shutdown();
+
+		bool getIsEnabled() const;
+
+		/// <summary>
+		/// Get an event to pass to a clEnqueue function, so that the timestamps of the command are recorded at the end of the frame
+		/// </summary>
+		/// <param name="pCommandName">The name of the command. Must outlive the profiler</param>
+		/// <returns>The event to pass to the clEnqueue function. NULL if the profiler is disabled or the frame cannot hold any more commands</returns>
+		cl_event* getEventForCommand(const char *pCommandName);
+
+		/// <summary>
+		/// Wait for all the commands of the current frame to finish executing, and store their timestamps in the ring buffer.
+		/// Must be called from the thread that enqueues the commands
+		/// </summary>
+		void endFrame();
+
+		// Get the number of frames that have been recorded since startup. Only the most recent numberOfFramesInHistory frames can be queried
+		Int32 getNumberOfRecordedFrames() const;
+
+		/// <summary>
+		/// Copy a recorded frame out of the ring buffer. Can be called from any thread
+		/// </summary>
+		/// <param name="pNumberOfFramesAgo">0 is the most recently recorded frame</param>
+		/// <param name="pFrameProfile">The frame profile to copy the frame into</param>
+		/// <returns>False if the frame is not in the ring buffer</returns>
+		bool getRecordedFrame(SizeType pNumberOfFramesAgo, FrameProfile &pFrameProfile) const;
+
+		// Write the timings of all the frames in the ring buffer to the given stream, from the oldest to the newest frame
+		void dump(std::ostream &pStream) const;
+
+	private:
+
+		struct FrameProfileSlot
+		{
+			// Odd while the frame profile is being written
+			AtomicInteger sequenceNumber;
+			FrameProfile frameProfile;
+		};
+
+		bool isEnabled = false;
+
+		// The commands enqueued in the current frame that have not been recorded yet
+		cl_event pendingEvents[maxNumberOfCommandsPerFrame];
+		const char *pendingCommandNames[maxNumberOfCommandsPerFrame];
+		SizeType numberOfPendingEvents = 0;
+
+		FrameProfileSlot *frameProfileSlots = nullptr;
+		AtomicInteger numberOfRecordedFrames;
+	};
+
+	inline
+	bool OpenCLProfiler::getIsEnabled() const
+	{
+		return this->isEnabled;
+	}
+
+	inline
+	Int32 OpenCLProfiler::getNumberOfRecordedFrames() const
+	{
+		return this->numberOfRecordedFrames.get();
+	}
+}
+
+#endif
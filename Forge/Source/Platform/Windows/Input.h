@@ -87,6 +87,16 @@ namespace forge
 		// Invoked when the 'B' key is released
 		Event<> onBKeyReleased;
 
+		// Invoked when the 'C' key is pressed. If the key is held down for long enough, this event will start repeating
+		Event<> onCKeyPressed;
+		// Invoked when the 'C' key is released
+		Event<> onCKeyReleased;
+
+		// Invoked when the 'P' key is pressed. If the key is held down for long enough, this event will start repeating
+		Event<> onPKeyPressed;
+		// Invoked when the 'P' key is released
+		Event<> onPKeyReleased;
+
 		// Invoked when the 'V' key is pressed. If the key is held down for long enough, this event will start repeating
 		Event<> onVKeyPressed;
 		// Invoked when the 'V' key is released
@@ -168,6 +178,8 @@ namespace forge
 		bool isZKeyPressed = false;
 		bool isGKeyPressed = false;
 		bool isBKeyPressed = false;
+		bool isCKeyPressed = false;
+		bool isPKeyPressed = false;
 		bool isVKeyPressed = false;
 		bool is1KeyPressed = false;
 		bool is2KeyPressed = false;
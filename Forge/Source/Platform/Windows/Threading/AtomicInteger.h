@@ -0,0 +1,113 @@
+#ifndef FORGE_ATOMIC_INTEGER_H
+#define FORGE_ATOMIC_INTEGER_H
+
+#ifdef _WIN32
+#include "../ForgeWindowsHeader.h"
+#else
+#include <atomic>
+#endif
+#include <Forge/Source/Core/Forge.h>
+
+namespace forge
+{
+	// A 32-bit signed integer that can be read and modified by multiple threads at the same time without a lock
+	class AtomicInteger
+	{
+	public:
+
+		AtomicInteger(Int32 pInitialValue = 0);
+
+		Int32 get() const;
+
+		void set(Int32 pValue);
+
+		// Increments the value and returns the incremented value
+		Int32 increment();
+
+		// Decrements the value and returns the decremented value
+		Int32 decrement();
+
+		// Adds the given amount to the value and returns the value before the addition
+		Int32 fetchAndAdd(Int32 pAmountToAdd);
+
+	private:
+
+#ifdef _WIN32
+		// NOTE: The Interlocked functions require the variable to be aligned on a 32-bit boundary
+		alignas(4) volatile LONG value;
+#else
+		// Other platforms use the standard library, so that the OpenCL code that depends on this can be built without Windows
+		std::atomic<Int32> value;
+#endif
+	};
+
+	inline
+	AtomicInteger::AtomicInteger(Int32 pInitialValue) :
+	value(pInitialValue)
+	{
+	}
+
+#ifdef _WIN32
+	inline
+	Int32 AtomicInteger::get() const
+	{
+		return static_cast<Int32>(InterlockedCompareExchange(const_cast<volatile LONG*>(&this->value), 0, 0));
+	}
+
+	inline
+	void AtomicInteger::set(Int32 pValue)
+	{
+		InterlockedExchange(&this->value, static_cast<LONG>(pValue));
+	}
+
+	inline
+	Int32 AtomicInteger::increment()
+	{
+		return static_cast<Int32>(InterlockedIncrement(&this->value));
+	}
+
+	inline
+	Int32 AtomicInteger::decrement()
+	{
+		return static_cast<Int32>(InterlockedDecrement(&this->value));
+	}
+
+	inline
+	Int32 AtomicInteger::fetchAndAdd(Int32 pAmountToAdd)
+	{
+		return static_cast<Int32>(InterlockedExchangeAdd(&this->value, static_cast<LONG>(pAmountToAdd)));
+	}
+#else
+	inline
+	Int32 AtomicInteger::get() const
+	{
+		return this->value.load();
+	}
+
+	inline
+	void AtomicInteger::set(Int32 pValue)
+	{
+		this->value.store(pValue);
+	}
+
+	inline
+	Int32 AtomicInteger::increment()
+	{
+		return this->value.fetch_add(1) + 1;
+	}
+
+	inline
+	Int32 AtomicInteger::decrement()
+	{
+		return this->value.fetch_sub(1) - 1;
+	}
+
+	inline
+	Int32 AtomicInteger::fetchAndAdd(Int32 pAmountToAdd)
+	{
+		return this->value.fetch_add(pAmountToAdd);
+	}
+#endif
+}
+
+#endif
@@ -1,8 +1,12 @@
 #ifndef FORGE_MUTEX_H
 #define FORGE_MUTEX_H
 
+#ifdef _WIN32
 #include "../ForgeWindowsHeader.h"
 #include <Forge/Source/Platform/Windows/WindowsLogging.h>
+#else
+#include <mutex>
+#endif
 
 namespace forge
 {
@@ -20,9 +24,15 @@ namespace forge
 
 	private:
 
+#ifdef _WIN32
 		CRITICAL_SECTION criticalSection;
+#else
+		// Other platforms use the standard library, so that the voxel grid can be built without Windows
+		std::mutex mutex;
+#endif
 	};
 
+#ifdef _WIN32
 	inline
 	Mutex::Mutex()
 	{
@@ -49,6 +59,29 @@ namespace forge
 	{
 		LeaveCriticalSection(&this->criticalSection);
 	}
+#else
+	inline
+	Mutex::Mutex()
+	{
+	}
+
+	inline
+	Mutex::~Mutex()
+	{
+	}
+
+	inline
+	void Mutex::lock()
+	{
+		this->mutex.lock();
+	}
+
+	inline
+	void Mutex::unlock()
+	{
+		this->mutex.unlock();
+	}
+#endif
 }
 
 #endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "../ForgeWindowsHeader.h"
 #include <Forge/Source/Platform/Windows/WindowsLogging.h>
+#include <Forge/Source/Core/Forge.h>
 
 namespace forge
 {
@@ -18,6 +19,9 @@ namespace forge
 
 		void waitForExit();
 
+		// Get the number of logical processors in the system. This is the number of threads that can truly run at the same time
+		static UInt32 getNumberOfLogicalProcessors();
+
 	private:
 
 		template <typename ClassType, typename FunctionArgumentType>
@@ -72,6 +76,14 @@ namespace forge
 		int i = 0;
 	}
 
+	inline
+	UInt32 Thread::getNumberOfLogicalProcessors()
+	{
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo(&systemInfo);
+		return static_cast<UInt32>(systemInfo.dwNumberOfProcessors);
+	}
+
 	template <typename ClassType, void (ClassType::*pThreadFunctionPointer)()>
 	inline
 	DWORD WINAPI Thread::staticThreadFunctionWithoutParams(LPVOID pLpParameter)
@@ -298,6 +298,20 @@ namespace forge
 			this->input.onBKeyPressed.invoke();
 			return 0;
 		}
+		// 'C' key
+		case 0x43:
+		{
+			this->input.isCKeyPressed = true;
+			this->input.onCKeyPressed.invoke();
+			return 0;
+		}
+		// 'P' key
+		case 0x50:
+		{
+			this->input.isPKeyPressed = true;
+			this->input.onPKeyPressed.invoke();
+			return 0;
+		}
 		// 'V' key
 		case 0x56:
 		{
@@ -411,6 +425,20 @@ namespace forge
 			this->input.onBKeyReleased.invoke();
 			return 0;
 		}
+		// 'C' key
+		case 0x43:
+		{
+			this->input.isCKeyPressed = false;
+			this->input.onCKeyReleased.invoke();
+			return 0;
+		}
+		// 'P' key
+		case 0x50:
+		{
+			this->input.isPKeyPressed = false;
+			this->input.onPKeyReleased.invoke();
+			return 0;
+		}
 		// 'V' key
 		case 0x56:
 		{
@@ -12,17 +12,20 @@ struct RayAndVoxelOctreeIntersectionData
 	float3 point;
 	float2 uvCoords;
 	float3 normal;
+	// The number of nodes and voxels that the ray visited, which is also set if the ray does not hit anything
+	uint numberOfTraversalSteps;
 };
 
 bool rayAndVoxelOctreeIntersectionTest(struct Ray pRay,
-									   __global struct Voxel *pVoxelOctreeNodesArray,
-									   uint pVoxelOctreeDepth,
+									   struct VoxelOctree pVoxelOctree,
 									   long3 pVoxelGridMinCoords,
 									   long3 pVoxelGridMaxCoords,
 									   float pMaxRayDistance,
 									   int pIsOctreeVisualizationEnabled,
 									   struct RayAndVoxelOctreeIntersectionData *pIntersectionData)
 {
+	pIntersectionData->numberOfTraversalSteps = 0;
+
 	// This AABB that represents the bounds of the voxel grid
 	struct AABB voxelGridAABB;
 	// Calculate the AABB that represents the bounds of the voxel grid
@@ -53,370 +56,353 @@ bool rayAndVoxelOctreeIntersectionTest(struct Ray pRay,
 		}
 	}
 
-	// These are the iteration variables that are initialized at the start of the iteration and do not change during the iteration
-	float3 rayDirectionSigns = sign(pRay.direction);
+	// The voxels are the nodes at the last level of the octree
+	const uint voxelLevel = pVoxelOctree.depth - 1;
+	const int voxelGridSideLength = 1 << voxelLevel;
+	const uint voxelBrickLevel = getVoxelBrickLevel(&pVoxelOctree);
+
+	// The octree is traversed in a mirrored coordinate system, in which every component of the direction of the ray is positive. This way,
+	// the traversal never has to branch on the direction of the ray. Each axis along which the ray has a negative direction is mirrored,
+	// which flips every bit of the voxel coords along that axis, and the child index bit of that axis in the child index of every node.
+	// Bit i of the octant mask is set if axis i is mirrored
+	const int3 isAxisMirrored = pRay.direction < 0.0f;
+	const uint octantMask = (isAxisMirrored.x & 0x00000001) | (isAxisMirrored.y & 0x00000002) | (isAxisMirrored.z & 0x00000004);
+	// The same mirroring for the bits of a voxel brick, which hold two bits of the voxel coords along each axis
+	const uint voxelBrickOctantMask = octantMask | (octantMask << 3);
+	// XOR the voxel coords with this to mirror them
+	const int3 voxelCoordsMirrorMask = isAxisMirrored & (voxelGridSideLength - 1);
+
+	// These are the iteration variables that are initialized at the start of the iteration and do not change during the iteration.
+	// The nodes are traversed in integer voxel coords relative to the minimum corner of the voxel grid, so the origin of the ray is moved into that space.
+	// Every distance along the ray is calculated from this origin, so no error is accumulated while the ray moves through the octree
+	const float3 rayOriginInVoxelGrid = pRay.origin - voxelGridAABB.minPoint;
+	// A direction of 0 is replaced with a tiny positive one, so that the ray never reaches the next node along that axis
+	const float3 mirroredRayDirectionInverses = 1.0f / fmax(fabs(pRay.direction), 1e-20f);
+
+	// With a toroidal offset, the nodes are traversed where the voxels are stored, and the origin of the ray is moved there as well. The ray wraps around
+	// to the start of the memory whenever it leaves the end of it, and it leaves the voxel grid in the middle of the memory instead, at the mirrored coords
+	// in memory of the first voxels past the voxel grid. The origin only changes when the ray wraps around, by a whole number of side lengths, so no error is accumulated
+	const bool isVoxelGridToroidal = any(pVoxelOctree.toroidalOffset != 0);
+	float3 mirroredRayOrigin = select(rayOriginInVoxelGrid, (float)voxelGridSideLength - rayOriginInVoxelGrid, isAxisMirrored);
+	int3 voxelGridExitCoords = (int3)(voxelGridSideLength, voxelGridSideLength, voxelGridSideLength);
+	if(isVoxelGridToroidal)
+	{
+		// The point at which the ray enters the voxel grid can be slightly outside of it, which would wrap it around to the other end of the voxel grid
+		mirroredRayOrigin = clamp(mirroredRayOrigin, 0.0f, (float)voxelGridSideLength);
+
+		// Mirroring moves the toroidal offset the other way along the mirrored axes
+		const int3 mirroredToroidalOffset = select(pVoxelOctree.toroidalOffset, (voxelGridSideLength - pVoxelOctree.toroidalOffset) & (voxelGridSideLength - 1), isAxisMirrored);
+		mirroredRayOrigin += convert_float3(mirroredToroidalOffset);
+		voxelGridExitCoords += mirroredToroidalOffset;
+
+		const int3 isRayOriginPastMemoryEnd = mirroredRayOrigin >= (float)voxelGridSideLength;
+		mirroredRayOrigin = select(mirroredRayOrigin, mirroredRayOrigin - (float)voxelGridSideLength, isRayOriginPastMemoryEnd);
+		voxelGridExitCoords = select(voxelGridExitCoords, voxelGridExitCoords - voxelGridSideLength, isRayOriginPastMemoryEnd);
+
+		// If the ray starts at the exit of the voxel grid
+		if(any(convert_int3(floor(mirroredRayOrigin)) >= voxelGridExitCoords))
+		{
+			return false;
+		}
+	}
 
 	// These are the iteration variables that are initialized at the start of the iteration and can change during the iteration
 	uint currentNodeMortonCode = 0x00000001;
 	uint currentLevel = 0;
-	float nodeHalfScale = (voxelGridAABB.maxPoint.x - voxelGridAABB.minPoint.x) / 2.0f;
-	float3 rayDistancesBetweenCoords = fabs(1.0f / pRay.direction) * (voxelGridAABB.maxPoint.x - voxelGridAABB.minPoint.x);
+	// The mirrored voxel coords of the minimum corner of the current node
+	int3 currentNodeMinCoords = (int3)(0, 0, 0);
+	// The distance from the origin of the ray at which the ray enters the current node
+	float currentRayDistance = 0.0f;
 	bool hasCurrentNodeBeenExplored = false;
-	float3 currentRayPosition = pRay.origin;
-	float3 currentNodeCenter;
-	float3 currentNodeParentCenter;
-	currentNodeCenter.x = -0.5f;
-	currentNodeCenter.y = -0.5f;
-	currentNodeCenter.z = -0.5f;
-	currentNodeParentCenter = currentNodeCenter;
+	// Used by the sparse voxel octree to keep track of the nodes on the path from the root to the current node
+	uint nodeIndexStack[FORGE_MAX_VOXEL_OCTREE_DEPTH];
 
 	// Traverse the octree
 	while(true)
 	{
+		++pIntersectionData->numberOfTraversalSteps;
+
+		// The side length of a node at the current level, in voxels, is a power of 2
+		const uint currentNodeSideLengthLog2 = voxelLevel - currentLevel;
+		const int currentNodeSideLength = 1 << currentNodeSideLengthLog2;
+
 		// If the current node has been explored
 		if(hasCurrentNodeBeenExplored)
 		{
-			// If the current level is 0
-			if(currentLevel == 0)
+			// Each component holds the distance from the origin of the ray at which the ray leaves the current node through its boundary along the corresponding axis
+			const float3 rayDistancesToNodeExit = (convert_float3(currentNodeMinCoords + currentNodeSideLength) - mirroredRayOrigin) * mirroredRayDirectionInverses;
+
+			// Move to the neighbouring node at the current level along the axis whose boundary the ray leaves the current node through first.
+			// Only the coordinate along that axis changes
+			int3 nextNodeMinCoords = currentNodeMinCoords;
+			uint axisOfNextNode;
+			int currentNodeCoord;
+			int nextNodeCoord;
+			float rayDistanceToNextNode;
+			{
+				if(rayDistancesToNodeExit.x < rayDistancesToNodeExit.y && rayDistancesToNodeExit.x < rayDistancesToNodeExit.z)
+				{
+					axisOfNextNode = 0;
+					currentNodeCoord = currentNodeMinCoords.x;
+					nextNodeMinCoords.x += currentNodeSideLength;
+					nextNodeCoord = nextNodeMinCoords.x;
+					rayDistanceToNextNode = rayDistancesToNodeExit.x;
+				}
+				else if(rayDistancesToNodeExit.y < rayDistancesToNodeExit.z)
+				{
+					axisOfNextNode = 1;
+					currentNodeCoord = currentNodeMinCoords.y;
+					nextNodeMinCoords.y += currentNodeSideLength;
+					nextNodeCoord = nextNodeMinCoords.y;
+					rayDistanceToNextNode = rayDistancesToNodeExit.y;
+				}
+				else
+				{
+					axisOfNextNode = 2;
+					currentNodeCoord = currentNodeMinCoords.z;
+					nextNodeMinCoords.z += currentNodeSideLength;
+					nextNodeCoord = nextNodeMinCoords.z;
+					rayDistanceToNextNode = rayDistancesToNodeExit.z;
+				}
+			}
+
+			// If the next node is outside the voxel grid
+			if(any(nextNodeMinCoords >= voxelGridExitCoords))
 			{
 				// The ray has exited the octree without hitting any voxel, so return false
 				return false;
 			}
-			// If the current level is not 0
-			else
+
+			// With a toroidal offset, the ray can leave the end of the memory before it leaves the voxel grid. It goes on from the start of the memory
+			// along that axis, so it starts again from the root node there
+			if(nextNodeCoord >= voxelGridSideLength)
 			{
-				// Each component holds the distance that the ray needs to travel for the whole number part of the corresponding coordinate to reach its next value
-				float3 rayDistancesToNextCoords;
-				// Calculate the ray distances to the next coords
+				if(axisOfNextNode == 0)
 				{
-					if(pRay.direction.x > 0.0f)
-					{
-						rayDistancesToNextCoords.x = (currentNodeCenter.x + nodeHalfScale - currentRayPosition.x) / (nodeHalfScale * 2.0f) * rayDistancesBetweenCoords.x;
-					}
-					else if(pRay.direction.x < 0.0f)
-					{
-						rayDistancesToNextCoords.x = (currentRayPosition.x - (currentNodeCenter.x - nodeHalfScale)) / (nodeHalfScale * 2.0f) * rayDistancesBetweenCoords.x;
-					}
-					else
-					{
-						rayDistancesToNextCoords.x = MAXFLOAT;
-					}
-	
-					if(pRay.direction.y > 0.0f)
-					{
-						rayDistancesToNextCoords.y = (currentNodeCenter.y + nodeHalfScale - currentRayPosition.y) / (nodeHalfScale * 2.0f) * rayDistancesBetweenCoords.y;
-					}
-					else if(pRay.direction.y < 0.0f)
-					{
-						rayDistancesToNextCoords.y = (currentRayPosition.y - (currentNodeCenter.y - nodeHalfScale)) / (nodeHalfScale * 2.0f) * rayDistancesBetweenCoords.y;
-					}
-					else
-					{
-						rayDistancesToNextCoords.y = MAXFLOAT;
-					}
-	
-					if(pRay.direction.z > 0.0f)
-					{
-						rayDistancesToNextCoords.z = (currentNodeCenter.z + nodeHalfScale - currentRayPosition.z) / (nodeHalfScale * 2.0f) * rayDistancesBetweenCoords.z;
-					}
-					else if(pRay.direction.z < 0.0f)
-					{
-						rayDistancesToNextCoords.z = (currentRayPosition.z - (currentNodeCenter.z - nodeHalfScale)) / (nodeHalfScale * 2.0f) * rayDistancesBetweenCoords.z;
-					}
-					else
-					{
-						rayDistancesToNextCoords.z = MAXFLOAT;
-					}
+					mirroredRayOrigin.x -= (float)voxelGridSideLength;
+					voxelGridExitCoords.x -= voxelGridSideLength;
+				}
+				else if(axisOfNextNode == 1)
+				{
+					mirroredRayOrigin.y -= (float)voxelGridSideLength;
+					voxelGridExitCoords.y -= voxelGridSideLength;
+				}
+				else
+				{
+					mirroredRayOrigin.z -= (float)voxelGridSideLength;
+					voxelGridExitCoords.z -= voxelGridSideLength;
 				}
+				currentNodeMortonCode = 0x00000001;
+				currentLevel = 0;
+				currentNodeMinCoords = (int3)(0, 0, 0);
+				currentRayDistance = fmax(currentRayDistance, rayDistanceToNextNode);
+				hasCurrentNodeBeenExplored = false;
+				continue;
+			}
+
+			// Step up directly to the level whose nodes the ray is moving between. The highest bit in which the coords of the current and the next node differ
+			// is the side length of the nodes at that level, because all the higher bits are the same in both of their coords, so they have the same parent there.
+			// That parent is an ancestor of the current node, so it has already been fetched, and the next node is one of its children
+			{
+				const uint nextNodeSideLengthLog2 = 31 - clz((uint)(currentNodeCoord ^ nextNodeCoord));
+				const uint nextLevel = voxelLevel - nextNodeSideLengthLog2;
+
+				// The child index of the next node only differs from the one of the ancestor of the current node at that level in the bit of the axis it moved along.
+				// This is the same whether or not the axis is mirrored
+				currentNodeMortonCode = (currentNodeMortonCode >> ((currentLevel - nextLevel) * 3)) ^ (1 << axisOfNextNode);
+				currentLevel = nextLevel;
+				currentNodeMinCoords = nextNodeMinCoords & ~((1 << nextNodeSideLengthLog2) - 1);
+				currentRayDistance = fmax(currentRayDistance, rayDistanceToNextNode);
 
-				float3 nextNodeCenter = currentNodeCenter;
-				float3 nextRayPosition;
-				// Calculate the center of the next node at this level and the next ray position
+				// Mark the node just stepped to as not explored
+				hasCurrentNodeBeenExplored = false;
+			}
+		}
+		// If the current node has not been explored
+		else
+		{
+			// The nodes at the voxel brick level hold the voxels, and the nodes above it hold the child masks
+			const bool isCurrentNodeAVoxelBrick = (currentLevel == voxelBrickLevel);
+			ulong currentVoxelBrick = 0;
+			uint currentVoxelBrickIndex = 0;
+			bool doesCurrentNodeHaveChildren;
+			if(isCurrentNodeAVoxelBrick)
+			{
+				currentVoxelBrick = getVoxelOctreeBrick(&pVoxelOctree, currentNodeMortonCode, nodeIndexStack, &currentVoxelBrickIndex);
+				doesCurrentNodeHaveChildren = (currentVoxelBrick != 0);
+			}
+			else
+			{
+				doesCurrentNodeHaveChildren = (getVoxelOctreeNodeChildMask(&pVoxelOctree, currentNodeMortonCode, currentLevel, nodeIndexStack) != 0);
+			}
+
+			// If the current node has any children
+			if(doesCurrentNodeHaveChildren)
+			{
+				// The mirrored position at which the ray enters the current node
+				const float3 currentRayPosition = mirroredRayOrigin + fabs(pRay.direction) * currentRayDistance;
+
+				// TODO: This debug draws the octree nodes. Can this be done in a better way?
 				{
-					if(rayDistancesToNextCoords.x < rayDistancesToNextCoords.y)
+					if(pIsOctreeVisualizationEnabled)
 					{
-						if(rayDistancesToNextCoords.x < rayDistancesToNextCoords.z)
+						const float nodeHalfScale = (float)currentNodeSideLength / 2.0f;
+						const float3 currentNodeCenter = convert_float3(currentNodeMinCoords) + nodeHalfScale;
+						int numberOfCoordsInBorderRange = 0;
+						if(fabs(currentNodeCenter.x - currentRayPosition.x) > nodeHalfScale - 0.1f)
 						{
-							nextNodeCenter.x += nodeHalfScale * 2.0f * rayDirectionSigns.x;
-							nextRayPosition = currentRayPosition + pRay.direction * rayDistancesToNextCoords.x;
+							++numberOfCoordsInBorderRange;
 						}
-						else
+						if(fabs(currentNodeCenter.y - currentRayPosition.y) > nodeHalfScale - 0.1f)
 						{
-							nextNodeCenter.z += nodeHalfScale * 2.0f * rayDirectionSigns.z;
-							nextRayPosition = currentRayPosition + pRay.direction * rayDistancesToNextCoords.z;
+							++numberOfCoordsInBorderRange;
 						}
-					}
-					else
-					{
-						if(rayDistancesToNextCoords.y < rayDistancesToNextCoords.z)
+						if(fabs(currentNodeCenter.z - currentRayPosition.z) > nodeHalfScale - 0.1f)
 						{
-							nextNodeCenter.y += nodeHalfScale * 2.0f * rayDirectionSigns.y;
-							nextRayPosition = currentRayPosition + pRay.direction * rayDistancesToNextCoords.y;
+							++numberOfCoordsInBorderRange;
 						}
-						else
+						if(numberOfCoordsInBorderRange > 1)
 						{
-							nextNodeCenter.z += nodeHalfScale * 2.0f * rayDirectionSigns.z;
-							nextRayPosition = currentRayPosition + pRay.direction * rayDistancesToNextCoords.z;
+							// Octree node borders are not voxels, so they are given the empty voxel ID
+							pIntersectionData->voxel.voxelID = 0;
+							pIntersectionData->point = pRay.origin + pRay.direction * currentRayDistance;
+							return true;
 						}
 					}
 				}
 
-				uint nextNodeIndex = 0;
-				// Calculate the index of the next node
-				{
-					if(nextNodeCenter.x > currentNodeParentCenter.x)
-					{
-						nextNodeIndex |= 0x00000001;
-					}
-					if(nextNodeCenter.y > currentNodeParentCenter.y)
-					{
-						nextNodeIndex |= 0x00000002;
-					}
-					if(nextNodeCenter.z > currentNodeParentCenter.z)
-					{
-						nextNodeIndex |= 0x00000004;
-					}
-				}
+				// The voxel that the ray enters the current node in. It is clamped to the current node, in case the ray position was rounded to just outside of it
+				const int3 currentVoxelCoords = clamp(convert_int3(floor(currentRayPosition)), currentNodeMinCoords, currentNodeMinCoords + (currentNodeSideLength - 1));
 
-				// If the next node the ray enters at the current level is a child of the parent of the current node
-				if((currentNodeMortonCode & 0x00000007) != nextNodeIndex)
+				// If the current node is a voxel brick
+				if(isCurrentNodeAVoxelBrick)
 				{
-					// Move to the next node at the current level that the ray enters
+					// With a toroidal offset, the ray can start again from the root node after it has wrapped around to the start of the memory, at the same time
+					// as it leaves the voxel grid along another axis
+					if(any(currentVoxelCoords >= voxelGridExitCoords))
 					{
-						currentNodeMortonCode = (currentNodeMortonCode & 0xfffffff8) | nextNodeIndex;
-
-						currentNodeCenter = nextNodeCenter;
+						return false;
+					}
 
-						currentRayPosition = nextRayPosition;
+					// Traverse the voxels in the voxel brick as a uniform grid, testing the bit of each voxel that the ray enters
+					int3 voxelCoordsInVoxelBrick = currentVoxelCoords - currentNodeMinCoords;
+					// Each component holds the distance from the origin of the ray at which the ray enters the next voxel along the corresponding axis
+					float3 rayDistancesToNextVoxels = (convert_float3(currentVoxelCoords + 1) - mirroredRayOrigin) * mirroredRayDirectionInverses;
+					// The distance from the origin of the ray at which the ray enters the current voxel
+					float rayDistanceToCurrentVoxel = currentRayDistance;
 
-						// Mark the current node at the current level as not fully explored
-						hasCurrentNodeBeenExplored = false;
-					}
-				}
-				// If the next node the ray enters at the current level is not a child of the parent of the current node
-				else
-				{
-					// Step up a certain number of levels
+					while(true)
 					{
-						// Step up to the next lowest level from which uniform grid traversal is possible
-						// TODO: Can this be made faster, by removing the loop?
-						{
-							do
-							{
-								uint currentChildIndex = currentNodeMortonCode & 0x00000007;
-								if(currentChildIndex & 0x00000001)
-								{
-									currentNodeCenter.x -= nodeHalfScale;
-								}
-								else
-								{
-									currentNodeCenter.x += nodeHalfScale;
-								}
-
-								if(currentChildIndex & 0x00000002)
-								{
-									currentNodeCenter.y -= nodeHalfScale;
-								}
-								else
-								{
-									currentNodeCenter.y += nodeHalfScale;
-								}
+						++pIntersectionData->numberOfTraversalSteps;
 
-								if(currentChildIndex & 0x00000004)
-								{
-									currentNodeCenter.z -= nodeHalfScale;
-								}
-								else
-								{
-									currentNodeCenter.z += nodeHalfScale;
-								}
+						// If the current voxel is non empty
+						const uint voxelBrickBitIndex = getVoxelBrickBitIndex(convert_uint3(voxelCoordsInVoxelBrick)) ^ voxelBrickOctantMask;
+						if(currentVoxelBrick & ((ulong)1 << voxelBrickBitIndex))
+						{
+							// A voxel has been hit, so fill the intersection data and return true. The coords of the voxel in memory are moved back by the toroidal offset
+							const int3 voxelCoords = (((currentNodeMinCoords + voxelCoordsInVoxelBrick) ^ voxelCoordsMirrorMask) - pVoxelOctree.toroidalOffset) & (voxelGridSideLength - 1);
+							const float3 voxelCenter = voxelGridAABB.minPoint + convert_float3(voxelCoords) + 0.5f;
+							const float3 hitPosition = pRay.origin + pRay.direction * rayDistanceToCurrentVoxel;
 
-								currentNodeMortonCode >>= 3;
-								--currentLevel;
-								nodeHalfScale *= 2.0f;
-								rayDistancesBetweenCoords *= 2.0f;
-							}
-							while(currentLevel != 0 && (currentNodeMortonCode & 0x00000007) == nextNodeIndex);
+							pIntersectionData->voxel = getVoxelOctreeVoxel(&pVoxelOctree, currentVoxelBrickIndex, currentVoxelBrick, voxelBrickBitIndex);
+							pIntersectionData->point = hitPosition;
 
-							// Calculate the center of the parent of the current node
+							// Calculate the uv coordinates and normals
+							// TODO: Is there a better and/or faster way to do this?
 							{
-								uint currentChildIndex = currentNodeMortonCode & 0x00000007;
-								currentNodeParentCenter = currentNodeCenter;
-								if(currentChildIndex & 0x00000001)
+								struct AABB voxelAABB;
+								voxelAABB.minPoint = voxelCenter + (float3)(-0.5f, -0.5f, -0.5f);
+								voxelAABB.maxPoint = voxelCenter + (float3)(0.5f, 0.5f, 0.5f);
+								struct RayAndAABBIntersectionData rayAndVoxelAABBIntersectionData;
+								if(rayAndAABBIntersectionTest(pRay, voxelAABB, &rayAndVoxelAABBIntersectionData, MAXFLOAT))
 								{
-									currentNodeParentCenter.x -= nodeHalfScale;
-								}
-								else
-								{
-									currentNodeParentCenter.x += nodeHalfScale;
-								}
-
-								if(currentChildIndex & 0x00000002)
-								{
-									currentNodeParentCenter.y -= nodeHalfScale;
-								}
-								else
-								{
-									currentNodeParentCenter.y += nodeHalfScale;
-								}
+									pIntersectionData->normal = rayAndVoxelAABBIntersectionData.normal;
 
-								if(currentChildIndex & 0x00000004)
-								{
-									currentNodeParentCenter.z -= nodeHalfScale;
+									if(fabs(rayAndVoxelAABBIntersectionData.normal.x) > 0.5f)
+									{
+										pIntersectionData->uvCoords.x = (hitPosition.z - voxelAABB.minPoint.z) / 1.0f;
+										pIntersectionData->uvCoords.y = (hitPosition.y - voxelAABB.minPoint.y) / 1.0f;
+									}
+									else if(fabs(rayAndVoxelAABBIntersectionData.normal.y) > 0.5f)
+									{
+										pIntersectionData->uvCoords.x = (hitPosition.x - voxelAABB.minPoint.x) / 1.0f;
+										pIntersectionData->uvCoords.y = (hitPosition.z - voxelAABB.minPoint.z) / 1.0f;
+									}
+									else if(fabs(rayAndVoxelAABBIntersectionData.normal.z) > 0.5f)
+									{
+										pIntersectionData->uvCoords.x = (hitPosition.x - voxelAABB.minPoint.x) / 1.0f;
+										pIntersectionData->uvCoords.y = (hitPosition.y - voxelAABB.minPoint.y) / 1.0f;
+									}
 								}
 								else
 								{
-									currentNodeParentCenter.z += nodeHalfScale;
+									pIntersectionData->normal = (float3)(0.0f, 0.0f, 0.0f);
+									pIntersectionData->uvCoords = (float2)(0.0f, 0.0f);
 								}
 							}
 
-							hasCurrentNodeBeenExplored = true;
+							return true;
 						}
-					}
-				}
-			}
-		}
-		// If the current node has not been explored
-		else
-		{
-			// If the current level is (pVoxelOctreeDepth - 1), which means it is the leaf nodes level
-			if(currentLevel == (pVoxelOctreeDepth - 1))
-			{
-				// If the current leaf node has a non empty voxel
-				if(pVoxelOctreeNodesArray[currentNodeMortonCode].voxelID)
-				{
-					// A voxel has been hit, so fill the intersection data and return true
-					{
-						pIntersectionData->voxel = pVoxelOctreeNodesArray[currentNodeMortonCode];
-						pIntersectionData->point = currentRayPosition;
 
-						// Calculate the uv coordinates and normals
-						// TODO: Is there a better and/or faster way to do this?
+						// Step to the next voxel that the ray enters, and stop if it is outside the voxel brick
+						if(rayDistancesToNextVoxels.x < rayDistancesToNextVoxels.y && rayDistancesToNextVoxels.x < rayDistancesToNextVoxels.z)
 						{
-							struct AABB voxelAABB;
-							voxelAABB.minPoint = currentNodeCenter + (float3)(-0.5f, -0.5f, -0.5f);
-							voxelAABB.maxPoint = currentNodeCenter + (float3)(0.5f, 0.5f, 0.5f);
-							struct RayAndAABBIntersectionData rayAndVoxelAABBIntersectionData;
-							if(rayAndAABBIntersectionTest(pRay, voxelAABB, &rayAndVoxelAABBIntersectionData, MAXFLOAT))
-							{
-								pIntersectionData->normal = rayAndVoxelAABBIntersectionData.normal;
-
-								if(fabs(rayAndVoxelAABBIntersectionData.normal.x) > 0.5f)
-								{
-									pIntersectionData->uvCoords.x = (currentRayPosition.z - voxelAABB.minPoint.z) / 1.0f;
-									pIntersectionData->uvCoords.y = (currentRayPosition.y - voxelAABB.minPoint.y) / 1.0f;
-								}
-								else if(fabs(rayAndVoxelAABBIntersectionData.normal.y) > 0.5f)
-								{
-									pIntersectionData->uvCoords.x = (currentRayPosition.x - voxelAABB.minPoint.x) / 1.0f;
-									pIntersectionData->uvCoords.y = (currentRayPosition.z - voxelAABB.minPoint.z) / 1.0f;
-								}
-								else if(fabs(rayAndVoxelAABBIntersectionData.normal.z) > 0.5f)
-								{
-									pIntersectionData->uvCoords.x = (currentRayPosition.x - voxelAABB.minPoint.x) / 1.0f;
-									pIntersectionData->uvCoords.y = (currentRayPosition.y - voxelAABB.minPoint.y) / 1.0f;
-								}
-							}
-							else
-							{
-								pIntersectionData->normal = (float3)(0.0f, 0.0f, 0.0f);
-								pIntersectionData->uvCoords = (float2)(0.0f, 0.0f);
-							}
+							rayDistanceToCurrentVoxel = rayDistancesToNextVoxels.x;
+							++voxelCoordsInVoxelBrick.x;
+							rayDistancesToNextVoxels.x += mirroredRayDirectionInverses.x;
 						}
-
-						return true;
-					}
-				}
-				// If the current leaf node has the empty voxel
-				else
-				{
-					// Mark the current node at the current level as explored
-					hasCurrentNodeBeenExplored = true;
-				}
-			}
-			// If the current level is not (pVoxelOctreeDepth - 1), which means it is not the leaf nodes level
-			else
-			{
-				// If the current node has any children
-				if(pVoxelOctreeNodesArray[currentNodeMortonCode].voxelID)
-				{
-					// TODO: This debug draws the octree nodes. Can this be done in a better way?
-					{
-						if(pIsOctreeVisualizationEnabled)
+						else if(rayDistancesToNextVoxels.y < rayDistancesToNextVoxels.z)
 						{
-							int numberOfCoordsInBorderRange = 0;
-							if(fabs(currentNodeCenter.x - currentRayPosition.x) > nodeHalfScale - 0.1f)
-							{
-								++numberOfCoordsInBorderRange;
-							}
-							if(fabs(currentNodeCenter.y - currentRayPosition.y) > nodeHalfScale - 0.1f)
-							{
-								++numberOfCoordsInBorderRange;
-							}
-							if(fabs(currentNodeCenter.z - currentRayPosition.z) > nodeHalfScale - 0.1f)
-							{
-								++numberOfCoordsInBorderRange;
-							}
-							if(numberOfCoordsInBorderRange > 1)
-							{
-								pIntersectionData->voxel = pVoxelOctreeNodesArray[0];
-								pIntersectionData->point = currentRayPosition;
-								return true;
-							}
-						}
-					}
-
-					// Step down to the next lower level node, which is one of the child nodes of the current node
-					{
-						uint childNodeIndex = 0;
-						currentNodeParentCenter = currentNodeCenter;
-
-						if(currentRayPosition.x > currentNodeCenter.x)
-						{
-							childNodeIndex |= 0x00000001;
-							currentNodeCenter.x += nodeHalfScale / 2.0f;
+							rayDistanceToCurrentVoxel = rayDistancesToNextVoxels.y;
+							++voxelCoordsInVoxelBrick.y;
+							rayDistancesToNextVoxels.y += mirroredRayDirectionInverses.y;
 						}
 						else
 						{
-							currentNodeCenter.x -= nodeHalfScale / 2.0f;
+							rayDistanceToCurrentVoxel = rayDistancesToNextVoxels.z;
+							++voxelCoordsInVoxelBrick.z;
+							rayDistancesToNextVoxels.z += mirroredRayDirectionInverses.z;
 						}
 
-						if(currentRayPosition.y > currentNodeCenter.y)
+						if(any(voxelCoordsInVoxelBrick >= FORGE_VOXEL_BRICK_SIDE_LENGTH))
 						{
-							childNodeIndex |= 0x00000002;
-							currentNodeCenter.y += nodeHalfScale / 2.0f;
-						}
-						else
-						{
-							currentNodeCenter.y -= nodeHalfScale / 2.0f;
+							break;
 						}
 
-						if(currentRayPosition.z > currentNodeCenter.z)
+						// With a toroidal offset, the ray can leave the voxel grid inside a voxel brick
+						if(any(currentNodeMinCoords + voxelCoordsInVoxelBrick >= voxelGridExitCoords))
 						{
-							childNodeIndex |= 0x00000004;
-							currentNodeCenter.z += nodeHalfScale / 2.0f;
-						}
-						else
-						{
-							currentNodeCenter.z -= nodeHalfScale / 2.0f;
+							return false;
 						}
+					}
+
+					// The ray has left the voxel brick without hitting any voxel, so mark it as explored
+					hasCurrentNodeBeenExplored = true;
+				}
+				// If the current node is above the voxel brick level
+				else
+				{
+					// Step down to the child node of the current node that the ray enters the current node in
+					{
+						const uint childNodeSideLengthLog2 = currentNodeSideLengthLog2 - 1;
+						const int3 childNodeCoords = (currentVoxelCoords >> childNodeSideLengthLog2) & 1;
+						// The child index bits of the mirrored axes are flipped, to get the child index in the octree
+						const uint childNodeIndex = (childNodeCoords.x | (childNodeCoords.y << 1) | (childNodeCoords.z << 2)) ^ octantMask;
 
 						currentNodeMortonCode = (currentNodeMortonCode << 3) | childNodeIndex;
-						
+						currentNodeMinCoords += childNodeCoords << childNodeSideLengthLog2;
 						++currentLevel;
-						nodeHalfScale /= 2.0f;
-						rayDistancesBetweenCoords /= 2.0f;
 
 						// Mark the current node at the level just stepped down to as not explored
 						hasCurrentNodeBeenExplored = false;
 					}
 				}
-				// If the current node does not have any children
-				else
-				{
-					// Mark the current node at the current level as explored
-					hasCurrentNodeBeenExplored = true;
-				}
+			}
+			// If the current node does not have any children
+			else
+			{
+				// Mark the current node at the current level as explored
+				hasCurrentNodeBeenExplored = true;
 			}
 		}
 	}
@@ -425,4 +411,147 @@ bool rayAndVoxelOctreeIntersectionTest(struct Ray pRay,
 	return false;
 }
 
+// The maximum number of steps that a cone takes through the empty space of a voxel octree in coneAndVoxelOctreeEmptySpaceTest
+#define FORGE_MAX_NUMBER_OF_CONE_STEPS 64
+
+// Get the distance along one axis at which a box that is centered on the axis of a cone, and grows with the radius of the cone,
+// leaves the range (pRangeMin, pRangeMax) along that axis. Both faces of the box move linearly with the distance along the axis of the cone
+float getConeBoxExitDistance(float pConeApex,
+							 float pConeDirection,
+							 float pConeRadiusPerDistance,
+							 float pRangeMin,
+							 float pRangeMax)
+{
+	float exitDistance = INFINITY;
+	if(pConeDirection + pConeRadiusPerDistance > 0.0f)
+	{
+		exitDistance = (pRangeMax - pConeApex) / (pConeDirection + pConeRadiusPerDistance);
+	}
+	if(pConeDirection - pConeRadiusPerDistance < 0.0f)
+	{
+		exitDistance = fmin(exitDistance, (pRangeMin - pConeApex) / (pConeDirection - pConeRadiusPerDistance));
+	}
+
+	return exitDistance;
+}
+
+// Find how far along its axis a cone can travel through a voxel octree before it touches a node that has any non empty voxels in it.
+// Every ray that starts at the apex of the cone and stays inside the cone does not hit any voxel before that distance, so it can start from there.
+// pConeRadiusPerDistance is the radius of the cone at a distance of 1 from its apex. Returns MAXFLOAT if the cone never touches a non empty node
+float coneAndVoxelOctreeEmptySpaceTest(struct Ray pConeAxis,
+									   float pConeRadiusPerDistance,
+									   struct VoxelOctree pVoxelOctree)
+{
+	// The voxels are the nodes at the last level of the octree
+	const uint voxelLevel = pVoxelOctree.depth - 1;
+	const int voxelGridSideLength = 1 << voxelLevel;
+	const uint voxelBrickLevel = getVoxelBrickLevel(&pVoxelOctree);
+
+	// The cone is traced in voxel coords relative to the minimum corner of the voxel grid. The voxel grid is centered on the origin, and each voxel is centered on its integer coords
+	const float3 coneApex = pConeAxis.origin + (float)(voxelGridSideLength / 2) + 0.5f;
+
+	// A box with a half size of the radius of the cone, centered on its axis, contains every ray in the cone at the same distance along it.
+	// The box is moved along the cone one step at a time. At each step, all the nodes that the box touches are checked, at a level at which the nodes
+	// are at least as large as the box. If they are all empty, the box can move on until it leaves them
+	float coneDistance = 0.0f;
+	for(int i = 0; i < FORGE_MAX_NUMBER_OF_CONE_STEPS; ++i)
+	{
+		const float coneRadius = coneDistance * pConeRadiusPerDistance;
+		const float3 boxMinPoint = coneApex + pConeAxis.direction * coneDistance - coneRadius;
+		const float3 boxMaxPoint = coneApex + pConeAxis.direction * coneDistance + coneRadius;
+
+		// The box is in empty space as long as it stays in the range along any axis in which it is outside the voxel grid
+		if(any(boxMaxPoint < 0.0f) || any(boxMinPoint > (float)voxelGridSideLength))
+		{
+			float exitDistance = coneDistance;
+			if(boxMaxPoint.x < 0.0f)
+			{
+				exitDistance = fmax(exitDistance, getConeBoxExitDistance(coneApex.x, pConeAxis.direction.x, pConeRadiusPerDistance, -INFINITY, 0.0f));
+			}
+			if(boxMaxPoint.y < 0.0f)
+			{
+				exitDistance = fmax(exitDistance, getConeBoxExitDistance(coneApex.y, pConeAxis.direction.y, pConeRadiusPerDistance, -INFINITY, 0.0f));
+			}
+			if(boxMaxPoint.z < 0.0f)
+			{
+				exitDistance = fmax(exitDistance, getConeBoxExitDistance(coneApex.z, pConeAxis.direction.z, pConeRadiusPerDistance, -INFINITY, 0.0f));
+			}
+			if(boxMinPoint.x > (float)voxelGridSideLength)
+			{
+				exitDistance = fmax(exitDistance, getConeBoxExitDistance(coneApex.x, pConeAxis.direction.x, pConeRadiusPerDistance, (float)voxelGridSideLength, INFINITY));
+			}
+			if(boxMinPoint.y > (float)voxelGridSideLength)
+			{
+				exitDistance = fmax(exitDistance, getConeBoxExitDistance(coneApex.y, pConeAxis.direction.y, pConeRadiusPerDistance, (float)voxelGridSideLength, INFINITY));
+			}
+			if(boxMinPoint.z > (float)voxelGridSideLength)
+			{
+				exitDistance = fmax(exitDistance, getConeBoxExitDistance(coneApex.z, pConeAxis.direction.z, pConeRadiusPerDistance, (float)voxelGridSideLength, INFINITY));
+			}
+
+			// If the cone never enters the voxel grid
+			if(exitDistance >= MAXFLOAT)
+			{
+				return MAXFLOAT;
+			}
+
+			// Make sure that the box always moves, even if the exit distance is rounded down to the current distance
+			coneDistance = fmax(exitDistance, coneDistance + 0.001f);
+			continue;
+		}
+
+		// Find the level at which the nodes are at least as large as the box, so it touches at most 2 nodes along each axis.
+		// Only the nodes down to the voxel brick level can be checked
+		const uint nodeSideLengthLog2 = clamp((uint)ceil(log2(fmax(2.0f * coneRadius, 1.0f))), voxelLevel - voxelBrickLevel, voxelLevel);
+		const uint nodeLevel = voxelLevel - nodeSideLengthLog2;
+
+		// The coords of the nodes that the box touches, clamped to the voxel grid
+		const int3 minNodeCoords = convert_int3(clamp(floor(boxMinPoint), 0.0f, (float)(voxelGridSideLength - 1))) >> nodeSideLengthLog2;
+		const int3 maxNodeCoords = convert_int3(clamp(floor(boxMaxPoint), 0.0f, (float)(voxelGridSideLength - 1))) >> nodeSideLengthLog2;
+
+		// The nodes in memory that hold the voxels of those nodes. With a toroidal offset, the voxels of a node are spread over up to 2 nodes in memory along each axis,
+		// and the coords of the nodes in memory wrap around at the end of it. Without one, they are the same nodes
+		const int3 minNodeCoordsInMemory = ((minNodeCoords << nodeSideLengthLog2) + pVoxelOctree.toroidalOffset) >> nodeSideLengthLog2;
+		const int3 maxNodeCoordsInMemory = (((maxNodeCoords + 1) << nodeSideLengthLog2) - 1 + pVoxelOctree.toroidalOffset) >> nodeSideLengthLog2;
+		const uint nodeCoordsInMemoryMask = (voxelGridSideLength >> nodeSideLengthLog2) - 1;
+
+		// If any of the nodes has a non empty voxel in it, the rays in the cone may hit it
+		for(int z = minNodeCoordsInMemory.z; z <= maxNodeCoordsInMemory.z; ++z)
+		{
+			for(int y = minNodeCoordsInMemory.y; y <= maxNodeCoordsInMemory.y; ++y)
+			{
+				for(int x = minNodeCoordsInMemory.x; x <= maxNodeCoordsInMemory.x; ++x)
+				{
+					if(doesVoxelOctreeNodeExist(&pVoxelOctree, (uint3)(x, y, z) & nodeCoordsInMemoryMask, nodeLevel))
+					{
+						return coneDistance;
+					}
+				}
+			}
+		}
+
+		// All the nodes are empty, so move the box on until it leaves them. The space outside the voxel grid is empty as well
+		float3 emptyRangeMinPoint = convert_float3(minNodeCoords << nodeSideLengthLog2);
+		float3 emptyRangeMaxPoint = convert_float3((maxNodeCoords + 1) << nodeSideLengthLog2);
+		emptyRangeMinPoint = select(emptyRangeMinPoint, (float3)(-INFINITY, -INFINITY, -INFINITY), minNodeCoords == 0);
+		emptyRangeMaxPoint = select(emptyRangeMaxPoint, (float3)(INFINITY, INFINITY, INFINITY), ((maxNodeCoords + 1) << nodeSideLengthLog2) == voxelGridSideLength);
+
+		float exitDistance = getConeBoxExitDistance(coneApex.x, pConeAxis.direction.x, pConeRadiusPerDistance, emptyRangeMinPoint.x, emptyRangeMaxPoint.x);
+		exitDistance = fmin(exitDistance, getConeBoxExitDistance(coneApex.y, pConeAxis.direction.y, pConeRadiusPerDistance, emptyRangeMinPoint.y, emptyRangeMaxPoint.y));
+		exitDistance = fmin(exitDistance, getConeBoxExitDistance(coneApex.z, pConeAxis.direction.z, pConeRadiusPerDistance, emptyRangeMinPoint.z, emptyRangeMaxPoint.z));
+
+		// If the whole voxel grid is empty
+		if(exitDistance >= MAXFLOAT)
+		{
+			return MAXFLOAT;
+		}
+
+		// Make sure that the box always moves, even if the exit distance is rounded down to the current distance
+		coneDistance = fmax(exitDistance, coneDistance + 0.001f);
+	}
+
+	// The cone has not found a non empty node within the maximum number of steps, but it is still safe to start from the distance it has reached
+	return coneDistance;
+}
+
 #endif
\ No newline at end of file
@@ -1,9 +1,172 @@
 #ifndef FORGE_CL_VOXEL_H
 #define FORGE_CL_VOXEL_H
 
+#include "ForgeData/OpenCL/Include/VoxelUtility.cl"
+
+// NOTE: This must match the VoxelData class in Source/Program/VoxelData.h
 struct Voxel
 {
-	uchar voxelID;
+	// The material of the voxel. The empty voxel has the ID 0
+	ushort voxelID;
+};
+
+// The maximum depth of a voxel octree that can be traversed
+#define FORGE_MAX_VOXEL_OCTREE_DEPTH 16
+
+// The number of voxels along each side of a voxel brick. The nodes at the level (depth - 3) of a voxel octree are stored as voxel bricks,
+// which replace the last two levels of the octree. A voxel brick is a 64 bit bitfield that indicates which of its voxels are non empty.
+// The bits are in Morton order, so byte i of a voxel brick holds the 2x2x2 voxels of its child with index i
+#define FORGE_VOXEL_BRICK_SIDE_LENGTH 4
+
+#ifdef FORGE_SPARSE_VOXEL_OCTREE
+
+// NOTE: This must match the SparseVoxelOctree::Node struct in Source/Program/SparseVoxelOctree.h
+struct SparseVoxelOctreeNode
+{
+	// Bit i is set if the child with index i exists
+	uint childMask;
+	// The index of the first existing child. For the nodes just above the voxel brick level, this is an index into the voxel bricks array
+	uint firstChildIndex;
+};
+
+// The buffers of a sparse voxel octree. Only the nodes that exist are stored, and the root node is the first node.
+// Only the voxels of the non empty voxels are stored, brick by brick, starting from the index that each voxel brick has in voxelBrickFirstMaterialIndices
+struct VoxelOctree
+{
+	__global const struct SparseVoxelOctreeNode *nodes;
+	__global const ulong *voxelBricks;
+	__global const uint *voxelBrickFirstMaterialIndices;
+	__global const struct Voxel *voxelMaterials;
+	uint depth;
+	// The sparse voxel octree is built from a voxel grid without a toroidal offset, so this is always 0
+	int3 toroidalOffset;
+};
+
+#else
+
+// The buffers of a voxel octree. The child masks of the nodes are indexed by the Morton codes of the nodes, and the voxel bricks and their first material indices
+// by the Morton codes of their nodes without the leading 1 bit. Only the voxel data of the non empty voxels is stored, like in the sparse voxel octree
+struct VoxelOctree
+{
+	__global const uchar *nodes;
+	__global const ulong *voxelBricks;
+	__global const uint *voxelBrickFirstMaterialIndices;
+	__global const struct Voxel *voxelMaterials;
+	uint depth;
+	// The voxel with the remapped coords c is stored at ((c + toroidalOffset) mod voxelGridSideLength) along each axis, as if the voxel grid wrapped around at its ends.
+	// The nodes are built over the voxels where they are stored, so a node may hold voxels from both ends of the voxel grid. Each component is in the range (0, voxelGridSideLength - 1)
+	int3 toroidalOffset;
 };
 
-#endif
\ No newline at end of file
+#endif
+
+// Get the level of a voxel octree whose nodes are stored as voxel bricks
+uint getVoxelBrickLevel(const struct VoxelOctree *pVoxelOctree)
+{
+	return pVoxelOctree->depth - 3;
+}
+
+// Get the child mask of an octree node above the voxel brick level, which is 0 if the node does not exist.
+// The nodes on the path from the root to the given node must already have been fetched with this function, in order from the root,
+// because the sparse voxel octree keeps the index of each of them in pNodeIndexStack
+uchar getVoxelOctreeNodeChildMask(const struct VoxelOctree *pVoxelOctree,
+								  uint pNodeMortonCode,
+								  uint pNodeLevel,
+								  uint *pNodeIndexStack)
+{
+#ifdef FORGE_SPARSE_VOXEL_OCTREE
+	// The root node is always the first node
+	if(pNodeLevel == 0)
+	{
+		pNodeIndexStack[0] = 0;
+		return (uchar)(pVoxelOctree->nodes[0].childMask);
+	}
+
+	const struct SparseVoxelOctreeNode parentNode = pVoxelOctree->nodes[pNodeIndexStack[pNodeLevel - 1]];
+	const uint childIndex = pNodeMortonCode & 0x00000007;
+	if(!(parentNode.childMask & (1 << childIndex)))
+	{
+		return 0;
+	}
+
+	// The existing children are stored next to each other, so skip the ones that come before this node
+	const uint nodeIndex = parentNode.firstChildIndex + popcount(parentNode.childMask & ((1 << childIndex) - 1));
+	pNodeIndexStack[pNodeLevel] = nodeIndex;
+	return (uchar)(pVoxelOctree->nodes[nodeIndex].childMask);
+#else
+	return pVoxelOctree->nodes[pNodeMortonCode];
+#endif
+}
+
+// Get the voxel brick of an octree node at the voxel brick level, which is 0 if the node does not exist.
+// The index of the voxel brick, which is needed to get the voxels in it, is written to pVoxelBrickIndex.
+// The nodes on the path from the root to its parent must already have been fetched with getVoxelOctreeNodeChildMask
+ulong getVoxelOctreeBrick(const struct VoxelOctree *pVoxelOctree,
+						  uint pNodeMortonCode,
+						  uint *pNodeIndexStack,
+						  uint *pVoxelBrickIndex)
+{
+	const uint voxelBrickLevel = getVoxelBrickLevel(pVoxelOctree);
+#ifdef FORGE_SPARSE_VOXEL_OCTREE
+	const struct SparseVoxelOctreeNode parentNode = pVoxelOctree->nodes[pNodeIndexStack[voxelBrickLevel - 1]];
+	const uint childIndex = pNodeMortonCode & 0x00000007;
+	if(!(parentNode.childMask & (1 << childIndex)))
+	{
+		return 0;
+	}
+
+	*pVoxelBrickIndex = parentNode.firstChildIndex + popcount(parentNode.childMask & ((1 << childIndex) - 1));
+#else
+	*pVoxelBrickIndex = pNodeMortonCode ^ (1 << (voxelBrickLevel * 3));
+#endif
+	return pVoxelOctree->voxelBricks[*pVoxelBrickIndex];
+}
+
+// Check if the octree node at the given level with the given coords exists, which means that it has at least one non empty voxel in it.
+// The coords of a node are the coords of its minimum voxel in memory, which include the toroidal offset, divided by its side length. Only the levels down to the voxel brick level can be checked
+bool doesVoxelOctreeNodeExist(const struct VoxelOctree *pVoxelOctree,
+							  uint3 pNodeCoords,
+							  uint pNodeLevel)
+{
+#ifdef FORGE_SPARSE_VOXEL_OCTREE
+	// Walk down from the root node, which is always the first node, through the ancestors of the node
+	uint nodeIndex = 0;
+	for(uint level = 1; level <= pNodeLevel; ++level)
+	{
+		const struct SparseVoxelOctreeNode parentNode = pVoxelOctree->nodes[nodeIndex];
+		const uint3 childNodeCoords = (pNodeCoords >> (pNodeLevel - level)) & 0x00000001;
+		const uint childIndex = childNodeCoords.x | (childNodeCoords.y << 1) | (childNodeCoords.z << 2);
+		if(!(parentNode.childMask & (1 << childIndex)))
+		{
+			return false;
+		}
+
+		nodeIndex = parentNode.firstChildIndex + popcount(parentNode.childMask & ((1 << childIndex) - 1));
+	}
+
+	// The root node always exists, but it may not have any children
+	return (pNodeLevel > 0) || (pVoxelOctree->nodes[0].childMask != 0);
+#else
+	// The root node has the Morton code 1
+	if(pNodeLevel == 0)
+	{
+		return pVoxelOctree->nodes[1] != 0;
+	}
+
+	// The node exists if its bit is set in the child mask of its parent
+	const uint nodeMortonCode = interleaveVoxelCoords(pNodeCoords) | (1 << (pNodeLevel * 3));
+	return (pVoxelOctree->nodes[nodeMortonCode >> 3] & (1 << (nodeMortonCode & 0x00000007))) != 0;
+#endif
+}
+
+// Get the voxel that has the given bit in a voxel brick. The bit must be set
+struct Voxel getVoxelOctreeVoxel(const struct VoxelOctree *pVoxelOctree,
+								 uint pVoxelBrickIndex,
+								 ulong pVoxelBrick,
+								 uint pVoxelBrickBitIndex)
+{
+	// Only the non empty voxels are stored, so skip the ones that come before this voxel
+	return pVoxelOctree->voxelMaterials[pVoxelOctree->voxelBrickFirstMaterialIndices[pVoxelBrickIndex] + popcount(pVoxelBrick & (((ulong)1 << pVoxelBrickBitIndex) - 1))];
+}
+
+#endif
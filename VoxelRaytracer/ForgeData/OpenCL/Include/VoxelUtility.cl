@@ -20,13 +20,24 @@ uint part1By2For32BitInteger(uint pValue)
 	return pValue;
 }
 
-uint getMortonCodeForVoxelCoords(uint3 pRemappedVoxelCoords,
-								 uint pVoxelOctreeDepth)
+// Interleave the bits of the given coordinates. This is the Morton code of the coordinates without the leading 1 bit that marks the octree level
+uint interleaveVoxelCoords(uint3 pRemappedVoxelCoords)
 {
 	return (part1By2For32BitInteger(pRemappedVoxelCoords.z) << 2) |
 		   (part1By2For32BitInteger(pRemappedVoxelCoords.y) << 1) |
-		   part1By2For32BitInteger(pRemappedVoxelCoords.x) |
-		   (1 << ((pVoxelOctreeDepth - 1) * 3));
+		   part1By2For32BitInteger(pRemappedVoxelCoords.x);
+}
+
+uint getMortonCodeForVoxelCoords(uint3 pRemappedVoxelCoords,
+								 uint pVoxelOctreeDepth)
+{
+	return interleaveVoxelCoords(pRemappedVoxelCoords) | (1 << ((pVoxelOctreeDepth - 1) * 3));
+}
+
+// Get the index of the bit of a voxel in its voxel brick from the coordinates of the voxel relative to the voxel brick, which are in the range (0, 3)
+uint getVoxelBrickBitIndex(uint3 pVoxelCoordsInVoxelBrick)
+{
+	return interleaveVoxelCoords(pVoxelCoordsInVoxelBrick);
 }
 
 #endif
\ No newline at end of file
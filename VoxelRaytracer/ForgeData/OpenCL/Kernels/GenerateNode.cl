@@ -2,7 +2,21 @@
 #include "ForgeData/OpenCL/Include/Voxel.cl"
 #include "ForgeData/OpenCL/Include/VoxelUtility.cl"
 
-__kernel void generateNodeKernel(__global struct Voxel *pVoxelArray,
+// Get the child mask of a node from the child masks of its children. The 8 children of a node are next to each other in Morton order,
+// so they are loaded with a single vector load, and compared with a single vector compare
+uchar getNodeChildMask(__global const uchar *pChildMaskArray,
+					   uint pNodeMortonCode)
+{
+	const uchar8 childNodeChildMasks = vload8(pNodeMortonCode, pChildMaskArray);
+
+	// Each component of the comparison is either all ones or all zeros, so only the bit of each child is kept, and the bits are ORed together
+	const uchar8 childBits = as_uchar8(childNodeChildMasks != (uchar8)(0)) & (uchar8)(1, 2, 4, 8, 16, 32, 64, 128);
+	const uchar4 childBitsOr4 = childBits.lo | childBits.hi;
+	const uchar2 childBitsOr2 = childBitsOr4.lo | childBitsOr4.hi;
+	return childBitsOr2.x | childBitsOr2.y;
+}
+
+__kernel void generateNodeKernel(__global uchar *pChildMaskArray,
 								 uint pVoxelOctreeDepth)
 {
 	// Get the coordinates of the node for which this kernel instance is being executed for remmaped to the range (0, gridSize - 1)
@@ -11,24 +25,67 @@ __kernel void generateNodeKernel(__global struct Voxel *pVoxelArray,
 	remappedVoxelCoords.y = get_global_id(1);
 	remappedVoxelCoords.z = get_global_id(2);
 
-	uint nodeMortonCode = getMortonCodeForVoxelCoords(remappedVoxelCoords, pVoxelOctreeDepth);
-	// For each of the children of the current node
-	for(uint i = 0; i < 8; ++i)
+	const uint nodeMortonCode = getMortonCodeForVoxelCoords(remappedVoxelCoords, pVoxelOctreeDepth);
+	pChildMaskArray[nodeMortonCode] = getNodeChildMask(pChildMaskArray, nodeMortonCode);
+}
+
+// Generates all the nodes of a level. The nodes of a level are next to each other in Morton order, so the work items are launched in one dimension,
+// and each one generates every (globalSize)th node, so that neighbouring work items read and write neighbouring memory. The number of work items
+// can be smaller than the number of nodes
+__kernel void generateNodeLevelKernel(__global uchar *pChildMaskArray,
+									  uint pVoxelOctreeDepth)
+{
+	const uint firstNodeMortonCode = 1 << ((pVoxelOctreeDepth - 1) * 3);
+	const uint numberOfNodes = firstNodeMortonCode;
+	for(uint nodeIndex = get_global_id(0); nodeIndex < numberOfNodes; nodeIndex += get_global_size(0))
 	{
-		// Calculate the morton code of the child node
-		uint childNodeMortonCode = (nodeMortonCode << 3) | i;
+		const uint nodeMortonCode = firstNodeMortonCode | nodeIndex;
+		pChildMaskArray[nodeMortonCode] = getNodeChildMask(pChildMaskArray, nodeMortonCode);
+	}
+}
 
-		// If the child node exists or has any children
-		if(pVoxelArray[childNodeMortonCode].voxelID)
-		// Set the hasChild bit of the child to 1
+// Generates the nodes of a level and of all the levels above it, up to the root node, with a single work group. The top levels have too few nodes
+// to be worth a kernel each, so the work group loops over the levels from the bottom up, and waits for each level to be written before the next one
+__kernel void generateTopNodeLevelsKernel(__global uchar *pChildMaskArray,
+										  uint pVoxelOctreeDepth)
+{
+	for(uint octreeLevel = pVoxelOctreeDepth; octreeLevel != 0; --octreeLevel)
+	{
+		const uint firstNodeMortonCode = 1 << ((octreeLevel - 1) * 3);
+		const uint numberOfNodes = firstNodeMortonCode;
+		for(uint nodeIndex = get_local_id(0); nodeIndex < numberOfNodes; nodeIndex += get_local_size(0))
 		{
-			pVoxelArray[nodeMortonCode].voxelID |= (1 << i);
+			const uint nodeMortonCode = firstNodeMortonCode | nodeIndex;
+			pChildMaskArray[nodeMortonCode] = getNodeChildMask(pChildMaskArray, nodeMortonCode);
 		}
-		// If the child node does not exist or have any children
-		else
-		// Set the hasChild bit of the child to 0
+		barrier(CLK_GLOBAL_MEM_FENCE);
+	}
+}
+
+// Generates the nodes just above the voxel brick level from the voxel bricks. The voxel brick array is the last parameter,
+// so that the other parameters are the same as the ones of generateNodeKernel
+__kernel void generateVoxelBrickParentNodeKernel(__global uchar *pChildMaskArray,
+												 uint pVoxelOctreeDepth,
+												 __global const ulong *pVoxelBrickArray)
+{
+	// Get the coordinates of the node for which this kernel instance is being executed for remmaped to the range (0, gridSize - 1)
+	uint3 remappedVoxelCoords;
+	remappedVoxelCoords.x = get_global_id(0);
+	remappedVoxelCoords.y = get_global_id(1);
+	remappedVoxelCoords.z = get_global_id(2);
+
+	// The voxel bricks are indexed by the Morton codes of their nodes without the leading 1 bit
+	uint firstChildVoxelBrickIndex = interleaveVoxelCoords(remappedVoxelCoords) << 3;
+	uchar childMask = 0;
+	// For each of the children of the current node
+	for(uint i = 0; i < 8; ++i)
+	{
+		// If the voxel brick of the child has any non empty voxels, set the hasChild bit of the child to 1
+		if(pVoxelBrickArray[firstChildVoxelBrickIndex | i])
 		{
-			pVoxelArray[nodeMortonCode].voxelID &= ~(1 << i);
+			childMask |= (1 << i);
 		}
 	}
-}
\ No newline at end of file
+
+	pChildMaskArray[getMortonCodeForVoxelCoords(remappedVoxelCoords, pVoxelOctreeDepth)] = childMask;
+}
@@ -2,14 +2,36 @@
 #include "ForgeData/OpenCL/Include/Voxel.cl"
 #include "ForgeData/OpenCL/Include/VoxelUtility.cl"
 
-struct Voxel generateVoxel(const uint pSeed, int3 pVoxelCoords, float pOffset)
+// The number of voxels along each side of a cell of the lattice of the noise the terrain is generated from
+#define FORGE_TERRAIN_NOISE_LATTICE_CELL_SIDE_LENGTH 80.0f
+
+// The corners of the terrain noise lattice that a run of voxels of a block of generateVoxelBlockKernel uses along each axis. A block is smaller than a lattice cell
+// along each axis, so the voxels of a run are in at most 2 cells, which have 3 corners
+#define FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_PER_RUN 3
+
+// The remapped coords of a block may wrap around the end of the voxel grid once along each axis, which splits its voxels into 2 runs that are not next to each other in the lattice
+#define FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS (2 * FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_PER_RUN)
+
+// Voxels where the terrain noise is at most this value are solid
+#define FORGE_TERRAIN_NOISE_SOLID_THRESHOLD 0.2f
+
+// How far the bounds of the terrain noise over a region must be from the solid threshold for the region to be treated as uniform.
+// This covers the rounding errors of the interpolation, which can take it slightly outside of the values it interpolates between
+#define FORGE_TERRAIN_NOISE_BOUNDS_MARGIN 0.0001f
+
+// Get the coords in the terrain noise lattice of a voxel. The integer parts of the coords are the coords of the bottom left corner of the lattice cell of the voxel
+float3 getTerrainNoiseCoords(int3 pVoxelCoords, float pOffset)
 {
 	float3 floatCoords;
 	floatCoords.x = (float)(pVoxelCoords.x) + pOffset;
 	floatCoords.y = (float)(pVoxelCoords.y) + pOffset;
 	floatCoords.z = (float)(pVoxelCoords.z) + pOffset;
-	float heightValue = valueNoise3D(pSeed, floatCoords / 80.0f);
-	if(heightValue <= (float)(0.2f))
+	return floatCoords / FORGE_TERRAIN_NOISE_LATTICE_CELL_SIDE_LENGTH;
+}
+
+struct Voxel generateVoxelFromTerrainNoise(float pHeightValue)
+{
+	if(pHeightValue <= FORGE_TERRAIN_NOISE_SOLID_THRESHOLD)
 	{
 		struct Voxel voxel;
 		voxel.voxelID = 1;
@@ -23,27 +45,391 @@ struct Voxel generateVoxel(const uint pSeed, int3 pVoxelCoords, float pOffset)
 	}
 }
 
-// This kernel gets executed for every voxel in the voxel grid. The global ID in the first, second and third dimensions correspond
-// to the integer coordinates of the voxel the current work item is being executed for
-__kernel void generateVoxelKernel(__global struct Voxel *pVoxelArray,
-								  uint pVoxelOctreeDepth, // An array in which each element represents the output data for a pixel
-								  float pOffset) 
+struct Voxel generateVoxel(const uint pSeed, int3 pVoxelCoords, float pOffset)
+{
+	return generateVoxelFromTerrainNoise(valueNoise3D(pSeed, getTerrainNoiseCoords(pVoxelCoords, pOffset)));
+}
+
+// Like generateVoxel, but the hashes of the corners of the terrain noise lattice are read from local memory instead of being calculated. The lattice values hold
+// the hashes of the corners of a block, and the corner with the coords (x, y, z) in the block is at index (x + 6 * y + 36 * z). The corner coords in the block are those of
+// the bottom left corner of the lattice cell of the voxel, and the fractional parts are the position of the voxel in that cell
+struct Voxel generateVoxelFromLattice(__local const float *pLatticeValues, int3 pCornerCoordsInBlock, float3 pFractionalParts)
+{
+	// The corners of the lattice cell of the voxel, in the order interpolateValueNoise3DCorners takes them
+	const uint strideY = FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS;
+	const uint strideZ = FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS * FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS;
+	const uint cornerIndex = pCornerCoordsInBlock.x + strideY * pCornerCoordsInBlock.y + strideZ * pCornerCoordsInBlock.z;
+	const float8 cornerValues = (float8)(pLatticeValues[cornerIndex],
+										 pLatticeValues[cornerIndex + 1],
+										 pLatticeValues[cornerIndex + strideY],
+										 pLatticeValues[cornerIndex + strideY + 1],
+										 pLatticeValues[cornerIndex + strideZ],
+										 pLatticeValues[cornerIndex + strideZ + 1],
+										 pLatticeValues[cornerIndex + strideZ + strideY],
+										 pLatticeValues[cornerIndex + strideZ + strideY + 1]);
+
+	return generateVoxelFromTerrainNoise(interpolateValueNoise3DCorners(cornerValues, pFractionalParts));
+}
+
+// Get the remapped coords of the voxel stored at the given coords in memory. The side length is a power of 2, so the remapped coords wrap around with a mask
+int3 getRemappedVoxelCoords(int3 pVoxelCoordsInMemory, int3 pVoxelGridToroidalOffset, int pVoxelGridSideLength)
+{
+	return (pVoxelCoordsInMemory - pVoxelGridToroidalOffset) & (pVoxelGridSideLength - 1);
+}
+
+// Get the coords in the terrain noise lattice of the bottom left corner of the lattice cell of the voxel with the given remapped coords. The actual coords are centered on the origin
+int3 getTerrainNoiseLatticeCoords(int3 pRemappedVoxelCoords, int pVoxelGridSideLength, float pOffset)
+{
+	float3 integerParts;
+	fract(getTerrainNoiseCoords(pRemappedVoxelCoords - pVoxelGridSideLength / 2, pOffset), &integerParts);
+	return convert_int3(integerParts);
+}
+
+// The corners of the terrain noise lattice that the voxels of a block use. Along each axis, the voxels from the first one of the block up to where the remapped coords
+// wrap around are the first run, and use the first 3 corners of the block. The voxels after it are the second run, and use the last 3 corners of the block
+struct BlockLattice
+{
+	int3 firstRemappedVoxelCoords;
+	int3 firstRunMinCornerCoords;
+	int3 secondRunMinCornerCoords;
+};
+
+// Get the coords in a block of a corner of the terrain noise lattice, from the remapped coords of a voxel of the block that uses the corner
+int3 getCornerCoordsInBlock(const struct BlockLattice *pLattice, int3 pRemappedVoxelCoords, int3 pCornerCoords)
+{
+	const int3 isInSecondRun = pRemappedVoxelCoords < pLattice->firstRemappedVoxelCoords;
+	return select(pCornerCoords - pLattice->firstRunMinCornerCoords, pCornerCoords - pLattice->secondRunMinCornerCoords + FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_PER_RUN, isInSecondRun);
+}
+
+// Generate the voxel that is stored at the given coords in memory, from the hashes of the corners of the terrain noise lattice of its block
+struct Voxel generateBlockVoxel(const struct BlockLattice *pLattice, __local const float *pLatticeValues, int3 pVoxelCoordsInMemory, int3 pVoxelGridToroidalOffset,
+								int pVoxelGridSideLength, float pOffset)
+{
+	const int3 remappedVoxelCoords = getRemappedVoxelCoords(pVoxelCoordsInMemory, pVoxelGridToroidalOffset, pVoxelGridSideLength);
+	float3 integerParts;
+	const float3 fractionalParts = fract(getTerrainNoiseCoords(remappedVoxelCoords - pVoxelGridSideLength / 2, pOffset), &integerParts);
+	const int3 cornerCoordsInBlock = getCornerCoordsInBlock(pLattice, remappedVoxelCoords, convert_int3(integerParts));
+	return generateVoxelFromLattice(pLatticeValues, cornerCoordsInBlock, fractionalParts);
+}
+
+// Get whether the voxel data of a voxel brick with the given number of non empty voxels does not fit in the voxel material array at the given index.
+// The voxel brick is then given the first voxel data of the array, so that the voxels it reads are in bounds, and its voxel data is not written.
+// The host sees that more voxel data was allocated than fits, and generates the whole world again into a larger voxel material array before generating anything else
+bool doesVoxelMaterialArrayOverflow(uint *pFirstMaterialIndex, uint pNumberOfNonEmptyVoxels, uint pVoxelMaterialArrayCapacity)
+{
+	if(*pFirstMaterialIndex + pNumberOfNonEmptyVoxels > pVoxelMaterialArrayCapacity)
+	{
+		*pFirstMaterialIndex = 0;
+		return true;
+	}
+	return false;
+}
+
+// This kernel gets executed for the voxel bricks that are generated. The global ID in the first, second and third dimensions correspond to the integer coordinates
+// of the voxel brick in memory the current work item is being executed for, so the global work offset is the coordinates of the first one.
+// With a toroidal offset, the voxel with the remapped coords c is stored at ((c + pVoxelGridToroidalOffset) mod voxelGridSideLength), so a voxel brick in memory
+// may hold voxels from both ends of the voxel grid. The toroidal offset is in the range (0, voxelGridSideLength - 1).
+// Only the voxel data of the non empty voxels is stored, in the order of their bits, from the first material index of their voxel brick. A voxel brick that was
+// generated before keeps its voxel data where it was if its non empty voxels still fit there, which is true for most of the voxel bricks of a slab, since the voxels
+// that stay in the voxel grid do not change. The other voxel bricks take new room from the end of the voxel data that is allocated. So before the whole world is generated,
+// the voxel bricks must be cleared and the number of allocated voxel data set to 0
+__kernel void generateVoxelKernel(__global ulong *pVoxelBrickArray,
+								  float pOffset,
+								  __global struct Voxel *pVoxelMaterialArray,
+								  int3 pVoxelGridToroidalOffset,
+								  uint pVoxelBrickLevel,
+								  __global uint *pVoxelBrickFirstMaterialIndexArray,
+								  __global uint *pNumberOfAllocatedVoxelMaterials,
+								  uint pVoxelMaterialArrayCapacity)
+{
+	// Get the coordinates of the voxel brick for which this kernel instance is being executed for in memory, in the range (0, numberOfVoxelBricksAlongEachAxis - 1)
+	uint3 voxelBrickCoords;
+	voxelBrickCoords.x = get_global_id(0);
+	voxelBrickCoords.y = get_global_id(1);
+	voxelBrickCoords.z = get_global_id(2);
+
+	// There are (2 ^ voxelBrickLevel) voxel bricks along each axis
+	const int voxelGridSideLength = FORGE_VOXEL_BRICK_SIDE_LENGTH << pVoxelBrickLevel;
+	const int3 voxelBrickMinCoordsInMemory = convert_int3(voxelBrickCoords) * FORGE_VOXEL_BRICK_SIDE_LENGTH;
+
+	const uint voxelBrickIndex = interleaveVoxelCoords(voxelBrickCoords);
+
+	// Generate the voxels of the voxel brick, and set the bits of the non empty ones
+	ulong voxelBrick = 0;
+	for(uint z = 0; z < FORGE_VOXEL_BRICK_SIDE_LENGTH; ++z)
+	{
+		for(uint y = 0; y < FORGE_VOXEL_BRICK_SIDE_LENGTH; ++y)
+		{
+			for(uint x = 0; x < FORGE_VOXEL_BRICK_SIDE_LENGTH; ++x)
+			{
+				const uint3 voxelCoordsInVoxelBrick = (uint3)(x, y, z);
+				const uint voxelBrickBitIndex = getVoxelBrickBitIndex(voxelCoordsInVoxelBrick);
+
+				// The actual coords are centered on the origin
+				const int3 remappedVoxelCoords = getRemappedVoxelCoords(voxelBrickMinCoordsInMemory + convert_int3(voxelCoordsInVoxelBrick), pVoxelGridToroidalOffset, voxelGridSideLength);
+				const struct Voxel voxel = generateVoxel(1, remappedVoxelCoords - voxelGridSideLength / 2, pOffset);
+				if(voxel.voxelID)
+				{
+					voxelBrick |= (ulong)1 << voxelBrickBitIndex;
+				}
+			}
+		}
+	}
+
+	// The voxel data stays where it was if it fits, or else it is allocated after the voxel data of the other voxel bricks
+	const uint numberOfNonEmptyVoxels = popcount(voxelBrick);
+	uint firstMaterialIndex = pVoxelBrickFirstMaterialIndexArray[voxelBrickIndex];
+	if(numberOfNonEmptyVoxels > popcount(pVoxelBrickArray[voxelBrickIndex]))
+	{
+		firstMaterialIndex = atomic_add(pNumberOfAllocatedVoxelMaterials, numberOfNonEmptyVoxels);
+	}
+	const bool doesOverflow = doesVoxelMaterialArrayOverflow(&firstMaterialIndex, numberOfNonEmptyVoxels, pVoxelMaterialArrayCapacity);
+
+	// Put the voxel brick into its position in the voxel brick array
+	pVoxelBrickArray[voxelBrickIndex] = voxelBrick;
+	pVoxelBrickFirstMaterialIndexArray[voxelBrickIndex] = firstMaterialIndex;
+	if(doesOverflow)
+	{
+		return;
+	}
+
+	// Write the voxel data of the non empty voxels. They are generated again, so that a work item does not have to keep the voxels of the whole voxel brick
+	__global struct Voxel *voxelBrickMaterialArray = pVoxelMaterialArray + firstMaterialIndex;
+	for(uint z = 0; z < FORGE_VOXEL_BRICK_SIDE_LENGTH; ++z)
+	{
+		for(uint y = 0; y < FORGE_VOXEL_BRICK_SIDE_LENGTH; ++y)
+		{
+			for(uint x = 0; x < FORGE_VOXEL_BRICK_SIDE_LENGTH; ++x)
+			{
+				const uint3 voxelCoordsInVoxelBrick = (uint3)(x, y, z);
+				const ulong voxelBit = (ulong)1 << getVoxelBrickBitIndex(voxelCoordsInVoxelBrick);
+				if(voxelBrick & voxelBit)
+				{
+					const int3 remappedVoxelCoords = getRemappedVoxelCoords(voxelBrickMinCoordsInMemory + convert_int3(voxelCoordsInVoxelBrick), pVoxelGridToroidalOffset, voxelGridSideLength);
+					voxelBrickMaterialArray[popcount(voxelBrick & (voxelBit - 1))] = generateVoxel(1, remappedVoxelCoords - voxelGridSideLength / 2, pOffset);
+				}
+			}
+		}
+	}
+}
+
+// Like generateVoxelKernel, but each work group generates a block of 4x4x4 voxel bricks, and also the two levels of nodes above them, which are a node with 8 children
+// that each have 8 voxel bricks as children. Whether the voxel bricks are empty is shared in local memory, so the voxel bricks are not read back from global memory,
+// and those two levels need no kernels of their own. The corners of the terrain noise lattice that the block uses are also hashed once into local memory,
+// instead of 8 times for every voxel. The work group size must be 4x4x4, and the global work offset and size must be multiples of 4.
+// The blocks are aligned to their size in memory, so the voxel bricks of a block are next to each other in Morton order, and so are the nodes above them.
+// The voxel bricks of a block that need new room for their voxel data take it with a single allocation for the whole block
+__kernel __attribute__((reqd_work_group_size(4, 4, 4)))
+void generateVoxelBlockKernel(__global ulong *pVoxelBrickArray,
+							  float pOffset,
+							  __global struct Voxel *pVoxelMaterialArray,
+							  int3 pVoxelGridToroidalOffset,
+							  uint pVoxelBrickLevel,
+							  __global uint *pVoxelBrickFirstMaterialIndexArray,
+							  __global uint *pNumberOfAllocatedVoxelMaterials,
+							  uint pVoxelMaterialArrayCapacity,
+							  __global uchar *pChildMaskArray)
 {
-	// Get the coordinates of the voxel for which this kernel instance is being executed for remmaped to the range (0, voxelGridSize - 1)
-	uint3 remappedVoxelCoords;
-	remappedVoxelCoords.x = get_global_id(0);
-	remappedVoxelCoords.y = get_global_id(1);
-	remappedVoxelCoords.z = get_global_id(2);
+	// The hashes of the corners of the terrain noise lattice that the voxels of the block use, which are shared by all the voxels of the block
+	__local float latticeValues[FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS * FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS * FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS];
+	// Whether each voxel brick of the block has any non empty voxels, indexed by the Morton code of its coords in the block
+	__local uchar isVoxelBrickNonEmptyArray[64];
+	// The child masks of the nodes just above the voxel bricks of the block, indexed by the Morton code of their coords in the block
+	__local uchar voxelBrickParentNodeChildMaskArray[8];
+	// The number of voxel data that the voxel bricks of the block need new room for, and the index of the first of them once they are allocated
+	__local uint numberOfBlockVoxelMaterials;
+	__local uint blockFirstMaterialIndex;
 
-	// Get half the resolution of the voxel grid
-	int3 halfVoxelGridSize;
-	halfVoxelGridSize.x = get_global_size(0) / 2;
-	halfVoxelGridSize.y = get_global_size(1) / 2;
-	halfVoxelGridSize.z = get_global_size(2) / 2;
+	// Get the coordinates of the voxel brick for which this kernel instance is being executed for in memory, in the range (0, numberOfVoxelBricksAlongEachAxis - 1)
+	uint3 voxelBrickCoords;
+	voxelBrickCoords.x = get_global_id(0);
+	voxelBrickCoords.y = get_global_id(1);
+	voxelBrickCoords.z = get_global_id(2);
+	uint3 voxelBrickCoordsInBlock;
+	voxelBrickCoordsInBlock.x = get_local_id(0);
+	voxelBrickCoordsInBlock.y = get_local_id(1);
+	voxelBrickCoordsInBlock.z = get_local_id(2);
+	// The group IDs do not include the global work offset, so the coords of the block in memory are found from those of its voxel bricks
+	const uint3 blockCoords = (voxelBrickCoords - voxelBrickCoordsInBlock) / 4;
 
-	// The actual coordinates of the current voxel
-	int3 voxelCoords = convert_int3(remappedVoxelCoords) - halfVoxelGridSize;
+	// There are (2 ^ voxelBrickLevel) voxel bricks along each axis
+	const int voxelGridSideLength = FORGE_VOXEL_BRICK_SIDE_LENGTH << pVoxelBrickLevel;
+	const int blockSideLength = 4 * FORGE_VOXEL_BRICK_SIDE_LENGTH;
 
-	// Generate the voxel and put it into its position in the voxel data array
-	pVoxelArray[getMortonCodeForVoxelCoords(remappedVoxelCoords, pVoxelOctreeDepth)] = generateVoxel(1, voxelCoords, pOffset);
+	// The lattice cell of the first voxel of each run has the first corner of the run. The lattice coords only grow with the remapped coords,
+	// so the corners of the other voxels of the run follow it. The second run starts at the remapped coords 0
+	struct BlockLattice lattice;
+	lattice.firstRemappedVoxelCoords = getRemappedVoxelCoords(convert_int3(blockCoords) * blockSideLength, pVoxelGridToroidalOffset, voxelGridSideLength);
+	lattice.firstRunMinCornerCoords = getTerrainNoiseLatticeCoords(lattice.firstRemappedVoxelCoords, voxelGridSideLength, pOffset);
+	lattice.secondRunMinCornerCoords = getTerrainNoiseLatticeCoords((int3)(0, 0, 0), voxelGridSideLength, pOffset);
+	// The remapped coords of the block wrap around along the axes where it reaches past the end of the voxel grid
+	const int3 doesBlockWrapAround = lattice.firstRemappedVoxelCoords > voxelGridSideLength - blockSideLength;
+
+	// Hash each corner of the block once. The corners of the second run along an axis are only used if the block wraps around along it
+	const uint workItemIndex = get_local_id(0) + 4 * (get_local_id(1) + 4 * get_local_id(2));
+	if(workItemIndex == 0)
+	{
+		numberOfBlockVoxelMaterials = 0;
+	}
+	const uint numberOfLatticeCorners = FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS * FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS * FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS;
+	for(uint i = workItemIndex; i < numberOfLatticeCorners; i += 64)
+	{
+		int3 cornerCoordsInBlock;
+		cornerCoordsInBlock.x = i % FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS;
+		cornerCoordsInBlock.y = (i / FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS) % FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS;
+		cornerCoordsInBlock.z = i / (FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS * FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS);
+		const int3 isInSecondRun = cornerCoordsInBlock >= FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_PER_RUN;
+		const int3 isCornerUsed = ~isInSecondRun | doesBlockWrapAround;
+		if(isCornerUsed.x && isCornerUsed.y && isCornerUsed.z)
+		{
+			latticeValues[i] = hash3DGrid(1, select(lattice.firstRunMinCornerCoords + cornerCoordsInBlock,
+													lattice.secondRunMinCornerCoords + cornerCoordsInBlock - FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_PER_RUN,
+													isInSecondRun));
+		}
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+
+	const int3 voxelBrickMinCoordsInMemory = convert_int3(voxelBrickCoords) * FORGE_VOXEL_BRICK_SIDE_LENGTH;
+	const uint voxelBrickIndex = interleaveVoxelCoords(voxelBrickCoords);
+
+	// Bound the terrain noise over the voxel brick. Value noise is a weighted average of the corners of its lattice cell, so over the voxel brick
+	// it is between the smallest and the largest of the corners of the cells of its bottom left and top right voxels in memory, and all the corners of the block in between.
+	// If the voxel brick wraps around, the corners in between are those of both runs, which bound the noise more loosely but still correctly
+	const int3 voxelBrickMinRemappedCoords = getRemappedVoxelCoords(voxelBrickMinCoordsInMemory, pVoxelGridToroidalOffset, voxelGridSideLength);
+	const int3 voxelBrickMaxRemappedCoords = getRemappedVoxelCoords(voxelBrickMinCoordsInMemory + (FORGE_VOXEL_BRICK_SIDE_LENGTH - 1), pVoxelGridToroidalOffset, voxelGridSideLength);
+	const int3 minCornerCoordsInBlock = getCornerCoordsInBlock(&lattice, voxelBrickMinRemappedCoords,
+															   getTerrainNoiseLatticeCoords(voxelBrickMinRemappedCoords, voxelGridSideLength, pOffset));
+	const int3 maxCornerCoordsInBlock = getCornerCoordsInBlock(&lattice, voxelBrickMaxRemappedCoords,
+															   getTerrainNoiseLatticeCoords(voxelBrickMaxRemappedCoords, voxelGridSideLength, pOffset)) + 1;
+	float minTerrainNoise = MAXFLOAT;
+	float maxTerrainNoise = -MAXFLOAT;
+	for(int z = minCornerCoordsInBlock.z; z <= maxCornerCoordsInBlock.z; ++z)
+	{
+		for(int y = minCornerCoordsInBlock.y; y <= maxCornerCoordsInBlock.y; ++y)
+		{
+			for(int x = minCornerCoordsInBlock.x; x <= maxCornerCoordsInBlock.x; ++x)
+			{
+				const float cornerValue = latticeValues[x + FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS * (y + FORGE_NUMBER_OF_BLOCK_LATTICE_CORNERS_ALONG_EACH_AXIS * z)];
+				minTerrainNoise = fmin(minTerrainNoise, cornerValue);
+				maxTerrainNoise = fmax(maxTerrainNoise, cornerValue);
+			}
+		}
+	}
+
+	ulong voxelBrick = 0;
+	const bool isVoxelBrickEmpty = minTerrainNoise > FORGE_TERRAIN_NOISE_SOLID_THRESHOLD + FORGE_TERRAIN_NOISE_BOUNDS_MARGIN;
+	const bool isVoxelBrickSolid = maxTerrainNoise < FORGE_TERRAIN_NOISE_SOLID_THRESHOLD - FORGE_TERRAIN_NOISE_BOUNDS_MARGIN;
+	if(isVoxelBrickEmpty || isVoxelBrickSolid)
+	{
+		// All the voxels of the voxel brick are the same, so the noise need not be evaluated for any of them
+		voxelBrick = isVoxelBrickSolid? ~(ulong)0 : (ulong)0;
+	}
+	else
+	{
+		// Generate the voxels of the voxel brick of this work item, and set the bits of the non empty ones
+		for(uint z = 0; z < FORGE_VOXEL_BRICK_SIDE_LENGTH; ++z)
+		{
+			for(uint y = 0; y < FORGE_VOXEL_BRICK_SIDE_LENGTH; ++y)
+			{
+				for(uint x = 0; x < FORGE_VOXEL_BRICK_SIDE_LENGTH; ++x)
+				{
+					const uint3 voxelCoordsInVoxelBrick = (uint3)(x, y, z);
+					const uint voxelBrickBitIndex = getVoxelBrickBitIndex(voxelCoordsInVoxelBrick);
+					const struct Voxel voxel = generateBlockVoxel(&lattice, latticeValues, voxelBrickMinCoordsInMemory + convert_int3(voxelCoordsInVoxelBrick),
+																  pVoxelGridToroidalOffset, voxelGridSideLength, pOffset);
+					if(voxel.voxelID)
+					{
+						voxelBrick |= (ulong)1 << voxelBrickBitIndex;
+					}
+				}
+			}
+		}
+	}
+
+	// The voxel data stays where it was if it fits, or else the voxel brick takes room from the allocation of the block
+	const uint numberOfNonEmptyVoxels = popcount(voxelBrick);
+	const bool doesVoxelBrickNeedRoom = numberOfNonEmptyVoxels > popcount(pVoxelBrickArray[voxelBrickIndex]);
+	uint firstMaterialIndex = doesVoxelBrickNeedRoom? atomic_add(&numberOfBlockVoxelMaterials, numberOfNonEmptyVoxels) : pVoxelBrickFirstMaterialIndexArray[voxelBrickIndex];
+	pVoxelBrickArray[voxelBrickIndex] = voxelBrick;
+
+	const uint voxelBrickIndexInBlock = interleaveVoxelCoords(voxelBrickCoordsInBlock);
+	isVoxelBrickNonEmptyArray[voxelBrickIndexInBlock] = (voxelBrick != 0);
+	barrier(CLK_LOCAL_MEM_FENCE);
+
+	if(voxelBrickIndexInBlock == 0)
+	{
+		blockFirstMaterialIndex = atomic_add(pNumberOfAllocatedVoxelMaterials, numberOfBlockVoxelMaterials);
+	}
+
+	// The children of node i of the block are the voxel bricks (8 * i) to (8 * i + 7) of the block, and the Morton codes of the nodes of the block
+	// follow the Morton code of the block, with a leading 1 bit for their level
+	const uint blockIndex = interleaveVoxelCoords(blockCoords);
+	if(voxelBrickIndexInBlock < 8)
+	{
+		uchar childMask = 0;
+		for(uint i = 0; i < 8; ++i)
+		{
+			if(isVoxelBrickNonEmptyArray[(voxelBrickIndexInBlock << 3) | i])
+			{
+				childMask |= (1 << i);
+			}
+		}
+		voxelBrickParentNodeChildMaskArray[voxelBrickIndexInBlock] = childMask;
+		pChildMaskArray[((blockIndex << 3) | voxelBrickIndexInBlock) | (1 << ((pVoxelBrickLevel - 1) * 3))] = childMask;
+	}
+	barrier(CLK_LOCAL_MEM_FENCE);
+
+	if(voxelBrickIndexInBlock == 0)
+	{
+		uchar childMask = 0;
+		for(uint i = 0; i < 8; ++i)
+		{
+			if(voxelBrickParentNodeChildMaskArray[i])
+			{
+				childMask |= (1 << i);
+			}
+		}
+		pChildMaskArray[blockIndex | (1 << ((pVoxelBrickLevel - 2) * 3))] = childMask;
+	}
+
+	// The allocation of the block was made before the last barrier
+	if(doesVoxelBrickNeedRoom)
+	{
+		firstMaterialIndex += blockFirstMaterialIndex;
+	}
+	const bool doesOverflow = doesVoxelMaterialArrayOverflow(&firstMaterialIndex, numberOfNonEmptyVoxels, pVoxelMaterialArrayCapacity);
+	pVoxelBrickFirstMaterialIndexArray[voxelBrickIndex] = firstMaterialIndex;
+	if(doesOverflow || voxelBrick == 0)
+	{
+		return;
+	}
+
+	// Write the voxel data of the non empty voxels in the order of their bits. The voxels of a voxel brick that is neither empty nor solid are generated again,
+	// so that a work item does not have to keep the voxels of the whole voxel brick until it has room for them
+	__global struct Voxel *voxelBrickMaterialArray = pVoxelMaterialArray + firstMaterialIndex;
+	if(isVoxelBrickSolid)
+	{
+		const struct Voxel voxel = generateVoxelFromTerrainNoise(0.0f);
+		for(uint i = 0; i < 64; ++i)
+		{
+			voxelBrickMaterialArray[i] = voxel;
+		}
+		return;
+	}
+	for(uint z = 0; z < FORGE_VOXEL_BRICK_SIDE_LENGTH; ++z)
+	{
+		for(uint y = 0; y < FORGE_VOXEL_BRICK_SIDE_LENGTH; ++y)
+		{
+			for(uint x = 0; x < FORGE_VOXEL_BRICK_SIDE_LENGTH; ++x)
+			{
+				const uint3 voxelCoordsInVoxelBrick = (uint3)(x, y, z);
+				const ulong voxelBit = (ulong)1 << getVoxelBrickBitIndex(voxelCoordsInVoxelBrick);
+				if(voxelBrick & voxelBit)
+				{
+					voxelBrickMaterialArray[popcount(voxelBrick & (voxelBit - 1))] = generateBlockVoxel(&lattice, latticeValues, voxelBrickMinCoordsInMemory + convert_int3(voxelCoordsInVoxelBrick),
+																										pVoxelGridToroidalOffset, voxelGridSideLength, pOffset);
+				}
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -8,25 +8,61 @@
 #include "ForgeData/OpenCL/Include/ProgramIntersectionTests.cl"
 #include "ForgeData/OpenCL/Include/Texture.cl"
 
+// The side length of the square tiles of pixels that share one beam, in pixels.
+// NOTE: This must match TraceBeamKernel::tileSize in Source/Rendering/OpenCLRenderer/Kernels/TraceBeamKernel.h
+#define FORGE_BEAM_TILE_SIZE 8
+
+// The side length of the square batches of work item coords that the work groups of renderPixel take when persistent threads are used. The work groups have one work item for every work item coords of a batch.
+// NOTE: This must match RenderPixelKernel::rayBatchSideLength in Source/Rendering/OpenCLRenderer/Kernels/RenderPixelKernel.h
+#define FORGE_RAY_BATCH_SIDE_LENGTH 8
+
+// The number of 32 bit masks that have one bit for every pixel of a tile
+#define FORGE_NUMBER_OF_REPROJECTED_DEPTH_TILE_PIXEL_MASKS (FORGE_BEAM_TILE_SIZE * FORGE_BEAM_TILE_SIZE / 32)
+
+// The depths of the previous frame that are reprojected into a tile of pixels of the current frame. The distances are the bits of non negative floats,
+// so they can be compared as integers. The bit of a pixel of the tile is set if a depth was reprojected into it. Pixels that were hidden in the previous frame
+// get no depth, and may show something that was not seen before, so the minimum distance is only used if every pixel of the tile got a depth.
+// NOTE: This must match ReprojectDepthKernel::ReprojectedDepthTile in Source/Rendering/OpenCLRenderer/Kernels/ReprojectDepthKernel.h
+struct ReprojectedDepthTile
+{
+	uint minDistance;
+	uint coveredPixelMasks[FORGE_NUMBER_OF_REPROJECTED_DEPTH_TILE_PIXEL_MASKS];
+};
+
+// The distance in voxels, and the fraction of the distance, that the rays start in front of the minimum reprojected distance of their tile,
+// because the rays of the current frame do not pass exactly through the points seen in the previous frame, and they are further apart the further away they are
+#define FORGE_REPROJECTED_DEPTH_MARGIN 2.0f
+#define FORGE_REPROJECTED_DEPTH_RELATIVE_MARGIN 0.05f
+// The rays also start in front of it by this many times the distance that the camera moved since the previous frame,
+// since the further the camera moves, the further in front of the surfaces seen before a surface that was hidden may appear
+#define FORGE_REPROJECTED_DEPTH_MARGIN_PER_CAMERA_TRANSLATION 1.0f
+
+// The difference in voxels, and as a fraction of the distance, between the distance at which a pixel of the previous frame hit a voxel
+// and the distance to the point that a pixel reconstructed in checkerboard rendering is assumed to see, up to which the pixel is assumed to have seen the point
+#define FORGE_CHECKERBOARD_MAX_HIT_DISTANCE_DIFFERENCE 1.0f
+#define FORGE_CHECKERBOARD_MAX_RELATIVE_HIT_DISTANCE_DIFFERENCE 0.05f
+
 struct RayHitData
 {
 	float3 color;
 	float3 point;
 	float3 normal;
+	uint numberOfTraversalSteps;
 };
 
 bool traceRay(struct Ray pRay,
-			  __global struct VoxelData *pVoxelOctreeNodesArray,
-			  uint pVoxelOctreeDepth,
+			  struct VoxelOctree pVoxelOctree,
 			  long3 pVoxelGridMinCoords,
 			  long3 pVoxelGridMaxCoords,
 			  float pMaxDistance,
 			  int pIsOctreeVisualizationEnabled,
 			  __global struct Texture *pTexturesBuffer,
-			  struct RayHitData *pRayHitData)
+			  struct RayHitData *pRayHitData) // The number of traversal steps is also set if the ray does not hit anything
 {
 	struct RayAndVoxelOctreeIntersectionData rayAndVoxelOctreeIntersectionData;
-	if(rayAndVoxelOctreeIntersectionTest(pRay, pVoxelOctreeNodesArray, pVoxelOctreeDepth, pVoxelGridMinCoords, pVoxelGridMaxCoords, pMaxDistance, pIsOctreeVisualizationEnabled, &rayAndVoxelOctreeIntersectionData))
+	const bool hasRayHitVoxel = rayAndVoxelOctreeIntersectionTest(pRay, pVoxelOctree, pVoxelGridMinCoords, pVoxelGridMaxCoords, pMaxDistance, pIsOctreeVisualizationEnabled, &rayAndVoxelOctreeIntersectionData);
+	pRayHitData->numberOfTraversalSteps = rayAndVoxelOctreeIntersectionData.numberOfTraversalSteps;
+	if(hasRayHitVoxel)
 	{
 		// The number of coordinates in the intersection point that have values that make them potentially part of a voxel's border
 		int numberOfCoordinatesInBorderRange = 0;
@@ -98,18 +134,22 @@ struct DebugAABB
 
 float3 calculatePixelColor(int2 pPixelCoords,
 						   int2 pOutputImageResolution,
+						   float pRayStartDistance, // The distance along the camera ray up to which there are no voxels, or MAXFLOAT if the ray does not hit any voxel
 						   float3 pCameraPosition, // The position of the camera in world space
 						   float3 pCameraOrientationXAxis, // The x axis basis vector of the camera orientation
 						   float3 pCameraOrientationYAxis, // The y axis basis vector of the camera orientation
 						   float3 pCameraOrientationZAxis, // The z axis basis vector of the camera orientation
 						   float pCameraVerticalFieldOfViewInDegrees, // The vertical field of view of the camera, specified in degrees
-						   __global struct Voxel *pVoxelOctreeNodesArray,
-						   uint pVoxelOctreeDepth,
+						   struct VoxelOctree pVoxelOctree,
 						   __global struct Texture *pTexturesBuffer,
 						   __global struct DebugAABB *pDebugAABBsArray,
 						   int pDebugAABBArrayLength,
-						   int pIsOctreeVisualizationEnabled)
+						   int pIsOctreeVisualizationEnabled,
+						   float *pOutputHitDistance, // The distance along the camera ray at which it hits a voxel, MAXFLOAT if it hits nothing, or 0 if it is not known
+						   uint *pOutputNumberOfTraversalSteps) // The number of octree nodes and voxels that the camera ray visited
 {
+	*pOutputNumberOfTraversalSteps = 0;
+
 	// Get the camera ray for the pixel
 	struct Ray cameraRayForPixel = getCameraRayForPixel(pCameraPosition,
 														pCameraOrientationXAxis,
@@ -128,6 +168,8 @@ float3 calculatePixelColor(int2 pPixelCoords,
 		struct RayAndAABBIntersectionData rayAndSingleEditVoxelAABBIntersectionData;
 		if(rayAndAABBIntersectionTest(cameraRayForPixel, singleEditVoxelAABB, &rayAndSingleEditVoxelAABBIntersectionData, MAXFLOAT))
 		{
+			*pOutputHitDistance = 0.0f;
+
 			int numberOfCoordinatesInBorderRange = 0;
 			float3 rayHitPoint = cameraRayForPixel.origin + cameraRayForPixel.direction * rayAndSingleEditVoxelAABBIntersectionData.entryDistance;
 			float3 rayHitPointFractionalPart = rayHitPoint - floor(rayHitPoint);
@@ -154,8 +196,19 @@ float3 calculatePixelColor(int2 pPixelCoords,
 		}
 	}
 
+	// The camera ray does not hit any voxel, so it does not need to be traced
+	if(pRayStartDistance >= MAXFLOAT)
+	{
+		*pOutputHitDistance = MAXFLOAT;
+		return getBackgroundColorForRay(cameraRayForPixel);
+	}
+
+	// Skip the empty space in front of the camera. Only the origin of the ray moves along its direction, so it still hits the same voxel
+	struct Ray cameraRayFromStartDistance = cameraRayForPixel;
+	cameraRayFromStartDistance.origin += cameraRayForPixel.direction * pRayStartDistance;
+
 	int octreeRootNodeScale = 2;
-	for(uint i = 1; i < pVoxelOctreeDepth - 1; ++i)
+	for(uint i = 1; i < pVoxelOctree.depth - 1; ++i)
 	{
 		octreeRootNodeScale *= 2;
 	}
@@ -171,57 +224,324 @@ float3 calculatePixelColor(int2 pPixelCoords,
 	float octreeRootNodeFloatHalfScale = (float)octreeRootNodeHalfScale;
 
 	struct RayHitData rayHitData;
-	if(traceRay(cameraRayForPixel, pVoxelOctreeNodesArray, pVoxelOctreeDepth, voxelGridMinCoords, voxelGridMaxCoords, FLT_MAX, pIsOctreeVisualizationEnabled, pTexturesBuffer, &rayHitData))
+	const bool hasRayHitVoxel = traceRay(cameraRayFromStartDistance, pVoxelOctree, voxelGridMinCoords, voxelGridMaxCoords, FLT_MAX, pIsOctreeVisualizationEnabled, pTexturesBuffer, &rayHitData);
+	*pOutputNumberOfTraversalSteps = rayHitData.numberOfTraversalSteps;
+	if(hasRayHitVoxel)
 	{
+		// The points on the borders of the octree nodes are not on any voxel
+		*pOutputHitDistance = pIsOctreeVisualizationEnabled? 0.0f : dot(rayHitData.point - cameraRayForPixel.origin, cameraRayForPixel.direction);
 		return rayHitData.color;
 	}
 	else
 	{
+		*pOutputHitDistance = MAXFLOAT;
 		return getBackgroundColorForRay(cameraRayForPixel);
 	}
 }
 
-// This kernel gets executed for every pixel in the backbuffer. The global ID in the first and second dimensions correspond
-// to the integer coordinates of the pixel the current work item is being executed for
-__kernel void renderPixel(float3 pCameraPosition, // The position of the camera in world space
-						  float3 pCameraOrientationXAxis, // The x axis basis vector of the camera orientation
-						  float3 pCameraOrientationYAxis, // The y axis basis vector of the camera orientation
-						  float3 pCameraOrientationZAxis, // The z axis basis vector of the camera orientation
-						  float pCameraVerticalFieldOfViewInDegrees, // The vertical field of view of the camera, specified in degrees
-						  __global struct Voxel *pVoxelOctreeNodesArray,
-						  uint pVoxelOctreeDepth,
-						  __global struct Texture *pTexturesBuffer,
-						  __global struct DebugAABB *pDebugAABBsArray,
-						  int pDebugAABBArrayLength,
-						  int pIsOctreeVisualizationEnabled,
-						  __global uchar4 *pOutputUchar4Framebuffer) // An array in which each element represents the output data for a pixel
+// This kernel gets executed for every tile of FORGE_BEAM_TILE_SIZE x FORGE_BEAM_TILE_SIZE pixels in the backbuffer, before renderPixel.
+// The global ID in the first and second dimensions correspond to the integer coordinates of the tile the current work item is being executed for.
+// It traces a cone that contains the camera rays of every pixel in the tile through the octree, and writes the distance up to which
+// none of them can hit a voxel, so that renderPixel does not have to trace them through the same empty nodes from the root of the octree
+__kernel void traceBeam(float3 pCameraPosition, // The position of the camera in world space
+						float3 pCameraOrientationXAxis, // The x axis basis vector of the camera orientation
+						float3 pCameraOrientationYAxis, // The y axis basis vector of the camera orientation
+						float3 pCameraOrientationZAxis, // The z axis basis vector of the camera orientation
+						float pCameraVerticalFieldOfViewInDegrees, // The vertical field of view of the camera, specified in degrees
+#ifdef FORGE_SPARSE_VOXEL_OCTREE
+						__global const struct SparseVoxelOctreeNode *pVoxelOctreeNodesArray,
+#else
+						__global const uchar *pVoxelOctreeNodesArray,
+#endif
+						uint pVoxelOctreeDepth,
+						int pOutputImageWidth,
+						int pOutputImageHeight,
+						__global float *pOutputBeamDistancesArray, // An array in which each element is the distance at which the camera rays of a tile start
+						__global struct ReprojectedDepthTile *pReprojectedDepthTilesArray, // Written by reprojectDepth, and cleared for the next frame by this kernel
+						int pHaveVoxelsChanged, // Whether any voxels were added or removed since the previous frame
+						float3 pChangedVoxelsAABBMinPoint, // The AABB that contains all the voxels that were added or removed since the previous frame
+						float3 pChangedVoxelsAABBMaxPoint,
+						int3 pVoxelGridToroidalOffset, // Where the voxels are stored in memory, relative to the voxel grid. See the VoxelOctree struct
+						float pCameraTranslationDistance) // The distance that the camera moved since the previous frame
+{
+	// Only the nodes are needed to find out which parts of the octree are empty
+	struct VoxelOctree voxelOctree;
+	voxelOctree.nodes = pVoxelOctreeNodesArray;
+	voxelOctree.depth = pVoxelOctreeDepth;
+	voxelOctree.toroidalOffset = pVoxelGridToroidalOffset;
+
+	int2 tileCoords;
+	tileCoords.x = get_global_id(0);
+	tileCoords.y = get_global_id(1);
+
+	int2 outputImageResolution;
+	outputImageResolution.x = pOutputImageWidth;
+	outputImageResolution.y = pOutputImageHeight;
+
+	// The pixels at the corners of the tile. The tiles at the right and top edges of the image may be cut off by it
+	const int2 tileMinPixelCoords = tileCoords * FORGE_BEAM_TILE_SIZE;
+	const int2 tileMaxPixelCoords = min(tileMinPixelCoords + (FORGE_BEAM_TILE_SIZE - 1), outputImageResolution - 1);
+
+	// The directions of the camera rays are on a plane in front of the camera before they are normalized, so the rays of all the pixels in the tile
+	// are inside the pyramid of the rays of its corner pixels. The axis of the cone goes through the center of the tile, and the cone contains the corner rays
+	float3 cornerRayDirections[4];
+	cornerRayDirections[0] = getCameraRayForPixel(pCameraPosition, pCameraOrientationXAxis, pCameraOrientationYAxis, pCameraOrientationZAxis, pCameraVerticalFieldOfViewInDegrees, (int2)(tileMinPixelCoords.x, tileMinPixelCoords.y), outputImageResolution).direction;
+	cornerRayDirections[1] = getCameraRayForPixel(pCameraPosition, pCameraOrientationXAxis, pCameraOrientationYAxis, pCameraOrientationZAxis, pCameraVerticalFieldOfViewInDegrees, (int2)(tileMaxPixelCoords.x, tileMinPixelCoords.y), outputImageResolution).direction;
+	cornerRayDirections[2] = getCameraRayForPixel(pCameraPosition, pCameraOrientationXAxis, pCameraOrientationYAxis, pCameraOrientationZAxis, pCameraVerticalFieldOfViewInDegrees, (int2)(tileMinPixelCoords.x, tileMaxPixelCoords.y), outputImageResolution).direction;
+	cornerRayDirections[3] = getCameraRayForPixel(pCameraPosition, pCameraOrientationXAxis, pCameraOrientationYAxis, pCameraOrientationZAxis, pCameraVerticalFieldOfViewInDegrees, (int2)(tileMaxPixelCoords.x, tileMaxPixelCoords.y), outputImageResolution).direction;
+
+	struct Ray coneAxis;
+	coneAxis.origin = pCameraPosition;
+	coneAxis.direction = normalize(cornerRayDirections[0] + cornerRayDirections[1] + cornerRayDirections[2] + cornerRayDirections[3]);
+
+	// The points at the same distance along two rays with unit directions are as far apart as their directions, times the distance
+	float coneRadiusPerDistance = 0.0f;
+	for(int i = 0; i < 4; ++i)
+	{
+		coneRadiusPerDistance = fmax(coneRadiusPerDistance, length(cornerRayDirections[i] - coneAxis.direction));
+	}
+	// Make the cone slightly wider, so that rounding errors can not leave any of the rays outside of it
+	coneRadiusPerDistance = coneRadiusPerDistance * 1.01f + 0.0001f;
+
+	float beamDistance = coneAndVoxelOctreeEmptySpaceTest(coneAxis, coneRadiusPerDistance, voxelOctree);
+	// Start the rays a voxel before the first node that the beam touches, so that rounding errors can not make them start inside a voxel
+	if(beamDistance < MAXFLOAT)
+	{
+		beamDistance = fmax(beamDistance - 1.0f, 0.0f);
+	}
+
+	const int numberOfTilesAlongX = get_global_size(0);
+	const int tileIndex = numberOfTilesAlongX * tileCoords.y + tileCoords.x;
+
+	// The distance at which the rays of the tile hit voxels in the previous frame is usually further than the beam gets, since the beam stops at the first node it touches.
+	// It is only used if it does not make the rays skip any of the voxels that were added since the previous frame. Removed voxels can only make the rays hit further away.
+	// The tiles at the edges of the image are left out, because they may show voxels that were outside of the view of the camera in the previous frame
+	// The tiles that are not at the edges are whole, so all the bits of their masks are used
+	const struct ReprojectedDepthTile reprojectedDepthTile = pReprojectedDepthTilesArray[tileIndex];
+	const bool isTileAtImageEdge = any(tileMinPixelCoords == 0) || any(tileMaxPixelCoords == outputImageResolution - 1);
+	bool isTileCovered = true;
+	for(int i = 0; i < FORGE_NUMBER_OF_REPROJECTED_DEPTH_TILE_PIXEL_MASKS; ++i)
+	{
+		isTileCovered = isTileCovered && reprojectedDepthTile.coveredPixelMasks[i] == 0xffffffff;
+	}
+	const float minReprojectedDistance = as_float(reprojectedDepthTile.minDistance);
+	const float reprojectedDistance = minReprojectedDistance * (1.0f - FORGE_REPROJECTED_DEPTH_RELATIVE_MARGIN) - FORGE_REPROJECTED_DEPTH_MARGIN -
+									  pCameraTranslationDistance * FORGE_REPROJECTED_DEPTH_MARGIN_PER_CAMERA_TRANSLATION;
+	if(!isTileAtImageEdge && isTileCovered && minReprojectedDistance < MAXFLOAT && beamDistance < reprojectedDistance)
+	{
+		// The part of the cone between the two distances is inside the box that contains the cross sections of the cone at both of them
+		const float3 beamCenter = coneAxis.origin + coneAxis.direction * beamDistance;
+		const float3 reprojectedCenter = coneAxis.origin + coneAxis.direction * reprojectedDistance;
+		const float3 coneSegmentMinPoint = fmin(beamCenter - beamDistance * coneRadiusPerDistance, reprojectedCenter - reprojectedDistance * coneRadiusPerDistance);
+		const float3 coneSegmentMaxPoint = fmax(beamCenter + beamDistance * coneRadiusPerDistance, reprojectedCenter + reprojectedDistance * coneRadiusPerDistance);
+		if(!pHaveVoxelsChanged || any(coneSegmentMaxPoint < pChangedVoxelsAABBMinPoint) || any(coneSegmentMinPoint > pChangedVoxelsAABBMaxPoint))
+		{
+			beamDistance = reprojectedDistance;
+		}
+	}
+
+	// Clear the tile for the depths of this frame, which are reprojected before the next frame
+	pReprojectedDepthTilesArray[tileIndex].minDistance = as_uint(MAXFLOAT);
+	for(int i = 0; i < FORGE_NUMBER_OF_REPROJECTED_DEPTH_TILE_PIXEL_MASKS; ++i)
+	{
+		pReprojectedDepthTilesArray[tileIndex].coveredPixelMasks[i] = 0;
+	}
+
+	pOutputBeamDistancesArray[tileIndex] = beamDistance;
+}
+
+// This kernel gets executed for every pixel of the previous frame, before traceBeam.
+// It moves the point that the camera ray of the pixel hit in the previous frame to the pixel of the current frame that it is seen through,
+// and keeps the minimum distance from the camera of the points that are moved into each tile of pixels, so that traceBeam can start the rays of the tile from there
+__kernel void reprojectDepth(float3 pPreviousCameraPosition, // The position of the camera in world space in the previous frame
+							 float3 pPreviousCameraOrientationXAxis, // The x axis basis vector of the camera orientation in the previous frame
+							 float3 pPreviousCameraOrientationYAxis, // The y axis basis vector of the camera orientation in the previous frame
+							 float3 pPreviousCameraOrientationZAxis, // The z axis basis vector of the camera orientation in the previous frame
+							 float pPreviousCameraVerticalFieldOfViewInDegrees, // The vertical field of view of the camera in the previous frame, specified in degrees
+							 float3 pCameraPosition, // The position of the camera in world space
+							 float3 pCameraOrientationXAxis, // The x axis basis vector of the camera orientation
+							 float3 pCameraOrientationYAxis, // The y axis basis vector of the camera orientation
+							 float3 pCameraOrientationZAxis, // The z axis basis vector of the camera orientation
+							 float pCameraVerticalFieldOfViewInDegrees, // The vertical field of view of the camera, specified in degrees
+							 __global const float *pPreviousDepthBuffer, // The hit distances written by renderPixel in the previous frame
+							 __global struct ReprojectedDepthTile *pOutputReprojectedDepthTilesArray) // Must have been cleared by traceBeam in the previous frame
 {
-	// Get the coordinates of the pixel for which this kernel instance is being executed for
 	int2 pixelCoords;
 	pixelCoords.x = get_global_id(0);
 	pixelCoords.y = get_global_id(1);
 
-	// Get the resolution of the output image
-	int2 outputImageResolution;
-	outputImageResolution.x = get_global_size(0);
-	outputImageResolution.y = get_global_size(1);
+	int2 imageResolution;
+	imageResolution.x = get_global_size(0);
+	imageResolution.y = get_global_size(1);
+
+	// The hit distance is not known for some pixels
+	const float previousHitDistance = pPreviousDepthBuffer[imageResolution.x * pixelCoords.y + pixelCoords.x];
+	if(previousHitDistance <= 0.0f)
+	{
+		return;
+	}
+
+	const struct Ray previousCameraRay = getCameraRayForPixel(pPreviousCameraPosition,
+															  pPreviousCameraOrientationXAxis,
+															  pPreviousCameraOrientationYAxis,
+															  pPreviousCameraOrientationZAxis,
+															  pPreviousCameraVerticalFieldOfViewInDegrees,
+															  pixelCoords,
+															  imageResolution);
+
+	// The rays that hit nothing are reprojected as points that are infinitely far away, which are only rotated by the camera
+	float3 directionToPoint = previousCameraRay.direction;
+	float distanceToPoint = MAXFLOAT;
+	if(previousHitDistance < MAXFLOAT)
+	{
+		directionToPoint = previousCameraRay.origin + previousCameraRay.direction * previousHitDistance - pCameraPosition;
+		distanceToPoint = length(directionToPoint);
+	}
+
+	// Find the pixel that the point is seen through, unless the point is behind the camera
+	float2 reprojectedPixelCoords;
+	if(!getPixelCoordsForCameraDirection(directionToPoint,
+										 pCameraOrientationXAxis,
+										 pCameraOrientationYAxis,
+										 pCameraOrientationZAxis,
+										 pCameraVerticalFieldOfViewInDegrees,
+										 imageResolution,
+										 &reprojectedPixelCoords))
+	{
+		return;
+	}
+	if(reprojectedPixelCoords.x < -1.0f || reprojectedPixelCoords.y < -1.0f ||
+	   reprojectedPixelCoords.x > (float)(imageResolution.x) || reprojectedPixelCoords.y > (float)(imageResolution.y))
+	{
+		return;
+	}
+
+	// The rays of the pixels around the point may pass just beside it and still hit its voxel,
+	// so the distance is given to every tile that has one of those pixels, even though the point only covers its nearest pixel
+	const int numberOfTilesAlongX = (imageResolution.x + FORGE_BEAM_TILE_SIZE - 1) / FORGE_BEAM_TILE_SIZE;
+	const int2 minTileCoords = clamp(convert_int2(floor(reprojectedPixelCoords - 1.0f)), (int2)(0), imageResolution - 1) / FORGE_BEAM_TILE_SIZE;
+	const int2 maxTileCoords = clamp(convert_int2(ceil(reprojectedPixelCoords + 1.0f)), (int2)(0), imageResolution - 1) / FORGE_BEAM_TILE_SIZE;
+	for(int tileY = minTileCoords.y; tileY <= maxTileCoords.y; ++tileY)
+	{
+		for(int tileX = minTileCoords.x; tileX <= maxTileCoords.x; ++tileX)
+		{
+			atomic_min(&pOutputReprojectedDepthTilesArray[numberOfTilesAlongX * tileY + tileX].minDistance, as_uint(distanceToPoint));
+		}
+	}
+
+	const float2 nearestPixelCoords = floor(reprojectedPixelCoords + 0.5f);
+	if(nearestPixelCoords.x >= 0.0f && nearestPixelCoords.y >= 0.0f &&
+	   nearestPixelCoords.x <= (float)(imageResolution.x - 1) && nearestPixelCoords.y <= (float)(imageResolution.y - 1))
+	{
+		const int2 tileCoords = convert_int2(nearestPixelCoords) / FORGE_BEAM_TILE_SIZE;
+		const int2 pixelCoordsInTile = convert_int2(nearestPixelCoords) - tileCoords * FORGE_BEAM_TILE_SIZE;
+		const int pixelIndexInTile = FORGE_BEAM_TILE_SIZE * pixelCoordsInTile.y + pixelCoordsInTile.x;
+		atomic_or(&pOutputReprojectedDepthTilesArray[numberOfTilesAlongX * tileCoords.y + tileCoords.x].coveredPixelMasks[pixelIndexInTile / 32], 1u << (pixelIndexInTile % 32));
+	}
+}
+
+// Get the coordinates of the pixel that a work item is executed for in checkerboard rendering. Each work item in a row of the image gets every second pixel,
+// starting from the first or the second pixel of the row, so that the pixels with the given parity form a checkerboard pattern.
+// The global work size along the first dimension is half of the image width, rounded up, so the last work item of a row may get a pixel that is outside of the image
+int2 getCheckerboardPixelCoords(int2 pWorkItemCoords, int pCheckerboardParity)
+{
+	int2 pixelCoords;
+	pixelCoords.x = pWorkItemCoords.x * 2 + ((pWorkItemCoords.y + pCheckerboardParity) & 1);
+	pixelCoords.y = pWorkItemCoords.y;
+	return pixelCoords;
+}
+
+// Get the work item coords of a work item of renderPixel from the index of the square batch of work item coords that it renders, and its index in the batch.
+// The batches are in row-major order. In the tiled pixel order, the work items of a batch are in Z-order, so the work items that are packed into one SIMD unit
+// render a square block of pixels instead of a strip of them. Their camera rays are closer together then, so they visit more of the same octree nodes
+int2 getRayBatchWorkItemCoords(uint pRayBatchIndex, uint pIndexInRayBatch, uint pNumberOfRayBatchesAlongX, int pIsTiledPixelOrderEnabled)
+{
+	int2 coordsInRayBatch = (int2)(0, 0);
+	if(pIsTiledPixelOrderEnabled)
+	{
+		// The bits of the index alternate between the x and the y coords
+		for(int i = 0; (1 << i) < FORGE_RAY_BATCH_SIDE_LENGTH; ++i)
+		{
+			coordsInRayBatch.x |= ((pIndexInRayBatch >> (2 * i)) & 1) << i;
+			coordsInRayBatch.y |= ((pIndexInRayBatch >> (2 * i + 1)) & 1) << i;
+		}
+	}
+	else
+	{
+		coordsInRayBatch.x = pIndexInRayBatch % FORGE_RAY_BATCH_SIDE_LENGTH;
+		coordsInRayBatch.y = pIndexInRayBatch / FORGE_RAY_BATCH_SIDE_LENGTH;
+	}
+
+	int2 workItemCoords;
+	workItemCoords.x = (pRayBatchIndex % pNumberOfRayBatchesAlongX) * FORGE_RAY_BATCH_SIDE_LENGTH + coordsInRayBatch.x;
+	workItemCoords.y = (pRayBatchIndex / pNumberOfRayBatchesAlongX) * FORGE_RAY_BATCH_SIDE_LENGTH + coordsInRayBatch.y;
+	return workItemCoords;
+}
+
+// Renders the pixel that a work item of renderPixel is executed for. The work item coords are the coords of the pixel, unless checkerboard rendering is used
+void renderPixelForWorkItem(int2 pWorkItemCoords,
+							uint pLaneIndex, // The index of the work item among all the work items of the dispatch, in the order in which they are packed into SIMD units
+							float3 pCameraPosition,
+							float3 pCameraOrientationXAxis,
+							float3 pCameraOrientationYAxis,
+							float3 pCameraOrientationZAxis,
+							float pCameraVerticalFieldOfViewInDegrees,
+							struct VoxelOctree pVoxelOctree,
+							__global struct Texture *pTexturesBuffer,
+							__global struct DebugAABB *pDebugAABBsArray,
+							int pDebugAABBArrayLength,
+							int pIsOctreeVisualizationEnabled,
+							__global uchar4 *pOutputUchar4Framebuffer,
+							__global const float *pBeamDistancesArray,
+							__global float *pOutputDepthBuffer,
+							int2 pOutputImageResolution,
+							int pCheckerboardParity,
+							__global uint2 *pOutputLaneStatisticsArray)
+{
+	int2 pixelCoords = pWorkItemCoords;
+	if(pCheckerboardParity >= 0)
+	{
+		pixelCoords = getCheckerboardPixelCoords(pixelCoords, pCheckerboardParity);
+	}
+
+	// The batches of work items at the edges of the image can reach past it
+	if(pixelCoords.x >= pOutputImageResolution.x || pixelCoords.y >= pOutputImageResolution.y)
+	{
+		return;
+	}
 
 	// Calculate the index of the pixel data for this pixel
-	int pixelIndex = outputImageResolution.x * pixelCoords.y + pixelCoords.x;
+	int pixelIndex = pOutputImageResolution.x * pixelCoords.y + pixelCoords.x;
+
+	// The borders of the octree nodes in front of the distance at which the beam of the tile starts would not be drawn, so it is not used while they are visualized
+	float rayStartDistance = 0.0f;
+	if(!pIsOctreeVisualizationEnabled)
+	{
+		const int numberOfTilesAlongX = (pOutputImageResolution.x + FORGE_BEAM_TILE_SIZE - 1) / FORGE_BEAM_TILE_SIZE;
+		rayStartDistance = pBeamDistancesArray[numberOfTilesAlongX * (pixelCoords.y / FORGE_BEAM_TILE_SIZE) + pixelCoords.x / FORGE_BEAM_TILE_SIZE];
+	}
 
+	float hitDistance;
+	uint numberOfTraversalSteps;
 	float3 pixelColor = calculatePixelColor(pixelCoords,
-											outputImageResolution,
+											pOutputImageResolution,
+											rayStartDistance,
 											pCameraPosition,
 											pCameraOrientationXAxis,
 											pCameraOrientationYAxis,
 											pCameraOrientationZAxis,
 											pCameraVerticalFieldOfViewInDegrees,
-											pVoxelOctreeNodesArray,
-											pVoxelOctreeDepth,
+											pVoxelOctree,
 											pTexturesBuffer,
 											pDebugAABBsArray,
 											pDebugAABBArrayLength,
-											pIsOctreeVisualizationEnabled);
+											pIsOctreeVisualizationEnabled,
+											&hitDistance,
+											&numberOfTraversalSteps);
+	pOutputDepthBuffer[pixelIndex] = hitDistance;
+#ifdef FORGE_MEASURE_LANE_UTILISATION
+	pOutputLaneStatisticsArray[pixelIndex] = (uint2)(numberOfTraversalSteps, pLaneIndex);
+#endif
 
 	// Apply gamma correction
 	{
@@ -237,4 +557,304 @@ __kernel void renderPixel(float3 pCameraPosition, // The position of the camera
 		pOutputUchar4Framebuffer[pixelIndex].z = (uchar)(255.0f * pixelColor.x);
 		pOutputUchar4Framebuffer[pixelIndex].w = 0;
 	}
+}
+
+// This kernel renders the pixels of the backbuffer. The work item coords are the integer coordinates of a pixel, or in checkerboard rendering, of every second pixel of a row.
+// Without persistent threads, it gets executed for every work item coords. In the tiled pixel order, the work items are dispatched along the first dimension,
+// FORGE_RAY_BATCH_SIDE_LENGTH x FORGE_RAY_BATCH_SIDE_LENGTH work items for every batch of work item coords. Otherwise, the work item coords are the global IDs in the first and second dimensions.
+// With persistent threads, only as many work groups of FORGE_RAY_BATCH_SIDE_LENGTH x FORGE_RAY_BATCH_SIDE_LENGTH work items along the first dimension are executed as the device can run at once.
+// Each of them takes square batches of work item coords from a counter in global memory until every batch has been taken, so a work group whose rays were short
+// takes another batch, instead of the device waiting for new work groups to be scheduled.
+// If FORGE_SPARSE_VOXEL_OCTREE is defined, the voxels are read from a sparse voxel octree instead of the Morton code indexed voxel array
+__kernel void renderPixel(float3 pCameraPosition, // The position of the camera in world space
+						  float3 pCameraOrientationXAxis, // The x axis basis vector of the camera orientation
+						  float3 pCameraOrientationYAxis, // The y axis basis vector of the camera orientation
+						  float3 pCameraOrientationZAxis, // The z axis basis vector of the camera orientation
+						  float pCameraVerticalFieldOfViewInDegrees, // The vertical field of view of the camera, specified in degrees
+#ifdef FORGE_SPARSE_VOXEL_OCTREE
+						  __global const struct SparseVoxelOctreeNode *pVoxelOctreeNodesArray,
+#else
+						  __global const uchar *pVoxelOctreeNodesArray,
+#endif
+						  uint pVoxelOctreeDepth,
+						  __global struct Texture *pTexturesBuffer,
+						  __global struct DebugAABB *pDebugAABBsArray,
+						  int pDebugAABBArrayLength,
+						  int pIsOctreeVisualizationEnabled,
+						  __global uchar4 *pOutputUchar4Framebuffer, // An array in which each element represents the output data for a pixel
+						  __global const ulong *pVoxelBricksArray,
+						  __global const struct Voxel *pVoxelMaterialArray,
+						  __global const float *pBeamDistancesArray, // The distances written by traceBeam, which must have been run for the same camera
+						  __global float *pOutputDepthBuffer, // An array in which each element is the distance at which the camera ray of a pixel hits a voxel
+						  int pOutputImageWidth,
+						  int pOutputImageHeight,
+						  int pCheckerboardParity, // The parity of the pixels that are rendered in checkerboard rendering, or -1 if all the pixels are rendered
+						  int pIsPersistentThreadsEnabled,
+						  __global uint *pNextRayBatchIndex, // The index of the next batch of work item coords that is taken with persistent threads, which must be 0 when the kernel starts
+						  __global uint2 *pOutputLaneStatisticsArray, // The number of traversal steps of the camera ray of every pixel, and the lane index of the work item that rendered it.
+																	   // It is only written if FORGE_MEASURE_LANE_UTILISATION is defined
+						  int pIsTiledPixelOrderEnabled, // Whether the work items of a batch of work item coords render them in Z-order, instead of row by row
+						  int3 pVoxelGridToroidalOffset, // Where the voxels are stored in memory, relative to the voxel grid. See the VoxelOctree struct
+						  __global const uint *pVoxelBrickFirstMaterialIndexArray)
+{
+	struct VoxelOctree voxelOctree;
+	voxelOctree.nodes = pVoxelOctreeNodesArray;
+	voxelOctree.voxelBricks = pVoxelBricksArray;
+	voxelOctree.voxelMaterials = pVoxelMaterialArray;
+	voxelOctree.voxelBrickFirstMaterialIndices = pVoxelBrickFirstMaterialIndexArray;
+	voxelOctree.depth = pVoxelOctreeDepth;
+	voxelOctree.toroidalOffset = pVoxelGridToroidalOffset;
+
+	// Get the resolution of the output image
+	int2 outputImageResolution;
+	outputImageResolution.x = pOutputImageWidth;
+	outputImageResolution.y = pOutputImageHeight;
+
+	// The work item coords only cover half of the image width in checkerboard rendering
+	const int workItemGridWidth = pCheckerboardParity >= 0 ? (outputImageResolution.x + 1) / 2 : outputImageResolution.x;
+	const uint numberOfRayBatchesAlongX = (workItemGridWidth + FORGE_RAY_BATCH_SIDE_LENGTH - 1) / FORGE_RAY_BATCH_SIDE_LENGTH;
+
+	if(!pIsPersistentThreadsEnabled)
+	{
+		// Get the coordinates of the pixel for which this kernel instance is being executed for
+		int2 workItemCoords;
+		if(pIsTiledPixelOrderEnabled)
+		{
+			workItemCoords = getRayBatchWorkItemCoords(get_global_id(0) / (FORGE_RAY_BATCH_SIDE_LENGTH * FORGE_RAY_BATCH_SIDE_LENGTH),
+													   get_global_id(0) % (FORGE_RAY_BATCH_SIDE_LENGTH * FORGE_RAY_BATCH_SIDE_LENGTH),
+													   numberOfRayBatchesAlongX,
+													   pIsTiledPixelOrderEnabled);
+		}
+		else
+		{
+			workItemCoords.x = get_global_id(0);
+			workItemCoords.y = get_global_id(1);
+		}
+
+		// The work items of a work group are packed into SIMD units in the order of their local IDs, with the first dimension changing the fastest
+		const uint localIndex = get_local_size(0) * get_local_id(1) + get_local_id(0);
+		const uint workGroupIndex = get_num_groups(0) * get_group_id(1) + get_group_id(0);
+		const uint laneIndex = get_local_size(0) * get_local_size(1) * workGroupIndex + localIndex;
+
+		renderPixelForWorkItem(workItemCoords,
+							   laneIndex,
+							   pCameraPosition,
+							   pCameraOrientationXAxis,
+							   pCameraOrientationYAxis,
+							   pCameraOrientationZAxis,
+							   pCameraVerticalFieldOfViewInDegrees,
+							   voxelOctree,
+							   pTexturesBuffer,
+							   pDebugAABBsArray,
+							   pDebugAABBArrayLength,
+							   pIsOctreeVisualizationEnabled,
+							   pOutputUchar4Framebuffer,
+							   pBeamDistancesArray,
+							   pOutputDepthBuffer,
+							   outputImageResolution,
+							   pCheckerboardParity,
+							   pOutputLaneStatisticsArray);
+		return;
+	}
+
+	const uint numberOfRayBatches = numberOfRayBatchesAlongX * ((outputImageResolution.y + FORGE_RAY_BATCH_SIDE_LENGTH - 1) / FORGE_RAY_BATCH_SIDE_LENGTH);
+	const uint localIndex = get_local_id(0);
+
+	__local uint currentRayBatchIndex;
+	while(true)
+	{
+		// One work item takes the next batch for the whole work group
+		if(localIndex == 0)
+		{
+			currentRayBatchIndex = atomic_inc(pNextRayBatchIndex);
+		}
+		barrier(CLK_LOCAL_MEM_FENCE);
+		const uint rayBatchIndex = currentRayBatchIndex;
+		// Every work item must have read the index of the batch before the next one is taken
+		barrier(CLK_LOCAL_MEM_FENCE);
+
+		if(rayBatchIndex >= numberOfRayBatches)
+		{
+			break;
+		}
+
+		const int2 workItemCoords = getRayBatchWorkItemCoords(rayBatchIndex, localIndex, numberOfRayBatchesAlongX, pIsTiledPixelOrderEnabled);
+
+		// Each batch is traced by the lanes of a new group of SIMD units, as far as the lane utilisation is concerned
+		renderPixelForWorkItem(workItemCoords,
+							   FORGE_RAY_BATCH_SIDE_LENGTH * FORGE_RAY_BATCH_SIDE_LENGTH * rayBatchIndex + localIndex,
+							   pCameraPosition,
+							   pCameraOrientationXAxis,
+							   pCameraOrientationYAxis,
+							   pCameraOrientationZAxis,
+							   pCameraVerticalFieldOfViewInDegrees,
+							   voxelOctree,
+							   pTexturesBuffer,
+							   pDebugAABBsArray,
+							   pDebugAABBArrayLength,
+							   pIsOctreeVisualizationEnabled,
+							   pOutputUchar4Framebuffer,
+							   pBeamDistancesArray,
+							   pOutputDepthBuffer,
+							   outputImageResolution,
+							   pCheckerboardParity,
+							   pOutputLaneStatisticsArray);
+	}
+}
+
+// This kernel gets executed for every pixel of the output framebuffer. It stretches the image that renderPixel rendered at a lower resolution over it.
+// The pixels at the edges of both images are seen through the same rays, so the input pixel coords are scaled by the number of pixels between the edges
+__kernel void upscaleFramebuffer(__global const uchar4 *pInputUchar4Framebuffer, // The framebuffer written by renderPixel
+								 int pInputImageWidth,
+								 int pInputImageHeight,
+								 __global uchar4 *pOutputUchar4Framebuffer)
+{
+	int2 pixelCoords;
+	pixelCoords.x = get_global_id(0);
+	pixelCoords.y = get_global_id(1);
+
+	int2 outputImageResolution;
+	outputImageResolution.x = get_global_size(0);
+	outputImageResolution.y = get_global_size(1);
+
+	int2 inputImageResolution;
+	inputImageResolution.x = pInputImageWidth;
+	inputImageResolution.y = pInputImageHeight;
+
+	// Blend the four input pixels around the point that the output pixel is at in the input image
+	const float2 inputPixelCoords = convert_float2(pixelCoords) * convert_float2(inputImageResolution - 1) / convert_float2(max(outputImageResolution - 1, 1));
+	const float2 inputPixelCoordsFloor = floor(inputPixelCoords);
+	const float2 blendFactors = inputPixelCoords - inputPixelCoordsFloor;
+	const int2 minInputPixelCoords = min(convert_int2(inputPixelCoordsFloor), inputImageResolution - 1);
+	const int2 maxInputPixelCoords = min(minInputPixelCoords + 1, inputImageResolution - 1);
+
+	const float4 bottomLeftColor = convert_float4(pInputUchar4Framebuffer[inputImageResolution.x * minInputPixelCoords.y + minInputPixelCoords.x]);
+	const float4 bottomRightColor = convert_float4(pInputUchar4Framebuffer[inputImageResolution.x * minInputPixelCoords.y + maxInputPixelCoords.x]);
+	const float4 topLeftColor = convert_float4(pInputUchar4Framebuffer[inputImageResolution.x * maxInputPixelCoords.y + minInputPixelCoords.x]);
+	const float4 topRightColor = convert_float4(pInputUchar4Framebuffer[inputImageResolution.x * maxInputPixelCoords.y + maxInputPixelCoords.x]);
+	const float4 pixelColor = mix(mix(bottomLeftColor, bottomRightColor, blendFactors.x), mix(topLeftColor, topRightColor, blendFactors.x), blendFactors.y);
+
+	pOutputUchar4Framebuffer[outputImageResolution.x * pixelCoords.y + pixelCoords.x] = convert_uchar4_sat(pixelColor + 0.5f);
+}
+
+// This kernel gets executed in checkerboard rendering for every pixel that renderPixel did not render in this frame, after renderPixel.
+// The point that the pixel sees is assumed to be at the distance of the nearest of the neighbouring pixels, which were all rendered in this frame.
+// The color of the pixel is taken from the pixel of the previous frame that the point was seen through, if that pixel saw a voxel at about the same distance.
+// Otherwise the point was not visible in the previous frame, and the color of the pixel is blended from the colors of its neighbours
+__kernel void reconstructCheckerboard(float3 pPreviousCameraPosition, // The position of the camera in world space in the previous frame
+									  float3 pPreviousCameraOrientationXAxis, // The x axis basis vector of the camera orientation in the previous frame
+									  float3 pPreviousCameraOrientationYAxis, // The y axis basis vector of the camera orientation in the previous frame
+									  float3 pPreviousCameraOrientationZAxis, // The z axis basis vector of the camera orientation in the previous frame
+									  float pPreviousCameraVerticalFieldOfViewInDegrees, // The vertical field of view of the camera in the previous frame, specified in degrees
+									  float3 pCameraPosition, // The position of the camera in world space
+									  float3 pCameraOrientationXAxis, // The x axis basis vector of the camera orientation
+									  float3 pCameraOrientationYAxis, // The y axis basis vector of the camera orientation
+									  float3 pCameraOrientationZAxis, // The z axis basis vector of the camera orientation
+									  float pCameraVerticalFieldOfViewInDegrees, // The vertical field of view of the camera, specified in degrees
+									  int pOutputImageWidth,
+									  int pOutputImageHeight,
+									  int pCheckerboardParity, // The parity of the pixels that renderPixel rendered in this frame
+									  int pIsPreviousFrameValid, // Whether the previous frame was rendered at the same resolution, and the voxels have not moved since then
+									  __global const uchar4 *pPreviousUchar4Framebuffer,
+									  __global const float *pPreviousDepthBuffer,
+									  __global uchar4 *pOutputUchar4Framebuffer, // The framebuffer that renderPixel rendered the other pixels to in this frame
+									  __global float *pOutputDepthBuffer)
+{
+	int2 outputImageResolution;
+	outputImageResolution.x = pOutputImageWidth;
+	outputImageResolution.y = pOutputImageHeight;
+
+	int2 workItemCoords;
+	workItemCoords.x = get_global_id(0);
+	workItemCoords.y = get_global_id(1);
+	const int2 pixelCoords = getCheckerboardPixelCoords(workItemCoords, 1 - pCheckerboardParity);
+	if(pixelCoords.x >= outputImageResolution.x)
+	{
+		return;
+	}
+
+	// The pixels to the left, right, bottom and top of the pixel have the other parity
+	int2 neighbourPixelOffsets[4];
+	neighbourPixelOffsets[0] = (int2)(-1, 0);
+	neighbourPixelOffsets[1] = (int2)(1, 0);
+	neighbourPixelOffsets[2] = (int2)(0, -1);
+	neighbourPixelOffsets[3] = (int2)(0, 1);
+
+	float4 neighbourColorSum = (float4)(0.0f, 0.0f, 0.0f, 0.0f);
+	float numberOfNeighbours = 0.0f;
+	float minNeighbourHitDistance = MAXFLOAT;
+	bool areNeighbourHitDistancesKnown = true;
+	for(int i = 0; i < 4; ++i)
+	{
+		const int2 neighbourPixelCoords = pixelCoords + neighbourPixelOffsets[i];
+		if(neighbourPixelCoords.x < 0 || neighbourPixelCoords.y < 0 || neighbourPixelCoords.x >= outputImageResolution.x || neighbourPixelCoords.y >= outputImageResolution.y)
+		{
+			continue;
+		}
+
+		const int neighbourPixelIndex = outputImageResolution.x * neighbourPixelCoords.y + neighbourPixelCoords.x;
+		neighbourColorSum += convert_float4(pOutputUchar4Framebuffer[neighbourPixelIndex]);
+		numberOfNeighbours += 1.0f;
+
+		// The hit distance is not known for some pixels
+		const float neighbourHitDistance = pOutputDepthBuffer[neighbourPixelIndex];
+		areNeighbourHitDistancesKnown = areNeighbourHitDistancesKnown && (neighbourHitDistance > 0.0f);
+		minNeighbourHitDistance = fmin(minNeighbourHitDistance, neighbourHitDistance);
+	}
+
+	float4 pixelColor = neighbourColorSum / numberOfNeighbours;
+	if(pIsPreviousFrameValid && areNeighbourHitDistancesKnown)
+	{
+		const struct Ray cameraRay = getCameraRayForPixel(pCameraPosition,
+														  pCameraOrientationXAxis,
+														  pCameraOrientationYAxis,
+														  pCameraOrientationZAxis,
+														  pCameraVerticalFieldOfViewInDegrees,
+														  pixelCoords,
+														  outputImageResolution);
+
+		// The points that are infinitely far away are only rotated by the camera
+		float3 directionToPointFromPreviousCamera = cameraRay.direction;
+		if(minNeighbourHitDistance < MAXFLOAT)
+		{
+			directionToPointFromPreviousCamera = cameraRay.origin + cameraRay.direction * minNeighbourHitDistance - pPreviousCameraPosition;
+		}
+
+		float2 previousPixelCoords;
+		if(getPixelCoordsForCameraDirection(directionToPointFromPreviousCamera,
+											pPreviousCameraOrientationXAxis,
+											pPreviousCameraOrientationYAxis,
+											pPreviousCameraOrientationZAxis,
+											pPreviousCameraVerticalFieldOfViewInDegrees,
+											outputImageResolution,
+											&previousPixelCoords))
+		{
+			previousPixelCoords = floor(previousPixelCoords + 0.5f);
+			if(previousPixelCoords.x >= 0.0f && previousPixelCoords.y >= 0.0f &&
+			   previousPixelCoords.x <= (float)(outputImageResolution.x - 1) && previousPixelCoords.y <= (float)(outputImageResolution.y - 1))
+			{
+				const int previousPixelIndex = outputImageResolution.x * (int)(previousPixelCoords.y) + (int)(previousPixelCoords.x);
+				const float previousHitDistance = pPreviousDepthBuffer[previousPixelIndex];
+
+				// The previous pixel must have seen the point, and not something in front of or behind it
+				bool didPreviousPixelSeePoint = (previousHitDistance >= MAXFLOAT);
+				if(minNeighbourHitDistance < MAXFLOAT)
+				{
+					const float distanceToPointFromPreviousCamera = length(directionToPointFromPreviousCamera);
+					didPreviousPixelSeePoint = (previousHitDistance > 0.0f) &&
+											   (fabs(previousHitDistance - distanceToPointFromPreviousCamera) <= FORGE_CHECKERBOARD_MAX_HIT_DISTANCE_DIFFERENCE + distanceToPointFromPreviousCamera * FORGE_CHECKERBOARD_MAX_RELATIVE_HIT_DISTANCE_DIFFERENCE);
+				}
+
+				if(didPreviousPixelSeePoint)
+				{
+					pixelColor = convert_float4(pPreviousUchar4Framebuffer[previousPixelIndex]);
+				}
+			}
+		}
+	}
+
+	// The distance of the nearest neighbour is used for the reprojection of the depth buffer in the next frame, since the rays of the neighbours hit voxels there
+	const int pixelIndex = outputImageResolution.x * pixelCoords.y + pixelCoords.x;
+	pOutputUchar4Framebuffer[pixelIndex] = convert_uchar4_sat(pixelColor + 0.5f);
+	pOutputDepthBuffer[pixelIndex] = areNeighbourHitDistancesKnown ? minNeighbourHitDistance : 0.0f;
 }
\ No newline at end of file
@@ -0,0 +1,689 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <Forge/Source/Core/Logging.h>
+#include <Forge/Source/Platform/OpenCL/OpenCLUtility.h>
+#include <VoxelRaytracer/Source/Rendering/OpenCLRenderer/Kernels/DirtTextureKernel.h>
+
+namespace forge
+{
+	namespace
+	{
+		// Get the value below which the given percentage of the sorted values fall, using the nearest rank method
+		Int64 getPercentile(const ResizableArray<Int64> &pSortedValues, Double pPercentage)
+		{
+			if(pSortedValues.getNumberOfElements() == 0)
+			{
+				return 0;
+			}
+
+			SizeType rank = static_cast<SizeType>(std::ceil(pPercentage / 100.0 * static_cast<Double>(pSortedValues.getNumberOfElements())));
+			rank = clamp<SizeType>(rank, 1, pSortedValues.getNumberOfElements());
+			return pSortedValues[rank - 1];
+		}
+
+		Double convertNanosecondsToMilliseconds(Int64 pNanoseconds)
+		{
+			return static_cast<Double>(pNanoseconds) / 1000000.0;
+		}
+	}
+
+	bool Benchmark::run(const Settings &pSettings)
+	{
+		this->settings = pSettings;
+
+		if(this->settings.cameraPathFilePath)
+		{
+			if(!this->cameraPath.loadFromFile(this->settings.cameraPathFilePath))
+			{
+				FORGE_ERROR_LOG("Could not load the camera path from ", this->settings.cameraPathFilePath);
+				return false;
+			}
+		}
+		else
+		{
+			this->cameraPath.createOrbit(200.0f, 80.0f, 15.0f, 64);
+		}
+
+		this->startup();
+
+		// The world is always generated once before the first frame
+		Float worldOffset = 0.0f;
+		FrameTimings initialGenerationTimings;
+		const std::chrono::steady_clock::time_point initialGenerationStartTime = std::chrono::steady_clock::now();
+		this->worldGenerator->generateWorld(worldOffset);
+		this->endFrame(initialGenerationStartTime, initialGenerationTimings);
+
+		if(this->settings.isSparseVoxelOctreeEnabled)
+		{
+			this->createSparseVoxelOctree();
+		}
+
+		ResizableArray<FrameTimings> frameTimings(this->settings.numberOfFrames);
+		const SizeType totalNumberOfFrames = this->settings.numberOfWarmUpFrames + this->settings.numberOfFrames;
+		for(SizeType i = 0; i < totalNumberOfFrames; ++i)
+		{
+			// The warm up frames all use the start of the path
+			const bool isWarmUpFrame = i < this->settings.numberOfWarmUpFrames;
+			Float pathParam = 0.0f;
+			if(!isWarmUpFrame && this->settings.numberOfFrames > 1)
+			{
+				pathParam = static_cast<Float>(i - this->settings.numberOfWarmUpFrames) / static_cast<Float>(this->settings.numberOfFrames - 1);
+			}
+
+			FrameTimings currentFrameTimings;
+			const std::chrono::steady_clock::time_point frameStartTime = std::chrono::steady_clock::now();
+
+			if(this->settings.shouldRegenerateWorldEveryFrame)
+			{
+				worldOffset += this->settings.worldOffsetIncreasePerFrame;
+				this->worldGenerator->generateWorld(worldOffset);
+			}
+
+			this->renderFrame(this->cameraPath.getCoordinateSpace(pathParam));
+
+			this->endFrame(frameStartTime, currentFrameTimings);
+
+			// The lane statistics are read back after the frame has ended, so that reading them does not add to the frame time
+			if(this->settings.isLaneUtilisationMeasured)
+			{
+				currentFrameTimings.laneUtilisation = this->calculateLaneUtilisation();
+			}
+
+			if(!isWarmUpFrame)
+			{
+				frameTimings[i - this->settings.numberOfWarmUpFrames] = currentFrameTimings;
+			}
+		}
+
+		const bool wereResultsWritten = this->writeResults(initialGenerationTimings, frameTimings);
+
+		this->shutdown();
+
+		return wereResultsWritten;
+	}
+
+	void Benchmark::startup()
+	{
+		// The stages of the frames are timed with the events of the profiler, which needs a command queue with profiling enabled
+		this->openCLManager = new OpenCLManager();
+		this->openCLManager->startup(true);
+
+		this->voxelGrid = new VoxelGrid(this->settings.octreeDepth);
+
+		// Used to store the return code from OpenCL functions
+		cl_int returnCode;
+
+		this->kernelVoxelDataBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_WRITE, sizeof(UInt8) * this->voxelGrid->getOctreeNodeChildMaskArray()->getNumberOfElements(), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		// All the nodes, voxel bricks and first material indices are written when the world is generated, including the root node. The voxel material buffer
+		// is created by the world generator
+		this->kernelVoxelBrickBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_WRITE, sizeof(UInt64) * this->voxelGrid->getVoxelBrickArray()->getNumberOfElements(), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		this->kernelVoxelBrickFirstMaterialIndexBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_WRITE, sizeof(UInt32) * this->voxelGrid->getVoxelBrickFirstMaterialIndexArray()->getNumberOfElements(), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+
+		this->worldGenerator = new WorldGenerator();
+		this->worldGenerator->startup(this->openCLManager, this->voxelGrid, this->kernelVoxelDataBuffer, this->kernelVoxelBrickBuffer, this->kernelVoxelBrickFirstMaterialIndexBuffer);
+
+		this->kernelTexturesBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_ONLY, sizeof(Float) * this->textureSize * this->textureSize * 255, NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		this->generateTextures();
+
+		// The frame is read back into host memory laid out in the same way as a Framebuffer, with 4 bytes per pixel
+		this->framebufferPixels.setNumberOfElements(static_cast<SizeType>(this->settings.resolutionWidth) * static_cast<SizeType>(this->settings.resolutionHeight) * 4);
+		this->kernelUInt8FrameBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_WRITE_ONLY, this->framebufferPixels.getNumberOfElements(), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+
+		// No debug AABBs are drawn, but the kernel still needs a valid buffer
+		this->kernelDebugAABBsBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_ONLY, sizeof(cl_float3) * 3, NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+
+		// One beam distance for every tile of pixels. The tiles at the right and top edges of the image may be cut off by it
+		this->numberOfBeamTilesAlongX = (static_cast<SizeType>(this->settings.resolutionWidth) + TraceBeamKernel::tileSize - 1) / TraceBeamKernel::tileSize;
+		this->numberOfBeamTilesAlongY = (static_cast<SizeType>(this->settings.resolutionHeight) + TraceBeamKernel::tileSize - 1) / TraceBeamKernel::tileSize;
+		this->kernelBeamDistancesBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_WRITE, sizeof(Float) * this->numberOfBeamTilesAlongX * this->numberOfBeamTilesAlongY, NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		// Without the beam pre-pass, every camera ray starts at the camera
+		if(!this->settings.isBeamPrePassEnabled)
+		{
+			ResizableArray<Float> zeroBeamDistances(this->numberOfBeamTilesAlongX * this->numberOfBeamTilesAlongY);
+			for(SizeType i = 0; i < zeroBeamDistances.getNumberOfElements(); ++i)
+			{
+				zeroBeamDistances[i] = 0.0f;
+			}
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueWriteBuffer(this->openCLManager->getCommandQueue(), this->kernelBeamDistancesBuffer, CL_BLOCKING, 0, sizeof(Float) * zeroBeamDistances.getNumberOfElements(), &zeroBeamDistances[0], 0, NULL, NULL));
+		}
+
+		this->kernelNextRayBatchIndexBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_WRITE, sizeof(cl_uint), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		if(this->settings.isLaneUtilisationMeasured)
+		{
+			this->laneStatistics.setNumberOfElements(static_cast<SizeType>(this->settings.resolutionWidth) * static_cast<SizeType>(this->settings.resolutionHeight));
+			this->kernelLaneStatisticsBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_WRITE_ONLY, sizeof(cl_uint2) * this->laneStatistics.getNumberOfElements(), NULL, &returnCode);
+			FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+
+			// The batches of pixels of persistent threads reach past the edges of the image, so they have the most lanes.
+			// The lane indices of the dispatch with one work item for every pixel only go up to the number of pixels
+			const SizeType rayBatchSize = RenderPixelKernel::rayBatchSideLength * RenderPixelKernel::rayBatchSideLength;
+			const SizeType numberOfRayBatches = RenderPixelKernel::getNumberOfRayBatches(this->settings.resolutionWidth, this->settings.resolutionHeight, false);
+			const SizeType numberOfSIMDUnits = (numberOfRayBatches * rayBatchSize + this->settings.simdWidth - 1) / this->settings.simdWidth;
+			this->simdUnitSumsOfTraversalSteps.setNumberOfElements(numberOfSIMDUnits);
+			this->simdUnitMaxNumbersOfTraversalSteps.setNumberOfElements(numberOfSIMDUnits);
+		}
+
+		this->kernelDepthBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_WRITE, sizeof(Float) * static_cast<SizeType>(this->settings.resolutionWidth) * static_cast<SizeType>(this->settings.resolutionHeight), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		this->kernelReprojectedDepthTilesBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_WRITE, sizeof(ReprojectDepthKernel::ReprojectedDepthTile) * this->numberOfBeamTilesAlongX * this->numberOfBeamTilesAlongY, NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		// The tiles are cleared by the traceBeam kernel every frame after it has read them, so they only need to be cleared here once
+		{
+			ResizableArray<ReprojectDepthKernel::ReprojectedDepthTile> clearedReprojectedDepthTiles(this->numberOfBeamTilesAlongX * this->numberOfBeamTilesAlongY);
+			for(SizeType i = 0; i < clearedReprojectedDepthTiles.getNumberOfElements(); ++i)
+			{
+				clearedReprojectedDepthTiles[i] = ReprojectDepthKernel::getClearedReprojectedDepthTile();
+			}
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueWriteBuffer(this->openCLManager->getCommandQueue(), this->kernelReprojectedDepthTilesBuffer, CL_BLOCKING, 0, sizeof(ReprojectDepthKernel::ReprojectedDepthTile) * clearedReprojectedDepthTiles.getNumberOfElements(), &clearedReprojectedDepthTiles[0], 0, NULL, NULL));
+		}
+
+		TextFileEditor renderPixelKernelTextEditor;
+		renderPixelKernelTextEditor.openFile("ForgeData/OpenCL/Kernels/Renderer.cl");
+		std::string renderPixelKernelBuildOptions;
+		if(this->settings.isSparseVoxelOctreeEnabled)
+		{
+			renderPixelKernelBuildOptions += " -D FORGE_SPARSE_VOXEL_OCTREE";
+		}
+		if(this->settings.isLaneUtilisationMeasured)
+		{
+			renderPixelKernelBuildOptions += " -D FORGE_MEASURE_LANE_UTILISATION";
+		}
+		this->renderPixelKernel = new RenderPixelKernel(this->openCLManager,
+														&renderPixelKernelTextEditor,
+														"renderPixel",
+														renderPixelKernelBuildOptions.empty()? nullptr : renderPixelKernelBuildOptions.c_str());
+		// The sparse voxel octree buffers are set once the world has been generated, and so is the voxel material buffer of the dense voxel octree,
+		// which the world generator creates again whenever the world outgrows it
+		if(!this->settings.isSparseVoxelOctreeEnabled)
+		{
+			this->renderPixelKernel->setKernelVoxelArrayBuffer(this->kernelVoxelDataBuffer);
+			this->renderPixelKernel->setKernelVoxelBrickArrayBuffer(this->kernelVoxelBrickBuffer);
+			this->renderPixelKernel->setKernelVoxelBrickFirstMaterialIndexArrayBuffer(this->kernelVoxelBrickFirstMaterialIndexBuffer);
+		}
+		this->renderPixelKernel->setVoxelOctreeDepth(this->voxelGrid->getOctreeDepth());
+		this->renderPixelKernel->setKernelTexturesBuffer(this->kernelTexturesBuffer);
+		this->renderPixelKernel->setKernelDebugAABBsBuffer(this->kernelDebugAABBsBuffer);
+		this->renderPixelKernel->setNumberOfDebugAABBs(0);
+		this->renderPixelKernel->setIsOctreeVisualizationEnabled(this->settings.isOctreeVisualizationEnabled);
+		this->renderPixelKernel->setCameraVerticalFieldOfViewInDegrees(this->settings.cameraVerticalFieldOfViewInDegrees);
+		this->renderPixelKernel->setOutputUInt8Framebuffer(this->kernelUInt8FrameBuffer);
+		this->renderPixelKernel->setKernelBeamDistancesBuffer(this->kernelBeamDistancesBuffer);
+		this->renderPixelKernel->setOutputDepthBuffer(this->kernelDepthBuffer);
+		this->renderPixelKernel->setOutputImageResolution(this->settings.resolutionWidth, this->settings.resolutionHeight);
+		// Every pixel is rendered in every frame, so the frames do not depend on each other
+		this->renderPixelKernel->setCheckerboardParity(-1);
+		this->renderPixelKernel->setIsPersistentThreadsEnabled(this->settings.isPersistentThreadsEnabled);
+		this->renderPixelKernel->setKernelNextRayBatchIndexBuffer(this->kernelNextRayBatchIndexBuffer);
+		this->renderPixelKernel->setOutputLaneStatisticsBuffer(this->kernelLaneStatisticsBuffer);
+		this->renderPixelKernel->setIsTiledPixelOrderEnabled(this->settings.isTiledPixelOrderEnabled);
+		// The whole world is generated every time, so the voxels are stored without a toroidal offset
+		this->renderPixelKernel->setVoxelGridToroidalOffset(IntegerVector3<Int32>(0, 0, 0));
+
+		this->traceBeamKernel = new TraceBeamKernel(this->openCLManager,
+													&renderPixelKernelTextEditor,
+													"traceBeam",
+													this->settings.isSparseVoxelOctreeEnabled? "-D FORGE_SPARSE_VOXEL_OCTREE" : nullptr);
+		if(!this->settings.isSparseVoxelOctreeEnabled)
+		{
+			this->traceBeamKernel->setKernelVoxelArrayBuffer(this->kernelVoxelDataBuffer);
+		}
+		this->traceBeamKernel->setVoxelOctreeDepth(this->voxelGrid->getOctreeDepth());
+		this->traceBeamKernel->setCameraVerticalFieldOfViewInDegrees(this->settings.cameraVerticalFieldOfViewInDegrees);
+		this->traceBeamKernel->setOutputImageResolution(this->settings.resolutionWidth, this->settings.resolutionHeight);
+		this->traceBeamKernel->setOutputBeamDistancesBuffer(this->kernelBeamDistancesBuffer);
+		this->traceBeamKernel->setKernelReprojectedDepthTilesBuffer(this->kernelReprojectedDepthTilesBuffer);
+		// The voxels are only changed by generating the whole world again, and the depth buffer is not reprojected then
+		this->traceBeamKernel->setChangedVoxelsAABB(false, AABB());
+		this->traceBeamKernel->setVoxelGridToroidalOffset(IntegerVector3<Int32>(0, 0, 0));
+
+		this->reprojectDepthKernel = new ReprojectDepthKernel(this->openCLManager,
+															  &renderPixelKernelTextEditor,
+															  "reprojectDepth");
+		this->reprojectDepthKernel->setPreviousCameraVerticalFieldOfViewInDegrees(this->settings.cameraVerticalFieldOfViewInDegrees);
+		this->reprojectDepthKernel->setCameraVerticalFieldOfViewInDegrees(this->settings.cameraVerticalFieldOfViewInDegrees);
+		this->reprojectDepthKernel->setKernelPreviousDepthBuffer(this->kernelDepthBuffer);
+		this->reprojectDepthKernel->setOutputReprojectedDepthTilesBuffer(this->kernelReprojectedDepthTilesBuffer);
+
+		FORGE_OPENCL_ERROR_CODE_CHECK(clFinish(this->openCLManager->getCommandQueue()));
+	}
+
+	void Benchmark::shutdown()
+	{
+		delete this->renderPixelKernel;
+		delete this->traceBeamKernel;
+		delete this->reprojectDepthKernel;
+
+		if(this->kernelSparseVoxelOctreeNodesBuffer)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelSparseVoxelOctreeNodesBuffer));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelSparseVoxelOctreeVoxelBricksBuffer));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelSparseVoxelOctreeVoxelBrickFirstMaterialIndicesBuffer));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelSparseVoxelOctreeVoxelMaterialsBuffer));
+		}
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelBeamDistancesBuffer));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelNextRayBatchIndexBuffer));
+		if(this->kernelLaneStatisticsBuffer)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelLaneStatisticsBuffer));
+		}
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelDepthBuffer));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelReprojectedDepthTilesBuffer));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelDebugAABBsBuffer));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelUInt8FrameBuffer));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelTexturesBuffer));
+
+		this->worldGenerator->shutdown();
+		delete this->worldGenerator;
+
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelVoxelDataBuffer));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelVoxelBrickBuffer));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelVoxelBrickFirstMaterialIndexBuffer));
+
+		delete this->voxelGrid;
+
+		this->openCLManager->shutdown();
+		delete this->openCLManager;
+	}
+
+	void Benchmark::generateTextures()
+	{
+		TextFileEditor dirtTextureTextEditor;
+		dirtTextureTextEditor.openFile("ForgeData/OpenCL/Kernels/DirtTexture.cl");
+
+		DirtTextureKernel dirtTextureKernel(this->openCLManager, &dirtTextureTextEditor, "dirtTextureKernel");
+		dirtTextureKernel.setTextureBuffer(this->kernelTexturesBuffer);
+		dirtTextureKernel.setTextureIndex(0);
+
+		// Run the kernel
+		size_t globalWorkSize[2];
+		globalWorkSize[0] = static_cast<size_t>(this->textureSize);
+		globalWorkSize[1] = static_cast<size_t>(this->textureSize);
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->openCLManager->getCommandQueue(), dirtTextureKernel.getKernel(), 2, NULL, globalWorkSize, NULL, 0, NULL, NULL));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clFinish(this->openCLManager->getCommandQueue()));
+	}
+
+	void Benchmark::endFrame(std::chrono::steady_clock::time_point pFrameStartTime, FrameTimings &pFrameTimings)
+	{
+		OpenCLProfiler *profiler = this->openCLManager->getProfiler();
+		profiler->endFrame();
+		pFrameTimings.totalTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - pFrameStartTime).count();
+
+		OpenCLProfiler::FrameProfile frameProfile;
+		if(!profiler->getRecordedFrame(0, frameProfile))
+		{
+			return;
+		}
+
+		for(SizeType i = 0; i < frameProfile.numberOfCommands; ++i)
+		{
+			const OpenCLProfiler::CommandTimings &commandTimings = frameProfile.commandTimings[i];
+			const Int64 commandTime = static_cast<Int64>(commandTimings.endTime - commandTimings.startTime);
+
+			// The node levels are stored from the root level down, but generated from the bottom up. The levels from the first one generated with the voxels down
+			// are included in the time of the voxels, and the top levels are generated together and their time is given to the lowest of them, so the times of the others stay 0
+			const SizeType generateNodesCommandNamePrefixLength = std::strlen("generateNodes level ");
+			const bool isGenerateNodesCommand = std::strncmp(commandTimings.name, "generateNodes level ", generateNodesCommandNamePrefixLength) == 0;
+			const bool isGenerateTopNodeLevelsCommand = std::strcmp(commandTimings.name, "generateTopNodeLevels") == 0;
+			if(isGenerateNodesCommand || isGenerateTopNodeLevelsCommand)
+			{
+				if(pFrameTimings.generateNodesTimes.getNumberOfElements() == 0)
+				{
+					pFrameTimings.generateNodesTimes.setNumberOfElements(this->voxelGrid->getVoxelBrickLevel());
+					for(SizeType i2 = 0; i2 < pFrameTimings.generateNodesTimes.getNumberOfElements(); ++i2)
+					{
+						pFrameTimings.generateNodesTimes[i2] = 0;
+					}
+				}
+
+				UInt32 octreeLevel = 0;
+				if(isGenerateNodesCommand)
+				{
+					octreeLevel = static_cast<UInt32>(std::strtoul(commandTimings.name + generateNodesCommandNamePrefixLength, nullptr, 10));
+				}
+				else
+				{
+					for(UInt32 i2 = this->worldGenerator->getFirstOctreeLevelGeneratedWithVoxels(); i2 != 0; --i2)
+					{
+						if(this->worldGenerator->getIsTopOctreeLevel(i2 - 1))
+						{
+							octreeLevel = i2 - 1;
+							break;
+						}
+					}
+				}
+				pFrameTimings.generateNodesTimes[octreeLevel] += commandTime;
+			}
+			else if(std::strcmp(commandTimings.name, "generateVoxels") == 0)
+			{
+				pFrameTimings.generateVoxelsTime += commandTime;
+			}
+			else if(std::strcmp(commandTimings.name, "reprojectDepth") == 0)
+			{
+				pFrameTimings.reprojectDepthTime += commandTime;
+			}
+			else if(std::strcmp(commandTimings.name, "traceBeam") == 0)
+			{
+				pFrameTimings.traceBeamTime += commandTime;
+			}
+			else if(std::strcmp(commandTimings.name, "renderPixel") == 0)
+			{
+				pFrameTimings.renderTime += commandTime;
+			}
+			else if(std::strcmp(commandTimings.name, "readBackFramebuffer") == 0)
+			{
+				pFrameTimings.readBackTime += commandTime;
+			}
+		}
+	}
+
+	void Benchmark::createSparseVoxelOctree()
+	{
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(this->openCLManager->getCommandQueue(),
+														  this->kernelVoxelDataBuffer,
+														  CL_BLOCKING,
+														  0,
+														  sizeof(UInt8) * this->voxelGrid->getOctreeNodeChildMaskArray()->getNumberOfElements(),
+														  &(*this->voxelGrid->getOctreeNodeChildMaskArray())[0],
+														  0,
+														  NULL,
+														  NULL));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(this->openCLManager->getCommandQueue(),
+														  this->kernelVoxelBrickBuffer,
+														  CL_BLOCKING,
+														  0,
+														  sizeof(UInt64) * this->voxelGrid->getVoxelBrickArray()->getNumberOfElements(),
+														  &(*this->voxelGrid->getVoxelBrickArray())[0],
+														  0,
+														  NULL,
+														  NULL));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(this->openCLManager->getCommandQueue(),
+														  this->kernelVoxelBrickFirstMaterialIndexBuffer,
+														  CL_BLOCKING,
+														  0,
+														  sizeof(UInt32) * this->voxelGrid->getVoxelBrickFirstMaterialIndexArray()->getNumberOfElements(),
+														  &(*this->voxelGrid->getVoxelBrickFirstMaterialIndexArray())[0],
+														  0,
+														  NULL,
+														  NULL));
+		// The world has just been generated whole, so all the allocated voxel data fits in the voxel material buffer
+		this->voxelGrid->setNumberOfVoxelMaterials(this->worldGenerator->getNumberOfAllocatedVoxelMaterials());
+		// Reading zero bytes is not allowed
+		if(this->voxelGrid->getNumberOfVoxelMaterials() > 0)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(this->openCLManager->getCommandQueue(),
+															  this->worldGenerator->getKernelVoxelMaterialBuffer(),
+															  CL_BLOCKING,
+															  0,
+															  sizeof(VoxelData) * this->voxelGrid->getNumberOfVoxelMaterials(),
+															  &(*this->voxelGrid->getVoxelMaterialArray())[0],
+															  0,
+															  NULL,
+															  NULL));
+		}
+
+		this->sparseVoxelOctree.build(*this->voxelGrid);
+		const ResizableArray<SparseVoxelOctree::Node> &nodeArray = *this->sparseVoxelOctree.getNodeArray();
+		const ResizableArray<UInt64> &voxelBrickArray = *this->sparseVoxelOctree.getVoxelBrickArray();
+		const ResizableArray<UInt32> &voxelBrickFirstMaterialIndexArray = *this->sparseVoxelOctree.getVoxelBrickFirstMaterialIndexArray();
+		const ResizableArray<VoxelData> &voxelMaterialArray = *this->sparseVoxelOctree.getVoxelMaterialArray();
+
+		// Used to store the return code from OpenCL functions
+		cl_int returnCode;
+
+		// Creating a buffer of zero bytes is not allowed, so the voxel brick buffers always have room for at least one voxel brick
+		this->kernelSparseVoxelOctreeNodesBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_ONLY, sizeof(SparseVoxelOctree::Node) * nodeArray.getNumberOfElements(), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		this->kernelSparseVoxelOctreeVoxelBricksBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_ONLY, sizeof(UInt64) * max<SizeType>(voxelBrickArray.getNumberOfElements(), 1), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		this->kernelSparseVoxelOctreeVoxelBrickFirstMaterialIndicesBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_ONLY, sizeof(UInt32) * max<SizeType>(voxelBrickFirstMaterialIndexArray.getNumberOfElements(), 1), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		this->kernelSparseVoxelOctreeVoxelMaterialsBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_ONLY, sizeof(VoxelData) * max<SizeType>(voxelMaterialArray.getNumberOfElements(), 1), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueWriteBuffer(this->openCLManager->getCommandQueue(), this->kernelSparseVoxelOctreeNodesBuffer, CL_BLOCKING, 0, sizeof(SparseVoxelOctree::Node) * nodeArray.getNumberOfElements(), &nodeArray[0], 0, NULL, NULL));
+		// Writing zero bytes is not allowed
+		if(voxelBrickArray.getNumberOfElements() > 0)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueWriteBuffer(this->openCLManager->getCommandQueue(), this->kernelSparseVoxelOctreeVoxelBricksBuffer, CL_BLOCKING, 0, sizeof(UInt64) * voxelBrickArray.getNumberOfElements(), &voxelBrickArray[0], 0, NULL, NULL));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueWriteBuffer(this->openCLManager->getCommandQueue(), this->kernelSparseVoxelOctreeVoxelBrickFirstMaterialIndicesBuffer, CL_BLOCKING, 0, sizeof(UInt32) * voxelBrickFirstMaterialIndexArray.getNumberOfElements(), &voxelBrickFirstMaterialIndexArray[0], 0, NULL, NULL));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueWriteBuffer(this->openCLManager->getCommandQueue(), this->kernelSparseVoxelOctreeVoxelMaterialsBuffer, CL_BLOCKING, 0, sizeof(VoxelData) * voxelMaterialArray.getNumberOfElements(), &voxelMaterialArray[0], 0, NULL, NULL));
+		}
+
+		this->renderPixelKernel->setKernelVoxelArrayBuffer(this->kernelSparseVoxelOctreeNodesBuffer);
+		this->renderPixelKernel->setKernelVoxelBrickArrayBuffer(this->kernelSparseVoxelOctreeVoxelBricksBuffer);
+		this->renderPixelKernel->setKernelVoxelBrickFirstMaterialIndexArrayBuffer(this->kernelSparseVoxelOctreeVoxelBrickFirstMaterialIndicesBuffer);
+		this->renderPixelKernel->setKernelVoxelMaterialArrayBuffer(this->kernelSparseVoxelOctreeVoxelMaterialsBuffer);
+		this->traceBeamKernel->setKernelVoxelArrayBuffer(this->kernelSparseVoxelOctreeNodesBuffer);
+	}
+
+	void Benchmark::renderFrame(const CoordinateSpace &pCameraCoordinateSpace)
+	{
+		// The world generator creates the voxel material buffer again whenever the world outgrows it
+		if(!this->settings.isSparseVoxelOctreeEnabled)
+		{
+			this->renderPixelKernel->setKernelVoxelMaterialArrayBuffer(this->worldGenerator->getKernelVoxelMaterialBuffer());
+		}
+		this->renderPixelKernel->setCameraPosition(pCameraCoordinateSpace.position);
+		this->renderPixelKernel->setCameraOrientationXAxis(pCameraCoordinateSpace.orientation.getXAxis());
+		this->renderPixelKernel->setCameraOrientationYAxis(pCameraCoordinateSpace.orientation.getYAxis());
+		this->renderPixelKernel->setCameraOrientationZAxis(pCameraCoordinateSpace.orientation.getZAxis());
+
+		// Reproject the depth buffer of the previous frame into the tiles that the beams read
+		if(this->settings.isBeamPrePassEnabled && this->settings.isDepthReprojectionEnabled && this->isPreviousDepthBufferValid)
+		{
+			this->reprojectDepthKernel->setPreviousCameraPosition(this->previousCameraCoordinateSpace.position);
+			this->reprojectDepthKernel->setPreviousCameraOrientationXAxis(this->previousCameraCoordinateSpace.orientation.getXAxis());
+			this->reprojectDepthKernel->setPreviousCameraOrientationYAxis(this->previousCameraCoordinateSpace.orientation.getYAxis());
+			this->reprojectDepthKernel->setPreviousCameraOrientationZAxis(this->previousCameraCoordinateSpace.orientation.getZAxis());
+			this->reprojectDepthKernel->setCameraPosition(pCameraCoordinateSpace.position);
+			this->reprojectDepthKernel->setCameraOrientationXAxis(pCameraCoordinateSpace.orientation.getXAxis());
+			this->reprojectDepthKernel->setCameraOrientationYAxis(pCameraCoordinateSpace.orientation.getYAxis());
+			this->reprojectDepthKernel->setCameraOrientationZAxis(pCameraCoordinateSpace.orientation.getZAxis());
+
+			size_t reprojectGlobalWorkSize[2];
+			reprojectGlobalWorkSize[0] = static_cast<size_t>(this->settings.resolutionWidth);
+			reprojectGlobalWorkSize[1] = static_cast<size_t>(this->settings.resolutionHeight);
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->openCLManager->getCommandQueue(), this->reprojectDepthKernel->getKernel(), 2, NULL, reprojectGlobalWorkSize, NULL, 0, NULL, this->openCLManager->getProfiler()->getEventForCommand("reprojectDepth")));
+		}
+
+		// Trace one beam for every tile of pixels
+		if(this->settings.isBeamPrePassEnabled)
+		{
+			this->traceBeamKernel->setCameraPosition(pCameraCoordinateSpace.position);
+			this->traceBeamKernel->setCameraOrientationXAxis(pCameraCoordinateSpace.orientation.getXAxis());
+			this->traceBeamKernel->setCameraOrientationYAxis(pCameraCoordinateSpace.orientation.getYAxis());
+			this->traceBeamKernel->setCameraOrientationZAxis(pCameraCoordinateSpace.orientation.getZAxis());
+			this->traceBeamKernel->setCameraTranslationDistance((pCameraCoordinateSpace.position - this->previousCameraCoordinateSpace.position).getMagnitude());
+
+			size_t beamGlobalWorkSize[2];
+			beamGlobalWorkSize[0] = static_cast<size_t>(this->numberOfBeamTilesAlongX);
+			beamGlobalWorkSize[1] = static_cast<size_t>(this->numberOfBeamTilesAlongY);
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->openCLManager->getCommandQueue(), this->traceBeamKernel->getKernel(), 2, NULL, beamGlobalWorkSize, NULL, 0, NULL, this->openCLManager->getProfiler()->getEventForCommand("traceBeam")));
+		}
+
+		// Run the kernel
+		if(this->settings.isPersistentThreadsEnabled)
+		{
+			const cl_uint firstRayBatchIndex = 0;
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueFillBuffer(this->openCLManager->getCommandQueue(), this->kernelNextRayBatchIndexBuffer, &firstRayBatchIndex, sizeof(cl_uint), 0, sizeof(cl_uint), 0, NULL, NULL));
+
+			size_t localWorkSize = RenderPixelKernel::rayBatchSideLength * RenderPixelKernel::rayBatchSideLength;
+			size_t globalWorkSize = localWorkSize * RenderPixelKernel::numberOfPersistentWorkGroupsPerComputeUnit * this->openCLManager->getNumberOfComputeUnits();
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->openCLManager->getCommandQueue(), this->renderPixelKernel->getKernel(), 1, NULL, &globalWorkSize, &localWorkSize, 0, NULL, this->openCLManager->getProfiler()->getEventForCommand("renderPixel")));
+		}
+		else if(this->settings.isTiledPixelOrderEnabled)
+		{
+			size_t globalWorkSize = RenderPixelKernel::rayBatchSideLength * RenderPixelKernel::rayBatchSideLength * RenderPixelKernel::getNumberOfRayBatches(this->settings.resolutionWidth, this->settings.resolutionHeight, false);
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->openCLManager->getCommandQueue(), this->renderPixelKernel->getKernel(), 1, NULL, &globalWorkSize, NULL, 0, NULL, this->openCLManager->getProfiler()->getEventForCommand("renderPixel")));
+		}
+		else
+		{
+			size_t globalWorkSize[2];
+			globalWorkSize[0] = static_cast<size_t>(this->settings.resolutionWidth);
+			globalWorkSize[1] = static_cast<size_t>(this->settings.resolutionHeight);
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->openCLManager->getCommandQueue(), this->renderPixelKernel->getKernel(), 2, NULL, globalWorkSize, NULL, 0, NULL, this->openCLManager->getProfiler()->getEventForCommand("renderPixel")));
+		}
+
+		// The depth buffer of this frame is reprojected in the next frame, unless the world is generated again before it
+		this->previousCameraCoordinateSpace = pCameraCoordinateSpace;
+		this->isPreviousDepthBufferValid = !this->settings.shouldRegenerateWorldEveryFrame;
+
+		// Copy the pixels from device memory to host memory, like the renderer does every frame. The frame ends by waiting for it
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(this->openCLManager->getCommandQueue(), this->kernelUInt8FrameBuffer, CL_NON_BLOCKING, 0, this->framebufferPixels.getNumberOfElements(), &this->framebufferPixels[0], 0, NULL, this->openCLManager->getProfiler()->getEventForCommand("readBackFramebuffer")));
+	}
+
+	Double Benchmark::calculateLaneUtilisation()
+	{
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(this->openCLManager->getCommandQueue(), this->kernelLaneStatisticsBuffer, CL_BLOCKING, 0, sizeof(cl_uint2) * this->laneStatistics.getNumberOfElements(), &this->laneStatistics[0], 0, NULL, NULL));
+
+		for(SizeType i = 0; i < this->simdUnitSumsOfTraversalSteps.getNumberOfElements(); ++i)
+		{
+			this->simdUnitSumsOfTraversalSteps[i] = 0;
+			this->simdUnitMaxNumbersOfTraversalSteps[i] = 0;
+		}
+
+		// The lanes of the work groups are packed into SIMD units in the order of their lane indices
+		for(SizeType i = 0; i < this->laneStatistics.getNumberOfElements(); ++i)
+		{
+			const UInt32 numberOfTraversalSteps = this->laneStatistics[i].s[0];
+			const SizeType simdUnitIndex = this->laneStatistics[i].s[1] / this->settings.simdWidth;
+			this->simdUnitSumsOfTraversalSteps[simdUnitIndex] += numberOfTraversalSteps;
+			this->simdUnitMaxNumbersOfTraversalSteps[simdUnitIndex] = max<UInt32>(this->simdUnitMaxNumbersOfTraversalSteps[simdUnitIndex], numberOfTraversalSteps);
+		}
+
+		// A SIMD unit steps all of its lanes until the longest ray among them is finished, and the lanes without a pixel or with a shorter ray wait for it
+		UInt64 numberOfActiveLaneSteps = 0;
+		UInt64 numberOfLaneSteps = 0;
+		for(SizeType i = 0; i < this->simdUnitSumsOfTraversalSteps.getNumberOfElements(); ++i)
+		{
+			numberOfActiveLaneSteps += this->simdUnitSumsOfTraversalSteps[i];
+			numberOfLaneSteps += static_cast<UInt64>(this->simdUnitMaxNumbersOfTraversalSteps[i]) * this->settings.simdWidth;
+		}
+
+		return (numberOfLaneSteps > 0)? static_cast<Double>(numberOfActiveLaneSteps) / static_cast<Double>(numberOfLaneSteps) : 1.0;
+	}
+
+	bool Benchmark::writeResults(const FrameTimings &pInitialGenerationTimings, const ResizableArray<FrameTimings> &pFrameTimings) const
+	{
+		std::ofstream outputFile(this->settings.outputFilePath);
+		if(!outputFile.is_open())
+		{
+			FORGE_ERROR_LOG("Could not open the benchmark output file ", this->settings.outputFilePath);
+			return false;
+		}
+
+		// Get the name of the device
+		size_t deviceNameSize;
+		FORGE_OPENCL_ERROR_CODE_CHECK(clGetDeviceInfo(this->openCLManager->getDeviceID(), CL_DEVICE_NAME, 0, NULL, &deviceNameSize));
+		ResizableArray<char> deviceName(deviceNameSize);
+		FORGE_OPENCL_ERROR_CODE_CHECK(clGetDeviceInfo(this->openCLManager->getDeviceID(), CL_DEVICE_NAME, deviceNameSize, &deviceName[0], NULL));
+
+		// Writes the timings of the stages of a frame as the members of a JSON object
+		auto writeFrameTimings = [&outputFile](const FrameTimings &pTimings, const char *pIndentation)
+		{
+			outputFile << pIndentation << "\"generateVoxelsMilliseconds\": " << convertNanosecondsToMilliseconds(pTimings.generateVoxelsTime) << ",\n";
+			outputFile << pIndentation << "\"generateNodesMillisecondsPerLevel\": [";
+			for(SizeType i = 0; i < pTimings.generateNodesTimes.getNumberOfElements(); ++i)
+			{
+				outputFile << ((i == 0)? "" : ", ") << convertNanosecondsToMilliseconds(pTimings.generateNodesTimes[i]);
+			}
+			outputFile << "],\n";
+			outputFile << pIndentation << "\"reprojectDepthMilliseconds\": " << convertNanosecondsToMilliseconds(pTimings.reprojectDepthTime) << ",\n";
+			outputFile << pIndentation << "\"traceBeamMilliseconds\": " << convertNanosecondsToMilliseconds(pTimings.traceBeamTime) << ",\n";
+			outputFile << pIndentation << "\"renderMilliseconds\": " << convertNanosecondsToMilliseconds(pTimings.renderTime) << ",\n";
+			outputFile << pIndentation << "\"readBackMilliseconds\": " << convertNanosecondsToMilliseconds(pTimings.readBackTime) << ",\n";
+			outputFile << pIndentation << "\"totalMilliseconds\": " << convertNanosecondsToMilliseconds(pTimings.totalTime);
+		};
+
+		// Sort the frame times to calculate the percentiles
+		ResizableArray<Int64> sortedFrameTimes(pFrameTimings.getNumberOfElements());
+		Int64 sumOfFrameTimes = 0;
+		for(SizeType i = 0; i < pFrameTimings.getNumberOfElements(); ++i)
+		{
+			sortedFrameTimes[i] = pFrameTimings[i].totalTime;
+			sumOfFrameTimes += pFrameTimings[i].totalTime;
+		}
+		if(sortedFrameTimes.getNumberOfElements() > 0)
+		{
+			std::sort(&sortedFrameTimes[0], &sortedFrameTimes[0] + sortedFrameTimes.getNumberOfElements());
+		}
+		const Int64 meanFrameTime = (pFrameTimings.getNumberOfElements() > 0)? sumOfFrameTimes / static_cast<Int64>(pFrameTimings.getNumberOfElements()) : 0;
+		// The dense format is the octree node child masks, the voxel bricks, their first material indices and the voxel material buffer, which holds the voxel data of the non empty voxels
+		const SizeType denseVoxelMemorySize = sizeof(UInt8) * this->voxelGrid->getOctreeNodeChildMaskArray()->getNumberOfElements() +
+											  sizeof(UInt64) * this->voxelGrid->getVoxelBrickArray()->getNumberOfElements() +
+											  sizeof(UInt32) * this->voxelGrid->getVoxelBrickFirstMaterialIndexArray()->getNumberOfElements() +
+											  sizeof(VoxelData) * this->worldGenerator->getVoxelMaterialArrayCapacity();
+
+		outputFile << "{\n";
+		outputFile << "  \"device\": \"" << &deviceName[0] << "\",\n";
+		outputFile << "  \"resolution\": [" << this->settings.resolutionWidth << ", " << this->settings.resolutionHeight << "],\n";
+		outputFile << "  \"octreeDepth\": " << this->voxelGrid->getOctreeDepth() << ",\n";
+		outputFile << "  \"octreeVisualizationEnabled\": " << (this->settings.isOctreeVisualizationEnabled? "true" : "false") << ",\n";
+		outputFile << "  \"worldRegeneratedEveryFrame\": " << (this->settings.shouldRegenerateWorldEveryFrame? "true" : "false") << ",\n";
+		outputFile << "  \"beamPrePassEnabled\": " << (this->settings.isBeamPrePassEnabled? "true" : "false") << ",\n";
+		outputFile << "  \"depthReprojectionEnabled\": " << (this->settings.isDepthReprojectionEnabled? "true" : "false") << ",\n";
+		outputFile << "  \"persistentThreadsEnabled\": " << (this->settings.isPersistentThreadsEnabled? "true" : "false") << ",\n";
+		outputFile << "  \"pixelOrder\": \"" << (this->settings.isTiledPixelOrderEnabled? "tiledMorton" : "rowMajor") << "\",\n";
+		outputFile << "  \"voxelFormat\": \"" << (this->settings.isSparseVoxelOctreeEnabled? "sparseVoxelOctree" : "dense") << "\",\n";
+		outputFile << "  \"denseVoxelMemorySize\": " << denseVoxelMemorySize << ",\n";
+		if(this->settings.isSparseVoxelOctreeEnabled)
+		{
+			outputFile << "  \"sparseVoxelOctreeMemorySize\": " << this->sparseVoxelOctree.getMemorySize() << ",\n";
+		}
+		outputFile << "  \"numberOfWarmUpFrames\": " << this->settings.numberOfWarmUpFrames << ",\n";
+		outputFile << "  \"numberOfFrames\": " << pFrameTimings.getNumberOfElements() << ",\n";
+		outputFile << "  \"initialGeneration\": {\n";
+		writeFrameTimings(pInitialGenerationTimings, "    ");
+		outputFile << "\n  },\n";
+		outputFile << "  \"frameTimeMilliseconds\": {\n";
+		outputFile << "    \"mean\": " << convertNanosecondsToMilliseconds(meanFrameTime) << ",\n";
+		outputFile << "    \"p50\": " << convertNanosecondsToMilliseconds(getPercentile(sortedFrameTimes, 50.0)) << ",\n";
+		outputFile << "    \"p95\": " << convertNanosecondsToMilliseconds(getPercentile(sortedFrameTimes, 95.0)) << ",\n";
+		outputFile << "    \"p99\": " << convertNanosecondsToMilliseconds(getPercentile(sortedFrameTimes, 99.0)) << ",\n";
+		outputFile << "    \"max\": " << convertNanosecondsToMilliseconds((sortedFrameTimes.getNumberOfElements() > 0)? sortedFrameTimes[sortedFrameTimes.getNumberOfElements() - 1] : 0) << "\n";
+		outputFile << "  },\n";
+		if(this->settings.isLaneUtilisationMeasured)
+		{
+			Double sumOfLaneUtilisations = 0.0;
+			for(SizeType i = 0; i < pFrameTimings.getNumberOfElements(); ++i)
+			{
+				sumOfLaneUtilisations += pFrameTimings[i].laneUtilisation;
+			}
+
+			outputFile << "  \"laneUtilisation\": {\n";
+			outputFile << "    \"simdWidth\": " << this->settings.simdWidth << ",\n";
+			outputFile << "    \"mean\": " << ((pFrameTimings.getNumberOfElements() > 0)? sumOfLaneUtilisations / static_cast<Double>(pFrameTimings.getNumberOfElements()) : 0.0) << "\n";
+			outputFile << "  },\n";
+		}
+		outputFile << "  \"frames\": [\n";
+		for(SizeType i = 0; i < pFrameTimings.getNumberOfElements(); ++i)
+		{
+			outputFile << "    {\n";
+			writeFrameTimings(pFrameTimings[i], "      ");
+			if(this->settings.isLaneUtilisationMeasured)
+			{
+				outputFile << ",\n      \"laneUtilisation\": " << pFrameTimings[i].laneUtilisation;
+			}
+			outputFile << "\n    }" << ((i + 1 < pFrameTimings.getNumberOfElements())? "," : "") << "\n";
+		}
+		outputFile << "  ]\n";
+		outputFile << "}\n";
+
+		FORGE_DEBUG_LOG("Benchmark results written to ", this->settings.outputFilePath);
+
+		return true;
+	}
+}
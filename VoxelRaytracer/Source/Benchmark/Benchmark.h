@@ -0,0 +1,155 @@
+#ifndef FORGE_BENCHMARK_H
+#define FORGE_BENCHMARK_H
+
+#include <chrono>
+#include <CL/cl.h>
+#include <Forge/Source/Core/Forge.h>
+#include <Forge/Source/Core/Containers/ResizableArray.h>
+#include <Forge/Source/Platform/OpenCL/OpenCLManager.h>
+#include <VoxelRaytracer/Source/Program/VoxelGrid.h>
+#include <VoxelRaytracer/Source/Program/SparseVoxelOctree.h>
+#include <VoxelRaytracer/Source/Program/WorldGenerator/WorldGenerator.h>
+#include <VoxelRaytracer/Source/Rendering/OpenCLRenderer/Kernels/RenderPixelKernel.h>
+#include <VoxelRaytracer/Source/Rendering/OpenCLRenderer/Kernels/TraceBeamKernel.h>
+#include <VoxelRaytracer/Source/Rendering/OpenCLRenderer/Kernels/ReprojectDepthKernel.h>
+#include "CameraPath.h"
+
+namespace forge
+{
+	/// <summary>
+	/// Renders frames along a camera path without a window, and measures how long each stage of a frame takes on the OpenCL device.
+	/// The stages are timed on the device with the events of the profiler, so the frame is enqueued without waiting between its stages,
+	/// and the frame time is measured on the host from the moment the first stage is enqueued until all of them have finished
+	/// </summary>
+	class Benchmark
+	{
+	public:
+
+		struct Settings
+		{
+			SizeType numberOfFrames = 300;
+			// Frames that are rendered before the measured frames, and are not part of the results
+			SizeType numberOfWarmUpFrames = 10;
+			Int resolutionWidth = 1280;
+			Int resolutionHeight = 720;
+			UInt32 octreeDepth = 10;
+			Float cameraVerticalFieldOfViewInDegrees = 60.0f;
+			bool isOctreeVisualizationEnabled = false;
+			// Whether the world is generated again every frame with a new offset, like it is while the world is scrolling in the program
+			bool shouldRegenerateWorldEveryFrame = false;
+			Float worldOffsetIncreasePerFrame = 10.0f / 60.0f;
+			// Whether the frames are rendered from a sparse voxel octree built from the initially generated world.
+			// The sparse voxel octree is built on the host, so this can not be combined with regenerating the world every frame
+			bool isSparseVoxelOctreeEnabled = false;
+			// Whether a beam is traced through the octree for every tile of pixels before the pixels are rendered, so that the camera rays can skip the empty space in front of them
+			bool isBeamPrePassEnabled = true;
+			// Whether the depth buffer of the previous frame is reprojected, so that the beams can start from where the rays hit voxels before.
+			// The reprojected depths are used by the beam pre-pass, so this has no effect without it. It is not used while the world is regenerated every frame
+			bool isDepthReprojectionEnabled = true;
+			// Whether the pixels are rendered by a fixed number of work groups that take batches of pixels, instead of one work item for every pixel
+			bool isPersistentThreadsEnabled = false;
+			// Whether the pixels are rendered in square batches in Z-order, instead of row by row
+			bool isTiledPixelOrderEnabled = true;
+			// Whether the fraction of the time that the lanes of the SIMD units spend tracing rays, instead of waiting for the other lanes to finish theirs, is measured.
+			// The number of traversal steps of every camera ray is written to device memory then, which makes the rendering itself a little slower
+			bool isLaneUtilisationMeasured = false;
+			// The number of lanes of a SIMD unit of the device, which is 32 on most GPUs, and 64 on older AMD GPUs
+			UInt32 simdWidth = 32;
+			// The file to load the camera path from. A built in orbit around the world is used if this is nullptr
+			const char *cameraPathFilePath = nullptr;
+			const char *outputFilePath = "BenchmarkResults.json";
+		};
+
+		/// <summary>
+		/// Run the benchmark and write the results to the output file as JSON
+		/// </summary>
+		/// <param name="pSettings">The settings of the benchmark</param>
+		/// <returns>True if the benchmark ran and the results were written, false otherwise</returns>
+		bool run(const Settings &pSettings);
+
+	private:
+
+		// The times of the stages of a frame, in nanoseconds
+		struct FrameTimings
+		{
+			// These are only measured if the world is generated in the frame
+			Int64 generateVoxelsTime = 0;
+			ResizableArray<Int64> generateNodesTimes;
+
+			// These are only measured if the beam pre-pass and the depth reprojection are enabled
+			Int64 reprojectDepthTime = 0;
+			Int64 traceBeamTime = 0;
+			Int64 renderTime = 0;
+			Int64 readBackTime = 0;
+			// The time on the host from when the first stage is enqueued until the last one finishes, which includes the time between the stages
+			Int64 totalTime = 0;
+
+			// This is only measured if the lane utilisation is measured
+			Double laneUtilisation = 0.0;
+		};
+
+		void startup();
+
+		void shutdown();
+
+		void generateTextures();
+
+		// Wait for the commands of the frame to finish, and take the times of the stages from the commands that the profiler recorded for it
+		void endFrame(std::chrono::steady_clock::time_point pFrameStartTime, FrameTimings &pFrameTimings);
+
+		// Read the generated voxels back from the device, build the sparse voxel octree from them and upload it to the device
+		void createSparseVoxelOctree();
+
+		void renderFrame(const CoordinateSpace &pCameraCoordinateSpace);
+
+		// Read the lane statistics of the last rendered frame back from the device, and calculate the fraction of the lanes that traced rays in every step of the SIMD units
+		Double calculateLaneUtilisation();
+
+		bool writeResults(const FrameTimings &pInitialGenerationTimings, const ResizableArray<FrameTimings> &pFrameTimings) const;
+
+		Settings settings;
+		CameraPath cameraPath;
+
+		OpenCLManager *openCLManager;
+		VoxelGrid *voxelGrid;
+		WorldGenerator *worldGenerator;
+		RenderPixelKernel *renderPixelKernel;
+		TraceBeamKernel *traceBeamKernel;
+		ReprojectDepthKernel *reprojectDepthKernel;
+
+		cl_mem kernelVoxelDataBuffer;
+		cl_mem kernelVoxelBrickBuffer;
+		cl_mem kernelVoxelBrickFirstMaterialIndexBuffer;
+		cl_mem kernelTexturesBuffer;
+		cl_mem kernelUInt8FrameBuffer;
+		cl_mem kernelDebugAABBsBuffer;
+		cl_mem kernelBeamDistancesBuffer;
+		cl_mem kernelNextRayBatchIndexBuffer;
+		// Only created if the lane utilisation is measured
+		cl_mem kernelLaneStatisticsBuffer = nullptr;
+		SizeType numberOfBeamTilesAlongX;
+		SizeType numberOfBeamTilesAlongY;
+		cl_mem kernelDepthBuffer;
+		cl_mem kernelReprojectedDepthTilesBuffer;
+		// The camera of the frame that the depth buffer was rendered for. There is no depth buffer to reproject before the first frame
+		CoordinateSpace previousCameraCoordinateSpace;
+		bool isPreviousDepthBufferValid = false;
+		const SizeType textureSize = 16;
+
+		SparseVoxelOctree sparseVoxelOctree;
+		cl_mem kernelSparseVoxelOctreeNodesBuffer = nullptr;
+		cl_mem kernelSparseVoxelOctreeVoxelBricksBuffer = nullptr;
+		cl_mem kernelSparseVoxelOctreeVoxelBrickFirstMaterialIndicesBuffer = nullptr;
+		cl_mem kernelSparseVoxelOctreeVoxelMaterialsBuffer = nullptr;
+
+		// The pixels that are read back from the device every frame
+		ResizableArray<UInt8> framebufferPixels;
+
+		// The number of traversal steps and the lane index of every pixel, and the sum and the maximum of the traversal steps of the lanes of every SIMD unit
+		ResizableArray<cl_uint2> laneStatistics;
+		ResizableArray<UInt32> simdUnitSumsOfTraversalSteps;
+		ResizableArray<UInt32> simdUnitMaxNumbersOfTraversalSteps;
+	};
+}
+
+#endif
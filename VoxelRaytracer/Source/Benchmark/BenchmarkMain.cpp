@@ -0,0 +1,106 @@
+#include <cstdlib>
+#include <cstring>
+#include <Forge/Source/Core/Logging.h>
+#include "Benchmark.h"
+
+// The entry point of the headless benchmark. It must be run from the VoxelRaytracer directory, so that the OpenCL kernels can be found.
+// Usage : VoxelRaytracerBenchmark [--frames N] [--warm-up-frames N] [--width N] [--height N] [--camera-path FILE]
+//								   [--output FILE] [--regenerate-world] [--octree-visualization] [--sparse-voxel-octree]
+//								   [--no-beam-pre-pass] [--no-depth-reprojection] [--persistent-threads] [--row-major-pixel-order]
+//								   [--measure-lane-utilisation] [--simd-width N]
+int main(int argc, char *argv[])
+{
+	forge::Benchmark::Settings settings;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		const bool hasValue = (i + 1) < argc;
+
+		if(std::strcmp(argv[i], "--frames") == 0 && hasValue)
+		{
+			settings.numberOfFrames = static_cast<forge::SizeType>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if(std::strcmp(argv[i], "--warm-up-frames") == 0 && hasValue)
+		{
+			settings.numberOfWarmUpFrames = static_cast<forge::SizeType>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if(std::strcmp(argv[i], "--width") == 0 && hasValue)
+		{
+			settings.resolutionWidth = std::atoi(argv[++i]);
+		}
+		else if(std::strcmp(argv[i], "--height") == 0 && hasValue)
+		{
+			settings.resolutionHeight = std::atoi(argv[++i]);
+		}
+		else if(std::strcmp(argv[i], "--camera-path") == 0 && hasValue)
+		{
+			settings.cameraPathFilePath = argv[++i];
+		}
+		else if(std::strcmp(argv[i], "--output") == 0 && hasValue)
+		{
+			settings.outputFilePath = argv[++i];
+		}
+		else if(std::strcmp(argv[i], "--regenerate-world") == 0)
+		{
+			settings.shouldRegenerateWorldEveryFrame = true;
+		}
+		else if(std::strcmp(argv[i], "--octree-visualization") == 0)
+		{
+			settings.isOctreeVisualizationEnabled = true;
+		}
+		else if(std::strcmp(argv[i], "--sparse-voxel-octree") == 0)
+		{
+			settings.isSparseVoxelOctreeEnabled = true;
+		}
+		else if(std::strcmp(argv[i], "--no-beam-pre-pass") == 0)
+		{
+			settings.isBeamPrePassEnabled = false;
+		}
+		else if(std::strcmp(argv[i], "--no-depth-reprojection") == 0)
+		{
+			settings.isDepthReprojectionEnabled = false;
+		}
+		else if(std::strcmp(argv[i], "--persistent-threads") == 0)
+		{
+			settings.isPersistentThreadsEnabled = true;
+		}
+		else if(std::strcmp(argv[i], "--row-major-pixel-order") == 0)
+		{
+			settings.isTiledPixelOrderEnabled = false;
+		}
+		else if(std::strcmp(argv[i], "--measure-lane-utilisation") == 0)
+		{
+			settings.isLaneUtilisationMeasured = true;
+		}
+		else if(std::strcmp(argv[i], "--simd-width") == 0 && hasValue)
+		{
+			settings.simdWidth = static_cast<forge::UInt32>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else
+		{
+			FORGE_ERROR_LOG("Unknown or incomplete benchmark argument : ", argv[i]);
+			return 1;
+		}
+	}
+
+	if(settings.numberOfFrames == 0 || settings.resolutionWidth < 2 || settings.resolutionHeight < 2)
+	{
+		FORGE_ERROR_LOG("The number of frames must be greater than 0 and the resolution must be at least 2x2");
+		return 1;
+	}
+
+	if(settings.simdWidth == 0)
+	{
+		FORGE_ERROR_LOG("The SIMD width must be greater than 0");
+		return 1;
+	}
+
+	if(settings.isSparseVoxelOctreeEnabled && settings.shouldRegenerateWorldEveryFrame)
+	{
+		FORGE_ERROR_LOG("The sparse voxel octree can not be used when the world is regenerated every frame");
+		return 1;
+	}
+
+	forge::Benchmark benchmark;
+	return benchmark.run(settings)? 0 : 1;
+}
@@ -0,0 +1,85 @@
+#include "CameraPath.h"
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <Forge/Source/Core/Math/MathUtility.h>
+
+namespace forge
+{
+	void CameraPath::createOrbit(Float pRadius, Float pHeight, Float pPitchInDegrees, SizeType pNumberOfKeyframes)
+	{
+		this->keyframes.setNumberOfElements(0);
+
+		// The last keyframe is the same as the first one, so that the path is a closed loop
+		for(SizeType i = 0; i <= pNumberOfKeyframes; ++i)
+		{
+			const Float yawInDegrees = 360.0f * static_cast<Float>(i) / static_cast<Float>(pNumberOfKeyframes);
+			const Float yawInRadians = convertDegreesToRadians(yawInDegrees);
+
+			// Place the camera so that its z axis points at the world y axis
+			Keyframe keyframe;
+			keyframe.position = Vector3(-pRadius * std::sin(yawInRadians), pHeight, -pRadius * std::cos(yawInRadians));
+			keyframe.pitchInDegrees = pPitchInDegrees;
+			keyframe.yawInDegrees = yawInDegrees;
+			this->appendKeyframe(keyframe);
+		}
+	}
+
+	bool CameraPath::loadFromFile(const char *pFilePath)
+	{
+		this->keyframes.setNumberOfElements(0);
+
+		std::ifstream file(pFilePath);
+		if(!file.is_open())
+		{
+			return false;
+		}
+
+		std::string line;
+		while(std::getline(file, line))
+		{
+			if(line.empty() || line[0] == '#')
+			{
+				continue;
+			}
+
+			Keyframe keyframe;
+			std::istringstream lineStream(line);
+			if(lineStream >> keyframe.position.x >> keyframe.position.y >> keyframe.position.z >> keyframe.pitchInDegrees >> keyframe.yawInDegrees)
+			{
+				this->appendKeyframe(keyframe);
+			}
+		}
+
+		return this->keyframes.getNumberOfElements() > 0;
+	}
+
+	CoordinateSpace CameraPath::getCoordinateSpace(Float pPathParam) const
+	{
+		// Find the two keyframes that the point in time lies between, and how far it is from the first of them
+		const SizeType lastKeyframeIndex = this->keyframes.getNumberOfElements() - 1;
+		const Float keyframePosition = clamp<Float>(pPathParam, 0.0f, 1.0f) * static_cast<Float>(lastKeyframeIndex);
+		const SizeType firstKeyframeIndex = min<SizeType>(static_cast<SizeType>(keyframePosition), lastKeyframeIndex);
+		const SizeType secondKeyframeIndex = min<SizeType>(firstKeyframeIndex + 1, lastKeyframeIndex);
+		const Float lerpParam = keyframePosition - static_cast<Float>(firstKeyframeIndex);
+
+		const Keyframe &firstKeyframe = this->keyframes[firstKeyframeIndex];
+		const Keyframe &secondKeyframe = this->keyframes[secondKeyframeIndex];
+
+		// Set the orientation in the same way that the Camera class does
+		CoordinateSpace coordinateSpace;
+		coordinateSpace.position = firstKeyframe.position + (secondKeyframe.position - firstKeyframe.position) * lerpParam;
+		coordinateSpace.orientation.resetToIdentity();
+		coordinateSpace.orientation.rotateAboutObjectSpaceXAxis(lerp<Float>(firstKeyframe.pitchInDegrees, secondKeyframe.pitchInDegrees, lerpParam));
+		coordinateSpace.orientation.rotateAboutWorldSpaceYAxis(lerp<Float>(firstKeyframe.yawInDegrees, secondKeyframe.yawInDegrees, lerpParam));
+
+		return coordinateSpace;
+	}
+
+	void CameraPath::appendKeyframe(const Keyframe &pKeyframe)
+	{
+		this->keyframes.setNumberOfElements(this->keyframes.getNumberOfElements() + 1);
+		this->keyframes[this->keyframes.getNumberOfElements() - 1] = pKeyframe;
+	}
+}
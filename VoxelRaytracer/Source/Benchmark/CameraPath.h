@@ -0,0 +1,68 @@
+#ifndef FORGE_CAMERA_PATH_H
+#define FORGE_CAMERA_PATH_H
+
+#include <Forge/Source/Core/Forge.h>
+#include <Forge/Source/Core/Containers/ResizableArray.h>
+#include <Forge/Source/Core/Math/Vector3.h>
+#include <Forge/Source/Core/Math/CoordinateSpace.h>
+
+namespace forge
+{
+	/// <summary>
+	/// A path that a camera follows, made up of keyframes that are evenly spaced in time.
+	/// The camera moves along straight lines between the keyframes
+	/// </summary>
+	class CameraPath
+	{
+	public:
+
+		struct Keyframe
+		{
+			Vector3 position;
+			// The angle of rotation about the camera's x axis. Positive values make the camera look down
+			Float pitchInDegrees = 0.0f;
+			// The angle of rotation about the world y axis. Positive values turn the camera from the z axis towards the x axis
+			Float yawInDegrees = 0.0f;
+		};
+
+		/// <summary>
+		/// Create a path that circles around the world y axis while looking at it
+		/// </summary>
+		/// <param name="pRadius">The distance of the camera from the world y axis</param>
+		/// <param name="pHeight">The y coordinate of the camera</param>
+		/// <param name="pPitchInDegrees">The pitch of the camera for the whole path</param>
+		/// <param name="pNumberOfKeyframes">The number of keyframes used to approximate the circle</param>
+		void createOrbit(Float pRadius, Float pHeight, Float pPitchInDegrees, SizeType pNumberOfKeyframes);
+
+		/// <summary>
+		/// Load the keyframes from a text file. Each non empty line that does not start with '#' is a keyframe
+		/// written as "xPosition yPosition zPosition pitchInDegrees yawInDegrees"
+		/// </summary>
+		/// <param name="pFilePath">The path of the file</param>
+		/// <returns>True if at least one keyframe was loaded, false otherwise</returns>
+		bool loadFromFile(const char *pFilePath);
+
+		SizeType getNumberOfKeyframes() const;
+
+		/// <summary>
+		/// Get the coordinate space of the camera at a point in time along the path
+		/// </summary>
+		/// <param name="pPathParam">The point in time, in the range [0.0f, 1.0f]. 0.0f is the first keyframe and 1.0f is the last one</param>
+		/// <returns>The coordinate space of the camera</returns>
+		CoordinateSpace getCoordinateSpace(Float pPathParam) const;
+
+	private:
+
+		void appendKeyframe(const Keyframe &pKeyframe);
+
+		ResizableArray<Keyframe> keyframes;
+	};
+
+	inline
+	SizeType CameraPath::getNumberOfKeyframes() const
+	{
+		return this->keyframes.getNumberOfElements();
+	}
+}
+
+#endif
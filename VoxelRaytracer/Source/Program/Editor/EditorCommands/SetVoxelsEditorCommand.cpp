@@ -4,33 +4,16 @@ namespace forge
 {
 	void SetVoxelsEditorCommand::execute()
 	{
-		SizeType nextIndex = 0;
-		for(VoxelGrid::VoxelCoordType x = this->setAreaMinCoords.x; x <= this->setAreaMaxCoords.x; ++x)
-		{
-			for(VoxelGrid::VoxelCoordType y = this->setAreaMinCoords.y; y <= this->setAreaMaxCoords.y; ++y)
-			{
-				for(VoxelGrid::VoxelCoordType z = this->setAreaMinCoords.z; z <= this->setAreaMaxCoords.z; ++z)
-				{
-					IntegerVector3<VoxelGrid::VoxelCoordType> integerVoxelCoords(x, y, z);
-					this->previousAreaVoxelDataArray[nextIndex++] = this->voxelGrid->getVoxelData(integerVoxelCoords);
-					this->voxelGrid->setVoxelData(integerVoxelCoords, this->voxelDataToSetWith);
-				}
-			}
-		}
+		// Undo restores the voxels exactly, so a redo changes the same voxels as the first execution, and the recorded runs stay valid
+		this->voxelGrid->setVoxelsInBox(this->setAreaMinCoords, this->setAreaMaxCoords, this->voxelDataToSetWith, this->havePreviousVoxelRunsBeenRecorded? nullptr : &this->previousVoxelRuns);
+		this->havePreviousVoxelRunsBeenRecorded = true;
 	}
 
 	void SetVoxelsEditorCommand::undo()
 	{
-		SizeType nextIndex = 0;
-		for(VoxelGrid::VoxelCoordType x = this->setAreaMinCoords.x; x <= this->setAreaMaxCoords.x; ++x)
+		if(this->previousVoxelRuns.getNumberOfElements() > 0)
 		{
-			for(VoxelGrid::VoxelCoordType y = this->setAreaMinCoords.y; y <= this->setAreaMaxCoords.y; ++y)
-			{
-				for(VoxelGrid::VoxelCoordType z = this->setAreaMinCoords.z; z <= this->setAreaMaxCoords.z; ++z)
-				{
-					this->voxelGrid->setVoxelData(IntegerVector3<VoxelGrid::VoxelCoordType>(x, y, z), this->previousAreaVoxelDataArray[nextIndex++]);
-				}
-			}
+			this->voxelGrid->setVoxelRuns(this->setAreaMinCoords, this->setAreaMaxCoords, this->previousVoxelRuns);
 		}
 	}
 }
\ No newline at end of file
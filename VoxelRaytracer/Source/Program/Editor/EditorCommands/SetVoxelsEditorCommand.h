@@ -6,6 +6,9 @@
 
 namespace forge
 {
+	// Sets the voxels in a box to the same voxel. Only the previous voxel data of the voxels that changed is kept for undo, as runs in the order of their voxel indices.
+	// Edits are applied to the voxel grid on the host, and the renderer patches its sparse voxel octree from it. There is no device side edit path, because the editor
+	// only runs on the static world, and the dense voxel octree on the device only exists while the world scrolls
 	class SetVoxelsEditorCommand : public Command
 	{
 	public:
@@ -15,8 +18,6 @@ namespace forge
 							   IntegerVector3<VoxelGrid::VoxelCoordType> pSetAreaMaxCoords,
 							   VoxelData pVoxelData);
 
-		~SetVoxelsEditorCommand();
-
 	private:
 
 		virtual void execute() override;
@@ -27,7 +28,8 @@ namespace forge
 		IntegerVector3<VoxelGrid::VoxelCoordType> setAreaMinCoords;
 		IntegerVector3<VoxelGrid::VoxelCoordType> setAreaMaxCoords;
 		VoxelData voxelDataToSetWith;
-		VoxelData *previousAreaVoxelDataArray = nullptr;
+		DynamicArray<VoxelGrid::VoxelRun> previousVoxelRuns;
+		bool havePreviousVoxelRunsBeenRecorded = false;
 	};
 
 	inline
@@ -40,15 +42,6 @@ namespace forge
 	setAreaMaxCoords(pSetAreaMaxCoords),
 	voxelDataToSetWith(pVoxelData)
 	{
-		this->previousAreaVoxelDataArray = new VoxelData[(pSetAreaMaxCoords.x - pSetAreaMinCoords.x + 1) *
-														 (pSetAreaMaxCoords.y - pSetAreaMinCoords.y + 1) *
-														 (pSetAreaMaxCoords.z - pSetAreaMinCoords.z + 1)];
-	}
-
-	inline
-	SetVoxelsEditorCommand::~SetVoxelsEditorCommand()
-	{
-		delete this->previousAreaVoxelDataArray;
 	}
 }
 
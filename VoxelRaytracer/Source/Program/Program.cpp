@@ -7,6 +7,9 @@
 #include <VoxelRaytracer/Source/Program/Editor/Editor.h>
 #include <Forge/Source/Platform/Windows/FileEditors/TextFileEditor.h>
 #include <Forge/Source/Core/Assert.h>
+#include <VoxelRaytracer/Source/Rendering/OpenCLRenderer/OpenCLRenderer.h>
+#include <VoxelRaytracer/Source/Rendering/OpenCLRenderer/DirtyMemoryPages.h>
+#include <VoxelRaytracer/Source/Rendering/CPURenderer/CPURenderer.h>
 
 namespace forge
 {
@@ -39,44 +42,41 @@ namespace forge
 		this->voxelGrid = new VoxelGrid(10);
 
 		this->openCLManager = new OpenCLManager();
-		this->openCLManager->startup();
-
-		TextFileEditor *generateVoxelKernelTextEditor = new TextFileEditor;
-		generateVoxelKernelTextEditor->openFile("ForgeData/OpenCL/Kernels/GenerateVoxel.cl");
-		this->generateVoxelKernel = new WorldGeneratorKernel(this->openCLManager, generateVoxelKernelTextEditor, "generateVoxelKernel");
-		delete generateVoxelKernelTextEditor;
-		
-		TextFileEditor *generateNodeKernelTextEditor = new TextFileEditor;
-		generateNodeKernelTextEditor->openFile("ForgeData/OpenCL/Kernels/GenerateNode.cl");
-		this->generateNodeKernel = new GenerateNodeKernel(this->openCLManager, generateNodeKernelTextEditor, "generateNodeKernel");
-		delete generateNodeKernelTextEditor;
+		this->openCLManager->startup(this->isOpenCLProfilingEnabled);
 
-		// Used to store the return code from OpenCL functions
-		cl_int returnCode;
-		// Create and fill the voxel data buffer on the device
-		this->kernelVoxelDataBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_ONLY, sizeof(VoxelData) * (*this->voxelGrid->getVoxelDataArray()).getNumberOfElements(), NULL, &returnCode);
-		clEnqueueWriteBuffer(this->openCLManager->getCommandQueue(),
-							 this->kernelVoxelDataBuffer,
-							 CL_BLOCKING,
-							 0,
-							 sizeof(VoxelData) * this->voxelGrid->getVoxelDataArray()->getNumberOfElements(),
-							 &(*this->voxelGrid->getVoxelDataArray())[0],
-							 NULL,
-							 NULL,
-							 NULL);
+		// The renderer kernel is only fast enough on a GPU, so render on the CPU if the system does not have one
+		this->isCPURenderingEnabled = !this->openCLManager->getIsDeviceAGPU();
+
+		this->worldGenerator = new WorldGenerator();
+		this->worldGenerator->startup(this->openCLManager, this->voxelGrid, nullptr, nullptr, nullptr);
 
+		// The world starts out scrolling, so it needs the dense voxel octree
+		this->createVoxelBuffers();
 		this->generateWorld();
 
 		this->camera = new Camera(this->window->getInput());
 		this->camera->setIsMouseLookEnabled(false);
 
-		this->renderer = new OpenCLRenderer();
-		this->renderer->startup(this, this->kernelVoxelDataBuffer);
+		if(this->isCPURenderingEnabled)
+		{
+			CPURenderer *cpuRenderer = new CPURenderer();
+			cpuRenderer->startup(this);
+			this->renderer = cpuRenderer;
+		}
+		else
+		{
+			OpenCLRenderer *openCLRenderer = new OpenCLRenderer();
+			openCLRenderer->startup(this, this->openCLRendererSettings);
+			this->renderer = openCLRenderer;
+		}
 
 		this->fpsCounter = new FPSCounter();
 
 		this->window->getInput()->onGKeyReleased.addListener<Program, &Program::onGKeyReleased>(this);
 		this->window->getInput()->onVKeyReleased.addListener<Program, &Program::onVKeyReleased>(this);
+		this->window->getInput()->onCKeyReleased.addListener<Program, &Program::onCKeyReleased>(this);
+		this->window->getInput()->onPKeyReleased.addListener<Program, &Program::onPKeyReleased>(this);
+		this->window->getInput()->onHKeyReleased.addListener<Program, &Program::onHKeyReleased>(this);
 		this->window->getInput()->onMouseRightButtonDown.addListener<Program, &Program::onMouseRightButtonDown>(this);
 		this->window->getInput()->onMouseRightButtonUp.addListener<Program, &Program::onMouseRightButtonUp>(this);
 
@@ -123,51 +123,179 @@ namespace forge
 		loadingScreenRenderer.shutdown();
 	}
 
-	void Program::generateWorld()
+	void Program::createVoxelBuffers()
 	{
 		// Used to store the return code from OpenCL functions
 		cl_int returnCode;
+		// Create the voxel data buffer on the device. Every node above the voxel brick level, including the root node, is written when the world is generated,
+		// so it does not need to be filled
+		this->kernelVoxelDataBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_WRITE, sizeof(UInt8) * this->voxelGrid->getOctreeNodeChildMaskArray()->getNumberOfElements(), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		// Create the voxel brick buffer on the device. The world generator clears it before it generates the whole world, so it does not need to be filled
+		this->kernelVoxelBrickBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_WRITE, sizeof(UInt64) * this->voxelGrid->getVoxelBrickArray()->getNumberOfElements(), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		// Create the voxel brick first material index buffer on the device. It is written completely when the world is generated. The voxel material buffer
+		// is created by the world generator
+		this->kernelVoxelBrickFirstMaterialIndexBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_WRITE, sizeof(UInt32) * this->voxelGrid->getVoxelBrickFirstMaterialIndexArray()->getNumberOfElements(), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+
+		this->worldGenerator->setVoxelBuffers(this->kernelVoxelDataBuffer, this->kernelVoxelBrickBuffer, this->kernelVoxelBrickFirstMaterialIndexBuffer);
+	}
 
-		// Generate the voxels
+	void Program::releaseVoxelBuffers()
+	{
+		// The buffers are only freed once the commands that use them have finished
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelVoxelDataBuffer));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelVoxelBrickBuffer));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelVoxelBrickFirstMaterialIndexBuffer));
+		this->kernelVoxelDataBuffer = nullptr;
+		this->kernelVoxelBrickBuffer = nullptr;
+		this->kernelVoxelBrickFirstMaterialIndexBuffer = nullptr;
+		this->worldGenerator->setVoxelBuffers(nullptr, nullptr, nullptr);
+	}
+
+	void Program::generateWorld()
+	{
+		this->worldGenerator->generateWorld(floorFloat(this->worldOffset));
+
+		// The CPU renderer reads the voxels from the VoxelGrid object, so it needs the newly generated voxels
+		if(this->isCPURenderingEnabled)
 		{
-			this->generateVoxelKernel->setKernelVoxelArrayBuffer(this->kernelVoxelDataBuffer);
-			this->generateVoxelKernel->setVoxelOctreeDepth(this->voxelGrid->getOctreeDepth());
-			this->generateVoxelKernel->setOffset(this->worldOffset);
-
-			// Run the kernel
-			size_t globalWorkSize[3];
-			globalWorkSize[0] = static_cast<size_t>(this->voxelGrid->getSideLength());
-			globalWorkSize[1] = static_cast<size_t>(this->voxelGrid->getSideLength());
-			globalWorkSize[2] = static_cast<size_t>(this->voxelGrid->getSideLength());
-			returnCode = (clEnqueueNDRangeKernel(this->openCLManager->getCommandQueue(), this->generateVoxelKernel->getKernel(), 3, NULL, globalWorkSize, NULL, 0, NULL, NULL));
-
-			SizeType numberOfVoxels = this->voxelGrid->getSideLength() * this->voxelGrid->getSideLength() * this->voxelGrid->getSideLength();
+			this->copyVoxelDataFromDevice();
 		}
-		
-		// Generate all the parent nodes
+	}
+
+	void Program::copyVoxelDataFromDevice()
+	{
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(this->openCLManager->getCommandQueue(),
+									  this->kernelVoxelDataBuffer,
+									  CL_BLOCKING,
+									  0,
+									  sizeof(UInt8) * this->voxelGrid->getOctreeNodeChildMaskArray()->getNumberOfElements(),
+									  &((*this->voxelGrid->getOctreeNodeChildMaskArray())[0]),
+									  0,
+									  NULL,
+									  this->openCLManager->getProfiler()->getEventForCommand("copyVoxelDataFromDevice")));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(this->openCLManager->getCommandQueue(),
+									  this->kernelVoxelBrickBuffer,
+									  CL_BLOCKING,
+									  0,
+									  sizeof(UInt64) * this->voxelGrid->getVoxelBrickArray()->getNumberOfElements(),
+									  &((*this->voxelGrid->getVoxelBrickArray())[0]),
+									  0,
+									  NULL,
+									  this->openCLManager->getProfiler()->getEventForCommand("copyVoxelBricksFromDevice")));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(this->openCLManager->getCommandQueue(),
+									  this->kernelVoxelBrickFirstMaterialIndexBuffer,
+									  CL_BLOCKING,
+									  0,
+									  sizeof(UInt32) * this->voxelGrid->getVoxelBrickFirstMaterialIndexArray()->getNumberOfElements(),
+									  &((*this->voxelGrid->getVoxelBrickFirstMaterialIndexArray())[0]),
+									  0,
+									  NULL,
+									  this->openCLManager->getProfiler()->getEventForCommand("copyVoxelBrickFirstMaterialIndicesFromDevice")));
+
+		// Only the allocated voxel data is copied. If the last scroll ran out of room, the voxel bricks that did not fit point at the start of the voxel material array
+		// until the next scroll generates the whole world again, so only as much as fits is copied
+		const SizeType numberOfVoxelMaterials = min<SizeType>(this->worldGenerator->getNumberOfAllocatedVoxelMaterials(), this->worldGenerator->getVoxelMaterialArrayCapacity());
+		this->voxelGrid->setNumberOfVoxelMaterials(numberOfVoxelMaterials);
+		// Reading zero bytes is not allowed
+		if(numberOfVoxelMaterials > 0)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(this->openCLManager->getCommandQueue(),
+										  this->worldGenerator->getKernelVoxelMaterialBuffer(),
+										  CL_BLOCKING,
+										  0,
+										  sizeof(VoxelData) * numberOfVoxelMaterials,
+										  &((*this->voxelGrid->getVoxelMaterialArray())[0]),
+										  0,
+										  NULL,
+										  this->openCLManager->getProfiler()->getEventForCommand("copyVoxelMaterialsFromDevice")));
+		}
+	}
+
+	void Program::copyGeneratedVoxelDataFromDevice()
+	{
+		// If the whole world was generated, all of the arrays changed
+		const WorldGenerator::VoxelBrickRange &firstGeneratedVoxelBrickRange = this->worldGenerator->getGeneratedVoxelBrickRange(0);
+		const UInt32 maxVoxelBrickCoord = static_cast<UInt32>(this->voxelGrid->getSideLength() / VoxelGrid::voxelBrickSideLength) - 1;
+		if(this->worldGenerator->getNumberOfGeneratedVoxelBrickRanges() == 1 &&
+		   firstGeneratedVoxelBrickRange.minVoxelBrickCoords == IntegerVector3<UInt32>(0, 0, 0) &&
+		   firstGeneratedVoxelBrickRange.maxVoxelBrickCoords == IntegerVector3<UInt32>(maxVoxelBrickCoord, maxVoxelBrickCoord, maxVoxelBrickCoord))
 		{
-			this->generateNodeKernel->setKernelVoxelArrayBuffer(this->kernelVoxelDataBuffer);
+			this->copyVoxelDataFromDevice();
+			return;
+		}
 
-			UInt32 currentGridSideLength = this->voxelGrid->getSideLength() / 2;
-			for(UInt32 octreeDepth = this->voxelGrid->getOctreeDepth() - 1; octreeDepth != 0; --octreeDepth)
+		// The node levels are small next to the voxel bricks, and they are generated whole, so they are copied whole
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(this->openCLManager->getCommandQueue(),
+									  this->kernelVoxelDataBuffer,
+									  CL_NON_BLOCKING,
+									  0,
+									  sizeof(UInt8) * this->voxelGrid->getOctreeNodeChildMaskArray()->getNumberOfElements(),
+									  &((*this->voxelGrid->getOctreeNodeChildMaskArray())[0]),
+									  0,
+									  NULL,
+									  this->openCLManager->getProfiler()->getEventForCommand("copyVoxelDataFromDevice")));
+
+		// Everything else on the host is the same as on the device, so only the pages that hold the generated voxel bricks are copied. The voxel bricks of a slab
+		// are spread over the arrays in Morton order, but the ones next to each other along the slab share pages
+		ResizableArray<UInt64> &voxelBrickArray = *this->voxelGrid->getVoxelBrickArray();
+		ResizableArray<UInt32> &voxelBrickFirstMaterialIndexArray = *this->voxelGrid->getVoxelBrickFirstMaterialIndexArray();
+		DirtyMemoryPages voxelBrickPages;
+		DirtyMemoryPages voxelBrickFirstMaterialIndexPages;
+		voxelBrickPages.setMemorySize(sizeof(UInt64) * voxelBrickArray.getNumberOfElements());
+		voxelBrickFirstMaterialIndexPages.setMemorySize(sizeof(UInt32) * voxelBrickFirstMaterialIndexArray.getNumberOfElements());
+
+		DynamicArray<SizeType> generatedVoxelBrickIndices;
+		const UInt32 voxelBrickLevel = this->voxelGrid->getVoxelBrickLevel();
+		for(SizeType i = 0; i < this->worldGenerator->getNumberOfGeneratedVoxelBrickRanges(); ++i)
+		{
+			const WorldGenerator::VoxelBrickRange &generatedVoxelBrickRange = this->worldGenerator->getGeneratedVoxelBrickRange(i);
+			IntegerVector3<UInt32> voxelBrickCoords;
+			for(voxelBrickCoords.z = generatedVoxelBrickRange.minVoxelBrickCoords.z; voxelBrickCoords.z <= generatedVoxelBrickRange.maxVoxelBrickCoords.z; ++voxelBrickCoords.z)
 			{
-				this->generateNodeKernel->setVoxelOctreeDepth(octreeDepth);
-
-				// Run the kernel
-				size_t globalWorkSize[3];
-				globalWorkSize[0] = static_cast<size_t>(currentGridSideLength);
-				globalWorkSize[1] = static_cast<size_t>(currentGridSideLength);
-				globalWorkSize[2] = static_cast<size_t>(currentGridSideLength);
-				returnCode = (clEnqueueNDRangeKernel(this->openCLManager->getCommandQueue(), this->generateNodeKernel->getKernel(), 3, NULL, globalWorkSize, NULL, 0, NULL, NULL));
-				currentGridSideLength /= 2;
+				for(voxelBrickCoords.y = generatedVoxelBrickRange.minVoxelBrickCoords.y; voxelBrickCoords.y <= generatedVoxelBrickRange.maxVoxelBrickCoords.y; ++voxelBrickCoords.y)
+				{
+					for(voxelBrickCoords.x = generatedVoxelBrickRange.minVoxelBrickCoords.x; voxelBrickCoords.x <= generatedVoxelBrickRange.maxVoxelBrickCoords.x; ++voxelBrickCoords.x)
+					{
+						const SizeType voxelBrickIndex = this->voxelGrid->getNodeMortonCode(voxelBrickCoords, voxelBrickLevel) ^ bitwiseLeftShiftInteger<UInt32>(1, voxelBrickLevel * 3);
+						voxelBrickPages.markBytesAsDirty(sizeof(UInt64) * voxelBrickIndex, sizeof(UInt64));
+						voxelBrickFirstMaterialIndexPages.markBytesAsDirty(sizeof(UInt32) * voxelBrickIndex, sizeof(UInt32));
+						generatedVoxelBrickIndices.append(voxelBrickIndex);
+					}
+				}
 			}
 		}
+
+		voxelBrickPages.downloadDirtyPages(this->openCLManager->getCommandQueue(), this->kernelVoxelBrickBuffer, &voxelBrickArray[0]);
+		voxelBrickFirstMaterialIndexPages.downloadDirtyPages(this->openCLManager->getCommandQueue(), this->kernelVoxelBrickFirstMaterialIndexBuffer, &voxelBrickFirstMaterialIndexArray[0]);
+		FORGE_OPENCL_ERROR_CODE_CHECK(clFinish(this->openCLManager->getCommandQueue()));
+
+		// The generated voxel bricks only wrote their own voxel data, so only the pages that hold it are copied. Only as much as fits is copied, like in copyVoxelDataFromDevice
+		const SizeType numberOfVoxelMaterials = min<SizeType>(this->worldGenerator->getNumberOfAllocatedVoxelMaterials(), this->worldGenerator->getVoxelMaterialArrayCapacity());
+		this->voxelGrid->setNumberOfVoxelMaterials(numberOfVoxelMaterials);
+		DirtyMemoryPages voxelMaterialPages;
+		voxelMaterialPages.setMemorySize(sizeof(VoxelData) * numberOfVoxelMaterials);
+		for(SizeType i = 0; i < generatedVoxelBrickIndices.getNumberOfElements(); ++i)
+		{
+			const SizeType voxelBrickIndex = generatedVoxelBrickIndices[i];
+			voxelMaterialPages.markBytesAsDirty(sizeof(VoxelData) * voxelBrickFirstMaterialIndexArray[voxelBrickIndex], sizeof(VoxelData) * countSetBits(voxelBrickArray[voxelBrickIndex]));
+		}
+
+		// The generated voxel bricks may all be empty, and the voxel material array may have no elements then
+		if(voxelMaterialPages.getAreAnyPagesDirty())
+		{
+			voxelMaterialPages.downloadDirtyPages(this->openCLManager->getCommandQueue(), this->worldGenerator->getKernelVoxelMaterialBuffer(), &((*this->voxelGrid->getVoxelMaterialArray())[0]));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clFinish(this->openCLManager->getCommandQueue()));
+		}
 	}
 
 	void Program::runProgramLoop()
 	{
 		// Display a frame to the user before starting to take input
 		this->renderer->render();
+		this->openCLManager->getProfiler()->endFrame();
 
 		const Float maxFrameTime = 1.0f / 30.0f;
 
@@ -188,6 +316,9 @@ namespace forge
 			// Render a new frame
 			this->renderer->render();
 
+			// Collect the timestamps of the OpenCL commands enqueued in this frame
+			this->openCLManager->getProfiler()->endFrame();
+
 			this->fpsCounter->simulate(programLoopTimer.getTimePassed());
 		}
 	}
@@ -197,7 +328,7 @@ namespace forge
 		if(this->worldScrollingEnabled)
 		{
 			this->worldOffset += pDeltaTime * 10.0f;
-			this->generateWorld();
+			this->scrollWorld();
 		}
 
 		this->camera->update(pDeltaTime);
@@ -208,10 +339,32 @@ namespace forge
 		}
 	}
 
+	void Program::scrollWorld()
+	{
+		// The world moves by whole voxels, so that the voxels that stay in the voxel grid keep their values
+		const Float scrollDistance = floorFloat(this->worldOffset) - this->worldGenerator->getWorldOffset();
+		if(scrollDistance == 0.0f)
+		{
+			return;
+		}
+
+		// Only the voxels that come into the voxel grid are generated
+		this->worldGenerator->scrollWorld(static_cast<Int32>(scrollDistance));
+
+		// The CPU renderer reads the voxels from the VoxelGrid object, and traverses it with the same toroidal offset
+		if(this->isCPURenderingEnabled)
+		{
+			this->copyGeneratedVoxelDataFromDevice();
+		}
+	}
+
 	void Program::shutdown()
 	{
 		this->window->getInput()->onGKeyReleased.removeListener<Program, &Program::onGKeyReleased>(this);
 		this->window->getInput()->onVKeyReleased.removeListener<Program, &Program::onVKeyReleased>(this);
+		this->window->getInput()->onCKeyReleased.removeListener<Program, &Program::onCKeyReleased>(this);
+		this->window->getInput()->onPKeyReleased.removeListener<Program, &Program::onPKeyReleased>(this);
+		this->window->getInput()->onHKeyReleased.removeListener<Program, &Program::onHKeyReleased>(this);
 		this->window->getInput()->onMouseRightButtonDown.removeListener<Program, &Program::onMouseRightButtonDown>(this);
 		this->window->getInput()->onMouseRightButtonUp.removeListener<Program, &Program::onMouseRightButtonUp>(this);
 
@@ -228,12 +381,15 @@ namespace forge
 
 		delete this->camera;
 
-		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelVoxelDataBuffer));
+		if(this->kernelVoxelDataBuffer)
+		{
+			this->releaseVoxelBuffers();
+		}
 
 		delete this->voxelGrid;
 
-		delete this->generateVoxelKernel;
-		delete this->generateNodeKernel;
+		this->worldGenerator->shutdown();
+		delete this->worldGenerator;
 
 		this->openCLManager->shutdown();
 		delete this->openCLManager;
@@ -251,19 +407,18 @@ namespace forge
 			this->editor->shutdown();
 			delete this->editor;
 			this->editor = nullptr;
+
+			// The world scrolls on from the generated world, without the edits
+			this->createVoxelBuffers();
+			this->generateWorld();
 		}
 		else
 		{
-			// Copy the voxels from OpenCL device memory to the VoxelGrid object
-			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(this->openCLManager->getCommandQueue(),
-										  this->kernelVoxelDataBuffer,
-										  CL_BLOCKING,
-										  0,
-										  sizeof(VoxelData) * this->voxelGrid->getVoxelDataArray()->getNumberOfElements(),
-										  &((*this->voxelGrid->getVoxelDataArray())[0]),
-										  0,
-										  NULL,
-										  NULL));
+			// The VoxelGrid object and the edits have no toroidal offset, so the world is generated again without one before it is copied
+			this->worldGenerator->generateWorld(this->worldGenerator->getWorldOffset());
+			this->copyVoxelDataFromDevice();
+			// The static world is rendered from the sparse voxel octree, which is built from the VoxelGrid object, so the dense voxel octree is not needed until the world scrolls again
+			this->releaseVoxelBuffers();
 
 			this->editor = new Editor;
 			this->editor->startup(this);
@@ -275,6 +430,24 @@ namespace forge
 		this->voxelOctreeVisualizationEnabled = !this->voxelOctreeVisualizationEnabled;
 	}
 
+	void Program::onCKeyReleased()
+	{
+		this->checkerboardRenderingEnabled = !this->checkerboardRenderingEnabled;
+	}
+
+	void Program::onPKeyReleased()
+	{
+		this->persistentThreadsEnabled = !this->persistentThreadsEnabled;
+	}
+
+	void Program::onHKeyReleased()
+	{
+		if(this->openCLManager->getProfiler()->getIsEnabled())
+		{
+			this->openCLManager->getProfiler()->dump(std::cout);
+		}
+	}
+
 	void Program::onMouseRightButtonDown(Int pXCoord, Int pYCoord)
 	{
 		this->window->hideCursor();
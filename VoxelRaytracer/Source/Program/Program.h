@@ -3,16 +3,16 @@
 
 #include <Forge/Source/Core/Containers/DynamicArray.h>
 #include <Forge/Source/Platform/Windows/Window.h>
-#include <VoxelRaytracer/Source/Rendering/OpenCLRenderer/OpenCLRenderer.h>
+#include <VoxelRaytracer/Source/Rendering/Renderer.h>
 #include "VoxelGrid.h"
 #include "Camera.h"
 #include <Forge/Source/Platform/OpenCL/OpenCLKernel.h>
 #include <Forge/Source/Platform/OpenCL/OpenCLManager.h>
 #include <Forge/Source/Platform/Windows/Threading/Thread.h>
 #include <Forge/Source/Platform/Windows/Threading/Mutex.h>
-#include <VoxelRaytracer/Source/Program/WorldGenerator/Kernels/WorldGeneratorKernel.h>
-#include <VoxelRaytracer/Source/Program/WorldGenerator/Kernels/GenerateNodeKernel.h>
+#include <VoxelRaytracer/Source/Program/WorldGenerator/WorldGenerator.h>
 #include <VoxelRaytracer/Source/Rendering/DebugAABBData.h>
+#include <VoxelRaytracer/Source/Rendering/OpenCLRenderer/OpenCLRenderer.h>
 #include "FPSCounter.h"
 
 namespace forge
@@ -36,10 +36,33 @@ namespace forge
 
 		bool getIsVoxelOctreeVisualizationEnabled() const;
 
+		// While checkerboard rendering is enabled, only half of the pixels are traced in each frame and the other half are reconstructed from the previous frame
+		bool getIsCheckerboardRenderingEnabled() const;
+
+		// While persistent threads are enabled, the pixels are rendered by a fixed number of work groups that take batches of pixels until all of them are rendered
+		bool getIsPersistentThreadsEnabled() const;
+
+		// The world is static while world scrolling is disabled. The VoxelGrid object is kept up to date with the device memory while the world is static
+		bool getIsWorldScrollingEnabled() const;
+
 		Camera* getCamera() const;
 
 		VoxelGrid* getVoxelGrid() const;
 
+		// Generates the voxels in device memory
+		WorldGenerator* getWorldGenerator() const;
+
+		// The buffers of the dense voxel octree in device memory, which the world is generated into. They only exist while the world scrolls,
+		// since the static world is rendered from the sparse voxel octree, and are nullptr otherwise
+		cl_mem getKernelVoxelDataBuffer() const;
+
+		cl_mem getKernelVoxelBrickBuffer() const;
+
+		cl_mem getKernelVoxelBrickFirstMaterialIndexBuffer() const;
+
+		// The voxel material buffer is created by the world generator, and is created again whenever the world outgrows it
+		cl_mem getKernelVoxelMaterialBuffer() const;
+
 		Window* getWindow() const;
 
 		OpenCLManager *getOpenCLManager() const;
@@ -56,16 +79,35 @@ namespace forge
 
 		void loadingScreenThreadEntry();
 
+		// Create the buffers of the dense voxel octree and pass them to the world generator
+		void createVoxelBuffers();
+
+		// Release the buffers of the dense voxel octree, once the voxels have been copied from them
+		void releaseVoxelBuffers();
+
 		void generateWorld();
 
+		// Copy the voxels from OpenCL device memory to the VoxelGrid object
+		void copyVoxelDataFromDevice();
+
+		// Copy only the voxels that the world generator generated last, and the nodes above them, from OpenCL device memory to the VoxelGrid object.
+		// The rest of the VoxelGrid object must already be the same as on the device
+		void copyGeneratedVoxelDataFromDevice();
+
 		void runProgramLoop();
 
 		void update(Float pDeltaTime, Int64 pTimePassed);
 
+		// Move the world by the whole number of voxels that the world offset has moved by since the world was generated
+		void scrollWorld();
+
 		void shutdown();
 
 		void onGKeyReleased();
 		void onVKeyReleased();
+		void onCKeyReleased();
+		void onPKeyReleased();
+		void onHKeyReleased();
 		void onMouseRightButtonDown(Int pXCoord, Int pYCoord);
 		void onMouseRightButtonUp(Int pXCoord, Int pYCoord);
 
@@ -73,12 +115,13 @@ namespace forge
 		OpenCLManager *openCLManager;
 		VoxelGrid *voxelGrid;
 		Camera *camera;
-		OpenCLRenderer *renderer;
+		Renderer *renderer;
 		FPSCounter *fpsCounter;
 
-		WorldGeneratorKernel *generateVoxelKernel;
-		GenerateNodeKernel *generateNodeKernel;
-		cl_mem kernelVoxelDataBuffer;
+		WorldGenerator *worldGenerator;
+		cl_mem kernelVoxelDataBuffer = nullptr;
+		cl_mem kernelVoxelBrickBuffer = nullptr;
+		cl_mem kernelVoxelBrickFirstMaterialIndexBuffer = nullptr;
 
 		Thread loadingScreenThread;
 		bool shouldLoadingScreenThreadExit = false;
@@ -91,6 +134,14 @@ namespace forge
 		Float worldOffset = 0.0f;
 		bool worldScrollingEnabled = true;
 		bool voxelOctreeVisualizationEnabled = true;
+		bool checkerboardRenderingEnabled = false;
+		bool persistentThreadsEnabled = false;
+		// Whether the frames are rendered on the CPU instead of the OpenCL device. The VoxelGrid object must be kept up to date with the device memory if this is true
+		bool isCPURenderingEnabled = false;
+		// Whether the device timestamps of the OpenCL commands are recorded. The recorded frames are written to the console when the H key is released
+		bool isOpenCLProfilingEnabled = false;
+		// The settings that the OpenCL renderer is started with, if the frames are not rendered on the CPU
+		OpenCLRenderer::Settings openCLRendererSettings;
 	};
 
 	inline
@@ -105,6 +156,24 @@ namespace forge
 		return this->voxelOctreeVisualizationEnabled;
 	}
 
+	inline
+	bool Program::getIsCheckerboardRenderingEnabled() const
+	{
+		return this->checkerboardRenderingEnabled;
+	}
+
+	inline
+	bool Program::getIsPersistentThreadsEnabled() const
+	{
+		return this->persistentThreadsEnabled;
+	}
+
+	inline
+	bool Program::getIsWorldScrollingEnabled() const
+	{
+		return this->worldScrollingEnabled;
+	}
+
 	inline
 	Camera* Program::getCamera() const
 	{
@@ -117,6 +186,36 @@ namespace forge
 		return this->voxelGrid;
 	}
 
+	inline
+	WorldGenerator* Program::getWorldGenerator() const
+	{
+		return this->worldGenerator;
+	}
+
+	inline
+	cl_mem Program::getKernelVoxelDataBuffer() const
+	{
+		return this->kernelVoxelDataBuffer;
+	}
+
+	inline
+	cl_mem Program::getKernelVoxelBrickBuffer() const
+	{
+		return this->kernelVoxelBrickBuffer;
+	}
+
+	inline
+	cl_mem Program::getKernelVoxelBrickFirstMaterialIndexBuffer() const
+	{
+		return this->kernelVoxelBrickFirstMaterialIndexBuffer;
+	}
+
+	inline
+	cl_mem Program::getKernelVoxelMaterialBuffer() const
+	{
+		return this->worldGenerator->getKernelVoxelMaterialBuffer();
+	}
+
 	inline
 	Window* Program::getWindow() const
 	{
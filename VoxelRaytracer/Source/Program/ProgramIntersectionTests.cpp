@@ -189,4 +189,358 @@ namespace forge
 		// The ray intersects the voxel grid
 		return true;
 	}
+
+	bool rayAndVoxelOctreeIntersectionTest(Ray pRay, const VoxelGrid &pVoxelGrid, const IntegerVector3<Int32> &pVoxelGridToroidalOffset, bool pIsOctreeVisualizationEnabled, RayAndVoxelOctreeIntersectionData &pIntersectionData)
+	{
+		const UInt8 *voxelOctreeNodeChildMasksArray = &(*pVoxelGrid.getOctreeNodeChildMaskArray())[0];
+		const UInt64 *voxelBricksArray = &(*pVoxelGrid.getVoxelBrickArray())[0];
+		const UInt32 *voxelBrickFirstMaterialIndicesArray = &(*pVoxelGrid.getVoxelBrickFirstMaterialIndexArray())[0];
+		const ResizableArray<VoxelData> &voxelMaterialsArray = *pVoxelGrid.getVoxelMaterialArray();
+		const UInt32 voxelBrickLevel = pVoxelGrid.getVoxelBrickLevel();
+		const AABB voxelGridAABB = pVoxelGrid.getAABB();
+		const Vector3 rayDirection = pRay.getDirection();
+
+		// Check if the origin of the ray is outside the voxel grid AABB, and handle that case as necessary
+		if(!voxelGridAABB.isPointInside(pRay.getOrigin()))
+		{
+			// Check if the ray intersects the AABB of the voxel data
+			RayAndAABBIntersectionData rayAndAABBIntersectionData;
+			if(rayAndAABBIntersectionTest(Ray(pRay.getOrigin(), rayDirection, NumericTypeInfo<Float>::maxValue()), voxelGridAABB, rayAndAABBIntersectionData))
+			{
+				// Move the origin of the ray to the point on the AABB at which the ray enters the AABB
+				pRay.setOrigin(pRay.getOrigin() + rayDirection * rayAndAABBIntersectionData.distance);
+			}
+			else
+			{
+				// If the ray does not intersect the AABB of the voxel data, then the ray cannot not intersect any voxel in the voxel data
+				return false;
+			}
+		}
+
+		// The voxels are the nodes at the last level of the octree
+		const UInt32 voxelLevel = pVoxelGrid.getOctreeDepth() - 1;
+		const Int voxelGridSideLength = bitwiseLeftShiftInteger<Int>(1, voxelLevel);
+
+		// The octree is traversed in a mirrored coordinate system, in which every component of the direction of the ray is positive, so that the traversal
+		// never has to branch on the direction of the ray. Mirroring an axis flips every bit of the voxel coords along that axis, and the bit of that axis in every child index.
+		// Bit i of the octant mask is set if axis i is mirrored
+		UInt32 octantMask = 0;
+		// XOR the voxel coords with this to mirror them
+		IntegerVector3<Int> voxelCoordsMirrorMask;
+		// These are the iteration variables that are initialized at the start of the iteration and do not change during the iteration.
+		// The nodes are traversed in integer voxel coords relative to the minimum corner of the voxel grid, so the origin of the ray is moved into that space.
+		// Every distance along the ray is calculated from this origin, so no error is accumulated while the ray moves through the octree
+		Vector3 mirroredRayOrigin = pRay.getOrigin() - voxelGridAABB.getMinPoint();
+		Vector3 mirroredRayDirection;
+		Vector3 mirroredRayDirectionInverses;
+		for(UInt32 i = 0; i < 3; ++i)
+		{
+			const bool isAxisMirrored = (rayDirection[i] < 0.0f);
+			octantMask |= bitwiseLeftShiftInteger<UInt32>(isAxisMirrored? 1 : 0, i);
+			voxelCoordsMirrorMask[i] = isAxisMirrored? (voxelGridSideLength - 1) : 0;
+			mirroredRayOrigin[i] = isAxisMirrored? (static_cast<Float>(voxelGridSideLength) - mirroredRayOrigin[i]) : mirroredRayOrigin[i];
+			mirroredRayDirection[i] = abs<Float>(rayDirection[i]);
+			// A direction of 0 is replaced with a tiny positive one, so that the ray never reaches the next node along that axis
+			mirroredRayDirectionInverses[i] = 1.0f / max<Float>(mirroredRayDirection[i], 1e-20f);
+		}
+		// The same mirroring for the bits of a voxel brick, which hold two bits of the voxel coords along each axis
+		const UInt32 voxelBrickOctantMask = octantMask | bitwiseLeftShiftInteger<UInt32>(octantMask, 3);
+
+		// With a toroidal offset, the nodes are traversed where the voxels are stored, and the origin of the ray is moved there as well. The ray wraps around
+		// to the start of the memory whenever it leaves the end of it, and it leaves the voxel grid in the middle of the memory instead, at the mirrored coords
+		// in memory of the first voxels past the voxel grid. The origin only changes when the ray wraps around, by a whole number of side lengths, so no error is accumulated
+		const bool isVoxelGridToroidal = (pVoxelGridToroidalOffset.x != 0 || pVoxelGridToroidalOffset.y != 0 || pVoxelGridToroidalOffset.z != 0);
+		IntegerVector3<Int> voxelGridExitCoords(voxelGridSideLength, voxelGridSideLength, voxelGridSideLength);
+		if(isVoxelGridToroidal)
+		{
+			for(UInt32 i = 0; i < 3; ++i)
+			{
+				// The point at which the ray enters the voxel grid can be slightly outside of it, which would wrap it around to the other end of the voxel grid
+				mirroredRayOrigin[i] = clamp<Float>(mirroredRayOrigin[i], 0.0f, static_cast<Float>(voxelGridSideLength));
+
+				// Mirroring moves the toroidal offset the other way along the mirrored axes
+				const bool isAxisMirrored = (octantMask & bitwiseLeftShiftInteger<UInt32>(1, i)) != 0;
+				const Int mirroredToroidalOffset = isAxisMirrored? ((voxelGridSideLength - pVoxelGridToroidalOffset[i]) & (voxelGridSideLength - 1)) : pVoxelGridToroidalOffset[i];
+				mirroredRayOrigin[i] += static_cast<Float>(mirroredToroidalOffset);
+				voxelGridExitCoords[i] += mirroredToroidalOffset;
+
+				if(mirroredRayOrigin[i] >= static_cast<Float>(voxelGridSideLength))
+				{
+					mirroredRayOrigin[i] -= static_cast<Float>(voxelGridSideLength);
+					voxelGridExitCoords[i] -= voxelGridSideLength;
+				}
+
+				// If the ray starts at the exit of the voxel grid
+				if(floorFloatToInteger<Int>(mirroredRayOrigin[i]) >= voxelGridExitCoords[i])
+				{
+					return false;
+				}
+			}
+		}
+
+		// These are the iteration variables that are initialized at the start of the iteration and can change during the iteration
+		UInt32 currentNodeMortonCode = 0x00000001;
+		UInt32 currentLevel = 0;
+		// The mirrored voxel coords of the minimum corner of the current node
+		IntegerVector3<Int> currentNodeMinCoords(0, 0, 0);
+		// The distance from the origin of the ray at which the ray enters the current node
+		Float currentRayDistance = 0.0f;
+		bool hasCurrentNodeBeenExplored = false;
+
+		// Traverse the octree
+		while(true)
+		{
+			// The side length of a node at the current level, in voxels, is a power of 2
+			const UInt32 currentNodeSideLengthLog2 = voxelLevel - currentLevel;
+			const Int currentNodeSideLength = bitwiseLeftShiftInteger<Int>(1, currentNodeSideLengthLog2);
+
+			// If the current node has been explored
+			if(hasCurrentNodeBeenExplored)
+			{
+				// Each component holds the distance from the origin of the ray at which the ray leaves the current node through its boundary along the corresponding axis
+				Vector3 rayDistancesToNodeExit;
+				for(SizeType i = 0; i < 3; ++i)
+				{
+					rayDistancesToNodeExit[i] = (static_cast<Float>(currentNodeMinCoords[i] + currentNodeSideLength) - mirroredRayOrigin[i]) * mirroredRayDirectionInverses[i];
+				}
+
+				// Move to the neighbouring node at the current level along the axis whose boundary the ray leaves the current node through first.
+				// Only the coordinate along that axis changes
+				SizeType axisOfNextNode;
+				if(rayDistancesToNodeExit.x < rayDistancesToNodeExit.y)
+				{
+					axisOfNextNode = (rayDistancesToNodeExit.x < rayDistancesToNodeExit.z)? 0 : 2;
+				}
+				else
+				{
+					axisOfNextNode = (rayDistancesToNodeExit.y < rayDistancesToNodeExit.z)? 1 : 2;
+				}
+				IntegerVector3<Int> nextNodeMinCoords = currentNodeMinCoords;
+				nextNodeMinCoords[axisOfNextNode] += currentNodeSideLength;
+
+				// If the next node is outside the voxel grid
+				if(nextNodeMinCoords.x >= voxelGridExitCoords.x || nextNodeMinCoords.y >= voxelGridExitCoords.y || nextNodeMinCoords.z >= voxelGridExitCoords.z)
+				{
+					// The ray has exited the octree without hitting any voxel, so return false
+					return false;
+				}
+
+				// With a toroidal offset, the ray can leave the end of the memory before it leaves the voxel grid. It goes on from the start of the memory
+				// along that axis, so it starts again from the root node there
+				if(nextNodeMinCoords[axisOfNextNode] >= voxelGridSideLength)
+				{
+					mirroredRayOrigin[axisOfNextNode] -= static_cast<Float>(voxelGridSideLength);
+					voxelGridExitCoords[axisOfNextNode] -= voxelGridSideLength;
+					currentNodeMortonCode = 0x00000001;
+					currentLevel = 0;
+					currentNodeMinCoords = IntegerVector3<Int>(0, 0, 0);
+					currentRayDistance = max<Float>(currentRayDistance, rayDistancesToNodeExit[axisOfNextNode]);
+					hasCurrentNodeBeenExplored = false;
+					continue;
+				}
+
+				// Step up directly to the level whose nodes the ray is moving between. The highest bit in which the coords of the current and the next node differ
+				// is the side length of the nodes at that level, because all the higher bits are the same in both of their coords, so they have the same parent there
+				const UInt32 nextNodeSideLengthLog2 = getHighestSetBitIndex(static_cast<UInt32>(currentNodeMinCoords[axisOfNextNode] ^ nextNodeMinCoords[axisOfNextNode]));
+				const UInt32 nextLevel = voxelLevel - nextNodeSideLengthLog2;
+
+				// The child index of the next node only differs from the one of the ancestor of the current node at that level in the bit of the axis it moved along.
+				// This is the same whether or not the axis is mirrored
+				currentNodeMortonCode = bitwiseRightShiftInteger<UInt32>(currentNodeMortonCode, (currentLevel - nextLevel) * 3) ^ bitwiseLeftShiftInteger<UInt32>(1, static_cast<UInt32>(axisOfNextNode));
+				currentLevel = nextLevel;
+				for(SizeType i = 0; i < 3; ++i)
+				{
+					currentNodeMinCoords[i] = nextNodeMinCoords[i] & ~(bitwiseLeftShiftInteger<Int>(1, nextNodeSideLengthLog2) - 1);
+				}
+				currentRayDistance = max<Float>(currentRayDistance, rayDistancesToNodeExit[axisOfNextNode]);
+
+				// Mark the node just stepped to as not explored
+				hasCurrentNodeBeenExplored = false;
+			}
+			// If the current node has not been explored
+			else
+			{
+				// The nodes at the voxel brick level are stored as voxel bricks, which are indexed by their Morton codes without the leading 1 bit
+				const bool isCurrentNodeAVoxelBrick = (currentLevel == voxelBrickLevel);
+				const UInt32 currentVoxelBrickIndex = isCurrentNodeAVoxelBrick? (currentNodeMortonCode ^ bitwiseLeftShiftInteger<UInt32>(1, voxelBrickLevel * 3)) : 0;
+				const UInt64 currentVoxelBrick = isCurrentNodeAVoxelBrick? voxelBricksArray[currentVoxelBrickIndex] : 0;
+
+				// If the current node has any children
+				if(isCurrentNodeAVoxelBrick? (currentVoxelBrick != 0) : (voxelOctreeNodeChildMasksArray[currentNodeMortonCode] != 0))
+				{
+					// The mirrored position at which the ray enters the current node
+					const Vector3 currentRayPosition = mirroredRayOrigin + mirroredRayDirection * currentRayDistance;
+
+					// Hit the borders of the octree nodes if the octree is being visualized
+					if(pIsOctreeVisualizationEnabled)
+					{
+						const Float nodeHalfScale = static_cast<Float>(currentNodeSideLength) / 2.0f;
+						Int numberOfCoordsInBorderRange = 0;
+						for(SizeType i = 0; i < 3; ++i)
+						{
+							if(abs<Float>(static_cast<Float>(currentNodeMinCoords[i]) + nodeHalfScale - currentRayPosition[i]) > nodeHalfScale - 0.1f)
+							{
+								++numberOfCoordsInBorderRange;
+							}
+						}
+						if(numberOfCoordsInBorderRange > 1)
+						{
+							// Octree node borders are not voxels, so they are given the empty voxel data
+							pIntersectionData.voxelData = VoxelData();
+							pIntersectionData.point = pRay.getOrigin() + rayDirection * currentRayDistance;
+							return true;
+						}
+					}
+
+					// The voxel that the ray enters the current node in. It is clamped to the current node, in case the ray position was rounded to just outside of it
+					IntegerVector3<Int> currentVoxelCoords;
+					for(SizeType i = 0; i < 3; ++i)
+					{
+						currentVoxelCoords[i] = clamp<Int>(floorFloatToInteger<Int>(currentRayPosition[i]), currentNodeMinCoords[i], currentNodeMinCoords[i] + currentNodeSideLength - 1);
+					}
+
+					// If the current node is a voxel brick
+					if(isCurrentNodeAVoxelBrick)
+					{
+						// With a toroidal offset, the ray can start again from the root node after it has wrapped around to the start of the memory, at the same time
+						// as it leaves the voxel grid along another axis
+						if(currentVoxelCoords.x >= voxelGridExitCoords.x || currentVoxelCoords.y >= voxelGridExitCoords.y || currentVoxelCoords.z >= voxelGridExitCoords.z)
+						{
+							return false;
+						}
+
+						// Traverse the voxels in the voxel brick as a uniform grid, testing the bit of each voxel that the ray enters
+						IntegerVector3<Int> voxelCoordsInVoxelBrick;
+						// Each component holds the distance from the origin of the ray at which the ray enters the next voxel along the corresponding axis
+						Vector3 rayDistancesToNextVoxels;
+						for(SizeType i = 0; i < 3; ++i)
+						{
+							voxelCoordsInVoxelBrick[i] = currentVoxelCoords[i] - currentNodeMinCoords[i];
+							rayDistancesToNextVoxels[i] = (static_cast<Float>(currentVoxelCoords[i] + 1) - mirroredRayOrigin[i]) * mirroredRayDirectionInverses[i];
+						}
+						// The distance from the origin of the ray at which the ray enters the current voxel
+						Float rayDistanceToCurrentVoxel = currentRayDistance;
+
+						while(true)
+						{
+							// The bits of a voxel brick are in Morton order, and the bits of the mirrored axes are flipped to get the bit in the voxel brick
+							UInt32 voxelBrickBitIndex = 0;
+							for(UInt32 i = 0; i < 3; ++i)
+							{
+								voxelBrickBitIndex |= bitwiseLeftShiftInteger<UInt32>(voxelCoordsInVoxelBrick[i] & 0x00000001, i);
+								voxelBrickBitIndex |= bitwiseLeftShiftInteger<UInt32>((voxelCoordsInVoxelBrick[i] >> 1) & 0x00000001, i + 3);
+							}
+							voxelBrickBitIndex ^= voxelBrickOctantMask;
+
+							// If the current voxel is non empty
+							if(currentVoxelBrick & bitwiseLeftShiftInteger<UInt64>(1, voxelBrickBitIndex))
+							{
+								// A voxel has been hit, so fill the intersection data and return true.
+								// Only the non empty voxels of a voxel brick have voxel data, in the same order as their bits, so skip the ones that come before this voxel
+								const Vector3 hitPosition = pRay.getOrigin() + rayDirection * rayDistanceToCurrentVoxel;
+								const UInt64 lowerVoxelBits = currentVoxelBrick & (bitwiseLeftShiftInteger<UInt64>(1, voxelBrickBitIndex) - 1);
+								pIntersectionData.voxelData = voxelMaterialsArray[voxelBrickFirstMaterialIndicesArray[currentVoxelBrickIndex] + countSetBits(lowerVoxelBits)];
+								pIntersectionData.point = hitPosition;
+
+								// Calculate the uv coordinates and normals. The coords of the voxel in memory are moved back by the toroidal offset
+								AABB voxelAABB;
+								Vector3 voxelMinPoint = voxelGridAABB.getMinPoint();
+								for(SizeType i = 0; i < 3; ++i)
+								{
+									voxelMinPoint[i] += static_cast<Float>((((currentNodeMinCoords[i] + voxelCoordsInVoxelBrick[i]) ^ voxelCoordsMirrorMask[i]) - pVoxelGridToroidalOffset[i]) & (voxelGridSideLength - 1));
+								}
+								voxelAABB.setMinPoint(voxelMinPoint);
+								voxelAABB.setMaxPoint(voxelMinPoint + Vector3(1.0f, 1.0f, 1.0f));
+								RayAndAABBIntersectionData rayAndVoxelAABBIntersectionData;
+								if(rayAndAABBIntersectionTest(Ray(pRay.getOrigin(), rayDirection, NumericTypeInfo<Float>::maxValue()), voxelAABB, rayAndVoxelAABBIntersectionData))
+								{
+									pIntersectionData.normal = rayAndVoxelAABBIntersectionData.normal;
+
+									if(abs<Float>(rayAndVoxelAABBIntersectionData.normal.x) > 0.5f)
+									{
+										pIntersectionData.uCoord = hitPosition.z - voxelAABB.getMinPoint().z;
+										pIntersectionData.vCoord = hitPosition.y - voxelAABB.getMinPoint().y;
+									}
+									else if(abs<Float>(rayAndVoxelAABBIntersectionData.normal.y) > 0.5f)
+									{
+										pIntersectionData.uCoord = hitPosition.x - voxelAABB.getMinPoint().x;
+										pIntersectionData.vCoord = hitPosition.z - voxelAABB.getMinPoint().z;
+									}
+									else
+									{
+										pIntersectionData.uCoord = hitPosition.x - voxelAABB.getMinPoint().x;
+										pIntersectionData.vCoord = hitPosition.y - voxelAABB.getMinPoint().y;
+									}
+								}
+								else
+								{
+									pIntersectionData.normal = Vector3(0.0f, 0.0f, 0.0f);
+									pIntersectionData.uCoord = 0.0f;
+									pIntersectionData.vCoord = 0.0f;
+								}
+
+								return true;
+							}
+
+							// Step to the next voxel along the axis whose voxel boundary is the closest
+							SizeType axisOfNextVoxel;
+							if(rayDistancesToNextVoxels.x < rayDistancesToNextVoxels.y)
+							{
+								axisOfNextVoxel = (rayDistancesToNextVoxels.x < rayDistancesToNextVoxels.z)? 0 : 2;
+							}
+							else
+							{
+								axisOfNextVoxel = (rayDistancesToNextVoxels.y < rayDistancesToNextVoxels.z)? 1 : 2;
+							}
+							rayDistanceToCurrentVoxel = rayDistancesToNextVoxels[axisOfNextVoxel];
+							rayDistancesToNextVoxels[axisOfNextVoxel] += mirroredRayDirectionInverses[axisOfNextVoxel];
+							++voxelCoordsInVoxelBrick[axisOfNextVoxel];
+
+							// If the ray has left the voxel brick
+							if(voxelCoordsInVoxelBrick[axisOfNextVoxel] >= VoxelGrid::voxelBrickSideLength)
+							{
+								break;
+							}
+
+							// With a toroidal offset, the ray can leave the voxel grid inside a voxel brick
+							if(currentNodeMinCoords[axisOfNextVoxel] + voxelCoordsInVoxelBrick[axisOfNextVoxel] >= voxelGridExitCoords[axisOfNextVoxel])
+							{
+								return false;
+							}
+						}
+
+						// The ray has passed through the voxel brick without hitting any voxel, so mark it as explored
+						hasCurrentNodeBeenExplored = true;
+					}
+					else
+					{
+						// Step down to the child node of the current node that the ray enters the current node in
+						const UInt32 childNodeSideLengthLog2 = currentNodeSideLengthLog2 - 1;
+						UInt32 childNodeIndex = 0;
+						for(UInt32 i = 0; i < 3; ++i)
+						{
+							const Int childNodeCoord = bitwiseRightShiftInteger<Int>(currentVoxelCoords[i], childNodeSideLengthLog2) & 0x00000001;
+							childNodeIndex |= bitwiseLeftShiftInteger<UInt32>(childNodeCoord, i);
+							currentNodeMinCoords[i] += bitwiseLeftShiftInteger<Int>(childNodeCoord, childNodeSideLengthLog2);
+						}
+
+						// The child index bits of the mirrored axes are flipped, to get the child index in the octree
+						currentNodeMortonCode = (currentNodeMortonCode << 3) | (childNodeIndex ^ octantMask);
+						++currentLevel;
+
+						// Mark the current node at the level just stepped down to as not explored
+						hasCurrentNodeBeenExplored = false;
+					}
+				}
+				// The current node does not have any children, so mark it as explored
+				else
+				{
+					hasCurrentNodeBeenExplored = true;
+				}
+			}
+		}
+
+		// The code in the loop above should always return with the correct value, but this return statement is here just in case
+		return false;
+	}
 }
\ No newline at end of file
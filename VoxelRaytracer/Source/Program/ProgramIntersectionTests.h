@@ -41,6 +41,39 @@ namespace forge
 										 RayAndVoxelDataIntersectionData &pIntersectionData,
 										 bool pShouldStopOnNonEmptyVoxelHit = true,
 										 SizeType pMaximumNumberOfVoxelsToTraverse = NumericTypeInfo<SizeType>::maxValue());
+
+	// Holds data about the intersection between a ray and the octree of a voxel grid
+	struct RayAndVoxelOctreeIntersectionData
+	{
+		// The data of the voxel that the ray hit
+		VoxelData voxelData;
+		// The point at which the ray enters the voxel
+		Vector3 point;
+		// The texture coordinates of the point on the voxel face that the ray enters the voxel through
+		Float uCoord;
+		Float vCoord;
+		// The normal of the face of the voxel that the ray enters the voxel through
+		Vector3 normal;
+	};
+
+	/// <summary>
+	/// Perform an intersection test between a ray and the octree of a voxel grid.
+	/// This is a port of the function with the same name in ForgeData/OpenCL/Include/ProgramIntersectionTests.cl, and must produce the same results.
+	/// Any change made to the traversal here must also be made there, and vice versa
+	/// </summary>
+	/// <param name="pRay">The ray. Its length is ignored</param>
+	/// <param name="pVoxelGrid">The voxel grid</param>
+	/// <param name="pVoxelGridToroidalOffset">The voxel with the remapped coords c is stored at ((c + pVoxelGridToroidalOffset) mod sideLength) along each axis.
+	///				 Each component is in the range (0, sideLength - 1)</param>
+	/// <param name="pIsOctreeVisualizationEnabled">Whether the borders of the octree nodes should be hit as well.
+	///				 When a border is hit, the intersection data will have the empty voxel data</param>
+	/// <param name="pIntersectionData">The output parameter into which the result of the intersection test will be written if an intersection is found</param>
+	/// <returns>True if the ray hits a non empty voxel, false if it does not</returns>
+	bool rayAndVoxelOctreeIntersectionTest(Ray pRay,
+										   const VoxelGrid &pVoxelGrid,
+										   const IntegerVector3<Int32> &pVoxelGridToroidalOffset,
+										   bool pIsOctreeVisualizationEnabled,
+										   RayAndVoxelOctreeIntersectionData &pIntersectionData);
 }
 
 #endif
\ No newline at end of file
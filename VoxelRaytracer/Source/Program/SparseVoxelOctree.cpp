@@ -0,0 +1,310 @@
+#include "SparseVoxelOctree.h"
+#include <Forge/Source/Core/Utility.h>
+
+namespace forge
+{
+	namespace
+	{
+		// Make room for the given number of elements after the elements of an array that are in use, and return the index of the first of them.
+		// The array grows by at least half of its length if they do not fit in it, so that updates in a row do not reallocate it every time
+		template <typename ElementType>
+		SizeType appendElements(ResizableArray<ElementType> &pArray, SizeType &pNumberOfElementsInUse, SizeType pNumberOfElements)
+		{
+			const SizeType firstElementIndex = pNumberOfElementsInUse;
+			pNumberOfElementsInUse += pNumberOfElements;
+			if(pNumberOfElementsInUse > pArray.getNumberOfElements())
+			{
+				pArray.setNumberOfElements(max(pNumberOfElementsInUse, pArray.getNumberOfElements() + pArray.getNumberOfElements() / 2));
+			}
+			return firstElementIndex;
+		}
+
+		// Get the number of set bits of a child mask below the bit of the child with the given index
+		UInt32 countSetBitsBelowChild(UInt32 pChildMask, UInt32 pChildIndex)
+		{
+			return countSetBits(pChildMask & (bitwiseLeftShiftInteger<UInt32>(1, pChildIndex) - 1));
+		}
+	}
+
+	void SparseVoxelOctree::build(const VoxelGrid &pVoxelGrid)
+	{
+		this->octreeDepth = pVoxelGrid.getOctreeDepth();
+		const ResizableArray<UInt8> &octreeNodeChildMaskArray = *pVoxelGrid.getOctreeNodeChildMaskArray();
+		const ResizableArray<UInt64> &gridVoxelBrickArray = *pVoxelGrid.getVoxelBrickArray();
+		const ResizableArray<UInt32> &gridVoxelBrickFirstMaterialIndexArray = *pVoxelGrid.getVoxelBrickFirstMaterialIndexArray();
+		const ResizableArray<VoxelData> &gridVoxelMaterialArray = *pVoxelGrid.getVoxelMaterialArray();
+		// The interior nodes are the nodes above the voxel brick level
+		const SizeType numberOfInteriorNodeLevels = pVoxelGrid.getVoxelBrickLevel();
+
+		// The Morton codes of the existing interior nodes, level by level in breadth first order. The root node is the only node at level 0
+		ResizableArray<ResizableArray<UInt32>> nodeMortonCodesPerLevel(numberOfInteriorNodeLevels);
+		nodeMortonCodesPerLevel[0].setNumberOfElements(1);
+		nodeMortonCodesPerLevel[0][0] = 1;
+
+		// Collect the Morton codes of the existing interior nodes at each level from the child masks of the level above it
+		SizeType numberOfNodes = 1;
+		for(SizeType level = 1; level < numberOfInteriorNodeLevels; ++level)
+		{
+			const ResizableArray<UInt32> &parentMortonCodes = nodeMortonCodesPerLevel[level - 1];
+
+			// Count the children first, so that the array is only allocated once
+			SizeType numberOfNodesAtLevel = 0;
+			for(SizeType i = 0; i < parentMortonCodes.getNumberOfElements(); ++i)
+			{
+				numberOfNodesAtLevel += countSetBits(octreeNodeChildMaskArray[parentMortonCodes[i]]);
+			}
+
+			ResizableArray<UInt32> &mortonCodes = nodeMortonCodesPerLevel[level];
+			mortonCodes.setNumberOfElements(numberOfNodesAtLevel);
+
+			SizeType nextIndex = 0;
+			for(SizeType i = 0; i < parentMortonCodes.getNumberOfElements(); ++i)
+			{
+				const UInt8 childMask = octreeNodeChildMaskArray[parentMortonCodes[i]];
+				for(UInt32 childIndex = 0; childIndex < 8; ++childIndex)
+				{
+					if(childMask & bitwiseLeftShiftInteger<UInt32>(1, childIndex))
+					{
+						mortonCodes[nextIndex++] = bitwiseLeftShiftInteger<UInt32>(parentMortonCodes[i], 3) | childIndex;
+					}
+				}
+			}
+
+			numberOfNodes += numberOfNodesAtLevel;
+		}
+
+		// Write the interior nodes in breadth first order. The children of the nodes at one level are the nodes at the next level, in the same order
+		this->nodeArray.setNumberOfElements(numberOfNodes);
+		this->numberOfNodes = numberOfNodes;
+		SizeType nextNodeIndex = 0;
+		// The index of the first child of the next node that has children
+		SizeType nextFirstChildIndex = 1;
+		SizeType numberOfVoxelBricks = 0;
+		for(SizeType level = 0; level < numberOfInteriorNodeLevels; ++level)
+		{
+			const ResizableArray<UInt32> &mortonCodes = nodeMortonCodesPerLevel[level];
+
+			// The children of the nodes just above the voxel brick level are stored in the voxel brick array, so their indices start from 0
+			if(level == numberOfInteriorNodeLevels - 1)
+			{
+				nextFirstChildIndex = 0;
+			}
+
+			for(SizeType i = 0; i < mortonCodes.getNumberOfElements(); ++i)
+			{
+				Node &node = this->nodeArray[nextNodeIndex++];
+				node.childMask = octreeNodeChildMaskArray[mortonCodes[i]];
+				node.firstChildIndex = static_cast<UInt32>(nextFirstChildIndex);
+
+				const UInt32 numberOfChildren = countSetBits(node.childMask);
+				nextFirstChildIndex += numberOfChildren;
+				if(level == numberOfInteriorNodeLevels - 1)
+				{
+					numberOfVoxelBricks += numberOfChildren;
+				}
+			}
+		}
+
+		// Write the voxel bricks in the same order as the children masks of the nodes just above the voxel brick level
+		this->voxelBrickArray.setNumberOfElements(numberOfVoxelBricks);
+		this->voxelBrickFirstMaterialIndexArray.setNumberOfElements(numberOfVoxelBricks);
+		this->numberOfVoxelBricks = numberOfVoxelBricks;
+		const ResizableArray<UInt32> &voxelBrickParentMortonCodes = nodeMortonCodesPerLevel[numberOfInteriorNodeLevels - 1];
+		// The voxel bricks of the voxel grid are indexed by the Morton codes of their nodes without the leading 1 bit
+		const UInt32 voxelBrickMortonCodeLeadingBit = bitwiseLeftShiftInteger<UInt32>(1, static_cast<UInt32>(numberOfInteriorNodeLevels * 3));
+		SizeType nextVoxelBrickIndex = 0;
+		SizeType numberOfNonEmptyVoxels = 0;
+		for(SizeType i = 0; i < voxelBrickParentMortonCodes.getNumberOfElements(); ++i)
+		{
+			const UInt8 childMask = octreeNodeChildMaskArray[voxelBrickParentMortonCodes[i]];
+			for(UInt32 childIndex = 0; childIndex < 8; ++childIndex)
+			{
+				if(childMask & bitwiseLeftShiftInteger<UInt32>(1, childIndex))
+				{
+					const UInt32 voxelBrickMortonCode = bitwiseLeftShiftInteger<UInt32>(voxelBrickParentMortonCodes[i], 3) | childIndex;
+					const UInt64 voxelBrick = gridVoxelBrickArray[voxelBrickMortonCode ^ voxelBrickMortonCodeLeadingBit];
+					this->voxelBrickArray[nextVoxelBrickIndex] = voxelBrick;
+					this->voxelBrickFirstMaterialIndexArray[nextVoxelBrickIndex] = static_cast<UInt32>(numberOfNonEmptyVoxels);
+					numberOfNonEmptyVoxels += countSetBits(voxelBrick);
+					++nextVoxelBrickIndex;
+				}
+			}
+		}
+
+		// Write the voxel data of the non empty voxels of each voxel brick, in the same order as their bits
+		this->voxelMaterialArray.setNumberOfElements(numberOfNonEmptyVoxels);
+		this->numberOfVoxelMaterials = numberOfNonEmptyVoxels;
+		SizeType nextVoxelMaterialIndex = 0;
+		for(SizeType i = 0; i < voxelBrickParentMortonCodes.getNumberOfElements(); ++i)
+		{
+			const UInt8 childMask = octreeNodeChildMaskArray[voxelBrickParentMortonCodes[i]];
+			for(UInt32 childIndex = 0; childIndex < 8; ++childIndex)
+			{
+				if(childMask & bitwiseLeftShiftInteger<UInt32>(1, childIndex))
+				{
+					// The voxel grid stores the voxel data of the non empty voxels of a voxel brick in the same order
+					const UInt32 voxelBrickMortonCode = bitwiseLeftShiftInteger<UInt32>(voxelBrickParentMortonCodes[i], 3) | childIndex;
+					const SizeType voxelBrickIndex = voxelBrickMortonCode ^ voxelBrickMortonCodeLeadingBit;
+					const UInt32 numberOfNonEmptyVoxels = countSetBits(gridVoxelBrickArray[voxelBrickIndex]);
+					const SizeType gridFirstMaterialIndex = gridVoxelBrickFirstMaterialIndexArray[voxelBrickIndex];
+					for(UInt32 j = 0; j < numberOfNonEmptyVoxels; ++j)
+					{
+						this->voxelMaterialArray[nextVoxelMaterialIndex++] = gridVoxelMaterialArray[gridFirstMaterialIndex + j];
+					}
+				}
+			}
+		}
+	}
+
+	void SparseVoxelOctree::updateVoxelBricks(const VoxelGrid &pVoxelGrid, const IntegerVector3<UInt32> &pMinVoxelBrickCoords, const IntegerVector3<UInt32> &pMaxVoxelBrickCoords)
+	{
+		// The root node is always the first node, and it is above every voxel brick
+		this->updateNode(pVoxelGrid, 0, IntegerVector3<UInt32>(0, 0, 0), 0, pMinVoxelBrickCoords, pMaxVoxelBrickCoords);
+	}
+
+	void SparseVoxelOctree::updateNode(const VoxelGrid &pVoxelGrid, SizeType pNodeIndex, const IntegerVector3<UInt32> &pNodeCoords, UInt32 pNodeLevel,
+									   const IntegerVector3<UInt32> &pMinVoxelBrickCoords, const IntegerVector3<UInt32> &pMaxVoxelBrickCoords)
+	{
+		const UInt32 voxelBrickLevel = pVoxelGrid.getVoxelBrickLevel();
+		const bool areChildrenVoxelBricks = pNodeLevel + 1 == voxelBrickLevel;
+		const UInt32 newChildMask = (*pVoxelGrid.getOctreeNodeChildMaskArray())[pVoxelGrid.getNodeMortonCode(pNodeCoords, pNodeLevel)];
+		// The node is copied, since appending children may move the node array
+		Node node = this->nodeArray[pNodeIndex];
+
+		if(newChildMask != node.childMask)
+		{
+			// Gather the children in the order of the new child mask. The children that are kept keep their contents, and the new ones start out empty, so that they are filled in below
+			const UInt32 numberOfNewChildren = countSetBits(newChildMask);
+			const bool doNewChildrenFit = numberOfNewChildren <= countSetBits(node.childMask);
+			if(areChildrenVoxelBricks)
+			{
+				UInt64 voxelBricks[8];
+				UInt32 voxelBrickFirstMaterialIndices[8];
+				UInt32 numberOfGatheredChildren = 0;
+				for(UInt32 childIndex = 0; childIndex < 8; ++childIndex)
+				{
+					if(newChildMask & bitwiseLeftShiftInteger<UInt32>(1, childIndex))
+					{
+						const bool doesChildExist = (node.childMask & bitwiseLeftShiftInteger<UInt32>(1, childIndex)) != 0;
+						const SizeType oldVoxelBrickIndex = node.firstChildIndex + countSetBitsBelowChild(node.childMask, childIndex);
+						voxelBricks[numberOfGatheredChildren] = doesChildExist ? this->voxelBrickArray[oldVoxelBrickIndex] : 0;
+						voxelBrickFirstMaterialIndices[numberOfGatheredChildren] = doesChildExist ? this->voxelBrickFirstMaterialIndexArray[oldVoxelBrickIndex] : 0;
+						++numberOfGatheredChildren;
+					}
+				}
+
+				// The children are written over the old ones if there are no more of them than before, or else after the voxel bricks in use
+				if(!doNewChildrenFit)
+				{
+					node.firstChildIndex = static_cast<UInt32>(appendElements(this->voxelBrickArray, this->numberOfVoxelBricks, numberOfNewChildren));
+					this->voxelBrickFirstMaterialIndexArray.setNumberOfElements(this->voxelBrickArray.getNumberOfElements());
+				}
+				for(UInt32 i = 0; i < numberOfNewChildren; ++i)
+				{
+					this->voxelBrickArray[node.firstChildIndex + i] = voxelBricks[i];
+					this->voxelBrickFirstMaterialIndexArray[node.firstChildIndex + i] = voxelBrickFirstMaterialIndices[i];
+				}
+				if(numberOfNewChildren > 0)
+				{
+					this->onVoxelBricksUpdated.invoke(node.firstChildIndex, numberOfNewChildren);
+				}
+			}
+			else
+			{
+				Node children[8];
+				UInt32 numberOfGatheredChildren = 0;
+				for(UInt32 childIndex = 0; childIndex < 8; ++childIndex)
+				{
+					if(newChildMask & bitwiseLeftShiftInteger<UInt32>(1, childIndex))
+					{
+						const bool doesChildExist = (node.childMask & bitwiseLeftShiftInteger<UInt32>(1, childIndex)) != 0;
+						children[numberOfGatheredChildren++] = doesChildExist ? this->nodeArray[node.firstChildIndex + countSetBitsBelowChild(node.childMask, childIndex)] : Node{0, 0};
+					}
+				}
+
+				if(!doNewChildrenFit)
+				{
+					node.firstChildIndex = static_cast<UInt32>(appendElements(this->nodeArray, this->numberOfNodes, numberOfNewChildren));
+				}
+				for(UInt32 i = 0; i < numberOfNewChildren; ++i)
+				{
+					this->nodeArray[node.firstChildIndex + i] = children[i];
+				}
+				if(numberOfNewChildren > 0)
+				{
+					this->onNodesUpdated.invoke(node.firstChildIndex, numberOfNewChildren);
+				}
+			}
+
+			node.childMask = newChildMask;
+			this->nodeArray[pNodeIndex] = node;
+			this->onNodesUpdated.invoke(pNodeIndex, 1);
+		}
+
+		// Update the children that overlap the range of voxel bricks. The child index holds the lowest bit of the coords of the child along each axis
+		const UInt32 childLevelShift = voxelBrickLevel - (pNodeLevel + 1);
+		for(UInt32 childIndex = 0; childIndex < 8; ++childIndex)
+		{
+			if(!(newChildMask & bitwiseLeftShiftInteger<UInt32>(1, childIndex)))
+			{
+				continue;
+			}
+
+			const IntegerVector3<UInt32> childCoords(pNodeCoords.x * 2 + (childIndex & 1), pNodeCoords.y * 2 + ((childIndex >> 1) & 1), pNodeCoords.z * 2 + ((childIndex >> 2) & 1));
+			const IntegerVector3<UInt32> childMinVoxelBrickCoords(childCoords.x << childLevelShift, childCoords.y << childLevelShift, childCoords.z << childLevelShift);
+			const UInt32 childSideLengthInVoxelBricks = bitwiseLeftShiftInteger<UInt32>(1, childLevelShift);
+			if(childMinVoxelBrickCoords.x > pMaxVoxelBrickCoords.x || childMinVoxelBrickCoords.x + childSideLengthInVoxelBricks <= pMinVoxelBrickCoords.x ||
+			   childMinVoxelBrickCoords.y > pMaxVoxelBrickCoords.y || childMinVoxelBrickCoords.y + childSideLengthInVoxelBricks <= pMinVoxelBrickCoords.y ||
+			   childMinVoxelBrickCoords.z > pMaxVoxelBrickCoords.z || childMinVoxelBrickCoords.z + childSideLengthInVoxelBricks <= pMinVoxelBrickCoords.z)
+			{
+				continue;
+			}
+
+			const SizeType childArrayIndex = node.firstChildIndex + countSetBitsBelowChild(newChildMask, childIndex);
+			if(areChildrenVoxelBricks)
+			{
+				this->updateVoxelBrick(pVoxelGrid, childArrayIndex, childCoords);
+			}
+			else
+			{
+				this->updateNode(pVoxelGrid, childArrayIndex, childCoords, pNodeLevel + 1, pMinVoxelBrickCoords, pMaxVoxelBrickCoords);
+			}
+		}
+	}
+
+	void SparseVoxelOctree::updateVoxelBrick(const VoxelGrid &pVoxelGrid, SizeType pVoxelBrickIndex, const IntegerVector3<UInt32> &pVoxelBrickCoords)
+	{
+		const UInt32 voxelBrickLevel = pVoxelGrid.getVoxelBrickLevel();
+		const SizeType gridVoxelBrickIndex = pVoxelGrid.getNodeMortonCode(pVoxelBrickCoords, voxelBrickLevel) ^ bitwiseLeftShiftInteger<UInt32>(1, voxelBrickLevel * 3);
+		const UInt64 newVoxelBrick = (*pVoxelGrid.getVoxelBrickArray())[gridVoxelBrickIndex];
+		const UInt64 oldVoxelBrick = this->voxelBrickArray[pVoxelBrickIndex];
+		const UInt32 oldFirstMaterialIndex = this->voxelBrickFirstMaterialIndexArray[pVoxelBrickIndex];
+
+		// The voxel data is written over the old voxel data if there are no more non empty voxels than before, or else after the voxel data in use
+		const UInt32 numberOfNonEmptyVoxels = countSetBits(newVoxelBrick);
+		UInt32 firstMaterialIndex = oldFirstMaterialIndex;
+		if(numberOfNonEmptyVoxels > countSetBits(oldVoxelBrick))
+		{
+			firstMaterialIndex = static_cast<UInt32>(appendElements(this->voxelMaterialArray, this->numberOfVoxelMaterials, numberOfNonEmptyVoxels));
+		}
+
+		// Any of the voxel data may have changed, even if the voxel brick did not. The voxel grid stores it in the same order
+		const ResizableArray<VoxelData> &gridVoxelMaterialArray = *pVoxelGrid.getVoxelMaterialArray();
+		const SizeType gridFirstMaterialIndex = (*pVoxelGrid.getVoxelBrickFirstMaterialIndexArray())[gridVoxelBrickIndex];
+		for(UInt32 i = 0; i < numberOfNonEmptyVoxels; ++i)
+		{
+			this->voxelMaterialArray[firstMaterialIndex + i] = gridVoxelMaterialArray[gridFirstMaterialIndex + i];
+		}
+		if(numberOfNonEmptyVoxels > 0)
+		{
+			this->onVoxelMaterialsUpdated.invoke(firstMaterialIndex, numberOfNonEmptyVoxels);
+		}
+
+		if(newVoxelBrick != oldVoxelBrick || firstMaterialIndex != oldFirstMaterialIndex)
+		{
+			this->voxelBrickArray[pVoxelBrickIndex] = newVoxelBrick;
+			this->voxelBrickFirstMaterialIndexArray[pVoxelBrickIndex] = firstMaterialIndex;
+			this->onVoxelBricksUpdated.invoke(pVoxelBrickIndex, 1);
+		}
+	}
+}
@@ -0,0 +1,136 @@
+#ifndef FORGE_SPARSE_VOXEL_OCTREE_H
+#define FORGE_SPARSE_VOXEL_OCTREE_H
+
+#include <Forge/Source/Core/Forge.h>
+#include <Forge/Source/Core/Containers/ResizableArray.h>
+#include <Forge/Source/Core/Event.h>
+#include <Forge/Source/Core/Math/IntegerVector3.h>
+#include "VoxelData.h"
+#include "VoxelGrid.h"
+
+namespace forge
+{
+	/// <summary>
+	/// A compact version of the octree of a voxel grid, that only stores the nodes that exist.
+	/// The interior nodes are stored in breadth first order, so the children of a node are always stored next to each other.
+	/// The root node is the first node. The nodes at the voxel brick level are stored in a separate array of voxel bricks, in the same order.
+	/// Only the voxel data of the non empty voxels is stored, brick by brick, and each voxel brick keeps the index of the voxel data of its first non empty voxel.
+	/// This is built from a VoxelGrid, and the parts of it under the voxel bricks that changed in the voxel grid can be updated in place.
+	/// Children and voxel data that no longer fit where they were are moved to the end of their arrays, and the elements they leave behind are unused until the next build
+	/// </summary>
+	class SparseVoxelOctree
+	{
+	public:
+
+		// NOTE: This must match the SparseVoxelOctreeNode struct in ForgeData/OpenCL/Include/Voxel.cl
+		struct Node
+		{
+			// Bit i is set if the child with index i exists. The child indices are the same as the last 3 bits of the Morton codes of the children
+			UInt32 childMask;
+			// The index of the first existing child. For the nodes just above the voxel brick level, this is an index into the voxel brick array,
+			// otherwise it is an index into the node array. The index of the child with index i is firstChildIndex + (the number of set bits in childMask below bit i)
+			UInt32 firstChildIndex;
+		};
+
+		/// <summary>
+		/// Build the sparse voxel octree from the octree of the given voxel grid. Any previous contents are discarded
+		/// </summary>
+		/// <param name="pVoxelGrid">The voxel grid. Its octree must be up to date</param>
+		void build(const VoxelGrid &pVoxelGrid);
+
+		/// <summary>
+		/// Update the nodes above the given range of voxel bricks, and the voxel bricks and their voxel data, from the voxel grid. The rest of the octree is left as it is.
+		/// The arrays grow if moved elements do not fit in them, and the changed elements are reported through the events
+		/// </summary>
+		/// <param name="pVoxelGrid">The voxel grid that the octree was built from. Only the voxels in the given range of voxel bricks may have changed since</param>
+		/// <param name="pMinVoxelBrickCoords">The minimum coords of the voxel bricks that changed</param>
+		/// <param name="pMaxVoxelBrickCoords">The maximum coords of the voxel bricks that changed. They are inclusive</param>
+		void updateVoxelBricks(const VoxelGrid &pVoxelGrid, const IntegerVector3<UInt32> &pMinVoxelBrickCoords, const IntegerVector3<UInt32> &pMaxVoxelBrickCoords);
+
+		UInt32 getOctreeDepth() const;
+
+		// After an update, the arrays may have more elements than are in use. The elements past the ones in use are value initialized
+		const ResizableArray<Node>* getNodeArray() const;
+
+		const ResizableArray<UInt64>* getVoxelBrickArray() const;
+
+		// The element at the index of a voxel brick holds the index of the voxel data of the first non empty voxel of that voxel brick.
+		// The voxel data of the voxel with bit i is at that index + (the number of set bits in the voxel brick below bit i)
+		const ResizableArray<UInt32>* getVoxelBrickFirstMaterialIndexArray() const;
+
+		const ResizableArray<VoxelData>* getVoxelMaterialArray() const;
+
+		// Get the total number of bytes used to store the nodes, the voxel bricks and the voxel data, including the elements that were left behind by updates
+		SizeType getMemorySize() const;
+
+		// Invoked by updateVoxelBricks with the index of the first node and the number of nodes of each run of nodes that changed
+		Event<SizeType, SizeType> onNodesUpdated;
+
+		// Invoked by updateVoxelBricks with the index of the first voxel brick and the number of voxel bricks of each run of voxel bricks that changed.
+		// The first material indices of the same voxel bricks may have changed as well
+		Event<SizeType, SizeType> onVoxelBricksUpdated;
+
+		// Invoked by updateVoxelBricks with the index of the first voxel data and the number of voxel data of each run of voxel data that changed
+		Event<SizeType, SizeType> onVoxelMaterialsUpdated;
+
+	private:
+
+		// Update the node with the given index, and the nodes and the voxel bricks below it that overlap the given range of voxel bricks.
+		// The coords of the node are at its own level
+		void updateNode(const VoxelGrid &pVoxelGrid, SizeType pNodeIndex, const IntegerVector3<UInt32> &pNodeCoords, UInt32 pNodeLevel,
+						const IntegerVector3<UInt32> &pMinVoxelBrickCoords, const IntegerVector3<UInt32> &pMaxVoxelBrickCoords);
+
+		// Update the voxel brick with the given index and its voxel data
+		void updateVoxelBrick(const VoxelGrid &pVoxelGrid, SizeType pVoxelBrickIndex, const IntegerVector3<UInt32> &pVoxelBrickCoords);
+
+		UInt32 octreeDepth = 0;
+		// The number of elements of the arrays that are in use. The arrays may have room for more, which updates can move elements into
+		SizeType numberOfNodes = 0;
+		SizeType numberOfVoxelBricks = 0;
+		SizeType numberOfVoxelMaterials = 0;
+		ResizableArray<Node> nodeArray;
+		ResizableArray<UInt64> voxelBrickArray;
+		ResizableArray<UInt32> voxelBrickFirstMaterialIndexArray;
+		ResizableArray<VoxelData> voxelMaterialArray;
+	};
+
+	inline
+	UInt32 SparseVoxelOctree::getOctreeDepth() const
+	{
+		return this->octreeDepth;
+	}
+
+	inline
+	const ResizableArray<SparseVoxelOctree::Node>* SparseVoxelOctree::getNodeArray() const
+	{
+		return &this->nodeArray;
+	}
+
+	inline
+	const ResizableArray<UInt64>* SparseVoxelOctree::getVoxelBrickArray() const
+	{
+		return &this->voxelBrickArray;
+	}
+
+	inline
+	const ResizableArray<UInt32>* SparseVoxelOctree::getVoxelBrickFirstMaterialIndexArray() const
+	{
+		return &this->voxelBrickFirstMaterialIndexArray;
+	}
+
+	inline
+	const ResizableArray<VoxelData>* SparseVoxelOctree::getVoxelMaterialArray() const
+	{
+		return &this->voxelMaterialArray;
+	}
+
+	inline
+	SizeType SparseVoxelOctree::getMemorySize() const
+	{
+		return sizeof(Node) * this->numberOfNodes +
+			   (sizeof(UInt64) + sizeof(UInt32)) * this->numberOfVoxelBricks +
+			   sizeof(VoxelData) * this->numberOfVoxelMaterials;
+	}
+}
+
+#endif
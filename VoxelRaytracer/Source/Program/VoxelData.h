@@ -5,14 +5,20 @@
 
 namespace forge
 {
-	// Represents a single voxel of any kind, including an empty voxel
+	// Represents a single voxel of any kind, including an empty voxel.
+	// NOTE: This must match the Voxel struct in ForgeData/OpenCL/Include/Voxel.cl
 	class VoxelData
 	{
 	public:
 
 		bool getIsEmpty() const;
 
-		UInt8 voxelID = 0;
+		bool operator==(const VoxelData &pVoxelData) const;
+
+		bool operator!=(const VoxelData &pVoxelData) const;
+
+		// The material of the voxel. The empty voxel has the ID 0
+		UInt16 voxelID = 0;
 	};
 
 	inline
@@ -20,6 +26,18 @@ namespace forge
 	{
 		return this->voxelID == 0;
 	}
+
+	inline
+	bool VoxelData::operator==(const VoxelData &pVoxelData) const
+	{
+		return this->voxelID == pVoxelData.voxelID;
+	}
+
+	inline
+	bool VoxelData::operator!=(const VoxelData &pVoxelData) const
+	{
+		return !(*this == pVoxelData);
+	}
 }
 
 #endif
\ No newline at end of file
@@ -4,6 +4,7 @@
 namespace forge
 {
 	VoxelGrid::VoxelGrid(VoxelCoordType pOctreeDepth) :
+	numberOfVoxelMaterials(0),
 	octreeDepth(pOctreeDepth)
 	{
 		this->sideLength = power<VoxelCoordType>(2, pOctreeDepth - 1);
@@ -15,104 +16,423 @@ namespace forge
 		this->aabb.setMinPoint(Vector3(static_cast<Float>(-halfSideLength) - 0.5f, static_cast<Float>(-halfSideLength) - 0.5f, static_cast<Float>(-halfSideLength) - 0.5f));
 		this->aabb.setMaxPoint(Vector3(static_cast<Float>(halfSideLength) - 0.5f, static_cast<Float>(halfSideLength) - 0.5f, static_cast<Float>(halfSideLength) - 0.5f));
 
-		// Allocate the voxel data array
-		const SizeType sideLengthSizeType = static_cast<SizeType>(this->sideLength);
-		this->voxelDataArray.setNumberOfElements(sideLengthSizeType * sideLengthSizeType * sideLengthSizeType * 2);
+		if(pOctreeDepth < 4)
+		{
+			FORGE_ERROR_LOG("The octree depth of a VoxelGrid must be at least 4");
+		}
+
+		// Allocate the octree node child mask array. The Morton codes of the nodes at the level just above the voxel brick level are the largest ones in it
+		this->octreeNodeChildMaskArray.setNumberOfElements(static_cast<SizeType>(bitwiseLeftShiftInteger<UInt32>(1, this->getVoxelBrickLevel() * 3)));
+
+		// Allocate the voxel brick array
+		const SizeType numberOfVoxelBricksAlongEachAxis = static_cast<SizeType>(this->sideLength / VoxelGrid::voxelBrickSideLength);
+		this->voxelBrickArray.setNumberOfElements(numberOfVoxelBricksAlongEachAxis * numberOfVoxelBricksAlongEachAxis * numberOfVoxelBricksAlongEachAxis);
+		this->voxelBrickFirstMaterialIndexArray.setNumberOfElements(this->voxelBrickArray.getNumberOfElements());
+
+		// The voxel material array only grows as voxels are set, since all the voxels start out empty
+	}
+
+	void VoxelGrid::setNumberOfVoxelMaterials(SizeType pNumberOfVoxelMaterials)
+	{
+		this->numberOfVoxelMaterials = pNumberOfVoxelMaterials;
+		if(this->numberOfVoxelMaterials > this->voxelMaterialArray.getNumberOfElements())
+		{
+			this->voxelMaterialArray.setNumberOfElements(this->numberOfVoxelMaterials);
+		}
 	}
 
 	void VoxelGrid::setVoxelData(const IntegerVector3<VoxelCoordType> &pVoxelCoords, const VoxelData &pVoxelData)
 	{
-		// If the voxel being placed is empty
-		if(pVoxelData.getIsEmpty())
+		const UInt32 voxelMortonCode = this->convertVoxelCoordsToMortonCode(pVoxelCoords);
+		if(voxelMortonCode == 0)
+		{
+			return;
+		}
+
+		// The voxel material array holds the voxel IDs of the non empty voxels, and the voxel bricks store whether each voxel is empty
+		const SizeType voxelBrickIndex = this->getVoxelBrickIndex(voxelMortonCode);
+		const UInt32 voxelBrickBitIndex = VoxelGrid::getVoxelBrickBitIndex(voxelMortonCode);
+		VoxelData voxels[64];
+		this->getVoxelBrickVoxels(voxelBrickIndex, voxels);
+		if(voxels[voxelBrickBitIndex].voxelID == pVoxelData.voxelID)
 		{
-			// Get the Morton code for the voxel coords
-			UInt32 voxelCoordsMortonCode = this->getMortonCodeForVoxelCoords(pVoxelCoords);
+			return;
+		}
+
+		voxels[voxelBrickBitIndex] = pVoxelData;
+		const UInt64 previousVoxelBrick = this->voxelBrickArray[voxelBrickIndex];
+		const UInt64 newVoxelBrick = this->setVoxelBrickVoxels(voxelBrickIndex, voxels);
+		this->onVoxelMaterialUpdated.invoke(this->getVoxelIndex(voxelMortonCode), pVoxelData);
 
-			// If the voxel is already the empty voxel, nothing needs to be done
-			if(this->voxelDataArray[voxelCoordsMortonCode].voxelID == 0)
+		// If the voxel was already empty or non empty, the octree does not change
+		if(newVoxelBrick == previousVoxelBrick)
+		{
+			return;
+		}
+
+		this->onVoxelBrickUpdated.invoke(voxelBrickIndex, newVoxelBrick);
+
+		// The node of the voxel brick only starts or stops existing if the brick was empty before or is empty now
+		if(previousVoxelBrick == 0 || newVoxelBrick == 0)
+		{
+			this->updateParentNodeBitfields(bitwiseRightShiftInteger<UInt32>(voxelMortonCode, 6), newVoxelBrick != 0);
+		}
+	}
+
+	void VoxelGrid::updateParentNodeBitfields(UInt32 pNodeMortonCode, bool pDoesNodeExist)
+	{
+		// This is the morton code for the current octree node
+		UInt32 currentOctreeNodeMortonCode = pNodeMortonCode;
+		// Each iteration of this loop processes one parent node. The iteration happens from the bottom of the hierarchy to the top, and stops at the root node
+		while(currentOctreeNodeMortonCode != 1)
+		{
+			// This is the Morton code of the parent node of the current node
+			const UInt32 parentNodeMortonCode = bitwiseRightShiftInteger<UInt32>(currentOctreeNodeMortonCode, 3);
+			// This is a bitfield with the bit that indicates the current node set to true
+			const UInt8 childNodeBitfieldPositionValue = bitwiseLeftShiftInteger<UInt8>(1, static_cast<UInt8>(currentOctreeNodeMortonCode & 0x00000007));
+			UInt8 &parentNodeBitfield = this->octreeNodeChildMaskArray[parentNodeMortonCode];
+			const bool didParentNodeExist = parentNodeBitfield != 0;
+
+			if(pDoesNodeExist)
 			{
-				return;
+				// If the bit is already set, then a path from the top of the hierarchy to the current node must exist.
+				// So there is no need to update the bitfields of any more nodes
+				if(parentNodeBitfield & childNodeBitfieldPositionValue)
+				{
+					break;
+				}
+				parentNodeBitfield |= childNodeBitfieldPositionValue;
+			}
+			else
+			{
+				parentNodeBitfield &= ~childNodeBitfieldPositionValue;
+			}
+			this->onVoxelOctreeNodeUpdated.invoke(parentNodeMortonCode, parentNodeBitfield);
+
+			// The nodes above the parent node only need to be updated if the parent node started or stopped existing
+			if(didParentNodeExist == (parentNodeBitfield != 0))
+			{
+				break;
 			}
 
-			// Set the voxel's data in the voxel data array.
-			// Set the leaf node bit of the Morton key and use that number as the index for the voxel
-			this->voxelDataArray[voxelCoordsMortonCode] = pVoxelData;
+			// The current node for the next iteration is the parent node of this iteration
+			currentOctreeNodeMortonCode = parentNodeMortonCode;
+		}
+	}
 
-			// Update the bit in the parent node's bitfield that indicates whether this child node exists or not
-			UInt32 mortonCodeOfParentNodeOfVoxel = bitwiseRightShiftInteger<UInt32>(voxelCoordsMortonCode, 3);
-			UInt8 childNodeIndex = static_cast<UInt8>(voxelCoordsMortonCode & 0x00000007);
-			this->voxelDataArray[mortonCodeOfParentNodeOfVoxel].voxelID &= ~bitwiseLeftShiftInteger<UInt8>(1, childNodeIndex);
-			this->onVoxelOctreeNodeUpdated.invoke(mortonCodeOfParentNodeOfVoxel, this->voxelDataArray[mortonCodeOfParentNodeOfVoxel].voxelID);
+	bool VoxelGrid::getVoxelBricksInBox(IntegerVector3<VoxelCoordType> &pBoxMinVoxelCoords, IntegerVector3<VoxelCoordType> &pBoxMaxVoxelCoords,
+										IntegerVector3<UInt32> &pMinVoxelBrickCoords, IntegerVector3<UInt32> &pMaxVoxelBrickCoords) const
+	{
+		pBoxMinVoxelCoords = IntegerVector3<VoxelCoordType>(max(pBoxMinVoxelCoords.x, this->minVoxelCoords.x), max(pBoxMinVoxelCoords.y, this->minVoxelCoords.y), max(pBoxMinVoxelCoords.z, this->minVoxelCoords.z));
+		pBoxMaxVoxelCoords = IntegerVector3<VoxelCoordType>(min(pBoxMaxVoxelCoords.x, this->maxVoxelCoords.x), min(pBoxMaxVoxelCoords.y, this->maxVoxelCoords.y), min(pBoxMaxVoxelCoords.z, this->maxVoxelCoords.z));
+		if(pBoxMinVoxelCoords.x > pBoxMaxVoxelCoords.x || pBoxMinVoxelCoords.y > pBoxMaxVoxelCoords.y || pBoxMinVoxelCoords.z > pBoxMaxVoxelCoords.z)
+		{
+			return false;
+		}
+
+		pMinVoxelBrickCoords = IntegerVector3<UInt32>(static_cast<UInt32>((pBoxMinVoxelCoords.x - this->minVoxelCoords.x) / VoxelGrid::voxelBrickSideLength),
+													  static_cast<UInt32>((pBoxMinVoxelCoords.y - this->minVoxelCoords.y) / VoxelGrid::voxelBrickSideLength),
+													  static_cast<UInt32>((pBoxMinVoxelCoords.z - this->minVoxelCoords.z) / VoxelGrid::voxelBrickSideLength));
+		pMaxVoxelBrickCoords = IntegerVector3<UInt32>(static_cast<UInt32>((pBoxMaxVoxelCoords.x - this->minVoxelCoords.x) / VoxelGrid::voxelBrickSideLength),
+													  static_cast<UInt32>((pBoxMaxVoxelCoords.y - this->minVoxelCoords.y) / VoxelGrid::voxelBrickSideLength),
+													  static_cast<UInt32>((pBoxMaxVoxelCoords.z - this->minVoxelCoords.z) / VoxelGrid::voxelBrickSideLength));
+		return true;
+	}
 
-			// Update all the necessary child node bitfields of the octree node hierarchy to reflect the voxel that was updated
+	void VoxelGrid::setVoxelsInBox(const IntegerVector3<VoxelCoordType> &pBoxMinVoxelCoords, const IntegerVector3<VoxelCoordType> &pBoxMaxVoxelCoords, const VoxelData &pVoxelData,
+								   DynamicArray<VoxelRun> *pPreviousVoxelRuns)
+	{
+		IntegerVector3<VoxelCoordType> clippedBoxMinVoxelCoords = pBoxMinVoxelCoords;
+		IntegerVector3<VoxelCoordType> clippedBoxMaxVoxelCoords = pBoxMaxVoxelCoords;
+		IntegerVector3<UInt32> minVoxelBrickCoords;
+		IntegerVector3<UInt32> maxVoxelBrickCoords;
+		if(!this->getVoxelBricksInBox(clippedBoxMinVoxelCoords, clippedBoxMaxVoxelCoords, minVoxelBrickCoords, maxVoxelBrickCoords))
+		{
+			return;
+		}
+
+		// Write the voxels brick by brick. The voxels of a voxel brick are visited in Morton order, which is the order of their voxel data
+		const UInt32 voxelBrickLevel = this->getVoxelBrickLevel();
+		for(UInt32 voxelBrickZ = minVoxelBrickCoords.z; voxelBrickZ <= maxVoxelBrickCoords.z; ++voxelBrickZ)
+		{
+			for(UInt32 voxelBrickY = minVoxelBrickCoords.y; voxelBrickY <= maxVoxelBrickCoords.y; ++voxelBrickY)
 			{
-				// This is the morton code for the current octree node
-				UInt32 currentOctreeNodeMortonCode = mortonCodeOfParentNodeOfVoxel;
-				// Each iteration of this loop processes one node.
-				// The iteration happens from the bottom of the hierarchy to the top, starting from level 7 of the octree
-				for(UInt32 i = 0; i < this->octreeDepth - 2; ++i)
+				for(UInt32 voxelBrickX = minVoxelBrickCoords.x; voxelBrickX <= maxVoxelBrickCoords.x; ++voxelBrickX)
 				{
-					// This is the Morton key of the parent node of the current node
-					UInt32 parentNodeMortonCode = bitwiseRightShiftInteger<UInt32>(currentOctreeNodeMortonCode, 3);
-
-					if(this->voxelDataArray[currentOctreeNodeMortonCode].voxelID == 0)
+					const UInt32 voxelBrickIndex = this->getNodeMortonCode(IntegerVector3<UInt32>(voxelBrickX, voxelBrickY, voxelBrickZ), voxelBrickLevel) ^ bitwiseLeftShiftInteger<UInt32>(1, voxelBrickLevel * 3);
+					const IntegerVector3<VoxelCoordType> voxelBrickMinVoxelCoords(static_cast<VoxelCoordType>(voxelBrickX) * VoxelGrid::voxelBrickSideLength + this->minVoxelCoords.x,
+																				  static_cast<VoxelCoordType>(voxelBrickY) * VoxelGrid::voxelBrickSideLength + this->minVoxelCoords.y,
+																				  static_cast<VoxelCoordType>(voxelBrickZ) * VoxelGrid::voxelBrickSideLength + this->minVoxelCoords.z);
+					VoxelData voxels[64];
+					this->getVoxelBrickVoxels(voxelBrickIndex, voxels);
+					bool haveVoxelsChanged = false;
+					for(UInt32 voxelBrickBitIndex = 0; voxelBrickBitIndex < 64; ++voxelBrickBitIndex)
 					{
-						UInt8 childNodeIndex = static_cast<UInt8>(currentOctreeNodeMortonCode & 0x00000007);
-						this->voxelDataArray[parentNodeMortonCode].voxelID &= ~bitwiseLeftShiftInteger<UInt8>(1, childNodeIndex);
-						this->onVoxelOctreeNodeUpdated.invoke(parentNodeMortonCode, this->voxelDataArray[parentNodeMortonCode].voxelID);
+						const IntegerVector3<VoxelCoordType> voxelCoords(voxelBrickMinVoxelCoords.x + static_cast<VoxelCoordType>(this->compact1By2For32BitInteger(voxelBrickBitIndex)),
+																		 voxelBrickMinVoxelCoords.y + static_cast<VoxelCoordType>(this->compact1By2For32BitInteger(bitwiseRightShiftInteger<UInt32>(voxelBrickBitIndex, 1))),
+																		 voxelBrickMinVoxelCoords.z + static_cast<VoxelCoordType>(this->compact1By2For32BitInteger(bitwiseRightShiftInteger<UInt32>(voxelBrickBitIndex, 2))));
+						if(voxelCoords.x < clippedBoxMinVoxelCoords.x || voxelCoords.x > clippedBoxMaxVoxelCoords.x ||
+						   voxelCoords.y < clippedBoxMinVoxelCoords.y || voxelCoords.y > clippedBoxMaxVoxelCoords.y ||
+						   voxelCoords.z < clippedBoxMinVoxelCoords.z || voxelCoords.z > clippedBoxMaxVoxelCoords.z)
+						{
+							continue;
+						}
+
+						// Only the voxels that change are recorded
+						if(voxels[voxelBrickBitIndex] == pVoxelData)
+						{
+							continue;
+						}
+						if(pPreviousVoxelRuns)
+						{
+							VoxelGrid::appendVoxelToVoxelRuns(*pPreviousVoxelRuns, (voxelBrickIndex << 6) | voxelBrickBitIndex, voxels[voxelBrickBitIndex]);
+						}
+						voxels[voxelBrickBitIndex] = pVoxelData;
+						haveVoxelsChanged = true;
 					}
-					else
+					if(haveVoxelsChanged)
 					{
-						break;
+						this->setVoxelBrickVoxels(voxelBrickIndex, voxels);
 					}
-
-					// The current node for the next iteration is the parent node of this iteration
-					currentOctreeNodeMortonCode = parentNodeMortonCode;
 				}
 			}
 		}
-		// If the voxel being placed is non-empty
-		else
-		{
-			// Get the Morton key for the voxel coords
-			UInt32 voxelCoordsMortonCode = this->getMortonCodeForVoxelCoords(pVoxelCoords);
 
-			// Set the voxel's data in the voxel data array.
-			// Set the leaf node bit of the Morton key and use that number as the index for the voxel
-			this->voxelDataArray[voxelCoordsMortonCode] = pVoxelData;
+		this->updateNodesAboveVoxelBricks(minVoxelBrickCoords, maxVoxelBrickCoords);
+		this->onVoxelsInBoxUpdated.invoke(clippedBoxMinVoxelCoords, clippedBoxMaxVoxelCoords);
+	}
+
+	void VoxelGrid::copyVoxelsFromBox(const IntegerVector3<VoxelCoordType> &pBoxMinVoxelCoords, const IntegerVector3<VoxelCoordType> &pBoxMaxVoxelCoords, DynamicArray<VoxelRun> &pVoxelRuns) const
+	{
+		IntegerVector3<VoxelCoordType> clippedBoxMinVoxelCoords = pBoxMinVoxelCoords;
+		IntegerVector3<VoxelCoordType> clippedBoxMaxVoxelCoords = pBoxMaxVoxelCoords;
+		IntegerVector3<UInt32> minVoxelBrickCoords;
+		IntegerVector3<UInt32> maxVoxelBrickCoords;
+		if(!this->getVoxelBricksInBox(clippedBoxMinVoxelCoords, clippedBoxMaxVoxelCoords, minVoxelBrickCoords, maxVoxelBrickCoords))
+		{
+			return;
+		}
 
-			// Update all the necessary child node bitfields of the octree node hierarchy to reflect the voxel that was updated
+		// Read the voxels brick by brick, so that the voxels of a voxel brick that are in the box usually form a few runs
+		const UInt32 voxelBrickLevel = this->getVoxelBrickLevel();
+		for(UInt32 voxelBrickZ = minVoxelBrickCoords.z; voxelBrickZ <= maxVoxelBrickCoords.z; ++voxelBrickZ)
+		{
+			for(UInt32 voxelBrickY = minVoxelBrickCoords.y; voxelBrickY <= maxVoxelBrickCoords.y; ++voxelBrickY)
 			{
-				// This is the morton code for the current octree node
-				UInt32 currentOctreeNodeMortonCode = voxelCoordsMortonCode;
-				// Each iteration of this loop processes one parent node. The iteration happens from the bottom of the hierarchy to the top
-				for(UInt32 i = 0; i < this->octreeDepth - 1; ++i)
+				for(UInt32 voxelBrickX = minVoxelBrickCoords.x; voxelBrickX <= maxVoxelBrickCoords.x; ++voxelBrickX)
 				{
-					// This is the Morton key of the parent node of the current node
-					UInt32 parentNodeMortonKey = bitwiseRightShiftInteger<UInt32>(currentOctreeNodeMortonCode, 3);
-					// This indicates the position of the bit in the parent node's bitfield that indicates whether this child node exists or not
-					UInt8 childNodeIndex = static_cast<UInt8>(currentOctreeNodeMortonCode & 0x00000007);
-					// This is a bitfield with the bit that indicates this child node set to true
-					UInt8 childNodeBitfieldPositionValue = bitwiseLeftShiftInteger<UInt8>(1, childNodeIndex);
-
-					// If the parent node already exists
-					if(this->voxelDataArray[parentNodeMortonKey].voxelID & childNodeBitfieldPositionValue)
+					const UInt32 voxelBrickIndex = this->getNodeMortonCode(IntegerVector3<UInt32>(voxelBrickX, voxelBrickY, voxelBrickZ), voxelBrickLevel) ^ bitwiseLeftShiftInteger<UInt32>(1, voxelBrickLevel * 3);
+					const IntegerVector3<VoxelCoordType> voxelBrickMinVoxelCoords(static_cast<VoxelCoordType>(voxelBrickX) * VoxelGrid::voxelBrickSideLength + this->minVoxelCoords.x,
+																				  static_cast<VoxelCoordType>(voxelBrickY) * VoxelGrid::voxelBrickSideLength + this->minVoxelCoords.y,
+																				  static_cast<VoxelCoordType>(voxelBrickZ) * VoxelGrid::voxelBrickSideLength + this->minVoxelCoords.z);
+					VoxelData voxels[64];
+					this->getVoxelBrickVoxels(voxelBrickIndex, voxels);
+					for(UInt32 voxelBrickBitIndex = 0; voxelBrickBitIndex < 64; ++voxelBrickBitIndex)
 					{
-						// If the parent node already exists, then a path from the top of the hierarchy to the current node must exist.
-						// So there is no need to update the bitfields of any more nodes
-						break;
+						const IntegerVector3<VoxelCoordType> voxelCoords(voxelBrickMinVoxelCoords.x + static_cast<VoxelCoordType>(this->compact1By2For32BitInteger(voxelBrickBitIndex)),
+																		 voxelBrickMinVoxelCoords.y + static_cast<VoxelCoordType>(this->compact1By2For32BitInteger(bitwiseRightShiftInteger<UInt32>(voxelBrickBitIndex, 1))),
+																		 voxelBrickMinVoxelCoords.z + static_cast<VoxelCoordType>(this->compact1By2For32BitInteger(bitwiseRightShiftInteger<UInt32>(voxelBrickBitIndex, 2))));
+						if(voxelCoords.x < clippedBoxMinVoxelCoords.x || voxelCoords.x > clippedBoxMaxVoxelCoords.x ||
+						   voxelCoords.y < clippedBoxMinVoxelCoords.y || voxelCoords.y > clippedBoxMaxVoxelCoords.y ||
+						   voxelCoords.z < clippedBoxMinVoxelCoords.z || voxelCoords.z > clippedBoxMaxVoxelCoords.z)
+						{
+							continue;
+						}
+
+						VoxelGrid::appendVoxelToVoxelRuns(pVoxelRuns, (voxelBrickIndex << 6) | voxelBrickBitIndex, voxels[voxelBrickBitIndex]);
 					}
-					else
+				}
+			}
+		}
+	}
+
+	void VoxelGrid::setVoxelRuns(const IntegerVector3<VoxelCoordType> &pBoxMinVoxelCoords, const IntegerVector3<VoxelCoordType> &pBoxMaxVoxelCoords, const DynamicArray<VoxelRun> &pVoxelRuns)
+	{
+		IntegerVector3<VoxelCoordType> clippedBoxMinVoxelCoords = pBoxMinVoxelCoords;
+		IntegerVector3<VoxelCoordType> clippedBoxMaxVoxelCoords = pBoxMaxVoxelCoords;
+		IntegerVector3<UInt32> minVoxelBrickCoords;
+		IntegerVector3<UInt32> maxVoxelBrickCoords;
+		if(!this->getVoxelBricksInBox(clippedBoxMinVoxelCoords, clippedBoxMaxVoxelCoords, minVoxelBrickCoords, maxVoxelBrickCoords))
+		{
+			return;
+		}
+
+		// The index of a voxel is the index of its voxel brick followed by the index of its bit in the voxel brick. The voxels of a voxel brick are written together,
+		// and the runs visit the voxel bricks one after the other
+		VoxelData voxels[64];
+		SizeType currentVoxelBrickIndex = 0;
+		bool isVoxelBrickRead = false;
+		for(SizeType i = 0; i < pVoxelRuns.getNumberOfElements(); ++i)
+		{
+			const VoxelRun &voxelRun = pVoxelRuns[i];
+			const UInt32 endVoxelIndex = voxelRun.firstVoxelIndex + voxelRun.numberOfVoxels;
+			for(UInt32 voxelIndex = voxelRun.firstVoxelIndex; voxelIndex < endVoxelIndex; ++voxelIndex)
+			{
+				const SizeType voxelBrickIndex = voxelIndex >> 6;
+				if(!isVoxelBrickRead || voxelBrickIndex != currentVoxelBrickIndex)
+				{
+					if(isVoxelBrickRead)
 					{
-						// Update the bit in the parent node's bitfield that indicates whether this child node exists or not
-						this->voxelDataArray[parentNodeMortonKey].voxelID |= childNodeBitfieldPositionValue;
-						this->onVoxelOctreeNodeUpdated.invoke(parentNodeMortonKey, this->voxelDataArray[parentNodeMortonKey].voxelID);
+						this->setVoxelBrickVoxels(currentVoxelBrickIndex, voxels);
 					}
+					this->getVoxelBrickVoxels(voxelBrickIndex, voxels);
+					currentVoxelBrickIndex = voxelBrickIndex;
+					isVoxelBrickRead = true;
+				}
+				voxels[voxelIndex & 63] = voxelRun.voxelData;
+			}
+		}
+		if(isVoxelBrickRead)
+		{
+			this->setVoxelBrickVoxels(currentVoxelBrickIndex, voxels);
+		}
 
-					// The current node for the next iteration is the parent node of this iteration
-					currentOctreeNodeMortonCode = parentNodeMortonKey;
+		this->updateNodesAboveVoxelBricks(minVoxelBrickCoords, maxVoxelBrickCoords);
+		this->onVoxelsInBoxUpdated.invoke(clippedBoxMinVoxelCoords, clippedBoxMaxVoxelCoords);
+	}
+
+	void VoxelGrid::updateNodesAboveVoxelBricks(const IntegerVector3<UInt32> &pMinVoxelBrickCoords, const IntegerVector3<UInt32> &pMaxVoxelBrickCoords)
+	{
+		// The coords of the ancestor of a node are the coords of the node shifted right once for every level between them,
+		// and the Morton codes of the children of a node are the Morton code of the node shifted left by 3 bits
+		const UInt32 voxelBrickLevel = this->getVoxelBrickLevel();
+		IntegerVector3<UInt32> minNodeCoords = pMinVoxelBrickCoords;
+		IntegerVector3<UInt32> maxNodeCoords = pMaxVoxelBrickCoords;
+		for(UInt32 childLevel = voxelBrickLevel; childLevel != 0; --childLevel)
+		{
+			minNodeCoords = IntegerVector3<UInt32>(bitwiseRightShiftInteger<UInt32>(minNodeCoords.x, 1), bitwiseRightShiftInteger<UInt32>(minNodeCoords.y, 1), bitwiseRightShiftInteger<UInt32>(minNodeCoords.z, 1));
+			maxNodeCoords = IntegerVector3<UInt32>(bitwiseRightShiftInteger<UInt32>(maxNodeCoords.x, 1), bitwiseRightShiftInteger<UInt32>(maxNodeCoords.y, 1), bitwiseRightShiftInteger<UInt32>(maxNodeCoords.z, 1));
+			for(UInt32 nodeZ = minNodeCoords.z; nodeZ <= maxNodeCoords.z; ++nodeZ)
+			{
+				for(UInt32 nodeY = minNodeCoords.y; nodeY <= maxNodeCoords.y; ++nodeY)
+				{
+					for(UInt32 nodeX = minNodeCoords.x; nodeX <= maxNodeCoords.x; ++nodeX)
+					{
+						const UInt32 nodeMortonCode = this->getNodeMortonCode(IntegerVector3<UInt32>(nodeX, nodeY, nodeZ), childLevel - 1);
+						UInt8 childMask = 0;
+						for(UInt32 i = 0; i < 8; ++i)
+						{
+							// The children at the voxel brick level are voxel bricks, which are indexed by their Morton codes without the leading 1 bit
+							const UInt32 childNodeMortonCode = bitwiseLeftShiftInteger<UInt32>(nodeMortonCode, 3) | i;
+							const bool doesChildNodeExist = (childLevel == voxelBrickLevel)? (this->voxelBrickArray[childNodeMortonCode ^ bitwiseLeftShiftInteger<UInt32>(1, childLevel * 3)] != 0) :
+																							 (this->octreeNodeChildMaskArray[childNodeMortonCode] != 0);
+							if(doesChildNodeExist)
+							{
+								childMask |= bitwiseLeftShiftInteger<UInt8>(1, static_cast<UInt8>(i));
+							}
+						}
+						this->octreeNodeChildMaskArray[nodeMortonCode] = childMask;
+					}
 				}
 			}
 		}
 	}
-}
\ No newline at end of file
+
+	void VoxelGrid::appendVoxelToVoxelRuns(DynamicArray<VoxelRun> &pVoxelRuns, UInt32 pVoxelIndex, const VoxelData &pVoxelData)
+	{
+		const SizeType numberOfVoxelRuns = pVoxelRuns.getNumberOfElements();
+		if(numberOfVoxelRuns > 0)
+		{
+			VoxelRun &lastVoxelRun = pVoxelRuns[numberOfVoxelRuns - 1];
+			if(lastVoxelRun.firstVoxelIndex + lastVoxelRun.numberOfVoxels == pVoxelIndex && lastVoxelRun.voxelData == pVoxelData && lastVoxelRun.numberOfVoxels != 0xFFFF)
+			{
+				++lastVoxelRun.numberOfVoxels;
+				return;
+			}
+		}
+
+		VoxelRun voxelRun;
+		voxelRun.firstVoxelIndex = pVoxelIndex;
+		voxelRun.numberOfVoxels = 1;
+		voxelRun.voxelData = pVoxelData;
+		pVoxelRuns.append(voxelRun);
+	}
+
+	void VoxelGrid::getVoxelBrickVoxels(SizeType pVoxelBrickIndex, VoxelData pVoxels[64]) const
+	{
+		const UInt64 voxelBrick = this->voxelBrickArray[pVoxelBrickIndex];
+		SizeType nextVoxelMaterialIndex = this->voxelBrickFirstMaterialIndexArray[pVoxelBrickIndex];
+		for(UInt32 bitIndex = 0; bitIndex < 64; ++bitIndex)
+		{
+			pVoxels[bitIndex] = (voxelBrick & bitwiseLeftShiftInteger<UInt64>(1, bitIndex))? this->voxelMaterialArray[nextVoxelMaterialIndex++] : VoxelData();
+		}
+	}
+
+	UInt64 VoxelGrid::setVoxelBrickVoxels(SizeType pVoxelBrickIndex, const VoxelData pVoxels[64])
+	{
+		UInt64 newVoxelBrick = 0;
+		for(UInt32 bitIndex = 0; bitIndex < 64; ++bitIndex)
+		{
+			if(!pVoxels[bitIndex].getIsEmpty())
+			{
+				newVoxelBrick |= bitwiseLeftShiftInteger<UInt64>(1, bitIndex);
+			}
+		}
+
+		// The voxel brick keeps its old voxel data until it has room for the new voxel data, so that packing the voxel data in between skips nothing
+		const UInt32 numberOfNonEmptyVoxels = countSetBits(newVoxelBrick);
+		SizeType nextVoxelMaterialIndex = this->voxelBrickFirstMaterialIndexArray[pVoxelBrickIndex];
+		if(numberOfNonEmptyVoxels > countSetBits(this->voxelBrickArray[pVoxelBrickIndex]))
+		{
+			nextVoxelMaterialIndex = this->allocateVoxelMaterials(numberOfNonEmptyVoxels);
+			this->voxelBrickFirstMaterialIndexArray[pVoxelBrickIndex] = static_cast<UInt32>(nextVoxelMaterialIndex);
+		}
+		for(UInt32 bitIndex = 0; bitIndex < 64; ++bitIndex)
+		{
+			if(!pVoxels[bitIndex].getIsEmpty())
+			{
+				this->voxelMaterialArray[nextVoxelMaterialIndex++] = pVoxels[bitIndex];
+			}
+		}
+
+		this->voxelBrickArray[pVoxelBrickIndex] = newVoxelBrick;
+		return newVoxelBrick;
+	}
+
+	SizeType VoxelGrid::allocateVoxelMaterials(SizeType pNumberOfVoxelMaterials)
+	{
+		if(this->numberOfVoxelMaterials + pNumberOfVoxelMaterials > this->voxelMaterialArray.getNumberOfElements() && this->getNumberOfNonEmptyVoxels() <= this->numberOfVoxelMaterials / 2)
+		{
+			this->packVoxelMaterials();
+		}
+
+		const SizeType firstVoxelMaterialIndex = this->numberOfVoxelMaterials;
+		this->numberOfVoxelMaterials += pNumberOfVoxelMaterials;
+		if(this->numberOfVoxelMaterials > this->voxelMaterialArray.getNumberOfElements())
+		{
+			this->voxelMaterialArray.setNumberOfElements(max(this->numberOfVoxelMaterials, this->voxelMaterialArray.getNumberOfElements() + this->voxelMaterialArray.getNumberOfElements() / 2));
+		}
+		return firstVoxelMaterialIndex;
+	}
+
+	void VoxelGrid::packVoxelMaterials()
+	{
+		// The voxel data of a voxel brick may be anywhere in the array, so it is packed into a new array instead of being moved in place
+		ResizableArray<VoxelData> packedVoxelMaterialArray(this->voxelMaterialArray.getNumberOfElements());
+		SizeType nextVoxelMaterialIndex = 0;
+		for(SizeType voxelBrickIndex = 0; voxelBrickIndex < this->voxelBrickArray.getNumberOfElements(); ++voxelBrickIndex)
+		{
+			const UInt32 numberOfNonEmptyVoxels = countSetBits(this->voxelBrickArray[voxelBrickIndex]);
+			const SizeType firstVoxelMaterialIndex = this->voxelBrickFirstMaterialIndexArray[voxelBrickIndex];
+			for(UInt32 i = 0; i < numberOfNonEmptyVoxels; ++i)
+			{
+				packedVoxelMaterialArray[nextVoxelMaterialIndex + i] = this->voxelMaterialArray[firstVoxelMaterialIndex + i];
+			}
+			this->voxelBrickFirstMaterialIndexArray[voxelBrickIndex] = static_cast<UInt32>(nextVoxelMaterialIndex);
+			nextVoxelMaterialIndex += numberOfNonEmptyVoxels;
+		}
+
+		this->voxelMaterialArray = packedVoxelMaterialArray;
+		this->numberOfVoxelMaterials = nextVoxelMaterialIndex;
+	}
+
+	SizeType VoxelGrid::getNumberOfNonEmptyVoxels() const
+	{
+		SizeType numberOfNonEmptyVoxels = 0;
+		for(SizeType voxelBrickIndex = 0; voxelBrickIndex < this->voxelBrickArray.getNumberOfElements(); ++voxelBrickIndex)
+		{
+			numberOfNonEmptyVoxels += countSetBits(this->voxelBrickArray[voxelBrickIndex]);
+		}
+		return numberOfNonEmptyVoxels;
+	}
+}
@@ -8,6 +8,7 @@
 #include <Forge/Source/Core/Math/IntegerVector3.h>
 #include "VoxelGrid.h"
 #include <Forge/Source/Core/Event.h>
+#include <Forge/Source/Core/Containers/DynamicArray.h>
 #include <Forge/Source/Core/Containers/ResizableArray.h>
 #include <Forge/Source/Core/Utility.h>
 #include <Forge/Source/Core/Logging.h>
@@ -15,17 +16,41 @@
 
 namespace forge
 {
-	// A 3D grid of voxels
+	/// <summary>
+	/// A 3D grid of voxels, stored as an octree indexed by Morton codes.
+	/// The nodes above the voxel brick level are stored in the octree node child mask array as bitfields that indicate which of their children exist.
+	/// The nodes at the voxel brick level cover 4x4x4 voxels each, and are stored in the voxel brick array as one 64 bit bitfield each,
+	/// which indicates which of their voxels are non empty. This replaces the last two levels of the octree.
+	/// The bits of a voxel brick are in Morton order, so byte i of a brick holds the 2x2x2 voxels of its child with index i.
+	/// The materials of the voxels are kept apart from the octree in the voxel material array, so that the octree stays small.
+	/// Only the voxel data of the non empty voxels is kept, brick by brick like in the sparse voxel octree, and each voxel brick keeps the index of the voxel data of its first non empty voxel
+	/// </summary>
 	class VoxelGrid
 	{
 	public:
 
 		using VoxelCoordType = Int32;
 
+		// The number of voxels along each side of a voxel brick
+		static const VoxelCoordType voxelBrickSideLength = 4;
+
+		// A run of voxels whose indices follow each other and that have the same voxel data. The index of a voxel is its Morton code without the leading 1 bit,
+		// so the voxels of a voxel brick follow each other in Morton order, and the voxels of a box that changed are usually covered by a few runs
+		struct VoxelRun
+		{
+			UInt32 firstVoxelIndex;
+			UInt16 numberOfVoxels;
+			VoxelData voxelData;
+		};
+
+		// The octree depth must be at least 4, so that the root node is stored in the octree node array
 		VoxelGrid(VoxelCoordType pOctreeDepth);
 
 		UInt32 getOctreeDepth() const;
 
+		// Get the level of the octree whose nodes are stored as voxel bricks. It is also the number of levels stored in the octree node array
+		UInt32 getVoxelBrickLevel() const;
+
 		/// <summary>
 		/// Get the coordinates of the bottom left voxel
 		/// </summary>
@@ -54,6 +79,30 @@ namespace forge
 		/// <param name="voxelDatum">The new voxel datum for the voxel</param>
 		void setVoxelData(const IntegerVector3<VoxelCoordType> &pVoxelCoords, const VoxelData &pVoxelData);
 
+		/// <summary>
+		/// Set all the voxels in a box to the same voxel data. The voxels are visited voxel brick by voxel brick, and each voxel brick in Morton order,
+		/// which is the order of its voxels in memory. Each node above the box is updated once, and onVoxelsInBoxUpdated is invoked once instead of the per voxel events
+		/// </summary>
+		/// <param name="pBoxMinVoxelCoords">The coordinates of the minimum voxel of the box</param>
+		/// <param name="pBoxMaxVoxelCoords">The coordinates of the maximum voxel of the box. The parts of the box outside of the voxel grid are ignored</param>
+		/// <param name="pVoxelData">The voxel data to set the voxels to</param>
+		/// <param name="pPreviousVoxelRuns">If not nullptr, the previous voxel data of the voxels that changed is appended to it as runs, so that setVoxelRuns can restore them</param>
+		void setVoxelsInBox(const IntegerVector3<VoxelCoordType> &pBoxMinVoxelCoords, const IntegerVector3<VoxelCoordType> &pBoxMaxVoxelCoords, const VoxelData &pVoxelData,
+							DynamicArray<VoxelRun> *pPreviousVoxelRuns = nullptr);
+
+		// Set the voxels of the given runs to the voxel data of their runs. All the voxels must be in the given box, which is used to update the nodes above them once,
+		// and onVoxelsInBoxUpdated is invoked once with it
+		void setVoxelRuns(const IntegerVector3<VoxelCoordType> &pBoxMinVoxelCoords, const IntegerVector3<VoxelCoordType> &pBoxMaxVoxelCoords, const DynamicArray<VoxelRun> &pVoxelRuns);
+
+		/// <summary>
+		/// Copy the voxel data of all the voxels in a box, including the empty ones, in the same order in which setVoxelsInBox visits them.
+		/// Together with setVoxelRuns, this copies the contents of a box out of the voxel grid and back into it
+		/// </summary>
+		/// <param name="pBoxMinVoxelCoords">The coordinates of the minimum voxel of the box</param>
+		/// <param name="pBoxMaxVoxelCoords">The coordinates of the maximum voxel of the box. The parts of the box outside of the voxel grid are ignored</param>
+		/// <param name="pVoxelRuns">The voxel data of the voxels is appended to it as runs</param>
+		void copyVoxelsFromBox(const IntegerVector3<VoxelCoordType> &pBoxMinVoxelCoords, const IntegerVector3<VoxelCoordType> &pBoxMaxVoxelCoords, DynamicArray<VoxelRun> &pVoxelRuns) const;
+
 		/// <summary>
 		/// Checks if the given voxel coordinates are within the bounds of the voxel grid
 		/// </summary>
@@ -64,29 +113,124 @@ namespace forge
 		// Get the AABB of the voxel grid. Any point inside this AABB will be intersect a voxel
 		AABB getAABB() const;
 
-		ResizableArray<VoxelData>* getVoxelDataArray();
+		// The element at the index of a Morton code holds the bitfield of the node with that Morton code. The element at index 0 is not used
+		ResizableArray<UInt8>* getOctreeNodeChildMaskArray();
+
+		const ResizableArray<UInt8>* getOctreeNodeChildMaskArray() const;
+
+		// The element at the index of a Morton code of a node at the voxel brick level, without its leading 1 bit, holds the voxel brick of that node
+		ResizableArray<UInt64>* getVoxelBrickArray();
 
-		const ResizableArray<VoxelData>* getVoxelDataArray() const;
+		const ResizableArray<UInt64>* getVoxelBrickArray() const;
+
+		// The element at the index of a voxel brick holds the index of the voxel data of the first non empty voxel of that voxel brick.
+		// The voxel data of the voxel with bit i is at that index + (the number of set bits in the voxel brick below bit i). It is not used by empty voxel bricks
+		ResizableArray<UInt32>* getVoxelBrickFirstMaterialIndexArray();
+
+		const ResizableArray<UInt32>* getVoxelBrickFirstMaterialIndexArray() const;
+
+		// Holds the voxel data of the non empty voxels. Only the first getNumberOfVoxelMaterials elements are in use, and some of them may have been left behind
+		// by voxel bricks whose voxel data no longer fit where it was
+		ResizableArray<VoxelData>* getVoxelMaterialArray();
+
+		const ResizableArray<VoxelData>* getVoxelMaterialArray() const;
+
+		SizeType getNumberOfVoxelMaterials() const;
+
+		// Set the number of voxel data in use, after the arrays were written directly, like when they are copied from the device. The voxel material array grows to hold them,
+		// and the voxel data of every non empty voxel must be in it
+		void setNumberOfVoxelMaterials(SizeType pNumberOfVoxelMaterials);
 
 		/// <summary>
-		/// Converts 3D voxel coordinates into an index that can be used on a contiguous voxel data array
+		/// Converts 3D voxel coordinates into the Morton code of the voxel, as a leaf node of the octree
 		/// </summary>
-		/// <param name="xCoord">The x coordinate of the voxel</param>
-		/// <param name="yCoord">The y coordinate of the voxel</param>
-		/// <param name="zCoord">The z coordinate of the voxel</param>
-		/// <returns>The index of the element in the voxel data array the represents the voxel with the given coordinates</returns>
-		SizeType convertVoxelCoordsToArrayIndex(const IntegerVector3<VoxelCoordType> &pVoxelCoords) const;
+		/// <param name="pVoxelCoords">The coordinates of the voxel</param>
+		/// <returns>The Morton code of the voxel, or 0 if the coordinates are out of bounds</returns>
+		UInt32 convertVoxelCoordsToMortonCode(const IntegerVector3<VoxelCoordType> &pVoxelCoords) const;
+
+		// Get the index of the voxel brick that holds the voxel with the given Morton code
+		SizeType getVoxelBrickIndex(UInt32 pVoxelMortonCode) const;
 
+		// Get the coordinates of the voxel with the smallest coordinates in the voxel brick with the given index
+		IntegerVector3<VoxelCoordType> getVoxelBrickMinVoxelCoords(SizeType pVoxelBrickIndex) const;
+
+		// Get the index of the bit that represents the voxel with the given Morton code in its voxel brick
+		static UInt32 getVoxelBrickBitIndex(UInt32 pVoxelMortonCode);
+
+		// Get the index of the voxel with the given Morton code, which is its Morton code without the leading 1 bit. It is the index of its voxel brick followed by the index of its bit
+		SizeType getVoxelIndex(UInt32 pVoxelMortonCode) const;
+
+		// Get the Morton code of the node at the given level with the given coords. The coords of a node are the remapped coords of its minimum voxel divided by its side length.
+		// At the voxel brick level, the Morton code without the leading 1 bit is the index of the voxel brick
+		UInt32 getNodeMortonCode(const IntegerVector3<UInt32> &pNodeCoords, UInt32 pNodeLevel) const;
+
+		// Clip a box to the voxel grid, and get the range of coords of the voxel bricks that overlap it. The maximum coords are inclusive.
+		// Returns false if none of the box is inside the voxel grid
+		bool getVoxelBricksInBox(IntegerVector3<VoxelCoordType> &pBoxMinVoxelCoords, IntegerVector3<VoxelCoordType> &pBoxMaxVoxelCoords,
+								 IntegerVector3<UInt32> &pMinVoxelBrickCoords, IntegerVector3<UInt32> &pMaxVoxelBrickCoords) const;
+
+		// Invoked with the Morton code and the new bitfield of an octree node whenever the bitfield changes
 		Event<UInt32, UInt8> onVoxelOctreeNodeUpdated;
 
+		// Invoked with the index and the new bitfield of a voxel brick whenever the bitfield changes
+		Event<SizeType, UInt64> onVoxelBrickUpdated;
+
+		// Invoked with the index and the new voxel data of a voxel whenever the voxel data changes
+		Event<SizeType, VoxelData> onVoxelMaterialUpdated;
+
+		// Invoked with the minimum and maximum voxel coords of a box, clipped to the voxel grid, after the voxels in it were written by setVoxelsInBox or setVoxelRuns.
+		// Any of the voxels in the box, the voxel bricks that overlap it and the nodes above them may have changed
+		Event<IntegerVector3<VoxelCoordType>, IntegerVector3<VoxelCoordType>> onVoxelsInBoxUpdated;
+
 	private:
 
 		UInt32 getMortonCodeForVoxelCoords(const IntegerVector3<VoxelCoordType> &pVoxelCoords) const;
 
 		UInt32 part1By2For32BitInteger(UInt32 pValue) const;
 
-		// The hash table that holds the data for all the voxels
-		ResizableArray<VoxelData> voxelDataArray;
+		// The inverse of part1By2For32BitInteger. Only every third bit of the given value is used, starting from the lowest bit
+		UInt32 compact1By2For32BitInteger(UInt32 pValue) const;
+
+		/// <summary>
+		/// Set or clear the bit of a node in the bitfield of its parent, and update the bits of the nodes above it if that makes the parent exist or stop existing
+		/// </summary>
+		/// <param name="pNodeMortonCode">The Morton code of the node. Must be at the voxel brick level or above it, and not the root node</param>
+		/// <param name="pDoesNodeExist">Whether the node exists</param>
+		void updateParentNodeBitfields(UInt32 pNodeMortonCode, bool pDoesNodeExist);
+
+		// Rebuild the bitfield of every node above the given range of voxel bricks once, level by level from the bottom up. The maximum coords are inclusive
+		void updateNodesAboveVoxelBricks(const IntegerVector3<UInt32> &pMinVoxelBrickCoords, const IntegerVector3<UInt32> &pMaxVoxelBrickCoords);
+
+		// Append a voxel to the last run if it continues it, or else start a new run with it
+		static void appendVoxelToVoxelRuns(DynamicArray<VoxelRun> &pVoxelRuns, UInt32 pVoxelIndex, const VoxelData &pVoxelData);
+
+		// Get the voxel data of all the voxels of a voxel brick, in the order of their bits. The empty voxels get the empty voxel data
+		void getVoxelBrickVoxels(SizeType pVoxelBrickIndex, VoxelData pVoxels[64]) const;
+
+		// Set the voxel data of all the voxels of a voxel brick, in the order of their bits, and return the new voxel brick. The voxel data is written over the old voxel data
+		// if there are no more non empty voxels than before, or else after the voxel data in use. The nodes above the voxel brick are not updated
+		UInt64 setVoxelBrickVoxels(SizeType pVoxelBrickIndex, const VoxelData pVoxels[64]);
+
+		// Make room for the given number of voxel data after the voxel data in use, and return the index of the first of them. If they do not fit, the voxel data in use
+		// is packed together first when at least half of it was left behind by voxel bricks that moved, or else the array grows by at least half of its length
+		SizeType allocateVoxelMaterials(SizeType pNumberOfVoxelMaterials);
+
+		// Move the voxel data of the voxel bricks next to each other, in the order of the voxel bricks, so that none of it is left behind
+		void packVoxelMaterials();
+
+		// Get the number of non empty voxels, which is the number of voxel data that the voxel bricks use
+		SizeType getNumberOfNonEmptyVoxels() const;
+
+		// Holds the bitfields of the nodes above the voxel brick level
+		ResizableArray<UInt8> octreeNodeChildMaskArray;
+		// Holds the bitfields of the nodes at the voxel brick level
+		ResizableArray<UInt64> voxelBrickArray;
+		// Holds the index of the voxel data of the first non empty voxel of each voxel brick
+		ResizableArray<UInt32> voxelBrickFirstMaterialIndexArray;
+		// Holds the voxel data of the non empty voxels
+		ResizableArray<VoxelData> voxelMaterialArray;
+		// The number of elements of the voxel material array in use, including the ones left behind by voxel bricks that moved
+		SizeType numberOfVoxelMaterials;
 		const UInt32 octreeDepth;
 		// The coordinates of the bottom left voxel
 		IntegerVector3<VoxelCoordType> minVoxelCoords;
@@ -105,6 +249,12 @@ namespace forge
 		return this->octreeDepth;
 	}
 
+	inline
+	UInt32 VoxelGrid::getVoxelBrickLevel() const
+	{
+		return this->octreeDepth - 3;
+	}
+
 	inline
 	IntegerVector3<VoxelGrid::VoxelCoordType> VoxelGrid::getMinVoxelCoords() const
 	{
@@ -126,7 +276,22 @@ namespace forge
 	inline
 	VoxelData VoxelGrid::getVoxelData(const IntegerVector3<VoxelCoordType> &pVoxelCoords) const
 	{
-		return this->voxelDataArray[this->convertVoxelCoordsToArrayIndex(pVoxelCoords)];
+		const UInt32 voxelMortonCode = this->convertVoxelCoordsToMortonCode(pVoxelCoords);
+		if(voxelMortonCode == 0)
+		{
+			return VoxelData();
+		}
+
+		// Only the non empty voxels have voxel data, so skip the ones that come before this voxel
+		const SizeType voxelBrickIndex = this->getVoxelBrickIndex(voxelMortonCode);
+		const UInt64 voxelBrick = this->voxelBrickArray[voxelBrickIndex];
+		const UInt64 voxelBit = bitwiseLeftShiftInteger<UInt64>(1, VoxelGrid::getVoxelBrickBitIndex(voxelMortonCode));
+		if(!(voxelBrick & voxelBit))
+		{
+			return VoxelData();
+		}
+
+		return this->voxelMaterialArray[this->voxelBrickFirstMaterialIndexArray[voxelBrickIndex] + countSetBits(voxelBrick & (voxelBit - 1))];
 	}
 
 	inline
@@ -144,30 +309,110 @@ namespace forge
 	}
 
 	inline
-	ResizableArray<VoxelData>* VoxelGrid::getVoxelDataArray()
+	ResizableArray<UInt8>* VoxelGrid::getOctreeNodeChildMaskArray()
+	{
+		return &this->octreeNodeChildMaskArray;
+	}
+
+	inline
+	const ResizableArray<UInt8>* VoxelGrid::getOctreeNodeChildMaskArray() const
+	{
+		return &this->octreeNodeChildMaskArray;
+	}
+
+	inline
+	ResizableArray<UInt64>* VoxelGrid::getVoxelBrickArray()
+	{
+		return &this->voxelBrickArray;
+	}
+
+	inline
+	const ResizableArray<UInt64>* VoxelGrid::getVoxelBrickArray() const
+	{
+		return &this->voxelBrickArray;
+	}
+
+	inline
+	ResizableArray<UInt32>* VoxelGrid::getVoxelBrickFirstMaterialIndexArray()
+	{
+		return &this->voxelBrickFirstMaterialIndexArray;
+	}
+
+	inline
+	const ResizableArray<UInt32>* VoxelGrid::getVoxelBrickFirstMaterialIndexArray() const
+	{
+		return &this->voxelBrickFirstMaterialIndexArray;
+	}
+
+	inline
+	ResizableArray<VoxelData>* VoxelGrid::getVoxelMaterialArray()
 	{
-		return &this->voxelDataArray;
+		return &this->voxelMaterialArray;
 	}
 
 	inline
-	const ResizableArray<VoxelData>* VoxelGrid::getVoxelDataArray() const
+	const ResizableArray<VoxelData>* VoxelGrid::getVoxelMaterialArray() const
 	{
-		return &this->voxelDataArray;
+		return &this->voxelMaterialArray;
 	}
 
 	inline
-	SizeType VoxelGrid::convertVoxelCoordsToArrayIndex(const IntegerVector3<VoxelCoordType> &pVoxelCoords) const
+	SizeType VoxelGrid::getNumberOfVoxelMaterials() const
+	{
+		return this->numberOfVoxelMaterials;
+	}
+
+	inline
+	UInt32 VoxelGrid::convertVoxelCoordsToMortonCode(const IntegerVector3<VoxelCoordType> &pVoxelCoords) const
 	{
 		// Do nothing if the givel voxel coordinates are out of bounds
 		if(!this->areCoordinatesWithinBounds(pVoxelCoords))
 		{
-			FORGE_ERROR_LOG("The voxel coordinates given to the convertVoxelCoordsToArrayIndex function are out of bounds");
+			FORGE_ERROR_LOG("The voxel coordinates given to the convertVoxelCoordsToMortonCode function are out of bounds");
 			return 0;
 		}
 
 		return this->getMortonCodeForVoxelCoords(pVoxelCoords);
 	}
 
+	inline
+	SizeType VoxelGrid::getVoxelBrickIndex(UInt32 pVoxelMortonCode) const
+	{
+		// The two lowest levels are inside the voxel brick, and the leading 1 bit of the Morton code of the brick's node is removed
+		return bitwiseRightShiftInteger<UInt32>(pVoxelMortonCode, 6) ^ bitwiseLeftShiftInteger<UInt32>(1, this->getVoxelBrickLevel() * 3);
+	}
+
+	inline
+	IntegerVector3<VoxelGrid::VoxelCoordType> VoxelGrid::getVoxelBrickMinVoxelCoords(SizeType pVoxelBrickIndex) const
+	{
+		// The index of a voxel brick is the Morton code of its node without the leading 1 bit
+		const UInt32 voxelBrickMortonCode = static_cast<UInt32>(pVoxelBrickIndex);
+		return IntegerVector3<VoxelCoordType>(static_cast<VoxelCoordType>(this->compact1By2For32BitInteger(voxelBrickMortonCode)) * VoxelGrid::voxelBrickSideLength + this->minVoxelCoords.x,
+											  static_cast<VoxelCoordType>(this->compact1By2For32BitInteger(bitwiseRightShiftInteger<UInt32>(voxelBrickMortonCode, 1))) * VoxelGrid::voxelBrickSideLength + this->minVoxelCoords.y,
+											  static_cast<VoxelCoordType>(this->compact1By2For32BitInteger(bitwiseRightShiftInteger<UInt32>(voxelBrickMortonCode, 2))) * VoxelGrid::voxelBrickSideLength + this->minVoxelCoords.z);
+	}
+
+	inline
+	UInt32 VoxelGrid::getVoxelBrickBitIndex(UInt32 pVoxelMortonCode)
+	{
+		return pVoxelMortonCode & 0x0000003f;
+	}
+
+	inline
+	SizeType VoxelGrid::getVoxelIndex(UInt32 pVoxelMortonCode) const
+	{
+		return pVoxelMortonCode ^ bitwiseLeftShiftInteger<UInt32>(1, (this->octreeDepth - 1) * 3);
+	}
+
+	inline
+	UInt32 VoxelGrid::getNodeMortonCode(const IntegerVector3<UInt32> &pNodeCoords, UInt32 pNodeLevel) const
+	{
+		return (this->part1By2For32BitInteger(pNodeCoords.z) << 2) |
+			   (this->part1By2For32BitInteger(pNodeCoords.y) << 1) |
+			   this->part1By2For32BitInteger(pNodeCoords.x) |
+			   bitwiseLeftShiftInteger<UInt32>(1, pNodeLevel * 3);
+	}
+
 	inline
 	UInt32 VoxelGrid::getMortonCodeForVoxelCoords(const IntegerVector3<VoxelCoordType> &pVoxelCoords) const
 	{
@@ -204,6 +449,27 @@ namespace forge
 
 		return pValue;
 	}
+
+	inline
+	UInt32 VoxelGrid::compact1By2For32BitInteger(UInt32 pValue) const
+	{
+		pValue = pValue & 0b00001001001001001001001001001001;
+		// pValue used bits are now 00001001001001001001001001001001
+
+		pValue = (pValue ^ bitwiseRightShiftInteger<UInt32>(pValue, 2)) & 0b00000011000011000011000011000011;
+		// pValue used bits are now 00000011000011000011000011000011
+
+		pValue = (pValue ^ bitwiseRightShiftInteger<UInt32>(pValue, 4)) & 0b00000011000000001111000000001111;
+		// pValue used bits are now 00000011000000001111000000001111
+
+		pValue = (pValue ^ bitwiseRightShiftInteger<UInt32>(pValue, 8)) & 0b00000011000000000000000011111111;
+		// pValue used bits are now 00000011000000000000000011111111
+
+		pValue = (pValue ^ bitwiseRightShiftInteger<UInt32>(pValue, 16)) & 0b00000000000000000000001111111111;
+		// pValue used bits are now 00000000000000000000001111111111
+
+		return pValue;
+	}
 }
 
 #endif
\ No newline at end of file
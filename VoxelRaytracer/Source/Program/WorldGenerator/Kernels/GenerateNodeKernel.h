@@ -14,6 +14,9 @@ namespace forge
 		void setKernelVoxelArrayBuffer(cl_mem pKernelVoxelArrayBuffer);
 
 		void setVoxelOctreeDepth(UInt32 pVoxelOctreeDepth);
+
+		// Only used by the generateVoxelBrickParentNodeKernel kernel
+		void setKernelVoxelBrickArrayBuffer(cl_mem pKernelVoxelBrickArrayBuffer);
 	};
 
 	inline
@@ -33,6 +36,12 @@ namespace forge
 	{
 		this->setUInt(1, pVoxelOctreeDepth);
 	}
+
+	inline
+	void GenerateNodeKernel::setKernelVoxelBrickArrayBuffer(cl_mem pKernelVoxelBrickArrayBuffer)
+	{
+		this->setBuffer(2, pKernelVoxelBrickArrayBuffer);
+	}
 }
 
 #endif
\ No newline at end of file
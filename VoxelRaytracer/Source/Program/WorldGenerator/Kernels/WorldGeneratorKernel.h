@@ -11,11 +11,27 @@ namespace forge
 
 		WorldGeneratorKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName);
 
-		void setKernelVoxelArrayBuffer(cl_mem pKernelVoxelArrayBuffer);
-
-		void setVoxelOctreeDepth(UInt32 pVoxelOctreeDepth);
+		void setKernelVoxelBrickArrayBuffer(cl_mem pKernelVoxelBrickArrayBuffer);
 
 		void setOffset(Float pOffset);
+
+		void setKernelVoxelMaterialArrayBuffer(cl_mem pKernelVoxelMaterialArrayBuffer);
+
+		// The voxel with the remapped coords c is stored at ((c + toroidalOffset) mod voxelGridSideLength)
+		void setVoxelGridToroidalOffset(const IntegerVector3<Int32> &pVoxelGridToroidalOffset);
+
+		void setVoxelBrickLevel(UInt32 pVoxelBrickLevel);
+
+		void setKernelVoxelBrickFirstMaterialIndexArrayBuffer(cl_mem pKernelVoxelBrickFirstMaterialIndexArrayBuffer);
+
+		// Holds a single UInt32, which the voxel bricks that need new room for their voxel data add their number of non empty voxels to
+		void setKernelNumberOfAllocatedVoxelMaterialsBuffer(cl_mem pKernelNumberOfAllocatedVoxelMaterialsBuffer);
+
+		// The number of voxel data that fit in the voxel material array
+		void setVoxelMaterialArrayCapacity(UInt32 pVoxelMaterialArrayCapacity);
+
+		// Only used by the generateVoxelBlockKernel kernel
+		void setKernelChildMaskArrayBuffer(cl_mem pKernelChildMaskArrayBuffer);
 	};
 
 	inline
@@ -25,21 +41,57 @@ namespace forge
 	}
 
 	inline
-	void WorldGeneratorKernel::setKernelVoxelArrayBuffer(cl_mem pKernelVoxelArrayBuffer)
+	void WorldGeneratorKernel::setKernelVoxelBrickArrayBuffer(cl_mem pKernelVoxelBrickArrayBuffer)
 	{
-		this->setBuffer(0, pKernelVoxelArrayBuffer);
+		this->setBuffer(0, pKernelVoxelBrickArrayBuffer);
 	}
 
 	inline
-	void WorldGeneratorKernel::setVoxelOctreeDepth(UInt32 pVoxelOctreeDepth)
+	void WorldGeneratorKernel::setOffset(Float pOffset)
 	{
-		this->setUInt(1, pVoxelOctreeDepth);
+		this->setFloat(1, pOffset);
 	}
 
 	inline
-	void WorldGeneratorKernel::setOffset(Float pOffset)
+	void WorldGeneratorKernel::setKernelVoxelMaterialArrayBuffer(cl_mem pKernelVoxelMaterialArrayBuffer)
+	{
+		this->setBuffer(2, pKernelVoxelMaterialArrayBuffer);
+	}
+
+	inline
+	void WorldGeneratorKernel::setVoxelGridToroidalOffset(const IntegerVector3<Int32> &pVoxelGridToroidalOffset)
+	{
+		this->setInt3(3, pVoxelGridToroidalOffset);
+	}
+
+	inline
+	void WorldGeneratorKernel::setVoxelBrickLevel(UInt32 pVoxelBrickLevel)
+	{
+		this->setUInt(4, pVoxelBrickLevel);
+	}
+
+	inline
+	void WorldGeneratorKernel::setKernelVoxelBrickFirstMaterialIndexArrayBuffer(cl_mem pKernelVoxelBrickFirstMaterialIndexArrayBuffer)
+	{
+		this->setBuffer(5, pKernelVoxelBrickFirstMaterialIndexArrayBuffer);
+	}
+
+	inline
+	void WorldGeneratorKernel::setKernelNumberOfAllocatedVoxelMaterialsBuffer(cl_mem pKernelNumberOfAllocatedVoxelMaterialsBuffer)
+	{
+		this->setBuffer(6, pKernelNumberOfAllocatedVoxelMaterialsBuffer);
+	}
+
+	inline
+	void WorldGeneratorKernel::setVoxelMaterialArrayCapacity(UInt32 pVoxelMaterialArrayCapacity)
+	{
+		this->setUInt(7, pVoxelMaterialArrayCapacity);
+	}
+
+	inline
+	void WorldGeneratorKernel::setKernelChildMaskArrayBuffer(cl_mem pKernelChildMaskArrayBuffer)
 	{
-		this->setFloat(2, pOffset);
+		this->setBuffer(8, pKernelChildMaskArrayBuffer);
 	}
 }
 
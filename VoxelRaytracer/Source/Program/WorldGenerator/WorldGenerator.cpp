@@ -0,0 +1,392 @@
+#include "WorldGenerator.h"
+#include <Forge/Source/Platform/OpenCL/OpenCLUtility.h>
+#include <Forge/Source/Platform/Windows/FileEditors/TextFileEditor.h>
+#include <Forge/Source/Core/Math/MathUtility.h>
+
+namespace forge
+{
+	namespace
+	{
+		// The names of the node generation commands given to the profiler, indexed by octree level
+		const char *const generateNodesCommandNames[] =
+		{
+			"generateNodes level 0", "generateNodes level 1", "generateNodes level 2", "generateNodes level 3",
+			"generateNodes level 4", "generateNodes level 5", "generateNodes level 6", "generateNodes level 7",
+			"generateNodes level 8", "generateNodes level 9", "generateNodes level 10", "generateNodes level 11",
+			"generateNodes level 12", "generateNodes level 13", "generateNodes level 14", "generateNodes level 15"
+		};
+	}
+
+	void WorldGenerator::startup(OpenCLManager *pOpenCLManager, const VoxelGrid *pVoxelGrid, cl_mem pKernelVoxelDataBuffer, cl_mem pKernelVoxelBrickBuffer, cl_mem pKernelVoxelBrickFirstMaterialIndexBuffer)
+	{
+		this->openCLManager = pOpenCLManager;
+		this->voxelGrid = pVoxelGrid;
+
+		TextFileEditor generateVoxelKernelTextEditor;
+		generateVoxelKernelTextEditor.openFile("ForgeData/OpenCL/Kernels/GenerateVoxel.cl");
+		this->generateVoxelKernel = new WorldGeneratorKernel(this->openCLManager, &generateVoxelKernelTextEditor, "generateVoxelKernel");
+		this->generateVoxelBlockKernel = new WorldGeneratorKernel(this->openCLManager, &generateVoxelKernelTextEditor, "generateVoxelBlockKernel");
+
+		TextFileEditor generateNodeKernelTextEditor;
+		generateNodeKernelTextEditor.openFile("ForgeData/OpenCL/Kernels/GenerateNode.cl");
+		this->generateNodeKernel = new GenerateNodeKernel(this->openCLManager, &generateNodeKernelTextEditor, "generateNodeKernel");
+		this->generateNodeLevelKernel = new GenerateNodeKernel(this->openCLManager, &generateNodeKernelTextEditor, "generateNodeLevelKernel");
+		this->generateTopNodeLevelsKernel = new GenerateNodeKernel(this->openCLManager, &generateNodeKernelTextEditor, "generateTopNodeLevelsKernel");
+		this->generateVoxelBrickParentNodeKernel = new GenerateNodeKernel(this->openCLManager, &generateNodeKernelTextEditor, "generateVoxelBrickParentNodeKernel");
+
+		// Used to store the return code from OpenCL functions
+		cl_int returnCode;
+		this->kernelNumberOfAllocatedVoxelMaterialsBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_WRITE, sizeof(cl_uint), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+
+		this->generateVoxelKernel->setVoxelBrickLevel(this->voxelGrid->getVoxelBrickLevel());
+		this->generateVoxelKernel->setKernelNumberOfAllocatedVoxelMaterialsBuffer(this->kernelNumberOfAllocatedVoxelMaterialsBuffer);
+		this->generateVoxelBlockKernel->setVoxelBrickLevel(this->voxelGrid->getVoxelBrickLevel());
+		this->generateVoxelBlockKernel->setKernelNumberOfAllocatedVoxelMaterialsBuffer(this->kernelNumberOfAllocatedVoxelMaterialsBuffer);
+		this->setVoxelBuffers(pKernelVoxelDataBuffer, pKernelVoxelBrickBuffer, pKernelVoxelBrickFirstMaterialIndexBuffer);
+
+		this->worldOffset = 0.0f;
+		this->voxelGridToroidalOffset = IntegerVector3<Int32>(0, 0, 0);
+	}
+
+	void WorldGenerator::setVoxelBuffers(cl_mem pKernelVoxelDataBuffer, cl_mem pKernelVoxelBrickBuffer, cl_mem pKernelVoxelBrickFirstMaterialIndexBuffer)
+	{
+		this->kernelVoxelDataBuffer = pKernelVoxelDataBuffer;
+		this->kernelVoxelBrickBuffer = pKernelVoxelBrickBuffer;
+		this->kernelVoxelBrickFirstMaterialIndexBuffer = pKernelVoxelBrickFirstMaterialIndexBuffer;
+
+		if(this->kernelVoxelBrickBuffer)
+		{
+			// The world is generated whole into new buffers, so the voxel material buffer starts out as large as it was for the last world,
+			// or else with room for one voxel per voxel brick, and is resized once the world is generated
+			const SizeType voxelMaterialArrayCapacity = (this->voxelMaterialArrayCapacity > 0)? this->voxelMaterialArrayCapacity : this->voxelGrid->getVoxelBrickArray()->getNumberOfElements();
+			this->createVoxelMaterialBuffer(voxelMaterialArrayCapacity, 0);
+		}
+		else if(this->kernelVoxelMaterialBuffer)
+		{
+			// The buffer is only freed once the commands that use it have finished
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelVoxelMaterialBuffer));
+			this->kernelVoxelMaterialBuffer = nullptr;
+		}
+
+		this->generateVoxelKernel->setKernelVoxelBrickArrayBuffer(this->kernelVoxelBrickBuffer);
+		this->generateVoxelKernel->setKernelVoxelBrickFirstMaterialIndexArrayBuffer(this->kernelVoxelBrickFirstMaterialIndexBuffer);
+		this->generateVoxelBlockKernel->setKernelVoxelBrickArrayBuffer(this->kernelVoxelBrickBuffer);
+		this->generateVoxelBlockKernel->setKernelVoxelBrickFirstMaterialIndexArrayBuffer(this->kernelVoxelBrickFirstMaterialIndexBuffer);
+		this->generateVoxelBlockKernel->setKernelChildMaskArrayBuffer(this->kernelVoxelDataBuffer);
+		this->generateNodeKernel->setKernelVoxelArrayBuffer(this->kernelVoxelDataBuffer);
+		this->generateNodeLevelKernel->setKernelVoxelArrayBuffer(this->kernelVoxelDataBuffer);
+		this->generateTopNodeLevelsKernel->setKernelVoxelArrayBuffer(this->kernelVoxelDataBuffer);
+		this->generateVoxelBrickParentNodeKernel->setKernelVoxelArrayBuffer(this->kernelVoxelDataBuffer);
+		this->generateVoxelBrickParentNodeKernel->setKernelVoxelBrickArrayBuffer(this->kernelVoxelBrickBuffer);
+	}
+
+	void WorldGenerator::shutdown()
+	{
+		if(this->numberOfAllocatedVoxelMaterialsReadEvent)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clWaitForEvents(1, &this->numberOfAllocatedVoxelMaterialsReadEvent));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseEvent(this->numberOfAllocatedVoxelMaterialsReadEvent));
+		}
+		if(this->kernelVoxelMaterialBuffer)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelVoxelMaterialBuffer));
+		}
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelNumberOfAllocatedVoxelMaterialsBuffer));
+
+		delete this->generateVoxelKernel;
+		delete this->generateVoxelBlockKernel;
+		delete this->generateNodeKernel;
+		delete this->generateNodeLevelKernel;
+		delete this->generateTopNodeLevelsKernel;
+		delete this->generateVoxelBrickParentNodeKernel;
+	}
+
+	void WorldGenerator::generateWorld(Float pWorldOffset)
+	{
+		// Generate the voxel bricks, and the nodes that are generated together with them
+		this->generateVoxels(pWorldOffset);
+		this->generateNodeLevelsAboveVoxels();
+		this->readNumberOfAllocatedVoxelMaterials();
+
+		// Scrolling takes new room for the voxel bricks whose non empty voxels no longer fit where they were, and leaves the room of the voxels that scroll out behind,
+		// so the voxel material buffer is given half again as much room as the world needs. It is only resized while less than an eighth of it is left or more than half
+		// of it is not needed, so that generating the world every frame does not resize it every frame. If the voxel data did not fit at all, the voxel bricks that did
+		// not fit have the wrong voxel data, so the world is generated again
+		const SizeType numberOfAllocatedVoxelMaterials = this->getNumberOfAllocatedVoxelMaterials();
+		const SizeType voxelMaterialArrayCapacity = numberOfAllocatedVoxelMaterials + numberOfAllocatedVoxelMaterials / 2;
+		if(numberOfAllocatedVoxelMaterials > this->voxelMaterialArrayCapacity)
+		{
+			this->createVoxelMaterialBuffer(voxelMaterialArrayCapacity, 0);
+			this->generateWorld(pWorldOffset);
+		}
+		else if(numberOfAllocatedVoxelMaterials > this->voxelMaterialArrayCapacity - this->voxelMaterialArrayCapacity / 8 || voxelMaterialArrayCapacity < this->voxelMaterialArrayCapacity / 2)
+		{
+			this->createVoxelMaterialBuffer(voxelMaterialArrayCapacity, numberOfAllocatedVoxelMaterials);
+		}
+	}
+
+	void WorldGenerator::scrollWorld(Int32 pScrollDistance)
+	{
+		if(pScrollDistance == 0)
+		{
+			return;
+		}
+
+		// If the world moves by the side length of the voxel grid or more, none of the voxels stay in it
+		const Int32 sideLength = static_cast<Int32>(this->voxelGrid->getSideLength());
+		if(abs(pScrollDistance) >= sideLength)
+		{
+			this->generateWorld(this->worldOffset + static_cast<Float>(pScrollDistance));
+			return;
+		}
+
+		// The voxel data left behind by the previous scrolls is only reclaimed by generating the whole world again, so that is done once the voxel material buffer
+		// is nearly full, or if the last scroll ran out of room. The number of allocated voxel data was read back after the last scroll, which has usually finished by now
+		const SizeType numberOfAllocatedVoxelMaterials = this->getNumberOfAllocatedVoxelMaterials();
+		if(numberOfAllocatedVoxelMaterials > this->voxelMaterialArrayCapacity - this->voxelMaterialArrayCapacity / 16)
+		{
+			this->generateWorld(this->worldOffset + static_cast<Float>(pScrollDistance));
+			return;
+		}
+
+		this->numberOfGeneratedVoxelBrickRanges = 0;
+
+		// The voxel that ends up at the remapped coords c was stored at ((c + pScrollDistance + toroidalOffset) mod sideLength), so it stays where it is in memory
+		// if the scroll distance is added to the toroidal offset. The side length is a power of 2, so the toroidal offset wraps around with a mask
+		this->worldOffset += static_cast<Float>(pScrollDistance);
+		for(SizeType i = 0; i < 3; ++i)
+		{
+			this->voxelGridToroidalOffset[i] = (this->voxelGridToroidalOffset[i] + pScrollDistance) & (sideLength - 1);
+		}
+
+		// The voxels that come into the voxel grid are in a slab at its end along each axis if it scrolls forward, or at its start if it scrolls backward.
+		// The slabs overlap at the edges of the voxel grid, where a few voxel bricks are generated more than once
+		const Int32 slabThickness = abs(pScrollDistance);
+		const Int32 slabFirstRemappedVoxelCoord = (pScrollDistance > 0)? (sideLength - slabThickness) : 0;
+		for(UInt32 axis = 0; axis < 3; ++axis)
+		{
+			this->generateVoxelSlab(axis, slabFirstRemappedVoxelCoord, slabThickness);
+		}
+
+		// The slabs span the whole voxel grid along the other two axes, so the nodes above them only fit in whole levels. Those levels are small next to the slabs,
+		// so they are generated whole with one kernel each, like generateWorld does, instead of with a kernel for each slab and level
+		this->generateNodeLevelsAboveVoxels();
+		this->readNumberOfAllocatedVoxelMaterials();
+	}
+
+	SizeType WorldGenerator::getNumberOfAllocatedVoxelMaterials()
+	{
+		if(this->numberOfAllocatedVoxelMaterialsReadEvent)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clWaitForEvents(1, &this->numberOfAllocatedVoxelMaterialsReadEvent));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseEvent(this->numberOfAllocatedVoxelMaterialsReadEvent));
+			this->numberOfAllocatedVoxelMaterialsReadEvent = NULL;
+		}
+		return static_cast<SizeType>(this->numberOfAllocatedVoxelMaterials);
+	}
+
+	void WorldGenerator::createVoxelMaterialBuffer(SizeType pVoxelMaterialArrayCapacity, SizeType pNumberOfVoxelMaterialsToKeep)
+	{
+		// A voxel brick may need room for all of its voxels
+		this->voxelMaterialArrayCapacity = max<SizeType>(pVoxelMaterialArrayCapacity, 64);
+
+		// Used to store the return code from OpenCL functions
+		cl_int returnCode;
+		cl_mem voxelMaterialBuffer = clCreateBuffer(this->openCLManager->getContext(), CL_MEM_READ_WRITE, sizeof(VoxelData) * this->voxelMaterialArrayCapacity, NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+
+		// The previous buffer is only freed once the commands that use it have finished. Copying zero bytes is not allowed
+		if(this->kernelVoxelMaterialBuffer)
+		{
+			if(pNumberOfVoxelMaterialsToKeep > 0)
+			{
+				FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueCopyBuffer(this->openCLManager->getCommandQueue(), this->kernelVoxelMaterialBuffer, voxelMaterialBuffer, 0, 0,
+																  sizeof(VoxelData) * pNumberOfVoxelMaterialsToKeep, 0, NULL, NULL));
+			}
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelVoxelMaterialBuffer));
+		}
+		this->kernelVoxelMaterialBuffer = voxelMaterialBuffer;
+
+		this->generateVoxelKernel->setKernelVoxelMaterialArrayBuffer(this->kernelVoxelMaterialBuffer);
+		this->generateVoxelKernel->setVoxelMaterialArrayCapacity(static_cast<UInt32>(this->voxelMaterialArrayCapacity));
+		this->generateVoxelBlockKernel->setKernelVoxelMaterialArrayBuffer(this->kernelVoxelMaterialBuffer);
+		this->generateVoxelBlockKernel->setVoxelMaterialArrayCapacity(static_cast<UInt32>(this->voxelMaterialArrayCapacity));
+	}
+
+	void WorldGenerator::readNumberOfAllocatedVoxelMaterials()
+	{
+		// Only the read back after the last generation function is waited for
+		if(this->numberOfAllocatedVoxelMaterialsReadEvent)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseEvent(this->numberOfAllocatedVoxelMaterialsReadEvent));
+		}
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(this->openCLManager->getCommandQueue(),
+														  this->kernelNumberOfAllocatedVoxelMaterialsBuffer,
+														  CL_NON_BLOCKING,
+														  0,
+														  sizeof(cl_uint),
+														  &this->numberOfAllocatedVoxelMaterials,
+														  0,
+														  NULL,
+														  &this->numberOfAllocatedVoxelMaterialsReadEvent));
+	}
+
+	void WorldGenerator::generateVoxels(Float pWorldOffset)
+	{
+		// All the voxel bricks are generated, so they are stored without a toroidal offset
+		this->worldOffset = pWorldOffset;
+		this->voxelGridToroidalOffset = IntegerVector3<Int32>(0, 0, 0);
+
+		// The voxel data of all the voxel bricks is allocated again from the start of the voxel material buffer, so the voxel bricks are cleared
+		// first, which leaves none of them any room to keep
+		const cl_ulong emptyVoxelBrick = 0;
+		const cl_uint numberOfAllocatedVoxelMaterials = 0;
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueFillBuffer(this->openCLManager->getCommandQueue(), this->kernelVoxelBrickBuffer, &emptyVoxelBrick, sizeof(cl_ulong), 0,
+														  sizeof(UInt64) * this->voxelGrid->getVoxelBrickArray()->getNumberOfElements(), 0, NULL, NULL));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueFillBuffer(this->openCLManager->getCommandQueue(), this->kernelNumberOfAllocatedVoxelMaterialsBuffer, &numberOfAllocatedVoxelMaterials, sizeof(cl_uint), 0,
+														  sizeof(cl_uint), 0, NULL, NULL));
+
+		this->numberOfGeneratedVoxelBrickRanges = 0;
+		const UInt32 maxVoxelBrickCoord = static_cast<UInt32>(this->voxelGrid->getSideLength() / VoxelGrid::voxelBrickSideLength) - 1;
+		this->generateVoxelBricksInRange(IntegerVector3<UInt32>(0, 0, 0), IntegerVector3<UInt32>(maxVoxelBrickCoord, maxVoxelBrickCoord, maxVoxelBrickCoord));
+	}
+
+	UInt32 WorldGenerator::getFirstOctreeLevelGeneratedWithVoxels() const
+	{
+		return this->getAreVoxelsGeneratedInBlocks()? (this->voxelGrid->getVoxelBrickLevel() - 2) : this->voxelGrid->getVoxelBrickLevel();
+	}
+
+	bool WorldGenerator::getAreVoxelsGeneratedInBlocks() const
+	{
+		// There are (2 ^ voxelBrickLevel) voxel bricks along each axis
+		return this->voxelGrid->getVoxelBrickLevel() >= 2;
+	}
+
+	void WorldGenerator::generateNodes(UInt32 pOctreeLevel)
+	{
+		// The children of the nodes just above the voxel brick level are voxel bricks, which are only read by the kernel that runs over a range of node coords
+		if(pOctreeLevel + 1 == this->voxelGrid->getVoxelBrickLevel())
+		{
+			// There are (2 ^ pOctreeLevel) nodes along each axis at the given level
+			const UInt32 maxNodeCoord = (static_cast<UInt32>(1) << pOctreeLevel) - 1;
+			this->generateNodesInRange(pOctreeLevel, IntegerVector3<UInt32>(0, 0, 0), IntegerVector3<UInt32>(maxNodeCoord, maxNodeCoord, maxNodeCoord));
+			return;
+		}
+
+		// The kernel takes the depth of the octree that ends at the level being generated
+		this->generateNodeLevelKernel->setVoxelOctreeDepth(pOctreeLevel + 1);
+
+		// Run the kernel. There are (8 ^ pOctreeLevel) nodes at the given level, and each work item generates several of them
+		const size_t numberOfNodes = static_cast<size_t>(1) << (pOctreeLevel * 3);
+		const size_t globalWorkSize = max<size_t>(numberOfNodes / WorldGenerator::numberOfNodesPerWorkItem, 1);
+		const char *commandName = (pOctreeLevel < sizeof(generateNodesCommandNames) / sizeof(generateNodesCommandNames[0]))? generateNodesCommandNames[pOctreeLevel] : "generateNodes";
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->openCLManager->getCommandQueue(), this->generateNodeLevelKernel->getKernel(), 1, NULL, &globalWorkSize, NULL, 0, NULL, this->openCLManager->getProfiler()->getEventForCommand(commandName)));
+	}
+
+	void WorldGenerator::generateTopNodeLevels(UInt32 pOctreeLevel)
+	{
+		// The kernel takes the depth of the octree that ends at the lowest level being generated
+		this->generateTopNodeLevelsKernel->setVoxelOctreeDepth(pOctreeLevel + 1);
+
+		// Run the kernel with a single work group, which generates the levels one after the other
+		const size_t globalWorkSize = WorldGenerator::topNodeLevelsWorkGroupSize;
+		const size_t localWorkSize = WorldGenerator::topNodeLevelsWorkGroupSize;
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->openCLManager->getCommandQueue(), this->generateTopNodeLevelsKernel->getKernel(), 1, NULL, &globalWorkSize, &localWorkSize, 0, NULL, this->openCLManager->getProfiler()->getEventForCommand("generateTopNodeLevels")));
+	}
+
+	bool WorldGenerator::getIsTopOctreeLevel(UInt32 pOctreeLevel) const
+	{
+		return pOctreeLevel < WorldGenerator::maxNumberOfTopOctreeLevels && pOctreeLevel + 1 < this->voxelGrid->getVoxelBrickLevel();
+	}
+
+	void WorldGenerator::generateNodesInRange(UInt32 pOctreeLevel, const IntegerVector3<UInt32> &pMinNodeCoords, const IntegerVector3<UInt32> &pMaxNodeCoords)
+	{
+		// The children of the nodes just above the voxel brick level are voxel bricks, so they are generated by a different kernel
+		GenerateNodeKernel *kernel = (pOctreeLevel + 1 == this->voxelGrid->getVoxelBrickLevel())? this->generateVoxelBrickParentNodeKernel : this->generateNodeKernel;
+
+		// The kernel takes the depth of the octree that ends at the level being generated
+		kernel->setVoxelOctreeDepth(pOctreeLevel + 1);
+
+		// Run the kernel. The global IDs are the coords of the nodes, so the global work offset is the coords of the first node
+		size_t globalWorkOffset[3];
+		globalWorkOffset[0] = static_cast<size_t>(pMinNodeCoords.x);
+		globalWorkOffset[1] = static_cast<size_t>(pMinNodeCoords.y);
+		globalWorkOffset[2] = static_cast<size_t>(pMinNodeCoords.z);
+		size_t globalWorkSize[3];
+		globalWorkSize[0] = static_cast<size_t>(pMaxNodeCoords.x - pMinNodeCoords.x + 1);
+		globalWorkSize[1] = static_cast<size_t>(pMaxNodeCoords.y - pMinNodeCoords.y + 1);
+		globalWorkSize[2] = static_cast<size_t>(pMaxNodeCoords.z - pMinNodeCoords.z + 1);
+		const char *commandName = (pOctreeLevel < sizeof(generateNodesCommandNames) / sizeof(generateNodesCommandNames[0]))? generateNodesCommandNames[pOctreeLevel] : "generateNodes";
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->openCLManager->getCommandQueue(), kernel->getKernel(), 3, globalWorkOffset, globalWorkSize, NULL, 0, NULL, this->openCLManager->getProfiler()->getEventForCommand(commandName)));
+	}
+
+	void WorldGenerator::generateNodeLevelsAboveVoxels()
+	{
+		// Generate the rest of the parent nodes, starting from the level just above the ones generated with the voxel bricks, until the rest are top levels
+		for(UInt32 octreeLevel = this->getFirstOctreeLevelGeneratedWithVoxels(); octreeLevel != 0; --octreeLevel)
+		{
+			if(this->getIsTopOctreeLevel(octreeLevel - 1))
+			{
+				this->generateTopNodeLevels(octreeLevel - 1);
+				break;
+			}
+			this->generateNodes(octreeLevel - 1);
+		}
+	}
+
+	void WorldGenerator::generateVoxelSlab(UInt32 pAxis, Int32 pFirstRemappedVoxelCoord, Int32 pThickness)
+	{
+		const Int32 sideLength = static_cast<Int32>(this->voxelGrid->getSideLength());
+		const UInt32 maxVoxelBrickCoord = static_cast<UInt32>(sideLength / VoxelGrid::voxelBrickSideLength) - 1;
+
+		// With blocks, the voxel bricks are generated in whole blocks, so the voxel brick coords along the axis are rounded out to multiples of 4
+		const UInt32 voxelBrickCoordAlignmentMask = this->getAreVoxelsGeneratedInBlocks()? 3 : 0;
+
+		// The slab is generated in at most two parts, since the part that goes past the end of the memory is at its start
+		Int32 firstVoxelCoordInMemory = (pFirstRemappedVoxelCoord + this->voxelGridToroidalOffset[pAxis]) & (sideLength - 1);
+		Int32 remainingThickness = pThickness;
+		while(remainingThickness > 0)
+		{
+			const Int32 partThickness = min<Int32>(remainingThickness, sideLength - firstVoxelCoordInMemory);
+
+			// The voxel bricks that hold any voxels of the part, which span the whole voxel grid along the other axes
+			IntegerVector3<UInt32> minVoxelBrickCoords(0, 0, 0);
+			IntegerVector3<UInt32> maxVoxelBrickCoords(maxVoxelBrickCoord, maxVoxelBrickCoord, maxVoxelBrickCoord);
+			minVoxelBrickCoords[pAxis] = static_cast<UInt32>(firstVoxelCoordInMemory / VoxelGrid::voxelBrickSideLength) & ~voxelBrickCoordAlignmentMask;
+			maxVoxelBrickCoords[pAxis] = static_cast<UInt32>((firstVoxelCoordInMemory + partThickness - 1) / VoxelGrid::voxelBrickSideLength) | voxelBrickCoordAlignmentMask;
+			this->generateVoxelBricksInRange(minVoxelBrickCoords, maxVoxelBrickCoords);
+
+			firstVoxelCoordInMemory = 0;
+			remainingThickness -= partThickness;
+		}
+	}
+
+	void WorldGenerator::generateVoxelBricksInRange(const IntegerVector3<UInt32> &pMinVoxelBrickCoords, const IntegerVector3<UInt32> &pMaxVoxelBrickCoords)
+	{
+		VoxelBrickRange &generatedVoxelBrickRange = this->generatedVoxelBrickRanges[this->numberOfGeneratedVoxelBrickRanges++];
+		generatedVoxelBrickRange.minVoxelBrickCoords = pMinVoxelBrickCoords;
+		generatedVoxelBrickRange.maxVoxelBrickCoords = pMaxVoxelBrickCoords;
+
+		// Each work item generates one voxel brick, and with blocks, each work group of 4x4x4 work items also generates the two levels of nodes above its voxel bricks
+		WorldGeneratorKernel *kernel = this->getAreVoxelsGeneratedInBlocks()? this->generateVoxelBlockKernel : this->generateVoxelKernel;
+		kernel->setOffset(this->worldOffset);
+		kernel->setVoxelGridToroidalOffset(this->voxelGridToroidalOffset);
+
+		// Run the kernel. The global IDs are the coords of the voxel bricks in memory, so the global work offset is the coords of the first voxel brick
+		size_t globalWorkOffset[3];
+		globalWorkOffset[0] = static_cast<size_t>(pMinVoxelBrickCoords.x);
+		globalWorkOffset[1] = static_cast<size_t>(pMinVoxelBrickCoords.y);
+		globalWorkOffset[2] = static_cast<size_t>(pMinVoxelBrickCoords.z);
+		size_t globalWorkSize[3];
+		globalWorkSize[0] = static_cast<size_t>(pMaxVoxelBrickCoords.x - pMinVoxelBrickCoords.x + 1);
+		globalWorkSize[1] = static_cast<size_t>(pMaxVoxelBrickCoords.y - pMinVoxelBrickCoords.y + 1);
+		globalWorkSize[2] = static_cast<size_t>(pMaxVoxelBrickCoords.z - pMinVoxelBrickCoords.z + 1);
+		size_t localWorkSize[3];
+		localWorkSize[0] = 4;
+		localWorkSize[1] = 4;
+		localWorkSize[2] = 4;
+		const size_t *localWorkSizePointer = this->getAreVoxelsGeneratedInBlocks()? localWorkSize : NULL;
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->openCLManager->getCommandQueue(), kernel->getKernel(), 3, globalWorkOffset, globalWorkSize, localWorkSizePointer, 0, NULL, this->openCLManager->getProfiler()->getEventForCommand("generateVoxels")));
+	}
+}
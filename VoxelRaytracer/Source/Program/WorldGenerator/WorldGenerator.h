@@ -0,0 +1,208 @@
+#ifndef FORGE_WORLD_GENERATOR_H
+#define FORGE_WORLD_GENERATOR_H
+
+#include <CL/cl.h>
+#include <Forge/Source/Platform/OpenCL/OpenCLManager.h>
+#include <VoxelRaytracer/Source/Program/VoxelGrid.h>
+#include "Kernels/WorldGeneratorKernel.h"
+#include "Kernels/GenerateNodeKernel.h"
+
+namespace forge
+{
+	/// <summary>
+	/// Generates the voxels of a voxel grid and all the nodes of its octree in OpenCL device memory.
+	/// The functions only enqueue kernels. They do not wait for the kernels to finish executing, except that generateWorld waits for the number of voxel data it allocated
+	/// </summary>
+	class WorldGenerator
+	{
+	public:
+
+		// A box of voxel bricks by their coords in memory. The range is inclusive
+		struct VoxelBrickRange
+		{
+			IntegerVector3<UInt32> minVoxelBrickCoords;
+			IntegerVector3<UInt32> maxVoxelBrickCoords;
+		};
+
+		// The voxel data buffer holds the child masks of the octree nodes, the voxel brick buffer holds the voxel bricks and the voxel brick first material index buffer
+		// holds the index of the voxel data of the first non empty voxel of each voxel brick, laid out like the arrays of the voxel grid
+		void startup(OpenCLManager *pOpenCLManager, const VoxelGrid *pVoxelGrid, cl_mem pKernelVoxelDataBuffer, cl_mem pKernelVoxelBrickBuffer, cl_mem pKernelVoxelBrickFirstMaterialIndexBuffer);
+
+		void shutdown();
+
+		// Set the buffers that the voxels and the nodes are generated into. The buffers can be replaced between the generation functions, and nullptr
+		// can be given while no buffers exist, as long as nothing is generated until they are set again. The voxel material buffer belongs with them,
+		// but how much voxel data it must hold is only known once the world is generated, so the world generator creates it, and releases it when nullptr is given
+		void setVoxelBuffers(cl_mem pKernelVoxelDataBuffer, cl_mem pKernelVoxelBrickBuffer, cl_mem pKernelVoxelBrickFirstMaterialIndexBuffer);
+
+		// The voxel data of the non empty voxels, laid out like the voxel material array of the voxel grid. It is created again whenever the world outgrows it,
+		// so it must be got again after each generation function
+		cl_mem getKernelVoxelMaterialBuffer() const;
+
+		// Get how many elements of the voxel material buffer are in use after the last generation function, waiting for the last one to finish if needed.
+		// This is more than the capacity of the buffer if a scroll ran out of room. The voxel bricks that did not fit then have the wrong voxel data until
+		// the next generation function, which generates the whole world again into a larger buffer
+		SizeType getNumberOfAllocatedVoxelMaterials();
+
+		// The number of voxel data that fit in the voxel material buffer
+		SizeType getVoxelMaterialArrayCapacity() const;
+
+		/// <summary>
+		/// Generate the voxel bricks, and then generate all the levels above them from the bottom up. The voxel grid has no toroidal offset afterwards.
+		/// The voxel material buffer is then resized to fit the voxel data with room to spare for scrolling. If the voxel data did not fit in it, the world is generated again
+		/// </summary>
+		/// <param name="pWorldOffset">The offset added to the voxel coordinates before they are passed to the noise function</param>
+		void generateWorld(Float pWorldOffset);
+
+		/// <summary>
+		/// Move the world by a whole number of voxels along every axis, so that the voxel at the remapped coords c is the one that was at (c + pScrollDistance).
+		/// The voxels that stay in the voxel grid are not moved in memory. The toroidal offset moves with them instead, and only the voxel bricks of the voxels
+		/// that come into the voxel grid are generated, followed by the levels of nodes above them. The voxel bricks whose voxel data no longer fits where it was
+		/// leave it behind, so once the voxel material buffer is nearly full, the whole world is generated again instead, which packs the voxel data
+		/// </summary>
+		/// <param name="pScrollDistance">The number of voxels to add to the world offset</param>
+		void scrollWorld(Int32 pScrollDistance);
+
+		// The world offset of the generated voxels
+		Float getWorldOffset() const;
+
+		// The voxel with the remapped coords c is stored at ((c + toroidalOffset) mod sideLength) along each axis, as if the voxel grid wrapped around at its ends.
+		// The octree is built over the voxels where they are stored, so the traversal wraps around as well. Each component is in the range (0, sideLength - 1)
+		const IntegerVector3<Int32>& getVoxelGridToroidalOffset() const;
+
+		/// <summary>
+		/// Generate the voxel bricks, which hold the voxels of the last levels of the octree, and the levels of nodes that are generated together with them.
+		/// The voxel grid has no toroidal offset afterwards. Unlike generateWorld, this does not check whether the voxel data fit in the voxel material buffer
+		/// </summary>
+		/// <param name="pWorldOffset">The offset added to the voxel coordinates before they are passed to the noise function</param>
+		void generateVoxels(Float pWorldOffset);
+
+		// The voxel bricks that the last generation function generated, so that only they need to be copied from the device. When the whole world is generated,
+		// it is a single range that covers the whole voxel grid. The nodes above them are always generated whole
+		SizeType getNumberOfGeneratedVoxelBrickRanges() const;
+
+		const VoxelBrickRange& getGeneratedVoxelBrickRange(SizeType pIndex) const;
+
+		// Get the highest level of the octree that generateVoxels generates. The levels above it must be generated with generateNodes
+		UInt32 getFirstOctreeLevelGeneratedWithVoxels() const;
+
+		/// <summary>
+		/// Generate the nodes at the given level of the octree from their children. The level below it must already be generated
+		/// </summary>
+		/// <param name="pOctreeLevel">The level of the nodes to generate. The root node is at level 0. Must be less than the voxel brick level</param>
+		void generateNodes(UInt32 pOctreeLevel);
+
+		/// <summary>
+		/// Generate the nodes at the given level of the octree and at all the levels above it with a single kernel. The level below it must already be generated
+		/// </summary>
+		/// <param name="pOctreeLevel">The lowest level of the nodes to generate. Must be a top level</param>
+		void generateTopNodeLevels(UInt32 pOctreeLevel);
+
+		// Whether the given level is one of the top levels of the octree, which have too few nodes to be worth a kernel each, so generateWorld generates them
+		// with generateTopNodeLevels. The level just above the voxel bricks is never a top level, since its nodes are generated from the voxel bricks
+		bool getIsTopOctreeLevel(UInt32 pOctreeLevel) const;
+
+	private:
+
+		// The number of levels at the top of the octree that can be top levels. The lowest of them has 4096 nodes
+		static const UInt32 maxNumberOfTopOctreeLevels = 5;
+
+		// A scroll generates a slab along each axis, in at most two parts each
+		static const SizeType maxNumberOfGeneratedVoxelBrickRanges = 6;
+
+		// The number of nodes each work item of generateNodeLevelKernel generates
+		static const size_t numberOfNodesPerWorkItem = 4;
+
+		// The number of work items of the single work group of generateTopNodeLevelsKernel
+		static const size_t topNodeLevelsWorkGroupSize = 64;
+
+		// Whether the voxels are generated in blocks of 4x4x4 voxel bricks together with the two levels of nodes above them. The voxel grid must have at least 4 voxel bricks along each axis
+		bool getAreVoxelsGeneratedInBlocks() const;
+
+		// Generate the nodes at the given level of the octree whose coords are in the given range, which is inclusive
+		void generateNodesInRange(UInt32 pOctreeLevel, const IntegerVector3<UInt32> &pMinNodeCoords, const IntegerVector3<UInt32> &pMaxNodeCoords);
+
+		// Generate all the nodes at the levels above the ones generated together with the voxel bricks, from the bottom up
+		void generateNodeLevelsAboveVoxels();
+
+		// Generate the voxels of a slab of the voxel grid that is perpendicular to the given axis, and the nodes generated together with them. The slab starts at the given remapped coord
+		// along the axis, and is at most as thick as the voxel grid. Whole voxel bricks are generated, or whole blocks of them with blocks, and the slab is split
+		// where it wraps around the end of the memory
+		void generateVoxelSlab(UInt32 pAxis, Int32 pFirstRemappedVoxelCoord, Int32 pThickness);
+
+		// Create the voxel material buffer with room for the given number of voxel data, and copy the given number of voxel data from the start
+		// of the previous one before releasing it
+		void createVoxelMaterialBuffer(SizeType pVoxelMaterialArrayCapacity, SizeType pNumberOfVoxelMaterialsToKeep);
+
+		// Read back the number of voxel data allocated by the generation functions enqueued so far, without waiting for it
+		void readNumberOfAllocatedVoxelMaterials();
+
+		// Generate the voxel bricks whose coords in memory are in the given range, which is inclusive, with the current world offset and toroidal offset.
+		// With blocks, the range must be whole blocks, and the two levels of nodes above the voxel bricks are generated as well
+		void generateVoxelBricksInRange(const IntegerVector3<UInt32> &pMinVoxelBrickCoords, const IntegerVector3<UInt32> &pMaxVoxelBrickCoords);
+
+		OpenCLManager *openCLManager;
+		const VoxelGrid *voxelGrid;
+		cl_mem kernelVoxelDataBuffer;
+		cl_mem kernelVoxelBrickBuffer;
+		cl_mem kernelVoxelBrickFirstMaterialIndexBuffer;
+		cl_mem kernelVoxelMaterialBuffer = nullptr;
+		SizeType voxelMaterialArrayCapacity = 0;
+		cl_mem kernelNumberOfAllocatedVoxelMaterialsBuffer;
+		// The number of allocated voxel data is read back after each generation function, and is only valid once the read back event has completed
+		cl_uint numberOfAllocatedVoxelMaterials = 0;
+		cl_event numberOfAllocatedVoxelMaterialsReadEvent = NULL;
+
+		WorldGeneratorKernel *generateVoxelKernel;
+		WorldGeneratorKernel *generateVoxelBlockKernel;
+		GenerateNodeKernel *generateNodeKernel;
+		GenerateNodeKernel *generateNodeLevelKernel;
+		GenerateNodeKernel *generateTopNodeLevelsKernel;
+		// Generates the nodes just above the voxel brick level
+		GenerateNodeKernel *generateVoxelBrickParentNodeKernel;
+
+		Float worldOffset;
+		IntegerVector3<Int32> voxelGridToroidalOffset;
+
+		VoxelBrickRange generatedVoxelBrickRanges[maxNumberOfGeneratedVoxelBrickRanges];
+		SizeType numberOfGeneratedVoxelBrickRanges = 0;
+	};
+
+	inline
+	cl_mem WorldGenerator::getKernelVoxelMaterialBuffer() const
+	{
+		return this->kernelVoxelMaterialBuffer;
+	}
+
+	inline
+	SizeType WorldGenerator::getVoxelMaterialArrayCapacity() const
+	{
+		return this->voxelMaterialArrayCapacity;
+	}
+
+	inline
+	SizeType WorldGenerator::getNumberOfGeneratedVoxelBrickRanges() const
+	{
+		return this->numberOfGeneratedVoxelBrickRanges;
+	}
+
+	inline
+	const WorldGenerator::VoxelBrickRange& WorldGenerator::getGeneratedVoxelBrickRange(SizeType pIndex) const
+	{
+		return this->generatedVoxelBrickRanges[pIndex];
+	}
+
+	inline
+	Float WorldGenerator::getWorldOffset() const
+	{
+		return this->worldOffset;
+	}
+
+	inline
+	const IntegerVector3<Int32>& WorldGenerator::getVoxelGridToroidalOffset() const
+	{
+		return this->voxelGridToroidalOffset;
+	}
+}
+
+#endif
@@ -0,0 +1,312 @@
+#include "CPURenderer.h"
+#include <cmath>
+#include <cstdio>
+#include <Forge/Source/Core/Math/MathUtility.h>
+#include <Forge/Source/Core/Math/IntersectionTests.h>
+#include <Forge/Source/Core/NumericTypeInfo.h>
+#include <Forge/Source/Core/Random/Hashing/Hashing.h>
+#include <VoxelRaytracer/Source/Program/Program.h>
+#include <VoxelRaytracer/Source/Program/ProgramIntersectionTests.h>
+
+namespace forge
+{
+	void CPURenderer::startup(Program *pProgram)
+	{
+		this->program = pProgram;
+
+		// Create a backbuffer that is has the same resolution as the window
+		this->backbuffer = new Framebuffer();
+		this->backbuffer->startup(pProgram->getWindow()->getResolutionWidth(), pProgram->getWindow()->getResolutionHeight());
+
+		this->generateTextures();
+
+		// Split the backbuffer into tiles. The tiles at the right and top edges may be partially outside the backbuffer
+		this->numberOfTilesAlongXAxis = (this->backbuffer->getWidth() + this->tileSize - 1) / this->tileSize;
+		this->numberOfTilesAlongYAxis = (this->backbuffer->getHeight() + this->tileSize - 1) / this->tileSize;
+		this->numberOfTiles = static_cast<Int32>(this->numberOfTilesAlongXAxis * this->numberOfTilesAlongYAxis);
+
+		// Start one worker thread for every logical processor except one, because the main thread renders tiles as well
+		const UInt32 numberOfLogicalProcessors = max<UInt32>(Thread::getNumberOfLogicalProcessors(), 1);
+		const SizeType numberOfWorkerThreads = static_cast<SizeType>(numberOfLogicalProcessors - 1);
+		this->shouldWorkerThreadsExit = false;
+		this->workerThreadsFinishedSignal = new Signal(false);
+		this->workerThreadStartSignals.setNumberOfElements(numberOfWorkerThreads);
+		this->workerThreads.setNumberOfElements(numberOfWorkerThreads);
+		for(SizeType i = 0; i < numberOfWorkerThreads; ++i)
+		{
+			this->workerThreadStartSignals[i] = new Signal(false);
+			this->workerThreads[i].start<CPURenderer, SizeType, &CPURenderer::workerThreadEntry>(this, i);
+		}
+
+		FORGE_DEBUG_LOG("CPURenderer is rendering with ", numberOfWorkerThreads + 1, " threads");
+	}
+
+	void CPURenderer::shutdown()
+	{
+		// Wake up the worker threads and wait for them to exit
+		this->shouldWorkerThreadsExit = true;
+		for(SizeType i = 0; i < this->workerThreads.getNumberOfElements(); ++i)
+		{
+			this->workerThreadStartSignals[i]->send();
+		}
+		for(SizeType i = 0; i < this->workerThreads.getNumberOfElements(); ++i)
+		{
+			this->workerThreads[i].waitForExit();
+			delete this->workerThreadStartSignals[i];
+		}
+		delete this->workerThreadsFinishedSignal;
+
+		this->backbuffer->shutdown();
+		delete this->backbuffer;
+	}
+
+	void CPURenderer::render()
+	{
+		// Gather the data that stays the same for every pixel in this frame
+		{
+			const Camera *camera = this->program->getCamera();
+			this->currentFrameData.cameraPosition = camera->coordinateSpace.position;
+			this->currentFrameData.cameraOrientationXAxis = camera->coordinateSpace.orientation.getXAxis();
+			this->currentFrameData.cameraOrientationYAxis = camera->coordinateSpace.orientation.getYAxis();
+			this->currentFrameData.cameraOrientationZAxis = camera->coordinateSpace.orientation.getZAxis();
+			this->currentFrameData.verticalViewExtent = std::tan(convertDegreesToRadians(camera->getVerticalFieldOfViewInDegrees() / 2.0f));
+			this->currentFrameData.horizontalViewExtent = this->currentFrameData.verticalViewExtent * static_cast<Float>(this->backbuffer->getWidth()) / static_cast<Float>(this->backbuffer->getHeight());
+			this->currentFrameData.isOctreeVisualizationEnabled = this->program->getIsVoxelOctreeVisualizationEnabled();
+			this->currentFrameData.voxelGridToroidalOffset = this->program->getWorldGenerator()->getVoxelGridToroidalOffset();
+
+			DynamicArray<DebugAABBData> debugAABBs;
+			this->program->getCurrentRenderingData(debugAABBs);
+			this->currentFrameData.debugAABBs.setNumberOfElements(debugAABBs.getNumberOfElements());
+			for(SizeType i = 0; i < debugAABBs.getNumberOfElements(); ++i)
+			{
+				this->currentFrameData.debugAABBs[i] = debugAABBs[i];
+			}
+		}
+
+		// Render all the tiles using the worker threads and this thread
+		{
+			Timer renderTimer;
+
+			this->nextTileIndex.set(0);
+			this->numberOfBusyWorkerThreads.set(static_cast<Int32>(this->workerThreads.getNumberOfElements()));
+			for(SizeType i = 0; i < this->workerThreads.getNumberOfElements(); ++i)
+			{
+				this->workerThreadStartSignals[i]->send();
+			}
+
+			this->renderTiles();
+
+			if(this->workerThreads.getNumberOfElements() > 0)
+			{
+				this->workerThreadsFinishedSignal->wait();
+			}
+
+			// Calculate the rendering speed of a single thread, so that it can be compared across systems with different numbers of logical processors
+			const Int64 renderTimeInMicroseconds = max<Int64>(renderTimer.getTimePassed(), 1);
+			const Double numberOfRays = static_cast<Double>(this->backbuffer->getWidth()) * static_cast<Double>(this->backbuffer->getHeight());
+			const Double numberOfThreads = static_cast<Double>(this->workerThreads.getNumberOfElements() + 1);
+			this->megaRaysPerSecondPerThread = numberOfRays / static_cast<Double>(renderTimeInMicroseconds) / numberOfThreads;
+		}
+
+		// Render the framerate and the rendering speed text
+		{
+			char framesPerSecondText[256] = "0";
+			Int numberOfCharactersInString = snprintf(framesPerSecondText, sizeof(framesPerSecondText), "FPS : %lld", this->program->getFPSCounter()->getCurrentFPS());
+			this->backbuffer->tempDrawText(0, 0, framesPerSecondText, numberOfCharactersInString);
+
+			char raysPerSecondText[256] = "0";
+			numberOfCharactersInString = snprintf(raysPerSecondText, sizeof(raysPerSecondText), "Mrays/s per thread : %.3f (%zu threads)", this->megaRaysPerSecondPerThread, this->workerThreads.getNumberOfElements() + 1);
+			this->backbuffer->tempDrawText(0, 50, raysPerSecondText, numberOfCharactersInString);
+		}
+
+		this->program->getWindow()->blitFramebufferToScreen(*this->backbuffer);
+	}
+
+	void CPURenderer::generateTextures()
+	{
+		// NOTE: This must produce the same texels as the dirtTextureKernel in ForgeData/OpenCL/Kernels/DirtTexture.cl
+		this->dirtTextureTexels.setNumberOfElements(this->textureSize * this->textureSize);
+		for(SizeType x = 0; x < this->textureSize; ++x)
+		{
+			for(SizeType y = 0; y < this->textureSize; ++y)
+			{
+				const Float hashValue = hash2DGrid(static_cast<Int32>(x), static_cast<Int32>(y));
+				this->dirtTextureTexels[x * this->textureSize + y] = Vector3(0.0f, 1.0f, 0.0f) * (0.2f + (0.4f - 0.2f) * hashValue);
+			}
+		}
+	}
+
+	void CPURenderer::workerThreadEntry(SizeType pWorkerThreadIndex)
+	{
+		while(true)
+		{
+			this->workerThreadStartSignals[pWorkerThreadIndex]->wait();
+
+			if(this->shouldWorkerThreadsExit)
+			{
+				break;
+			}
+
+			this->renderTiles();
+
+			// The last worker thread to finish lets the main thread know that the frame is complete
+			if(this->numberOfBusyWorkerThreads.decrement() == 0)
+			{
+				this->workerThreadsFinishedSignal->send();
+			}
+		}
+	}
+
+	void CPURenderer::renderTiles()
+	{
+		while(true)
+		{
+			const Int32 tileIndex = this->nextTileIndex.fetchAndAdd(1);
+			if(tileIndex >= this->numberOfTiles)
+			{
+				break;
+			}
+
+			this->renderTile(static_cast<SizeType>(tileIndex));
+		}
+	}
+
+	void CPURenderer::renderTile(SizeType pTileIndex)
+	{
+		const Int tileMinXCoord = static_cast<Int>(pTileIndex % this->numberOfTilesAlongXAxis) * this->tileSize;
+		const Int tileMinYCoord = static_cast<Int>(pTileIndex / this->numberOfTilesAlongXAxis) * this->tileSize;
+		const Int tileMaxXCoord = min<Int>(tileMinXCoord + this->tileSize, this->backbuffer->getWidth());
+		const Int tileMaxYCoord = min<Int>(tileMinYCoord + this->tileSize, this->backbuffer->getHeight());
+
+		UInt8 *pixelsMemory = this->backbuffer->getPixelsMemoryPointer();
+		const Float gammaCorrectionExponent = 1.0f / 2.2f;
+
+		for(Int y = tileMinYCoord; y < tileMaxYCoord; ++y)
+		{
+			for(Int x = tileMinXCoord; x < tileMaxXCoord; ++x)
+			{
+				Vector3 pixelColor = this->calculatePixelColor(x, y);
+
+				// Apply gamma correction
+				for(SizeType i = 0; i < 3; ++i)
+				{
+					pixelColor[i] = std::pow(pixelColor[i], gammaCorrectionExponent);
+				}
+
+				// NOTE: Red and Blue are flipped here because the backbuffer is a Windows framebuffer
+				UInt8 *pixel = pixelsMemory + (static_cast<SizeType>(this->backbuffer->getWidth()) * y + x) * 4;
+				pixel[0] = static_cast<UInt8>(255.0f * pixelColor.z);
+				pixel[1] = static_cast<UInt8>(255.0f * pixelColor.y);
+				pixel[2] = static_cast<UInt8>(255.0f * pixelColor.x);
+				pixel[3] = 0;
+			}
+		}
+	}
+
+	Ray CPURenderer::getCameraRayForPixel(Int pXCoord, Int pYCoord) const
+	{
+		// Calculate the direction of the ray in camera space
+		const Float xParam = static_cast<Float>(pXCoord) / static_cast<Float>(this->backbuffer->getWidth() - 1);
+		const Float yParam = static_cast<Float>(pYCoord) / static_cast<Float>(this->backbuffer->getHeight() - 1);
+		const Float xDirection = -this->currentFrameData.horizontalViewExtent + 2.0f * this->currentFrameData.horizontalViewExtent * xParam;
+		const Float yDirection = -this->currentFrameData.verticalViewExtent + 2.0f * this->currentFrameData.verticalViewExtent * yParam;
+
+		// Convert the direction to world space
+		Vector3 direction = this->currentFrameData.cameraOrientationXAxis * xDirection +
+							this->currentFrameData.cameraOrientationYAxis * yDirection +
+							this->currentFrameData.cameraOrientationZAxis;
+		direction.normalize();
+
+		return Ray(this->currentFrameData.cameraPosition, direction, NumericTypeInfo<Float>::maxValue());
+	}
+
+	Vector3 CPURenderer::calculatePixelColor(Int pXCoord, Int pYCoord) const
+	{
+		const Ray cameraRayForPixel = this->getCameraRayForPixel(pXCoord, pYCoord);
+
+		for(SizeType i = 0; i < this->currentFrameData.debugAABBs.getNumberOfElements(); ++i)
+		{
+			RayAndAABBIntersectionData rayAndDebugAABBIntersectionData;
+			if(rayAndAABBIntersectionTest(cameraRayForPixel, this->currentFrameData.debugAABBs[i].aabb, rayAndDebugAABBIntersectionData))
+			{
+				Int numberOfCoordinatesInBorderRange = 0;
+				const Vector3 rayHitPoint = cameraRayForPixel.getOrigin() + cameraRayForPixel.getDirection() * rayAndDebugAABBIntersectionData.distance;
+				for(SizeType i2 = 0; i2 < 3; ++i2)
+				{
+					const Float rayHitPointFractionalPart = rayHitPoint[i2] - floorFloat(rayHitPoint[i2]);
+					if(rayHitPointFractionalPart > 0.4f && rayHitPointFractionalPart < 0.6f)
+					{
+						++numberOfCoordinatesInBorderRange;
+					}
+				}
+
+				// The fractional part of one of the coordinates of the intersection point will be 0.5f, because of the the way the voxels are placed in the world.
+				// So at least one of the other coordinates must be in the border range for the intersection point to be a part of a voxel's border
+				if(numberOfCoordinatesInBorderRange > 1)
+				{
+					// Give the pixel the debug AABB color
+					return this->currentFrameData.debugAABBs[i].color.getRGBVector3();
+				}
+			}
+		}
+
+		RayHitData rayHitData;
+		if(this->traceRay(cameraRayForPixel, rayHitData))
+		{
+			return rayHitData.color;
+		}
+		else
+		{
+			return this->getBackgroundColorForRay(cameraRayForPixel);
+		}
+	}
+
+	bool CPURenderer::traceRay(const Ray &pRay, RayHitData &pRayHitData) const
+	{
+		RayAndVoxelOctreeIntersectionData rayAndVoxelOctreeIntersectionData;
+		if(!rayAndVoxelOctreeIntersectionTest(pRay, *this->program->getVoxelGrid(), this->currentFrameData.voxelGridToroidalOffset, this->currentFrameData.isOctreeVisualizationEnabled, rayAndVoxelOctreeIntersectionData))
+		{
+			return false;
+		}
+
+		// The number of coordinates in the intersection point that have values that make them potentially part of a voxel's border
+		Int numberOfCoordinatesInBorderRange = 0;
+		for(SizeType i = 0; i < 3; ++i)
+		{
+			const Float rayHitPointFractionalPart = rayAndVoxelOctreeIntersectionData.point[i] - floorFloat(rayAndVoxelOctreeIntersectionData.point[i]);
+			if(rayHitPointFractionalPart > 0.4f && rayHitPointFractionalPart < 0.6f)
+			{
+				++numberOfCoordinatesInBorderRange;
+			}
+		}
+
+		// The fractional part of one of the coordinates of the intersection point will be 0.5f, because of the the way the voxels are placed in the world.
+		// So at least one of the other coordinates must be in the border range for the intersection point to be a part of a voxel's border
+		if(numberOfCoordinatesInBorderRange > 1)
+		{
+			pRayHitData.color = Vector3(0.0f, 0.0f, 0.0f);
+		}
+		else
+		{
+			// Calculate the texel coordinates from the uv coordinates
+			const SizeType texelXCoord = clamp<Int>(floorFloatToInteger<Int>(rayAndVoxelOctreeIntersectionData.uCoord * 15.0f), 0, 15);
+			const SizeType texelYCoord = clamp<Int>(floorFloatToInteger<Int>(rayAndVoxelOctreeIntersectionData.vCoord * 15.0f), 0, 15);
+			pRayHitData.color = this->dirtTextureTexels[texelXCoord * this->textureSize + texelYCoord];
+		}
+
+		pRayHitData.point = rayAndVoxelOctreeIntersectionData.point;
+		pRayHitData.normal = rayAndVoxelOctreeIntersectionData.normal;
+		return true;
+	}
+
+	Vector3 CPURenderer::getBackgroundColorForRay(const Ray &pRay) const
+	{
+		const Vector3 horizonColor(170.0f / 255.0f, 209.0f / 255.0f, 254.0f / 255.0f);
+		const Vector3 skyColor(120.0f / 255.0f, 167.0f / 255.0f, 255.0f / 255.0f);
+
+		const Float oneMinusAbsoluteYDirection = 1.0f - abs<Float>(pRay.getDirection().y);
+		const Float mixParam = 1.0f - oneMinusAbsoluteYDirection * oneMinusAbsoluteYDirection;
+
+		return horizonColor + (skyColor - horizonColor) * mixParam;
+	}
+}
@@ -0,0 +1,110 @@
+#ifndef FORGE_CPU_RENDERER_H
+#define FORGE_CPU_RENDERER_H
+
+#include <Forge/Source/Platform/Windows/Framebuffer.h>
+#include <Forge/Source/Platform/Windows/Timer.h>
+#include <Forge/Source/Core/Containers/ResizableArray.h>
+#include <Forge/Source/Core/Containers/DynamicArray.h>
+#include <Forge/Source/Core/Math/Vector3.h>
+#include <Forge/Source/Core/Math/IntegerVector3.h>
+#include <Forge/Source/Core/Math/Ray.h>
+#include <Forge/Source/Platform/Windows/Threading/Thread.h>
+#include <Forge/Source/Platform/Windows/Threading/Signal.h>
+#include <Forge/Source/Platform/Windows/Threading/AtomicInteger.h>
+#include <VoxelRaytracer/Source/Rendering/Renderer.h>
+#include <VoxelRaytracer/Source/Rendering/DebugAABBData.h>
+
+namespace forge
+{
+	class Program;
+
+	/// <summary>
+	/// Renders the voxel grid on the CPU. This is used when the system does not have a GPU.
+	/// It produces the same image as the renderPixel kernel in ForgeData/OpenCL/Kernels/Renderer.cl.
+	/// The backbuffer is split into square tiles. The tiles are handed out one at a time to a pool of worker threads and the main thread,
+	/// so that all the logical processors in the system are used to render a frame
+	/// </summary>
+	class CPURenderer : public Renderer
+	{
+	public:
+
+		void startup(Program *pProgram);
+
+		void shutdown() override;
+
+		void render() override;
+
+	private:
+
+		// The data that stays the same for every pixel in a frame
+		struct FrameData
+		{
+			Vector3 cameraPosition;
+			Vector3 cameraOrientationXAxis;
+			Vector3 cameraOrientationYAxis;
+			Vector3 cameraOrientationZAxis;
+			Float verticalViewExtent;
+			Float horizontalViewExtent;
+			bool isOctreeVisualizationEnabled;
+			// The voxel with the remapped coords c is stored at ((c + voxelGridToroidalOffset) mod sideLength) in the voxel grid while the world scrolls
+			IntegerVector3<Int32> voxelGridToroidalOffset;
+			ResizableArray<DebugAABBData> debugAABBs;
+		};
+
+		struct RayHitData
+		{
+			Vector3 color;
+			Vector3 point;
+			Vector3 normal;
+		};
+
+		void generateTextures();
+
+		void workerThreadEntry(SizeType pWorkerThreadIndex);
+
+		// Keep taking tiles and rendering them until there are no tiles left in the current frame
+		void renderTiles();
+
+		void renderTile(SizeType pTileIndex);
+
+		Ray getCameraRayForPixel(Int pXCoord, Int pYCoord) const;
+
+		Vector3 calculatePixelColor(Int pXCoord, Int pYCoord) const;
+
+		bool traceRay(const Ray &pRay, RayHitData &pRayHitData) const;
+
+		Vector3 getBackgroundColorForRay(const Ray &pRay) const;
+
+		Program *program;
+		Framebuffer *backbuffer = nullptr;
+
+		// The texels of the dirt texture. The texel with the coordinates (x, y) is at the index (x * textureSize + y)
+		const SizeType textureSize = 16;
+		ResizableArray<Vector3> dirtTextureTexels;
+
+		// The width and height in pixels of a tile
+		const Int tileSize = 16;
+		Int numberOfTilesAlongXAxis;
+		Int numberOfTilesAlongYAxis;
+		Int32 numberOfTiles;
+
+		FrameData currentFrameData;
+
+		// The index of the next tile that needs to be rendered in the current frame
+		AtomicInteger nextTileIndex;
+		// The number of worker threads that have not finished rendering tiles in the current frame
+		AtomicInteger numberOfBusyWorkerThreads;
+
+		ResizableArray<Thread> workerThreads;
+		// Each worker thread waits on its own signal to start rendering tiles for a frame
+		ResizableArray<Signal*> workerThreadStartSignals;
+		// Sent by the last worker thread to finish rendering tiles in a frame
+		Signal *workerThreadsFinishedSignal = nullptr;
+		bool shouldWorkerThreadsExit = false;
+
+		// The number of rays cast per second in the last frame divided by the number of threads that rendered it
+		Double megaRaysPerSecondPerThread = 0.0;
+	};
+}
+
+#endif
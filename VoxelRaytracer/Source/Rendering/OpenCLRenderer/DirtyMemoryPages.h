@@ -0,0 +1,181 @@
+#ifndef FORGE_DIRTY_MEMORY_PAGES_H
+#define FORGE_DIRTY_MEMORY_PAGES_H
+
+#include <CL/cl.h>
+#include <Forge/Source/Core/Forge.h>
+#include <Forge/Source/Core/Containers/ResizableArray.h>
+#include <Forge/Source/Core/Math/MathUtility.h>
+#include <Forge/Source/Platform/OpenCL/OpenCLUtility.h>
+
+namespace forge
+{
+	// Keeps track of the pages of a block of host memory that were changed since it was last uploaded to a buffer in device memory,
+	// so that only the changed pages need to be uploaded. It also works the other way around, for the pages that were changed in the buffer
+	class DirtyMemoryPages
+	{
+	public:
+
+		// The size in bytes of a page. Small edits upload at least this much memory, and each run of consecutive dirty pages is uploaded with a single write
+		static const SizeType pageSize = 4096;
+
+		// Sets the size in bytes of the memory. All the pages are clean afterwards
+		void setMemorySize(SizeType pMemorySize);
+
+		SizeType getMemorySize() const;
+
+		// Marks the pages that overlap the given range of bytes as dirty. The bytes past the end of the memory are ignored
+		void markBytesAsDirty(SizeType pFirstByteIndex, SizeType pNumberOfBytes);
+
+		bool getAreAnyPagesDirty() const;
+
+		// Used when the buffer is brought up to date in some other way
+		void markAllPagesAsClean();
+
+		// Enqueues non-blocking writes of the runs of consecutive dirty pages from the host memory into the buffer, and then marks all the pages as clean.
+		// The host memory is only read once the writes are executed, so changes to it in the meantime may be uploaded as well. Those changes mark their pages
+		// as dirty again, so they are uploaded once more with the next call, and the buffer never ends up with stale data
+		void uploadDirtyPages(cl_command_queue pCommandQueue, cl_mem pBuffer, const void *pHostMemory);
+
+		// Enqueues non-blocking reads of the runs of consecutive dirty pages from the buffer into the host memory, and then marks all the pages as clean.
+		// The host memory must be up to date outside of the dirty pages, since the rest of each dirty page is read as well
+		void downloadDirtyPages(cl_command_queue pCommandQueue, cl_mem pBuffer, void *pHostMemory);
+
+	private:
+
+		void transferDirtyPages(cl_command_queue pCommandQueue, cl_mem pBuffer, void *pHostMemory, bool pIsDownload);
+
+		SizeType memorySize = 0;
+		ResizableArray<bool> isPageDirtyArray;
+		// The range of pages that may contain dirty pages, so that the pages outside of it need not be checked. The range is empty if no page is dirty
+		SizeType firstDirtyPageIndex = 0;
+		SizeType endDirtyPageIndex = 0;
+	};
+
+	inline
+	void DirtyMemoryPages::setMemorySize(SizeType pMemorySize)
+	{
+		this->memorySize = pMemorySize;
+		this->isPageDirtyArray.setNumberOfElements(0);
+		this->isPageDirtyArray.setNumberOfElements((pMemorySize + pageSize - 1) / pageSize);
+		this->firstDirtyPageIndex = 0;
+		this->endDirtyPageIndex = 0;
+	}
+
+	inline
+	SizeType DirtyMemoryPages::getMemorySize() const
+	{
+		return this->memorySize;
+	}
+
+	inline
+	void DirtyMemoryPages::markBytesAsDirty(SizeType pFirstByteIndex, SizeType pNumberOfBytes)
+	{
+		if(pNumberOfBytes == 0 || pFirstByteIndex >= this->memorySize)
+		{
+			return;
+		}
+
+		const SizeType firstPageIndex = pFirstByteIndex / pageSize;
+		const SizeType endPageIndex = (min(pFirstByteIndex + pNumberOfBytes, this->memorySize) - 1) / pageSize + 1;
+		for(SizeType i = firstPageIndex; i < endPageIndex; ++i)
+		{
+			this->isPageDirtyArray[i] = true;
+		}
+
+		if(this->getAreAnyPagesDirty())
+		{
+			this->firstDirtyPageIndex = min(this->firstDirtyPageIndex, firstPageIndex);
+			this->endDirtyPageIndex = max(this->endDirtyPageIndex, endPageIndex);
+		}
+		else
+		{
+			this->firstDirtyPageIndex = firstPageIndex;
+			this->endDirtyPageIndex = endPageIndex;
+		}
+	}
+
+	inline
+	bool DirtyMemoryPages::getAreAnyPagesDirty() const
+	{
+		return this->firstDirtyPageIndex < this->endDirtyPageIndex;
+	}
+
+	inline
+	void DirtyMemoryPages::markAllPagesAsClean()
+	{
+		for(SizeType i = this->firstDirtyPageIndex; i < this->endDirtyPageIndex; ++i)
+		{
+			this->isPageDirtyArray[i] = false;
+		}
+		this->firstDirtyPageIndex = 0;
+		this->endDirtyPageIndex = 0;
+	}
+
+	inline
+	void DirtyMemoryPages::uploadDirtyPages(cl_command_queue pCommandQueue, cl_mem pBuffer, const void *pHostMemory)
+	{
+		// The host memory is only read from when uploading
+		this->transferDirtyPages(pCommandQueue, pBuffer, const_cast<void*>(pHostMemory), false);
+	}
+
+	inline
+	void DirtyMemoryPages::downloadDirtyPages(cl_command_queue pCommandQueue, cl_mem pBuffer, void *pHostMemory)
+	{
+		this->transferDirtyPages(pCommandQueue, pBuffer, pHostMemory, true);
+	}
+
+	inline
+	void DirtyMemoryPages::transferDirtyPages(cl_command_queue pCommandQueue, cl_mem pBuffer, void *pHostMemory, bool pIsDownload)
+	{
+		SizeType pageIndex = this->firstDirtyPageIndex;
+		while(pageIndex < this->endDirtyPageIndex)
+		{
+			if(!this->isPageDirtyArray[pageIndex])
+			{
+				++pageIndex;
+				continue;
+			}
+
+			// Find the end of the run of dirty pages, and mark them as clean
+			const SizeType firstPageIndexInRun = pageIndex;
+			while(pageIndex < this->endDirtyPageIndex && this->isPageDirtyArray[pageIndex])
+			{
+				this->isPageDirtyArray[pageIndex] = false;
+				++pageIndex;
+			}
+
+			// The last page may be cut off by the end of the memory
+			const SizeType firstByteIndex = firstPageIndexInRun * pageSize;
+			const SizeType numberOfBytes = min(pageIndex * pageSize, this->memorySize) - firstByteIndex;
+			if(pIsDownload)
+			{
+				FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(pCommandQueue,
+																  pBuffer,
+																  CL_NON_BLOCKING,
+																  firstByteIndex,
+																  numberOfBytes,
+																  static_cast<UInt8*>(pHostMemory) + firstByteIndex,
+																  0,
+																  NULL,
+																  NULL));
+			}
+			else
+			{
+				FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueWriteBuffer(pCommandQueue,
+																   pBuffer,
+																   CL_NON_BLOCKING,
+																   firstByteIndex,
+																   numberOfBytes,
+																   static_cast<const UInt8*>(pHostMemory) + firstByteIndex,
+																   0,
+																   NULL,
+																   NULL));
+			}
+		}
+
+		this->firstDirtyPageIndex = 0;
+		this->endDirtyPageIndex = 0;
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,171 @@
+#ifndef FORGE_RECONSTRUCT_CHECKERBOARD_KERNEL_H
+#define FORGE_RECONSTRUCT_CHECKERBOARD_KERNEL_H
+
+#include <Forge/Source/Platform/OpenCL/OpenCLKernel.h>
+
+namespace forge
+{
+	// Fills in the pixels that the RenderPixelKernel did not render in checkerboard rendering, from the previous frame and from the pixels around them.
+	// The global work size along the first dimension is half of the image width, rounded up, and along the second dimension it is the image height
+	class ReconstructCheckerboardKernel : public OpenCLKernel
+	{
+	public:
+
+		ReconstructCheckerboardKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName);
+
+		void setPreviousCameraPosition(const Vector3 &pPreviousCameraPosition);
+
+		void setPreviousCameraOrientationXAxis(const Vector3 &pPreviousCameraOrientationXAxis);
+
+		void setPreviousCameraOrientationYAxis(const Vector3 &pPreviousCameraOrientationYAxis);
+
+		void setPreviousCameraOrientationZAxis(const Vector3 &pPreviousCameraOrientationZAxis);
+
+		void setPreviousCameraVerticalFieldOfViewInDegrees(Float pPreviousCameraVerticalFieldOfViewInDegrees);
+
+		void setCameraPosition(const Vector3 &pCameraPosition);
+
+		void setCameraOrientationXAxis(const Vector3 &pCameraOrientationXAxis);
+
+		void setCameraOrientationYAxis(const Vector3 &pCameraOrientationYAxis);
+
+		void setCameraOrientationZAxis(const Vector3 &pCameraOrientationZAxis);
+
+		void setCameraVerticalFieldOfViewInDegrees(Float pCameraVerticalFieldOfViewInDegrees);
+
+		void setOutputImageResolution(Int32 pOutputImageWidth, Int32 pOutputImageHeight);
+
+		// The parity of the pixels that the RenderPixelKernel rendered in this frame, which is 0 or 1
+		void setCheckerboardParity(Int32 pCheckerboardParity);
+
+		// The previous frame is only used if it was rendered at the same resolution, and the voxels have not moved since then
+		void setIsPreviousFrameValid(bool pIsPreviousFrameValid);
+
+		void setKernelPreviousUInt8Framebuffer(cl_mem pKernelPreviousUInt8Framebuffer);
+
+		void setKernelPreviousDepthBuffer(cl_mem pKernelPreviousDepthBuffer);
+
+		// The framebuffer and the depth buffer that the RenderPixelKernel wrote in this frame, which are completed by this kernel
+		void setOutputUInt8Framebuffer(cl_mem pOutputUInt8Framebuffer);
+
+		void setOutputDepthBuffer(cl_mem pOutputDepthBuffer);
+	};
+
+	inline
+	ReconstructCheckerboardKernel::ReconstructCheckerboardKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName) :
+	OpenCLKernel(pOpenCLManager, pTextFileEditor, pKernelName)
+	{
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setPreviousCameraPosition(const Vector3 &pPreviousCameraPosition)
+	{
+		this->setFloat3(0, pPreviousCameraPosition);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setPreviousCameraOrientationXAxis(const Vector3 &pPreviousCameraOrientationXAxis)
+	{
+		this->setFloat3(1, pPreviousCameraOrientationXAxis);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setPreviousCameraOrientationYAxis(const Vector3 &pPreviousCameraOrientationYAxis)
+	{
+		this->setFloat3(2, pPreviousCameraOrientationYAxis);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setPreviousCameraOrientationZAxis(const Vector3 &pPreviousCameraOrientationZAxis)
+	{
+		this->setFloat3(3, pPreviousCameraOrientationZAxis);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setPreviousCameraVerticalFieldOfViewInDegrees(Float pPreviousCameraVerticalFieldOfViewInDegrees)
+	{
+		this->setFloat(4, pPreviousCameraVerticalFieldOfViewInDegrees);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setCameraPosition(const Vector3 &pCameraPosition)
+	{
+		this->setFloat3(5, pCameraPosition);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setCameraOrientationXAxis(const Vector3 &pCameraOrientationXAxis)
+	{
+		this->setFloat3(6, pCameraOrientationXAxis);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setCameraOrientationYAxis(const Vector3 &pCameraOrientationYAxis)
+	{
+		this->setFloat3(7, pCameraOrientationYAxis);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setCameraOrientationZAxis(const Vector3 &pCameraOrientationZAxis)
+	{
+		this->setFloat3(8, pCameraOrientationZAxis);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setCameraVerticalFieldOfViewInDegrees(Float pCameraVerticalFieldOfViewInDegrees)
+	{
+		this->setFloat(9, pCameraVerticalFieldOfViewInDegrees);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setOutputImageResolution(Int32 pOutputImageWidth, Int32 pOutputImageHeight)
+	{
+		this->setInt(10, pOutputImageWidth);
+		this->setInt(11, pOutputImageHeight);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setCheckerboardParity(Int32 pCheckerboardParity)
+	{
+		this->setInt(12, pCheckerboardParity);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setIsPreviousFrameValid(bool pIsPreviousFrameValid)
+	{
+		if(pIsPreviousFrameValid)
+		{
+			this->setInt(13, 1);
+		}
+		else
+		{
+			this->setInt(13, 0);
+		}
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setKernelPreviousUInt8Framebuffer(cl_mem pKernelPreviousUInt8Framebuffer)
+	{
+		this->setBuffer(14, pKernelPreviousUInt8Framebuffer);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setKernelPreviousDepthBuffer(cl_mem pKernelPreviousDepthBuffer)
+	{
+		this->setBuffer(15, pKernelPreviousDepthBuffer);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setOutputUInt8Framebuffer(cl_mem pOutputUInt8Framebuffer)
+	{
+		this->setBuffer(16, pOutputUInt8Framebuffer);
+	}
+
+	inline
+	void ReconstructCheckerboardKernel::setOutputDepthBuffer(cl_mem pOutputDepthBuffer)
+	{
+		this->setBuffer(17, pOutputDepthBuffer);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -9,7 +9,20 @@ namespace forge
 	{
 	public:
 
-		RenderPixelKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName);
+		// The side length of the square batches of work item coords that the work groups take when persistent threads are used.
+		// The local work size must be the number of work item coords in a batch then.
+		// NOTE: This must match FORGE_RAY_BATCH_SIDE_LENGTH in ForgeData/OpenCL/Kernels/Renderer.cl
+		static const SizeType rayBatchSideLength = 8;
+
+		// The number of work groups that are dispatched with persistent threads for each compute unit of the device. More work groups than one per compute unit
+		// are needed to hide the latency of the memory reads, and the ones that do not fit on a compute unit at once only start once the others have taken every batch
+		static const SizeType numberOfPersistentWorkGroupsPerComputeUnit = 16;
+
+		// The number of batches of work item coords that cover an image of the given resolution. In checkerboard rendering, the work item coords only cover half of the image width
+		static SizeType getNumberOfRayBatches(Int32 pOutputImageWidth, Int32 pOutputImageHeight, bool pIsCheckerboardRenderingUsed);
+
+		// If the build options define FORGE_SPARSE_VOXEL_OCTREE, the kernel reads the voxels from a sparse voxel octree
+		RenderPixelKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName, const char *pBuildOptions = nullptr);
 
 		void setCameraPosition(const Vector3 &pCameraPosition);
 
@@ -34,14 +47,59 @@ namespace forge
 		void setIsOctreeVisualizationEnabled(bool pIsOctreeVisualizationEnabled);
 
 		void setOutputUInt8Framebuffer(cl_mem pOutputUInt8Framebuffer);
+
+		// The voxel bricks of the voxel octree whose nodes are set with setKernelVoxelArrayBuffer
+		void setKernelVoxelBrickArrayBuffer(cl_mem pKernelVoxelBrickArrayBuffer);
+
+		// The voxel data of the voxels in the voxel bricks
+		void setKernelVoxelMaterialArrayBuffer(cl_mem pKernelVoxelMaterialArrayBuffer);
+
+		// The distances at which the camera rays of the tiles start, which are written by the TraceBeamKernel
+		void setKernelBeamDistancesBuffer(cl_mem pKernelBeamDistancesBuffer);
+
+		// One float for every pixel, which is the distance along the camera ray of the pixel at which it hits a voxel
+		void setOutputDepthBuffer(cl_mem pOutputDepthBuffer);
+
+		// The resolution of the image, in pixels. The global work size is the resolution of the image, unless checkerboard rendering is used
+		void setOutputImageResolution(Int32 pOutputImageWidth, Int32 pOutputImageHeight);
+
+		// In checkerboard rendering, only the pixels with the given parity, which is 0 or 1, are rendered, and the global work size along the first dimension
+		// is half of the image width, rounded up. A parity of -1 renders all the pixels
+		void setCheckerboardParity(Int32 pCheckerboardParity);
+
+		// With persistent threads, a fixed number of work groups is dispatched along the first dimension, and they take batches of work item coords until all of them are rendered
+		void setIsPersistentThreadsEnabled(bool pIsPersistentThreadsEnabled);
+
+		// One uint that counts the batches of work item coords that have been taken with persistent threads. It must be cleared to 0 before every dispatch
+		void setKernelNextRayBatchIndexBuffer(cl_mem pKernelNextRayBatchIndexBuffer);
+
+		// One cl_uint2 for every pixel, holding the number of traversal steps of its camera ray and the index of the lane that rendered it.
+		// It is only written if the build options define FORGE_MEASURE_LANE_UTILISATION
+		void setOutputLaneStatisticsBuffer(cl_mem pOutputLaneStatisticsBuffer);
+
+		// In the tiled pixel order, the work items render the batches of work item coords one after another, and the work item coords of a batch in Z-order.
+		// Without persistent threads, the work items are dispatched along the first dimension then, with rayBatchSideLength x rayBatchSideLength work items for every batch
+		void setIsTiledPixelOrderEnabled(bool pIsTiledPixelOrderEnabled);
+
+		// The voxel with the remapped coords c is stored at ((c + toroidalOffset) mod voxelGridSideLength) along each axis. It must be 0 for the sparse voxel octree
+		void setVoxelGridToroidalOffset(const IntegerVector3<Int32> &pVoxelGridToroidalOffset);
+
+		void setKernelVoxelBrickFirstMaterialIndexArrayBuffer(cl_mem pKernelVoxelBrickFirstMaterialIndexArrayBuffer);
 	};
 
 	inline
-	RenderPixelKernel::RenderPixelKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName) :
-	OpenCLKernel(pOpenCLManager, pTextFileEditor, pKernelName)
+	RenderPixelKernel::RenderPixelKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName, const char *pBuildOptions) :
+	OpenCLKernel(pOpenCLManager, pTextFileEditor, pKernelName, pBuildOptions)
 	{
 	}
 
+	inline
+	SizeType RenderPixelKernel::getNumberOfRayBatches(Int32 pOutputImageWidth, Int32 pOutputImageHeight, bool pIsCheckerboardRenderingUsed)
+	{
+		const SizeType workItemGridWidth = pIsCheckerboardRenderingUsed? (static_cast<SizeType>(pOutputImageWidth) + 1) / 2 : static_cast<SizeType>(pOutputImageWidth);
+		return ((workItemGridWidth + rayBatchSideLength - 1) / rayBatchSideLength) * ((static_cast<SizeType>(pOutputImageHeight) + rayBatchSideLength - 1) / rayBatchSideLength);
+	}
+
 	inline
 	void RenderPixelKernel::setCameraPosition(const Vector3 &pCameraPosition)
 	{
@@ -120,6 +178,93 @@ namespace forge
 	{
 		this->setBuffer(11, pOutputUInt8Framebuffer);
 	}
+
+	inline
+	void RenderPixelKernel::setKernelVoxelBrickArrayBuffer(cl_mem pKernelVoxelBrickArrayBuffer)
+	{
+		this->setBuffer(12, pKernelVoxelBrickArrayBuffer);
+	}
+
+	inline
+	void RenderPixelKernel::setKernelVoxelMaterialArrayBuffer(cl_mem pKernelVoxelMaterialArrayBuffer)
+	{
+		this->setBuffer(13, pKernelVoxelMaterialArrayBuffer);
+	}
+
+	inline
+	void RenderPixelKernel::setKernelBeamDistancesBuffer(cl_mem pKernelBeamDistancesBuffer)
+	{
+		this->setBuffer(14, pKernelBeamDistancesBuffer);
+	}
+
+	inline
+	void RenderPixelKernel::setOutputDepthBuffer(cl_mem pOutputDepthBuffer)
+	{
+		this->setBuffer(15, pOutputDepthBuffer);
+	}
+
+	inline
+	void RenderPixelKernel::setOutputImageResolution(Int32 pOutputImageWidth, Int32 pOutputImageHeight)
+	{
+		this->setInt(16, pOutputImageWidth);
+		this->setInt(17, pOutputImageHeight);
+	}
+
+	inline
+	void RenderPixelKernel::setCheckerboardParity(Int32 pCheckerboardParity)
+	{
+		this->setInt(18, pCheckerboardParity);
+	}
+
+	inline
+	void RenderPixelKernel::setIsPersistentThreadsEnabled(bool pIsPersistentThreadsEnabled)
+	{
+		if(pIsPersistentThreadsEnabled)
+		{
+			this->setInt(19, 1);
+		}
+		else
+		{
+			this->setInt(19, 0);
+		}
+	}
+
+	inline
+	void RenderPixelKernel::setKernelNextRayBatchIndexBuffer(cl_mem pKernelNextRayBatchIndexBuffer)
+	{
+		this->setBuffer(20, pKernelNextRayBatchIndexBuffer);
+	}
+
+	inline
+	void RenderPixelKernel::setOutputLaneStatisticsBuffer(cl_mem pOutputLaneStatisticsBuffer)
+	{
+		this->setBuffer(21, pOutputLaneStatisticsBuffer);
+	}
+
+	inline
+	void RenderPixelKernel::setIsTiledPixelOrderEnabled(bool pIsTiledPixelOrderEnabled)
+	{
+		if(pIsTiledPixelOrderEnabled)
+		{
+			this->setInt(22, 1);
+		}
+		else
+		{
+			this->setInt(22, 0);
+		}
+	}
+
+	inline
+	void RenderPixelKernel::setVoxelGridToroidalOffset(const IntegerVector3<Int32> &pVoxelGridToroidalOffset)
+	{
+		this->setInt3(23, pVoxelGridToroidalOffset);
+	}
+
+	inline
+	void RenderPixelKernel::setKernelVoxelBrickFirstMaterialIndexArrayBuffer(cl_mem pKernelVoxelBrickFirstMaterialIndexArrayBuffer)
+	{
+		this->setBuffer(24, pKernelVoxelBrickFirstMaterialIndexArrayBuffer);
+	}
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,152 @@
+#ifndef FORGE_REPROJECT_DEPTH_KERNEL_H
+#define FORGE_REPROJECT_DEPTH_KERNEL_H
+
+#include <cfloat>
+#include <cstring>
+#include <Forge/Source/Platform/OpenCL/OpenCLKernel.h>
+
+namespace forge
+{
+	class ReprojectDepthKernel : public OpenCLKernel
+	{
+	public:
+
+		// The number of 32 bit masks that have one bit for every pixel of a tile of the TraceBeamKernel
+		// NOTE: This must match FORGE_NUMBER_OF_REPROJECTED_DEPTH_TILE_PIXEL_MASKS in ForgeData/OpenCL/Kernels/Renderer.cl
+		static const SizeType numberOfCoveredPixelMasks = 2;
+
+		// The depths of the previous frame that are reprojected into a tile of pixels of the current frame. The global work size is the resolution of the image.
+		// NOTE: This must match the ReprojectedDepthTile struct in ForgeData/OpenCL/Kernels/Renderer.cl
+		struct ReprojectedDepthTile
+		{
+			// The bits of the minimum distance from the camera of the reprojected points, as a non negative float
+			UInt32 minDistance;
+			// The bit of a pixel of the tile, in row order, is set if a point was reprojected into it
+			UInt32 coveredPixelMasks[numberOfCoveredPixelMasks];
+		};
+
+		// Get a tile that no depths have been reprojected into yet. The TraceBeamKernel clears the tiles in the same way after reading them
+		static ReprojectedDepthTile getClearedReprojectedDepthTile();
+
+		ReprojectDepthKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName, const char *pBuildOptions = nullptr);
+
+		void setPreviousCameraPosition(const Vector3 &pPreviousCameraPosition);
+
+		void setPreviousCameraOrientationXAxis(const Vector3 &pPreviousCameraOrientationXAxis);
+
+		void setPreviousCameraOrientationYAxis(const Vector3 &pPreviousCameraOrientationYAxis);
+
+		void setPreviousCameraOrientationZAxis(const Vector3 &pPreviousCameraOrientationZAxis);
+
+		void setPreviousCameraVerticalFieldOfViewInDegrees(Float pPreviousCameraVerticalFieldOfViewInDegrees);
+
+		void setCameraPosition(const Vector3 &pCameraPosition);
+
+		void setCameraOrientationXAxis(const Vector3 &pCameraOrientationXAxis);
+
+		void setCameraOrientationYAxis(const Vector3 &pCameraOrientationYAxis);
+
+		void setCameraOrientationZAxis(const Vector3 &pCameraOrientationZAxis);
+
+		void setCameraVerticalFieldOfViewInDegrees(Float pCameraVerticalFieldOfViewInDegrees);
+
+		// The depth buffer that the RenderPixelKernel wrote in the previous frame
+		void setKernelPreviousDepthBuffer(cl_mem pKernelPreviousDepthBuffer);
+
+		// One ReprojectedDepthTile for every tile of the TraceBeamKernel
+		void setOutputReprojectedDepthTilesBuffer(cl_mem pOutputReprojectedDepthTilesBuffer);
+	};
+
+	inline
+	ReprojectDepthKernel::ReprojectDepthKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName, const char *pBuildOptions) :
+	OpenCLKernel(pOpenCLManager, pTextFileEditor, pKernelName, pBuildOptions)
+	{
+	}
+
+	inline
+	ReprojectDepthKernel::ReprojectedDepthTile ReprojectDepthKernel::getClearedReprojectedDepthTile()
+	{
+		const Float maxDistance = FLT_MAX;
+		ReprojectedDepthTile clearedReprojectedDepthTile;
+		std::memcpy(&clearedReprojectedDepthTile.minDistance, &maxDistance, sizeof(maxDistance));
+		for(SizeType i = 0; i < ReprojectDepthKernel::numberOfCoveredPixelMasks; ++i)
+		{
+			clearedReprojectedDepthTile.coveredPixelMasks[i] = 0;
+		}
+		return clearedReprojectedDepthTile;
+	}
+
+	inline
+	void ReprojectDepthKernel::setPreviousCameraPosition(const Vector3 &pPreviousCameraPosition)
+	{
+		this->setFloat3(0, pPreviousCameraPosition);
+	}
+
+	inline
+	void ReprojectDepthKernel::setPreviousCameraOrientationXAxis(const Vector3 &pPreviousCameraOrientationXAxis)
+	{
+		this->setFloat3(1, pPreviousCameraOrientationXAxis);
+	}
+
+	inline
+	void ReprojectDepthKernel::setPreviousCameraOrientationYAxis(const Vector3 &pPreviousCameraOrientationYAxis)
+	{
+		this->setFloat3(2, pPreviousCameraOrientationYAxis);
+	}
+
+	inline
+	void ReprojectDepthKernel::setPreviousCameraOrientationZAxis(const Vector3 &pPreviousCameraOrientationZAxis)
+	{
+		this->setFloat3(3, pPreviousCameraOrientationZAxis);
+	}
+
+	inline
+	void ReprojectDepthKernel::setPreviousCameraVerticalFieldOfViewInDegrees(Float pPreviousCameraVerticalFieldOfViewInDegrees)
+	{
+		this->setFloat(4, pPreviousCameraVerticalFieldOfViewInDegrees);
+	}
+
+	inline
+	void ReprojectDepthKernel::setCameraPosition(const Vector3 &pCameraPosition)
+	{
+		this->setFloat3(5, pCameraPosition);
+	}
+
+	inline
+	void ReprojectDepthKernel::setCameraOrientationXAxis(const Vector3 &pCameraOrientationXAxis)
+	{
+		this->setFloat3(6, pCameraOrientationXAxis);
+	}
+
+	inline
+	void ReprojectDepthKernel::setCameraOrientationYAxis(const Vector3 &pCameraOrientationYAxis)
+	{
+		this->setFloat3(7, pCameraOrientationYAxis);
+	}
+
+	inline
+	void ReprojectDepthKernel::setCameraOrientationZAxis(const Vector3 &pCameraOrientationZAxis)
+	{
+		this->setFloat3(8, pCameraOrientationZAxis);
+	}
+
+	inline
+	void ReprojectDepthKernel::setCameraVerticalFieldOfViewInDegrees(Float pCameraVerticalFieldOfViewInDegrees)
+	{
+		this->setFloat(9, pCameraVerticalFieldOfViewInDegrees);
+	}
+
+	inline
+	void ReprojectDepthKernel::setKernelPreviousDepthBuffer(cl_mem pKernelPreviousDepthBuffer)
+	{
+		this->setBuffer(10, pKernelPreviousDepthBuffer);
+	}
+
+	inline
+	void ReprojectDepthKernel::setOutputReprojectedDepthTilesBuffer(cl_mem pOutputReprojectedDepthTilesBuffer)
+	{
+		this->setBuffer(11, pOutputReprojectedDepthTilesBuffer);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,149 @@
+#ifndef FORGE_TRACE_BEAM_KERNEL_H
+#define FORGE_TRACE_BEAM_KERNEL_H
+
+#include <Forge/Source/Platform/OpenCL/OpenCLKernel.h>
+#include <Forge/Source/Core/Math/AABB.h>
+
+namespace forge
+{
+	class TraceBeamKernel : public OpenCLKernel
+	{
+	public:
+
+		// The side length of the square tiles of pixels that share one beam, in pixels. The global work size is the number of tiles along each axis of the image.
+		// NOTE: This must match FORGE_BEAM_TILE_SIZE in ForgeData/OpenCL/Kernels/Renderer.cl
+		static const SizeType tileSize = 8;
+
+		// If the build options define FORGE_SPARSE_VOXEL_OCTREE, the kernel reads the nodes of a sparse voxel octree
+		TraceBeamKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName, const char *pBuildOptions = nullptr);
+
+		void setCameraPosition(const Vector3 &pCameraPosition);
+
+		void setCameraOrientationXAxis(const Vector3 &pCameraOrientationXAxis);
+
+		void setCameraOrientationYAxis(const Vector3 &pCameraOrientationYAxis);
+
+		void setCameraOrientationZAxis(const Vector3 &pCameraOrientationZAxis);
+
+		void setCameraVerticalFieldOfViewInDegrees(Float pCameraVerticalFieldOfViewInDegrees);
+
+		void setKernelVoxelArrayBuffer(cl_mem pKernelVoxelArrayBuffer);
+
+		void setVoxelOctreeDepth(UInt32 pVoxelOctreeDepth);
+
+		// The resolution of the image that the RenderPixelKernel renders, in pixels
+		void setOutputImageResolution(Int32 pOutputImageWidth, Int32 pOutputImageHeight);
+
+		// One float for every tile of the image
+		void setOutputBeamDistancesBuffer(cl_mem pOutputBeamDistancesBuffer);
+
+		// The tiles that the depths of the previous frame are reprojected into by the ReprojectDepthKernel. The kernel clears them after reading them
+		void setKernelReprojectedDepthTilesBuffer(cl_mem pKernelReprojectedDepthTilesBuffer);
+
+		// Set the AABB that contains all the voxels that were added or removed since the previous frame.
+		// The reprojected depths are not used for the tiles whose rays pass through it
+		void setChangedVoxelsAABB(bool pHaveVoxelsChanged, const AABB &pChangedVoxelsAABB);
+
+		// The voxel with the remapped coords c is stored at ((c + toroidalOffset) mod voxelGridSideLength) along each axis. It must be 0 for the sparse voxel octree
+		void setVoxelGridToroidalOffset(const IntegerVector3<Int32> &pVoxelGridToroidalOffset);
+
+		// The distance that the camera moved since the previous frame. The reprojected depths are moved towards the camera by a margin that grows with it
+		void setCameraTranslationDistance(Float pCameraTranslationDistance);
+	};
+
+	inline
+	TraceBeamKernel::TraceBeamKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName, const char *pBuildOptions) :
+	OpenCLKernel(pOpenCLManager, pTextFileEditor, pKernelName, pBuildOptions)
+	{
+	}
+
+	inline
+	void TraceBeamKernel::setCameraPosition(const Vector3 &pCameraPosition)
+	{
+		this->setFloat3(0, pCameraPosition);
+	}
+
+	inline
+	void TraceBeamKernel::setCameraOrientationXAxis(const Vector3 &pCameraOrientationXAxis)
+	{
+		this->setFloat3(1, pCameraOrientationXAxis);
+	}
+
+	inline
+	void TraceBeamKernel::setCameraOrientationYAxis(const Vector3 &pCameraOrientationYAxis)
+	{
+		this->setFloat3(2, pCameraOrientationYAxis);
+	}
+
+	inline
+	void TraceBeamKernel::setCameraOrientationZAxis(const Vector3 &pCameraOrientationZAxis)
+	{
+		this->setFloat3(3, pCameraOrientationZAxis);
+	}
+
+	inline
+	void TraceBeamKernel::setCameraVerticalFieldOfViewInDegrees(Float pCameraVerticalFieldOfViewInDegrees)
+	{
+		this->setFloat(4, pCameraVerticalFieldOfViewInDegrees);
+	}
+
+	inline
+	void TraceBeamKernel::setKernelVoxelArrayBuffer(cl_mem pKernelVoxelArrayBuffer)
+	{
+		this->setBuffer(5, pKernelVoxelArrayBuffer);
+	}
+
+	inline
+	void TraceBeamKernel::setVoxelOctreeDepth(UInt32 pVoxelOctreeDepth)
+	{
+		this->setUInt(6, pVoxelOctreeDepth);
+	}
+
+	inline
+	void TraceBeamKernel::setOutputImageResolution(Int32 pOutputImageWidth, Int32 pOutputImageHeight)
+	{
+		this->setInt(7, pOutputImageWidth);
+		this->setInt(8, pOutputImageHeight);
+	}
+
+	inline
+	void TraceBeamKernel::setOutputBeamDistancesBuffer(cl_mem pOutputBeamDistancesBuffer)
+	{
+		this->setBuffer(9, pOutputBeamDistancesBuffer);
+	}
+
+	inline
+	void TraceBeamKernel::setKernelReprojectedDepthTilesBuffer(cl_mem pKernelReprojectedDepthTilesBuffer)
+	{
+		this->setBuffer(10, pKernelReprojectedDepthTilesBuffer);
+	}
+
+	inline
+	void TraceBeamKernel::setChangedVoxelsAABB(bool pHaveVoxelsChanged, const AABB &pChangedVoxelsAABB)
+	{
+		if(pHaveVoxelsChanged)
+		{
+			this->setInt(11, 1);
+		}
+		else
+		{
+			this->setInt(11, 0);
+		}
+		this->setFloat3(12, pChangedVoxelsAABB.getMinPoint());
+		this->setFloat3(13, pChangedVoxelsAABB.getMaxPoint());
+	}
+
+	inline
+	void TraceBeamKernel::setVoxelGridToroidalOffset(const IntegerVector3<Int32> &pVoxelGridToroidalOffset)
+	{
+		this->setInt3(14, pVoxelGridToroidalOffset);
+	}
+
+	inline
+	void TraceBeamKernel::setCameraTranslationDistance(Float pCameraTranslationDistance)
+	{
+		this->setFloat(15, pCameraTranslationDistance);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef FORGE_UPSCALE_FRAMEBUFFER_KERNEL_H
+#define FORGE_UPSCALE_FRAMEBUFFER_KERNEL_H
+
+#include <Forge/Source/Platform/OpenCL/OpenCLKernel.h>
+
+namespace forge
+{
+	// Stretches a framebuffer that was rendered at a lower resolution over a framebuffer of a higher resolution.
+	// The global work size is the resolution of the output framebuffer
+	class UpscaleFramebufferKernel : public OpenCLKernel
+	{
+	public:
+
+		UpscaleFramebufferKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName);
+
+		void setInputUInt8Framebuffer(cl_mem pInputUInt8Framebuffer);
+
+		// The resolution that the input framebuffer was rendered at, in pixels. It may be smaller than the memory of the input framebuffer
+		void setInputImageResolution(Int32 pInputImageWidth, Int32 pInputImageHeight);
+
+		void setOutputUInt8Framebuffer(cl_mem pOutputUInt8Framebuffer);
+	};
+
+	inline
+	UpscaleFramebufferKernel::UpscaleFramebufferKernel(OpenCLManager *pOpenCLManager, const TextFileEditor *pTextFileEditor, const char *pKernelName) :
+	OpenCLKernel(pOpenCLManager, pTextFileEditor, pKernelName)
+	{
+	}
+
+	inline
+	void UpscaleFramebufferKernel::setInputUInt8Framebuffer(cl_mem pInputUInt8Framebuffer)
+	{
+		this->setBuffer(0, pInputUInt8Framebuffer);
+	}
+
+	inline
+	void UpscaleFramebufferKernel::setInputImageResolution(Int32 pInputImageWidth, Int32 pInputImageHeight)
+	{
+		this->setInt(1, pInputImageWidth);
+		this->setInt(2, pInputImageHeight);
+	}
+
+	inline
+	void UpscaleFramebufferKernel::setOutputUInt8Framebuffer(cl_mem pOutputUInt8Framebuffer)
+	{
+		this->setBuffer(3, pOutputUInt8Framebuffer);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -9,94 +9,266 @@
 
 namespace forge
 {
-	struct OpenCLAABB
-	{
-		cl_float3 minPoint;
-		cl_float3 maxPoint;
-	};
-
-	struct OpenCLDebugAABBData
-	{
-		OpenCLAABB aabb;
-		cl_float3 color;
-	};
-
-	void OpenCLRenderer::startup(Program *pProgram, cl_mem pKernelVoxelDataBuffer)
+	void OpenCLRenderer::startup(Program *pProgram, const Settings &pSettings)
 	{
 		this->program = pProgram;
-		this->kernelVoxelDataBuffer = pKernelVoxelDataBuffer;
+		this->readBackPipelineDepth = pSettings.readBackPipelineDepth;
+		this->targetFrameTime = pSettings.targetFrameTime;
 
-		// Create a backbuffer that is has the same resolution as the window
-		this->backbuffer = new Framebuffer();
-		this->backbuffer->startup(pProgram->getWindow()->getResolutionWidth(), pProgram->getWindow()->getResolutionHeight());
+		// Create the backbuffers that the frames are read back into. They have the same resolution as the window
+		this->backbuffers.setNumberOfElements(this->readBackPipelineDepth);
+		this->kernelBackbufferBuffers.setNumberOfElements(this->readBackPipelineDepth);
+		this->mappedBackbufferPointers.setNumberOfElements(this->readBackPipelineDepth);
+		this->backbufferReadBackEvents.setNumberOfElements(this->readBackPipelineDepth);
+		for(SizeType i = 0; i < this->readBackPipelineDepth; ++i)
+		{
+			this->backbuffers[i] = new Framebuffer();
+			this->backbuffers[i]->startup(pProgram->getWindow()->getResolutionWidth(), pProgram->getWindow()->getResolutionHeight());
+		}
 
 		// Used to store the return code from OpenCL functions
 		cl_int returnCode;
 
+		// The pixel memory of the backbuffers is a DIB section, which is page aligned, so the devices that share memory with the host can use it without copying it
+		for(SizeType i = 0; i < this->readBackPipelineDepth; ++i)
+		{
+			this->kernelBackbufferBuffers[i] = clCreateBuffer(this->program->getOpenCLManager()->getContext(), CL_MEM_WRITE_ONLY | CL_MEM_USE_HOST_PTR, this->backbuffers[i]->getPixelsMemorySize(), this->backbuffers[i]->getPixelsMemoryPointer(), &returnCode);
+			FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+			this->mappedBackbufferPointers[i] = nullptr;
+			this->backbufferReadBackEvents[i] = NULL;
+		}
+
 		this->kernelTexturesBuffer = clCreateBuffer(this->program->getOpenCLManager()->getContext(), CL_MEM_READ_ONLY, sizeof(Float) * this->textureSize * this->textureSize * 255, NULL, &returnCode);
 		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
 		this->generateTextures();
-		this->kernelUInt8FrameBuffer = clCreateBuffer(this->program->getOpenCLManager()->getContext(), CL_MEM_WRITE_ONLY, this->backbuffer->getPixelsMemorySize(), NULL, &returnCode);
-		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		// The frames are rendered into these buffers, and read from them by the upscale kernel, and by the checkerboard reconstruction in the next frame
+		for(SizeType i = 0; i < 2; ++i)
+		{
+			this->kernelUInt8FrameBuffers[i] = clCreateBuffer(this->program->getOpenCLManager()->getContext(), CL_MEM_READ_WRITE, this->backbuffers[0]->getPixelsMemorySize(), NULL, &returnCode);
+			FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+			this->kernelDepthBuffers[i] = clCreateBuffer(this->program->getOpenCLManager()->getContext(), CL_MEM_READ_WRITE, sizeof(Float) * this->backbuffers[0]->getWidth() * this->backbuffers[0]->getHeight(), NULL, &returnCode);
+			FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		}
+		// Start at the full resolution of the backbuffer
+		this->renderResolutionScale = 1.0f;
+		this->renderResolutionWidth = static_cast<Int32>(this->backbuffers[0]->getWidth());
+		this->renderResolutionHeight = static_cast<Int32>(this->backbuffers[0]->getHeight());
+		this->averageFrameTime = static_cast<Float>(this->targetFrameTime);
 		this->kernelDebugAABBsBuffer = clCreateBuffer(this->program->getOpenCLManager()->getContext(), CL_MEM_READ_ONLY, sizeof(OpenCLDebugAABBData) * this->maxNumberOfDebugAABBs, NULL, &returnCode);
 		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		this->debugAABBsPerBackbuffer.setNumberOfElements(this->readBackPipelineDepth * this->maxNumberOfDebugAABBs);
+		// The tiles at the right and top edges of the backbuffer may be cut off by it. There are fewer tiles while the render resolution is lower
+		this->numberOfBeamTilesAlongX = (static_cast<SizeType>(this->backbuffers[0]->getWidth()) + TraceBeamKernel::tileSize - 1) / TraceBeamKernel::tileSize;
+		this->numberOfBeamTilesAlongY = (static_cast<SizeType>(this->backbuffers[0]->getHeight()) + TraceBeamKernel::tileSize - 1) / TraceBeamKernel::tileSize;
+		this->kernelBeamDistancesBuffer = clCreateBuffer(this->program->getOpenCLManager()->getContext(), CL_MEM_READ_WRITE, sizeof(Float) * this->numberOfBeamTilesAlongX * this->numberOfBeamTilesAlongY, NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		this->kernelReprojectedDepthTilesBuffer = clCreateBuffer(this->program->getOpenCLManager()->getContext(), CL_MEM_READ_WRITE, sizeof(ReprojectDepthKernel::ReprojectedDepthTile) * this->numberOfBeamTilesAlongX * this->numberOfBeamTilesAlongY, NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		this->kernelNextRayBatchIndexBuffer = clCreateBuffer(this->program->getOpenCLManager()->getContext(), CL_MEM_READ_WRITE, sizeof(cl_uint), NULL, &returnCode);
+		FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+		// The tiles are cleared by the traceBeam kernel every frame after it has read them, so they only need to be cleared here once
+		{
+			ResizableArray<ReprojectDepthKernel::ReprojectedDepthTile> clearedReprojectedDepthTiles(this->numberOfBeamTilesAlongX * this->numberOfBeamTilesAlongY);
+			for(SizeType i = 0; i < clearedReprojectedDepthTiles.getNumberOfElements(); ++i)
+			{
+				clearedReprojectedDepthTiles[i] = ReprojectDepthKernel::getClearedReprojectedDepthTile();
+			}
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueWriteBuffer(this->program->getOpenCLManager()->getCommandQueue(), this->kernelReprojectedDepthTilesBuffer, CL_BLOCKING, 0, sizeof(ReprojectDepthKernel::ReprojectedDepthTile) * clearedReprojectedDepthTiles.getNumberOfElements(), &clearedReprojectedDepthTiles[0], 0, NULL, NULL));
+		}
 
 		TextFileEditor renderPixelKernelTextEditor;
 		renderPixelKernelTextEditor.openFile("ForgeData/OpenCL/Kernels/Renderer.cl");
 		this->renderPixelKernel = new RenderPixelKernel(this->program->getOpenCLManager(),
 														&renderPixelKernelTextEditor,
 														"renderPixel");
-		this->renderPixelKernel->setKernelVoxelArrayBuffer(this->kernelVoxelDataBuffer);
-		this->renderPixelKernel->setOutputUInt8Framebuffer(this->kernelUInt8FrameBuffer);
 		this->renderPixelKernel->setKernelTexturesBuffer(this->kernelTexturesBuffer);
 		this->renderPixelKernel->setKernelDebugAABBsBuffer(this->kernelDebugAABBsBuffer);
+		this->renderPixelKernel->setKernelBeamDistancesBuffer(this->kernelBeamDistancesBuffer);
+		this->renderPixelKernel->setKernelNextRayBatchIndexBuffer(this->kernelNextRayBatchIndexBuffer);
+		// The lane utilisation is only measured by the benchmark
+		this->renderPixelKernel->setOutputLaneStatisticsBuffer(nullptr);
+		this->renderPixelKernel->setIsTiledPixelOrderEnabled(this->isTiledPixelOrderEnabled);
+
+		this->sparseVoxelOctreeRenderPixelKernel = new RenderPixelKernel(this->program->getOpenCLManager(),
+																		 &renderPixelKernelTextEditor,
+																		 "renderPixel",
+																		 "-D FORGE_SPARSE_VOXEL_OCTREE");
+		this->sparseVoxelOctreeRenderPixelKernel->setKernelTexturesBuffer(this->kernelTexturesBuffer);
+		this->sparseVoxelOctreeRenderPixelKernel->setKernelDebugAABBsBuffer(this->kernelDebugAABBsBuffer);
+		this->sparseVoxelOctreeRenderPixelKernel->setKernelBeamDistancesBuffer(this->kernelBeamDistancesBuffer);
+		this->sparseVoxelOctreeRenderPixelKernel->setKernelNextRayBatchIndexBuffer(this->kernelNextRayBatchIndexBuffer);
+		this->sparseVoxelOctreeRenderPixelKernel->setOutputLaneStatisticsBuffer(nullptr);
+		this->sparseVoxelOctreeRenderPixelKernel->setIsTiledPixelOrderEnabled(this->isTiledPixelOrderEnabled);
+
+		this->traceBeamKernel = new TraceBeamKernel(this->program->getOpenCLManager(),
+													&renderPixelKernelTextEditor,
+													"traceBeam");
+		this->traceBeamKernel->setOutputBeamDistancesBuffer(this->kernelBeamDistancesBuffer);
+		this->traceBeamKernel->setKernelReprojectedDepthTilesBuffer(this->kernelReprojectedDepthTilesBuffer);
+
+		this->sparseVoxelOctreeTraceBeamKernel = new TraceBeamKernel(this->program->getOpenCLManager(),
+																	 &renderPixelKernelTextEditor,
+																	 "traceBeam",
+																	 "-D FORGE_SPARSE_VOXEL_OCTREE");
+		this->sparseVoxelOctreeTraceBeamKernel->setOutputBeamDistancesBuffer(this->kernelBeamDistancesBuffer);
+		this->sparseVoxelOctreeTraceBeamKernel->setKernelReprojectedDepthTilesBuffer(this->kernelReprojectedDepthTilesBuffer);
 
-		this->program->getVoxelGrid()->onVoxelOctreeNodeUpdated.addListener<OpenCLRenderer, &OpenCLRenderer::onVoxelNodeUpdated>(this);
+		this->reprojectDepthKernel = new ReprojectDepthKernel(this->program->getOpenCLManager(),
+															  &renderPixelKernelTextEditor,
+															  "reprojectDepth");
+		this->reprojectDepthKernel->setOutputReprojectedDepthTilesBuffer(this->kernelReprojectedDepthTilesBuffer);
+
+		this->upscaleFramebufferKernel = new UpscaleFramebufferKernel(this->program->getOpenCLManager(),
+																	  &renderPixelKernelTextEditor,
+																	  "upscaleFramebuffer");
+
+		this->reconstructCheckerboardKernel = new ReconstructCheckerboardKernel(this->program->getOpenCLManager(),
+																				&renderPixelKernelTextEditor,
+																				"reconstructCheckerboard");
+
+		this->program->getVoxelGrid()->onVoxelBrickUpdated.addListener<OpenCLRenderer, &OpenCLRenderer::onVoxelBrickUpdated>(this);
+		this->program->getVoxelGrid()->onVoxelMaterialUpdated.addListener<OpenCLRenderer, &OpenCLRenderer::onVoxelMaterialUpdated>(this);
+		this->program->getVoxelGrid()->onVoxelsInBoxUpdated.addListener<OpenCLRenderer, &OpenCLRenderer::onVoxelsInBoxUpdated>(this);
+		this->sparseVoxelOctree.onNodesUpdated.addListener<OpenCLRenderer, &OpenCLRenderer::onSparseVoxelOctreeNodesUpdated>(this);
+		this->sparseVoxelOctree.onVoxelBricksUpdated.addListener<OpenCLRenderer, &OpenCLRenderer::onSparseVoxelOctreeVoxelBricksUpdated>(this);
+		this->sparseVoxelOctree.onVoxelMaterialsUpdated.addListener<OpenCLRenderer, &OpenCLRenderer::onSparseVoxelOctreeVoxelMaterialsUpdated>(this);
 	}
 
 	void OpenCLRenderer::shutdown()
 	{
-		this->program->getVoxelGrid()->onVoxelOctreeNodeUpdated.removeListener<OpenCLRenderer, &OpenCLRenderer::onVoxelNodeUpdated>(this);
+		this->program->getVoxelGrid()->onVoxelBrickUpdated.removeListener<OpenCLRenderer, &OpenCLRenderer::onVoxelBrickUpdated>(this);
+		this->program->getVoxelGrid()->onVoxelMaterialUpdated.removeListener<OpenCLRenderer, &OpenCLRenderer::onVoxelMaterialUpdated>(this);
+		this->program->getVoxelGrid()->onVoxelsInBoxUpdated.removeListener<OpenCLRenderer, &OpenCLRenderer::onVoxelsInBoxUpdated>(this);
+		this->sparseVoxelOctree.onNodesUpdated.removeListener<OpenCLRenderer, &OpenCLRenderer::onSparseVoxelOctreeNodesUpdated>(this);
+		this->sparseVoxelOctree.onVoxelBricksUpdated.removeListener<OpenCLRenderer, &OpenCLRenderer::onSparseVoxelOctreeVoxelBricksUpdated>(this);
+		this->sparseVoxelOctree.onVoxelMaterialsUpdated.removeListener<OpenCLRenderer, &OpenCLRenderer::onSparseVoxelOctreeVoxelMaterialsUpdated>(this);
+
+		// The device may still be writing into the backbuffers, and reading from the framebuffers
+		for(SizeType i = 0; i < this->readBackPipelineDepth; ++i)
+		{
+			if(this->backbufferReadBackEvents[i])
+			{
+				FORGE_OPENCL_ERROR_CODE_CHECK(clWaitForEvents(1, &this->backbufferReadBackEvents[i]));
+				FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseEvent(this->backbufferReadBackEvents[i]));
+				this->backbufferReadBackEvents[i] = NULL;
+			}
+			if(this->mappedBackbufferPointers[i])
+			{
+				FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueUnmapMemObject(this->program->getOpenCLManager()->getCommandQueue(), this->kernelBackbufferBuffers[i], this->mappedBackbufferPointers[i], 0, NULL, NULL));
+				this->mappedBackbufferPointers[i] = nullptr;
+			}
+		}
+		FORGE_OPENCL_ERROR_CODE_CHECK(clFinish(this->program->getOpenCLManager()->getCommandQueue()));
 
 		// Clean up OpenCL resources
-		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelUInt8FrameBuffer));
+		if(this->sparseVoxelOctreeUploadEvent)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseEvent(this->sparseVoxelOctreeUploadEvent));
+		}
+		for(SizeType i = 0; i < 2; ++i)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelUInt8FrameBuffers[i]));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelDepthBuffers[i]));
+		}
+		for(SizeType i = 0; i < this->readBackPipelineDepth; ++i)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelBackbufferBuffers[i]));
+		}
 		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelTexturesBuffer));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelBeamDistancesBuffer));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelReprojectedDepthTilesBuffer));
+		FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelNextRayBatchIndexBuffer));
+		if(this->kernelSparseVoxelOctreeNodesBuffer)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelSparseVoxelOctreeNodesBuffer));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelSparseVoxelOctreeVoxelBricksBuffer));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelSparseVoxelOctreeVoxelBrickFirstMaterialIndicesBuffer));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(this->kernelSparseVoxelOctreeVoxelMaterialsBuffer));
+		}
 
 		delete this->renderPixelKernel;
+		delete this->sparseVoxelOctreeRenderPixelKernel;
+		delete this->traceBeamKernel;
+		delete this->sparseVoxelOctreeTraceBeamKernel;
+		delete this->reprojectDepthKernel;
+		delete this->upscaleFramebufferKernel;
+		delete this->reconstructCheckerboardKernel;
 
-		this->backbuffer->shutdown();
-		delete this->backbuffer;
+		for(SizeType i = 0; i < this->readBackPipelineDepth; ++i)
+		{
+			this->backbuffers[i]->shutdown();
+			delete this->backbuffers[i];
+		}
 	}
 
 	void OpenCLRenderer::render()
 	{
+		this->updateRenderResolution();
+
+		// The sparse voxel octree is only used while the world is static, since the world changes every frame while it scrolls
+		const bool isSparseVoxelOctreeUsed = !this->program->getIsWorldScrollingEnabled();
+		RenderPixelKernel *currentRenderPixelKernel = isSparseVoxelOctreeUsed ? this->sparseVoxelOctreeRenderPixelKernel : this->renderPixelKernel;
+		TraceBeamKernel *currentTraceBeamKernel = isSparseVoxelOctreeUsed ? this->sparseVoxelOctreeTraceBeamKernel : this->traceBeamKernel;
+		const bool isCheckerboardRenderingUsed = this->program->getIsCheckerboardRenderingEnabled();
+		const bool isPersistentThreadsUsed = this->program->getIsPersistentThreadsEnabled();
+		const SizeType frameBufferIndex = this->currentFrameBufferIndex;
+		const SizeType previousFrameBufferIndex = 1 - this->currentFrameBufferIndex;
+		// The sparse voxel octree is built from the VoxelGrid object, which has no toroidal offset
+		const IntegerVector3<Int32> voxelGridToroidalOffset = isSparseVoxelOctreeUsed ? IntegerVector3<Int32>(0, 0, 0) : this->program->getWorldGenerator()->getVoxelGridToroidalOffset();
+
 		// Pass arguments to the parameters of the renderer kernel
 		{
-			this->renderPixelKernel->setCameraPosition(this->program->getCamera()->coordinateSpace.position);
-			this->renderPixelKernel->setCameraOrientationXAxis(this->program->getCamera()->coordinateSpace.orientation.getXAxis());
-			this->renderPixelKernel->setCameraOrientationYAxis(this->program->getCamera()->coordinateSpace.orientation.getYAxis());
-			this->renderPixelKernel->setCameraOrientationZAxis(this->program->getCamera()->coordinateSpace.orientation.getZAxis());
-			this->renderPixelKernel->setCameraVerticalFieldOfViewInDegrees(this->program->getCamera()->getVerticalFieldOfViewInDegrees());
-			this->renderPixelKernel->setVoxelOctreeDepth(this->program->getVoxelGrid()->getOctreeDepth());
-			this->renderPixelKernel->setIsOctreeVisualizationEnabled(this->program->getIsVoxelOctreeVisualizationEnabled());
+			currentRenderPixelKernel->setCameraPosition(this->program->getCamera()->coordinateSpace.position);
+			currentRenderPixelKernel->setCameraOrientationXAxis(this->program->getCamera()->coordinateSpace.orientation.getXAxis());
+			currentRenderPixelKernel->setCameraOrientationYAxis(this->program->getCamera()->coordinateSpace.orientation.getYAxis());
+			currentRenderPixelKernel->setCameraOrientationZAxis(this->program->getCamera()->coordinateSpace.orientation.getZAxis());
+			currentRenderPixelKernel->setCameraVerticalFieldOfViewInDegrees(this->program->getCamera()->getVerticalFieldOfViewInDegrees());
+			currentRenderPixelKernel->setVoxelOctreeDepth(this->program->getVoxelGrid()->getOctreeDepth());
+			currentRenderPixelKernel->setIsOctreeVisualizationEnabled(this->program->getIsVoxelOctreeVisualizationEnabled());
+			currentRenderPixelKernel->setOutputImageResolution(this->renderResolutionWidth, this->renderResolutionHeight);
+			currentRenderPixelKernel->setCheckerboardParity(isCheckerboardRenderingUsed ? this->checkerboardParity : -1);
+			currentRenderPixelKernel->setIsPersistentThreadsEnabled(isPersistentThreadsUsed);
+			currentRenderPixelKernel->setOutputUInt8Framebuffer(this->kernelUInt8FrameBuffers[frameBufferIndex]);
+			currentRenderPixelKernel->setOutputDepthBuffer(this->kernelDepthBuffers[frameBufferIndex]);
+			currentRenderPixelKernel->setVoxelGridToroidalOffset(voxelGridToroidalOffset);
+
+			currentTraceBeamKernel->setCameraPosition(this->program->getCamera()->coordinateSpace.position);
+			currentTraceBeamKernel->setCameraOrientationXAxis(this->program->getCamera()->coordinateSpace.orientation.getXAxis());
+			currentTraceBeamKernel->setCameraOrientationYAxis(this->program->getCamera()->coordinateSpace.orientation.getYAxis());
+			currentTraceBeamKernel->setCameraOrientationZAxis(this->program->getCamera()->coordinateSpace.orientation.getZAxis());
+			currentTraceBeamKernel->setCameraVerticalFieldOfViewInDegrees(this->program->getCamera()->getVerticalFieldOfViewInDegrees());
+			currentTraceBeamKernel->setVoxelOctreeDepth(this->program->getVoxelGrid()->getOctreeDepth());
+			currentTraceBeamKernel->setOutputImageResolution(this->renderResolutionWidth, this->renderResolutionHeight);
+			currentTraceBeamKernel->setChangedVoxelsAABB(this->haveVoxelsChanged, this->changedVoxelsAABB);
+			currentTraceBeamKernel->setVoxelGridToroidalOffset(voxelGridToroidalOffset);
+			currentTraceBeamKernel->setCameraTranslationDistance((this->program->getCamera()->coordinateSpace.position - this->previousCameraCoordinateSpace.position).getMagnitude());
 		}
 
 		// Update the voxel octree data in the device memory if needed
+		// The edits only change the VoxelGrid object, which the dense voxel octree is not read from. It is generated again on the device once the world scrolls
+		if(isSparseVoxelOctreeUsed)
 		{
-			if(this->shouldUpdateVoxelOctreeBuffer)
+			if(this->shouldRebuildSparseVoxelOctree)
+			{
+				this->rebuildSparseVoxelOctree();
+				this->shouldRebuildSparseVoxelOctree = false;
+			}
+			else if(this->haveVoxelBricksChangedSinceUpdate)
 			{
-				clEnqueueWriteBuffer(this->program->getOpenCLManager()->getCommandQueue(),
-									 this->kernelVoxelDataBuffer,
-									 CL_BLOCKING,
-									 0,
-									 sizeof(VoxelData) * this->program->getVoxelGrid()->getVoxelDataArray()->getNumberOfElements(),
-									 &(*this->program->getVoxelGrid()->getVoxelDataArray())[0],
-									 NULL,
-									 NULL,
-									 NULL);
-				
-				this->shouldUpdateVoxelOctreeBuffer = false;
+				this->updateSparseVoxelOctree();
 			}
+			this->haveVoxelBricksChangedSinceUpdate = false;
+		}
+		else
+		{
+			this->shouldRebuildSparseVoxelOctree = true;
+
+			// The buffers of the dense voxel octree are created again whenever the world starts scrolling
+			this->renderPixelKernel->setKernelVoxelArrayBuffer(this->program->getKernelVoxelDataBuffer());
+			this->renderPixelKernel->setKernelVoxelBrickArrayBuffer(this->program->getKernelVoxelBrickBuffer());
+			this->renderPixelKernel->setKernelVoxelBrickFirstMaterialIndexArrayBuffer(this->program->getKernelVoxelBrickFirstMaterialIndexBuffer());
+			this->renderPixelKernel->setKernelVoxelMaterialArrayBuffer(this->program->getKernelVoxelMaterialBuffer());
+			this->traceBeamKernel->setKernelVoxelArrayBuffer(this->program->getKernelVoxelDataBuffer());
 		}
 		
 		// Update the debug AABBs data in the device memory
@@ -104,38 +276,207 @@ namespace forge
 			DynamicArray<DebugAABBData> debugAABBs;
 			this->program->getCurrentRenderingData(debugAABBs);
 			Int32 numberOfDebugAABBsInThisFrame = static_cast<Int32>(min<SizeType>(debugAABBs.getNumberOfElements(), this->maxNumberOfDebugAABBs));
-			ResizableArray<OpenCLDebugAABBData> openCLDebugAABBs(debugAABBs.getNumberOfElements());
+			OpenCLDebugAABBData *openCLDebugAABBs = &this->debugAABBsPerBackbuffer[this->currentBackbufferIndex * this->maxNumberOfDebugAABBs];
 			for(cl_int i = 0; i < numberOfDebugAABBsInThisFrame; ++i)
 			{
 				openCLDebugAABBs[i].aabb.minPoint = convertVector3Tocl_float3(debugAABBs[i].aabb.getMinPoint());
 				openCLDebugAABBs[i].aabb.maxPoint = convertVector3Tocl_float3(debugAABBs[i].aabb.getMaxPoint());
 				openCLDebugAABBs[i].color = convertVector3Tocl_float3(debugAABBs[i].color.getRGBVector3());
 			}
-			clEnqueueWriteBuffer(this->program->getOpenCLManager()->getCommandQueue(), this->kernelDebugAABBsBuffer, CL_BLOCKING, 0, sizeof(OpenCLDebugAABBData) * numberOfDebugAABBsInThisFrame, &openCLDebugAABBs[0], NULL, NULL, NULL);
+			// Writing zero bytes is not allowed
+			if(numberOfDebugAABBsInThisFrame > 0)
+			{
+				FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueWriteBuffer(this->program->getOpenCLManager()->getCommandQueue(), this->kernelDebugAABBsBuffer, CL_NON_BLOCKING, 0, sizeof(OpenCLDebugAABBData) * numberOfDebugAABBsInThisFrame, openCLDebugAABBs, 0, NULL, this->program->getOpenCLManager()->getProfiler()->getEventForCommand("uploadDebugAABBs")));
+			}
 
 			// Set the number of debug AABBs
-			this->renderPixelKernel->setNumberOfDebugAABBs(numberOfDebugAABBsInThisFrame);
+			currentRenderPixelKernel->setNumberOfDebugAABBs(numberOfDebugAABBsInThisFrame);
 		}
 
-		// Run the kernel
+		// Reproject the depth buffer of the previous frame into the tiles that the beams read. The tiles stay cleared if it is not reprojected
+		const bool isDepthReprojectionUsed = this->isPreviousFrameValid && !this->program->getIsWorldScrollingEnabled();
+		if(isDepthReprojectionUsed)
+		{
+			this->reprojectDepthKernel->setPreviousCameraPosition(this->previousCameraCoordinateSpace.position);
+			this->reprojectDepthKernel->setPreviousCameraOrientationXAxis(this->previousCameraCoordinateSpace.orientation.getXAxis());
+			this->reprojectDepthKernel->setPreviousCameraOrientationYAxis(this->previousCameraCoordinateSpace.orientation.getYAxis());
+			this->reprojectDepthKernel->setPreviousCameraOrientationZAxis(this->previousCameraCoordinateSpace.orientation.getZAxis());
+			this->reprojectDepthKernel->setPreviousCameraVerticalFieldOfViewInDegrees(this->previousCameraVerticalFieldOfViewInDegrees);
+			this->reprojectDepthKernel->setCameraPosition(this->program->getCamera()->coordinateSpace.position);
+			this->reprojectDepthKernel->setCameraOrientationXAxis(this->program->getCamera()->coordinateSpace.orientation.getXAxis());
+			this->reprojectDepthKernel->setCameraOrientationYAxis(this->program->getCamera()->coordinateSpace.orientation.getYAxis());
+			this->reprojectDepthKernel->setCameraOrientationZAxis(this->program->getCamera()->coordinateSpace.orientation.getZAxis());
+			this->reprojectDepthKernel->setCameraVerticalFieldOfViewInDegrees(this->program->getCamera()->getVerticalFieldOfViewInDegrees());
+			this->reprojectDepthKernel->setKernelPreviousDepthBuffer(this->kernelDepthBuffers[previousFrameBufferIndex]);
+
+			size_t globalWorkSize[2];
+			globalWorkSize[0] = static_cast<size_t>(this->renderResolutionWidth);
+			globalWorkSize[1] = static_cast<size_t>(this->renderResolutionHeight);
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->program->getOpenCLManager()->getCommandQueue(), this->reprojectDepthKernel->getKernel(), 2, NULL, globalWorkSize, NULL, 0, NULL, this->program->getOpenCLManager()->getProfiler()->getEventForCommand("reprojectDepth")));
+		}
+
+		// Trace one beam for every tile of the backbuffer. This runs on the same command queue as renderPixel, so it finishes before it
 		{
 			size_t globalWorkSize[2];
-			globalWorkSize[0] = static_cast<size_t>(this->backbuffer->getWidth());
-			globalWorkSize[1] = static_cast<size_t>(this->backbuffer->getHeight());
-			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->program->getOpenCLManager()->getCommandQueue(), this->renderPixelKernel->getKernel(), 2, NULL, globalWorkSize, NULL, 0, NULL, NULL));
+			globalWorkSize[0] = (static_cast<size_t>(this->renderResolutionWidth) + TraceBeamKernel::tileSize - 1) / TraceBeamKernel::tileSize;
+			globalWorkSize[1] = (static_cast<size_t>(this->renderResolutionHeight) + TraceBeamKernel::tileSize - 1) / TraceBeamKernel::tileSize;
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->program->getOpenCLManager()->getCommandQueue(), currentTraceBeamKernel->getKernel(), 2, NULL, globalWorkSize, NULL, 0, NULL, this->program->getOpenCLManager()->getProfiler()->getEventForCommand("traceBeam")));
 		}
 
-		// Copy the pixels from device memory to the backbuffer
-		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueReadBuffer(this->program->getOpenCLManager()->getCommandQueue(), this->kernelUInt8FrameBuffer, CL_BLOCKING, 0, this->backbuffer->getPixelsMemorySize(), this->backbuffer->getPixelsMemoryPointer(), 0, NULL, NULL));
+		// Run the kernel. In checkerboard rendering, each work item renders every second pixel of a row
+		if(isPersistentThreadsUsed)
+		{
+			// The work groups take the batches of pixels in order, starting from the first one
+			const cl_uint firstRayBatchIndex = 0;
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueFillBuffer(this->program->getOpenCLManager()->getCommandQueue(), this->kernelNextRayBatchIndexBuffer, &firstRayBatchIndex, sizeof(cl_uint), 0, sizeof(cl_uint), 0, NULL, NULL));
 
-		// Render the framerate text
+			size_t localWorkSize = RenderPixelKernel::rayBatchSideLength * RenderPixelKernel::rayBatchSideLength;
+			size_t globalWorkSize = localWorkSize * RenderPixelKernel::numberOfPersistentWorkGroupsPerComputeUnit * this->program->getOpenCLManager()->getNumberOfComputeUnits();
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->program->getOpenCLManager()->getCommandQueue(), currentRenderPixelKernel->getKernel(), 1, NULL, &globalWorkSize, &localWorkSize, 0, NULL, this->program->getOpenCLManager()->getProfiler()->getEventForCommand("renderPixel")));
+		}
+		else if(this->isTiledPixelOrderEnabled)
 		{
-			char framesPerSecondText[256] = "0";
-			Int numberOfCharactersInString = snprintf(framesPerSecondText, sizeof(framesPerSecondText), "FPS : %lld", this->program->getFPSCounter()->getCurrentFPS());
-			this->backbuffer->tempDrawText(0, 0, framesPerSecondText, numberOfCharactersInString);
+			size_t globalWorkSize = RenderPixelKernel::rayBatchSideLength * RenderPixelKernel::rayBatchSideLength * RenderPixelKernel::getNumberOfRayBatches(this->renderResolutionWidth, this->renderResolutionHeight, isCheckerboardRenderingUsed);
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->program->getOpenCLManager()->getCommandQueue(), currentRenderPixelKernel->getKernel(), 1, NULL, &globalWorkSize, NULL, 0, NULL, this->program->getOpenCLManager()->getProfiler()->getEventForCommand("renderPixel")));
 		}
+		else
+		{
+			size_t globalWorkSize[2];
+			globalWorkSize[0] = isCheckerboardRenderingUsed ? (static_cast<size_t>(this->renderResolutionWidth) + 1) / 2 : static_cast<size_t>(this->renderResolutionWidth);
+			globalWorkSize[1] = static_cast<size_t>(this->renderResolutionHeight);
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->program->getOpenCLManager()->getCommandQueue(), currentRenderPixelKernel->getKernel(), 2, NULL, globalWorkSize, NULL, 0, NULL, this->program->getOpenCLManager()->getProfiler()->getEventForCommand("renderPixel")));
+		}
+
+		// Fill in the pixels that were not rendered in checkerboard rendering
+		if(isCheckerboardRenderingUsed)
+		{
+			this->reconstructCheckerboardKernel->setPreviousCameraPosition(this->previousCameraCoordinateSpace.position);
+			this->reconstructCheckerboardKernel->setPreviousCameraOrientationXAxis(this->previousCameraCoordinateSpace.orientation.getXAxis());
+			this->reconstructCheckerboardKernel->setPreviousCameraOrientationYAxis(this->previousCameraCoordinateSpace.orientation.getYAxis());
+			this->reconstructCheckerboardKernel->setPreviousCameraOrientationZAxis(this->previousCameraCoordinateSpace.orientation.getZAxis());
+			this->reconstructCheckerboardKernel->setPreviousCameraVerticalFieldOfViewInDegrees(this->previousCameraVerticalFieldOfViewInDegrees);
+			this->reconstructCheckerboardKernel->setCameraPosition(this->program->getCamera()->coordinateSpace.position);
+			this->reconstructCheckerboardKernel->setCameraOrientationXAxis(this->program->getCamera()->coordinateSpace.orientation.getXAxis());
+			this->reconstructCheckerboardKernel->setCameraOrientationYAxis(this->program->getCamera()->coordinateSpace.orientation.getYAxis());
+			this->reconstructCheckerboardKernel->setCameraOrientationZAxis(this->program->getCamera()->coordinateSpace.orientation.getZAxis());
+			this->reconstructCheckerboardKernel->setCameraVerticalFieldOfViewInDegrees(this->program->getCamera()->getVerticalFieldOfViewInDegrees());
+			this->reconstructCheckerboardKernel->setOutputImageResolution(this->renderResolutionWidth, this->renderResolutionHeight);
+			this->reconstructCheckerboardKernel->setCheckerboardParity(this->checkerboardParity);
+			this->reconstructCheckerboardKernel->setIsPreviousFrameValid(this->isPreviousFrameValid && !this->program->getIsWorldScrollingEnabled());
+			this->reconstructCheckerboardKernel->setKernelPreviousUInt8Framebuffer(this->kernelUInt8FrameBuffers[previousFrameBufferIndex]);
+			this->reconstructCheckerboardKernel->setKernelPreviousDepthBuffer(this->kernelDepthBuffers[previousFrameBufferIndex]);
+			this->reconstructCheckerboardKernel->setOutputUInt8Framebuffer(this->kernelUInt8FrameBuffers[frameBufferIndex]);
+			this->reconstructCheckerboardKernel->setOutputDepthBuffer(this->kernelDepthBuffers[frameBufferIndex]);
 
-		this->program->getWindow()->blitFramebufferToScreen(*this->backbuffer);
+			size_t globalWorkSize[2];
+			globalWorkSize[0] = (static_cast<size_t>(this->renderResolutionWidth) + 1) / 2;
+			globalWorkSize[1] = static_cast<size_t>(this->renderResolutionHeight);
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->program->getOpenCLManager()->getCommandQueue(), this->reconstructCheckerboardKernel->getKernel(), 2, NULL, globalWorkSize, NULL, 0, NULL, this->program->getOpenCLManager()->getProfiler()->getEventForCommand("reconstructCheckerboard")));
+		}
+
+		// The framebuffer and the depth buffer of this frame are read in the next frame, and the other pixels are rendered in checkerboard rendering
+		this->previousCameraCoordinateSpace = this->program->getCamera()->coordinateSpace;
+		this->previousCameraVerticalFieldOfViewInDegrees = this->program->getCamera()->getVerticalFieldOfViewInDegrees();
+		this->isPreviousFrameValid = !this->program->getIsWorldScrollingEnabled();
+		this->haveVoxelsChanged = false;
+		this->currentFrameBufferIndex = previousFrameBufferIndex;
+		this->checkerboardParity = 1 - this->checkerboardParity;
+
+		// Write the final frame into the buffer over the current backbuffer. The frame that was shown from it has already been blitted to the screen, and the buffer unmapped.
+		// The command queue is in order, so the framebuffer is not written by the next frame before it has been read
+		cl_mem backbufferBuffer = this->kernelBackbufferBuffers[this->currentBackbufferIndex];
+		if(this->renderResolutionWidth != this->backbuffers[0]->getWidth() || this->renderResolutionHeight != this->backbuffers[0]->getHeight())
+		{
+			// Stretch the frame over the backbuffer, since it was rendered at a lower resolution
+			this->upscaleFramebufferKernel->setInputUInt8Framebuffer(this->kernelUInt8FrameBuffers[frameBufferIndex]);
+			this->upscaleFramebufferKernel->setInputImageResolution(this->renderResolutionWidth, this->renderResolutionHeight);
+			this->upscaleFramebufferKernel->setOutputUInt8Framebuffer(backbufferBuffer);
+
+			size_t globalWorkSize[2];
+			globalWorkSize[0] = static_cast<size_t>(this->backbuffers[0]->getWidth());
+			globalWorkSize[1] = static_cast<size_t>(this->backbuffers[0]->getHeight());
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->program->getOpenCLManager()->getCommandQueue(), this->upscaleFramebufferKernel->getKernel(), 2, NULL, globalWorkSize, NULL, 0, NULL, this->program->getOpenCLManager()->getProfiler()->getEventForCommand("upscaleFramebuffer")));
+		}
+		else
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueCopyBuffer(this->program->getOpenCLManager()->getCommandQueue(), this->kernelUInt8FrameBuffers[frameBufferIndex], backbufferBuffer, 0, 0, this->backbuffers[0]->getPixelsMemorySize(), 0, NULL, this->program->getOpenCLManager()->getProfiler()->getEventForCommand("copyFramebufferToBackbuffer")));
+		}
+
+		// Map the buffer to read the frame back into the pixel memory of the backbuffer
+		{
+			cl_int returnCode;
+			cl_event *readBackEvent = &this->backbufferReadBackEvents[this->currentBackbufferIndex];
+			this->mappedBackbufferPointers[this->currentBackbufferIndex] = clEnqueueMapBuffer(this->program->getOpenCLManager()->getCommandQueue(), backbufferBuffer, CL_NON_BLOCKING, CL_MAP_READ, 0, this->backbuffers[0]->getPixelsMemorySize(), 0, NULL, readBackEvent, &returnCode);
+			FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+
+			// The profiler waits for and releases the events it is given at the end of the frame, so it gets its own reference to the event.
+			// While profiling, the read back therefore finishes within the frame, as it did before
+			cl_event *profilerEvent = this->program->getOpenCLManager()->getProfiler()->getEventForCommand("readBackFramebuffer");
+			if(profilerEvent)
+			{
+				FORGE_OPENCL_ERROR_CODE_CHECK(clRetainEvent(*readBackEvent));
+				*profilerEvent = *readBackEvent;
+			}
+
+			// Submit the commands of this frame to the device without waiting for them to finish
+			FORGE_OPENCL_ERROR_CODE_CHECK(clFlush(this->program->getOpenCLManager()->getCommandQueue()));
+		}
+
+		// Show the oldest frame that is being read back, which is the current one if the pipeline depth is 1
+		this->currentBackbufferIndex = (this->currentBackbufferIndex + 1) % this->readBackPipelineDepth;
+		if(this->backbufferReadBackEvents[this->currentBackbufferIndex])
+		{
+			Framebuffer *oldestBackbuffer = this->backbuffers[this->currentBackbufferIndex];
+			FORGE_OPENCL_ERROR_CODE_CHECK(clWaitForEvents(1, &this->backbufferReadBackEvents[this->currentBackbufferIndex]));
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseEvent(this->backbufferReadBackEvents[this->currentBackbufferIndex]));
+			this->backbufferReadBackEvents[this->currentBackbufferIndex] = NULL;
+
+			// The buffer was created over the pixel memory of the backbuffer, so the mapped pointer points into it.
+			// The text only needs to be in the pixel memory, since the buffer is mapped for reading, and the next frame overwrites it
+			{
+				char framesPerSecondText[256] = "0";
+				Int numberOfCharactersInString = snprintf(framesPerSecondText, sizeof(framesPerSecondText), "FPS : %lld", this->program->getFPSCounter()->getCurrentFPS());
+				oldestBackbuffer->tempDrawText(0, 0, framesPerSecondText, numberOfCharactersInString);
+			}
+
+			this->program->getWindow()->blitFramebufferToScreen(*oldestBackbuffer);
+
+			// Hand the buffer back to the device, before the next frame is written into it
+			FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueUnmapMemObject(this->program->getOpenCLManager()->getCommandQueue(), this->kernelBackbufferBuffers[this->currentBackbufferIndex], this->mappedBackbufferPointers[this->currentBackbufferIndex], 0, NULL, NULL));
+			this->mappedBackbufferPointers[this->currentBackbufferIndex] = nullptr;
+		}
+	}
+
+	void OpenCLRenderer::updateRenderResolution()
+	{
+		// The time since the previous frame started includes everything else that the program did in it, such as generating the world.
+		// A single long frame, such as the first one after the world was generated, must not drop the resolution to the minimum by itself
+		const Int64 frameTime = min<Int64>(this->frameTimer.getTimePassed(), this->targetFrameTime * 4);
+		this->frameTimer.reset();
+		this->averageFrameTime += (static_cast<Float>(frameTime) - this->averageFrameTime) * 0.1f;
+
+		// The number of pixels grows with the square of the scale, so the resolution is only raised again when there is a lot of time left over
+		Float newRenderResolutionScale = this->renderResolutionScale;
+		if(this->averageFrameTime > static_cast<Float>(this->targetFrameTime) * 1.1f)
+		{
+			newRenderResolutionScale = max(this->renderResolutionScale - this->renderResolutionScaleStep, this->minRenderResolutionScale);
+		}
+		else if(this->averageFrameTime < static_cast<Float>(this->targetFrameTime) * 0.75f)
+		{
+			newRenderResolutionScale = min(this->renderResolutionScale + this->renderResolutionScaleStep, 1.0f);
+		}
+
+		if(newRenderResolutionScale != this->renderResolutionScale)
+		{
+			this->renderResolutionScale = newRenderResolutionScale;
+			this->renderResolutionWidth = max<Int32>(roundFloatToInteger<Int32>(static_cast<Float>(this->backbuffers[0]->getWidth()) * this->renderResolutionScale), 1);
+			this->renderResolutionHeight = max<Int32>(roundFloatToInteger<Int32>(static_cast<Float>(this->backbuffers[0]->getHeight()) * this->renderResolutionScale), 1);
+
+			// The depth buffer of the previous frame has a different resolution
+			this->isPreviousFrameValid = false;
+			// Wait for the frame time at the new resolution to settle before changing it again
+			this->averageFrameTime = static_cast<Float>(this->targetFrameTime);
+		}
 	}
 
 	void OpenCLRenderer::generateTextures()
@@ -154,8 +495,189 @@ namespace forge
 		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueNDRangeKernel(this->program->getOpenCLManager()->getCommandQueue(), dirtTextureKernel.getKernel(), 2, NULL, globalWorkSize, NULL, 0, NULL, NULL));
 	}
 
-	void OpenCLRenderer::onVoxelNodeUpdated(UInt32 pMortonCode, UInt8 pHasChildBitfield)
+	void OpenCLRenderer::rebuildSparseVoxelOctree()
 	{
-		this->shouldUpdateVoxelOctreeBuffer = true;
+		// The pending writes may still read the arrays, which the build reallocates
+		if(this->sparseVoxelOctreeUploadEvent)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clWaitForEvents(1, &this->sparseVoxelOctreeUploadEvent));
+		}
+
+		this->sparseVoxelOctree.build(*this->program->getVoxelGrid());
+
+		// The buffers are recreated, so that all of them is uploaded. A buffer is only released once the commands that use it have finished
+		cl_mem *buffers[] = {&this->kernelSparseVoxelOctreeNodesBuffer, &this->kernelSparseVoxelOctreeVoxelBricksBuffer, &this->kernelSparseVoxelOctreeVoxelBrickFirstMaterialIndicesBuffer, &this->kernelSparseVoxelOctreeVoxelMaterialsBuffer};
+		for(cl_mem *buffer : buffers)
+		{
+			if(*buffer)
+			{
+				FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(*buffer));
+				*buffer = nullptr;
+			}
+		}
+		this->uploadSparseVoxelOctree();
+
+		const SizeType denseVoxelOctreeMemorySize = sizeof(UInt8) * this->program->getVoxelGrid()->getOctreeNodeChildMaskArray()->getNumberOfElements() +
+													sizeof(UInt64) * this->program->getVoxelGrid()->getVoxelBrickArray()->getNumberOfElements() +
+													sizeof(UInt32) * this->program->getVoxelGrid()->getVoxelBrickFirstMaterialIndexArray()->getNumberOfElements() +
+													sizeof(VoxelData) * this->program->getVoxelGrid()->getNumberOfVoxelMaterials();
+		FORGE_DEBUG_LOG("Sparse voxel octree size : ", this->sparseVoxelOctree.getMemorySize(), " bytes, dense voxel octree size : ", denseVoxelOctreeMemorySize, " bytes");
+	}
+
+	void OpenCLRenderer::updateSparseVoxelOctree()
+	{
+		// The update may grow the arrays, which moves them, so the pending writes must have read them first. They were enqueued before the previous frame was rendered
+		if(this->sparseVoxelOctreeUploadEvent)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clWaitForEvents(1, &this->sparseVoxelOctreeUploadEvent));
+		}
+
+		// The elements that the update changes mark their pages as dirty through the events of the sparse voxel octree
+		this->sparseVoxelOctree.updateVoxelBricks(*this->program->getVoxelGrid(), this->minChangedVoxelBrickCoords, this->maxChangedVoxelBrickCoords);
+		this->uploadSparseVoxelOctree();
+	}
+
+	void OpenCLRenderer::uploadSparseVoxelOctree()
+	{
+		this->uploadSparseVoxelOctreeArray(this->kernelSparseVoxelOctreeNodesBuffer, this->dirtySparseVoxelOctreeNodePages,
+										   &(*this->sparseVoxelOctree.getNodeArray())[0], sizeof(SparseVoxelOctree::Node) * this->sparseVoxelOctree.getNodeArray()->getNumberOfElements());
+		this->uploadSparseVoxelOctreeArray(this->kernelSparseVoxelOctreeVoxelBricksBuffer, this->dirtySparseVoxelOctreeVoxelBrickPages,
+										   this->sparseVoxelOctree.getVoxelBrickArray()->getNumberOfElements() > 0 ? &(*this->sparseVoxelOctree.getVoxelBrickArray())[0] : nullptr,
+										   sizeof(UInt64) * this->sparseVoxelOctree.getVoxelBrickArray()->getNumberOfElements());
+		this->uploadSparseVoxelOctreeArray(this->kernelSparseVoxelOctreeVoxelBrickFirstMaterialIndicesBuffer, this->dirtySparseVoxelOctreeVoxelBrickFirstMaterialIndexPages,
+										   this->sparseVoxelOctree.getVoxelBrickFirstMaterialIndexArray()->getNumberOfElements() > 0 ? &(*this->sparseVoxelOctree.getVoxelBrickFirstMaterialIndexArray())[0] : nullptr,
+										   sizeof(UInt32) * this->sparseVoxelOctree.getVoxelBrickFirstMaterialIndexArray()->getNumberOfElements());
+		// Every voxel brick that exists has at least one non empty voxel, so this is only empty when there are no voxel bricks
+		this->uploadSparseVoxelOctreeArray(this->kernelSparseVoxelOctreeVoxelMaterialsBuffer, this->dirtySparseVoxelOctreeVoxelMaterialPages,
+										   this->sparseVoxelOctree.getVoxelMaterialArray()->getNumberOfElements() > 0 ? &(*this->sparseVoxelOctree.getVoxelMaterialArray())[0] : nullptr,
+										   sizeof(VoxelData) * this->sparseVoxelOctree.getVoxelMaterialArray()->getNumberOfElements());
+
+		this->sparseVoxelOctreeRenderPixelKernel->setKernelVoxelArrayBuffer(this->kernelSparseVoxelOctreeNodesBuffer);
+		this->sparseVoxelOctreeRenderPixelKernel->setKernelVoxelBrickArrayBuffer(this->kernelSparseVoxelOctreeVoxelBricksBuffer);
+		this->sparseVoxelOctreeRenderPixelKernel->setKernelVoxelBrickFirstMaterialIndexArrayBuffer(this->kernelSparseVoxelOctreeVoxelBrickFirstMaterialIndicesBuffer);
+		this->sparseVoxelOctreeRenderPixelKernel->setKernelVoxelMaterialArrayBuffer(this->kernelSparseVoxelOctreeVoxelMaterialsBuffer);
+		this->sparseVoxelOctreeTraceBeamKernel->setKernelVoxelArrayBuffer(this->kernelSparseVoxelOctreeNodesBuffer);
+
+		// The command queue is in order, so the marker completes once the writes have finished, without waiting for the commands that are enqueued after it
+		if(this->sparseVoxelOctreeUploadEvent)
+		{
+			FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseEvent(this->sparseVoxelOctreeUploadEvent));
+		}
+		FORGE_OPENCL_ERROR_CODE_CHECK(clEnqueueMarkerWithWaitList(this->program->getOpenCLManager()->getCommandQueue(), 0, NULL, &this->sparseVoxelOctreeUploadEvent));
+	}
+
+	void OpenCLRenderer::uploadSparseVoxelOctreeArray(cl_mem &pBuffer, DirtyMemoryPages &pDirtyPages, const void *pArrayMemory, SizeType pArrayMemorySize)
+	{
+		if(!pBuffer || pDirtyPages.getMemorySize() != pArrayMemorySize)
+		{
+			if(pBuffer)
+			{
+				FORGE_OPENCL_ERROR_CODE_CHECK(clReleaseMemObject(pBuffer));
+			}
+
+			// Creating a buffer of zero bytes is not allowed, so the buffer always has room for at least one byte. There are no voxel bricks if an array is empty
+			cl_int returnCode;
+			pBuffer = clCreateBuffer(this->program->getOpenCLManager()->getContext(), CL_MEM_READ_ONLY, max<SizeType>(pArrayMemorySize, 1), NULL, &returnCode);
+			FORGE_OPENCL_ERROR_CODE_CHECK(returnCode);
+
+			pDirtyPages.setMemorySize(pArrayMemorySize);
+			pDirtyPages.markBytesAsDirty(0, pArrayMemorySize);
+		}
+
+		pDirtyPages.uploadDirtyPages(this->program->getOpenCLManager()->getCommandQueue(), pBuffer, pArrayMemory);
+	}
+
+	void OpenCLRenderer::addChangedVoxelBricks(const IntegerVector3<UInt32> &pMinVoxelBrickCoords, const IntegerVector3<UInt32> &pMaxVoxelBrickCoords)
+	{
+		if(this->haveVoxelBricksChangedSinceUpdate)
+		{
+			this->minChangedVoxelBrickCoords = IntegerVector3<UInt32>(min(this->minChangedVoxelBrickCoords.x, pMinVoxelBrickCoords.x), min(this->minChangedVoxelBrickCoords.y, pMinVoxelBrickCoords.y), min(this->minChangedVoxelBrickCoords.z, pMinVoxelBrickCoords.z));
+			this->maxChangedVoxelBrickCoords = IntegerVector3<UInt32>(max(this->maxChangedVoxelBrickCoords.x, pMaxVoxelBrickCoords.x), max(this->maxChangedVoxelBrickCoords.y, pMaxVoxelBrickCoords.y), max(this->maxChangedVoxelBrickCoords.z, pMaxVoxelBrickCoords.z));
+		}
+		else
+		{
+			this->minChangedVoxelBrickCoords = pMinVoxelBrickCoords;
+			this->maxChangedVoxelBrickCoords = pMaxVoxelBrickCoords;
+			this->haveVoxelBricksChangedSinceUpdate = true;
+		}
+	}
+
+	void OpenCLRenderer::onVoxelBrickUpdated(SizeType pVoxelBrickIndex, UInt64 pVoxelBrick)
+	{
+		// The nodes above a voxel brick only change when it does
+		const IntegerVector3<VoxelGrid::VoxelCoordType> voxelBrickMinVoxelCoords = this->program->getVoxelGrid()->getVoxelBrickMinVoxelCoords(pVoxelBrickIndex);
+		const IntegerVector3<VoxelGrid::VoxelCoordType> minVoxelCoords = this->program->getVoxelGrid()->getMinVoxelCoords();
+		const IntegerVector3<UInt32> voxelBrickCoords(static_cast<UInt32>(voxelBrickMinVoxelCoords.x - minVoxelCoords.x) / VoxelGrid::voxelBrickSideLength,
+													  static_cast<UInt32>(voxelBrickMinVoxelCoords.y - minVoxelCoords.y) / VoxelGrid::voxelBrickSideLength,
+													  static_cast<UInt32>(voxelBrickMinVoxelCoords.z - minVoxelCoords.z) / VoxelGrid::voxelBrickSideLength);
+		this->addChangedVoxelBricks(voxelBrickCoords, voxelBrickCoords);
+
+		// Grow the AABB of the changed voxels to contain the whole voxel brick. Each voxel is centered on its coords
+		const Vector3 voxelBrickMinPoint(static_cast<Float>(voxelBrickMinVoxelCoords.x) - 0.5f, static_cast<Float>(voxelBrickMinVoxelCoords.y) - 0.5f, static_cast<Float>(voxelBrickMinVoxelCoords.z) - 0.5f);
+		const Float voxelBrickSideLength = static_cast<Float>(VoxelGrid::voxelBrickSideLength);
+		const Vector3 voxelBrickMaxPoint(voxelBrickMinPoint.x + voxelBrickSideLength, voxelBrickMinPoint.y + voxelBrickSideLength, voxelBrickMinPoint.z + voxelBrickSideLength);
+		this->growChangedVoxelsAABB(voxelBrickMinPoint, voxelBrickMaxPoint);
+	}
+
+	void OpenCLRenderer::onVoxelMaterialUpdated(SizeType pVoxelIndex, VoxelData pVoxelData)
+	{
+		// The index of a voxel is the index of its voxel brick followed by its bit in it. A voxel brick that did not change still has to update its voxel data
+		this->onVoxelBrickUpdated(pVoxelIndex / 64, 0);
+	}
+
+	void OpenCLRenderer::onVoxelsInBoxUpdated(IntegerVector3<VoxelGrid::VoxelCoordType> pBoxMinVoxelCoords, IntegerVector3<VoxelGrid::VoxelCoordType> pBoxMaxVoxelCoords)
+	{
+		const VoxelGrid *voxelGrid = this->program->getVoxelGrid();
+		IntegerVector3<UInt32> minVoxelBrickCoords;
+		IntegerVector3<UInt32> maxVoxelBrickCoords;
+		if(!voxelGrid->getVoxelBricksInBox(pBoxMinVoxelCoords, pBoxMaxVoxelCoords, minVoxelBrickCoords, maxVoxelBrickCoords))
+		{
+			return;
+		}
+
+		this->addChangedVoxelBricks(minVoxelBrickCoords, maxVoxelBrickCoords);
+
+		// Grow the AABB of the changed voxels to contain the whole voxel bricks, like for the voxel bricks that are updated one by one. Each voxel is centered on its coords
+		const IntegerVector3<VoxelGrid::VoxelCoordType> minVoxelCoords = voxelGrid->getMinVoxelCoords();
+		const Float voxelBrickSideLength = static_cast<Float>(VoxelGrid::voxelBrickSideLength);
+		const Vector3 minPoint(static_cast<Float>(minVoxelCoords.x) - 0.5f + static_cast<Float>(minVoxelBrickCoords.x) * voxelBrickSideLength,
+							   static_cast<Float>(minVoxelCoords.y) - 0.5f + static_cast<Float>(minVoxelBrickCoords.y) * voxelBrickSideLength,
+							   static_cast<Float>(minVoxelCoords.z) - 0.5f + static_cast<Float>(minVoxelBrickCoords.z) * voxelBrickSideLength);
+		const Vector3 maxPoint(static_cast<Float>(minVoxelCoords.x) - 0.5f + static_cast<Float>(maxVoxelBrickCoords.x + 1) * voxelBrickSideLength,
+							   static_cast<Float>(minVoxelCoords.y) - 0.5f + static_cast<Float>(maxVoxelBrickCoords.y + 1) * voxelBrickSideLength,
+							   static_cast<Float>(minVoxelCoords.z) - 0.5f + static_cast<Float>(maxVoxelBrickCoords.z + 1) * voxelBrickSideLength);
+		this->growChangedVoxelsAABB(minPoint, maxPoint);
+	}
+
+	void OpenCLRenderer::onSparseVoxelOctreeNodesUpdated(SizeType pFirstNodeIndex, SizeType pNumberOfNodes)
+	{
+		this->dirtySparseVoxelOctreeNodePages.markBytesAsDirty(sizeof(SparseVoxelOctree::Node) * pFirstNodeIndex, sizeof(SparseVoxelOctree::Node) * pNumberOfNodes);
+	}
+
+	void OpenCLRenderer::onSparseVoxelOctreeVoxelBricksUpdated(SizeType pFirstVoxelBrickIndex, SizeType pNumberOfVoxelBricks)
+	{
+		this->dirtySparseVoxelOctreeVoxelBrickPages.markBytesAsDirty(sizeof(UInt64) * pFirstVoxelBrickIndex, sizeof(UInt64) * pNumberOfVoxelBricks);
+		this->dirtySparseVoxelOctreeVoxelBrickFirstMaterialIndexPages.markBytesAsDirty(sizeof(UInt32) * pFirstVoxelBrickIndex, sizeof(UInt32) * pNumberOfVoxelBricks);
+	}
+
+	void OpenCLRenderer::onSparseVoxelOctreeVoxelMaterialsUpdated(SizeType pFirstVoxelMaterialIndex, SizeType pNumberOfVoxelMaterials)
+	{
+		this->dirtySparseVoxelOctreeVoxelMaterialPages.markBytesAsDirty(sizeof(VoxelData) * pFirstVoxelMaterialIndex, sizeof(VoxelData) * pNumberOfVoxelMaterials);
+	}
+
+	void OpenCLRenderer::growChangedVoxelsAABB(const Vector3 &pMinPoint, const Vector3 &pMaxPoint)
+	{
+		if(this->haveVoxelsChanged)
+		{
+			const Vector3 changedVoxelsAABBMinPoint = this->changedVoxelsAABB.getMinPoint();
+			const Vector3 changedVoxelsAABBMaxPoint = this->changedVoxelsAABB.getMaxPoint();
+			this->changedVoxelsAABB.setMinPoint(Vector3(min(changedVoxelsAABBMinPoint.x, pMinPoint.x), min(changedVoxelsAABBMinPoint.y, pMinPoint.y), min(changedVoxelsAABBMinPoint.z, pMinPoint.z)));
+			this->changedVoxelsAABB.setMaxPoint(Vector3(max(changedVoxelsAABBMaxPoint.x, pMaxPoint.x), max(changedVoxelsAABBMaxPoint.y, pMaxPoint.y), max(changedVoxelsAABBMaxPoint.z, pMaxPoint.z)));
+		}
+		else
+		{
+			this->changedVoxelsAABB = AABB(pMinPoint, pMaxPoint);
+			this->haveVoxelsChanged = true;
+		}
 	}
 }
\ No newline at end of file
@@ -7,45 +7,195 @@
 #include <Forge/Source/Platform/Windows/Timer.h>
 #include <Forge/Source/Platform/OpenCL/OpenCLManager.h>
 #include <Forge/Source/Core/Math/IntegerVector3.h>
+#include <Forge/Source/Core/Containers/ResizableArray.h>
 #include "Kernels/RenderPixelKernel.h"
+#include "Kernels/TraceBeamKernel.h"
+#include "Kernels/ReprojectDepthKernel.h"
+#include "Kernels/UpscaleFramebufferKernel.h"
+#include "Kernels/ReconstructCheckerboardKernel.h"
+#include "DirtyMemoryPages.h"
 #include <Forge/Source/Platform/Windows/Threading/Thread.h>
 #include <Forge/Source/Platform/Windows/Threading/Mutex.h>
 #include <Forge/Source/Platform/Windows/Threading/Signal.h>
 #include <Forge/Source/Core/Math/AABB.h>
+#include <Forge/Source/Core/Math/CoordinateSpace.h>
+#include <VoxelRaytracer/Source/Rendering/Renderer.h>
+#include <VoxelRaytracer/Source/Program/SparseVoxelOctree.h>
 
 namespace forge
 {
 	class Program;
 
-	class OpenCLRenderer
+	class OpenCLRenderer : public Renderer
 	{
 	public:
 
-		void startup(Program *pProgram, cl_mem pKernelVoxelDataBuffer);
+		struct Settings
+		{
+			// The number of frames that are read back from the device at the same time. A frame is only shown once the frames after it have been submitted,
+			// so the CPU prepares the next frames while the device renders and reads back the previous ones. A depth of 1 waits for every frame to be read back
+			// before it is shown, and every frame in the pipeline adds a frame of latency. Must be at least 1
+			SizeType readBackPipelineDepth = 2;
+			// The frames are rendered at a lower resolution while they take longer than this, in microseconds
+			Int64 targetFrameTime = 1000000 / 120;
+		};
 
-		void shutdown();
+		void startup(Program *pProgram, const Settings &pSettings);
 
-		void render();
+		void shutdown() override;
+
+		void render() override;
 
 	private:
 
+		// NOTE: These must match the AABB struct of the OpenCL kernels and the DebugAABB struct in ForgeData/OpenCL/Kernels/Renderer.cl
+		struct OpenCLAABB
+		{
+			cl_float3 minPoint;
+			cl_float3 maxPoint;
+		};
+
+		struct OpenCLDebugAABBData
+		{
+			OpenCLAABB aabb;
+			cl_float3 color;
+		};
+
 		void generateTextures();
 
-		void onVoxelNodeUpdated(UInt32 pMortonCode, UInt8 pHasChildBitfield);
+		// Choose the resolution that the frame is rendered at from the time that the previous frames took
+		void updateRenderResolution();
+
+		// Build the sparse voxel octree from the whole VoxelGrid object and upload all of it to the device memory
+		void rebuildSparseVoxelOctree();
+
+		// Update the parts of the sparse voxel octree above the voxel bricks that changed since the previous frame, and upload the pages that changed
+		void updateSparseVoxelOctree();
+
+		// Recreate the buffers of the sparse voxel octree that its arrays outgrew, and enqueue the writes of the dirty pages of its arrays
+		void uploadSparseVoxelOctree();
+
+		/// <summary>
+		/// Recreate a buffer of the sparse voxel octree if it does not exist or has a different size than its array, which makes all of it dirty, and upload its dirty pages
+		/// </summary>
+		/// <param name="pBuffer">The buffer. It is replaced if it is recreated</param>
+		/// <param name="pDirtyPages">The dirty pages of the array. Its memory size is the size of the buffer</param>
+		/// <param name="pArrayMemory">The memory of the array</param>
+		/// <param name="pArrayMemorySize">The size of the array in bytes</param>
+		void uploadSparseVoxelOctreeArray(cl_mem &pBuffer, DirtyMemoryPages &pDirtyPages, const void *pArrayMemory, SizeType pArrayMemorySize);
+
+		// Grow the range of the voxel bricks that changed since the previous frame to contain the given range. The maximum coords are inclusive
+		void addChangedVoxelBricks(const IntegerVector3<UInt32> &pMinVoxelBrickCoords, const IntegerVector3<UInt32> &pMaxVoxelBrickCoords);
+
+		void onVoxelBrickUpdated(SizeType pVoxelBrickIndex, UInt64 pVoxelBrick);
+
+		void onVoxelMaterialUpdated(SizeType pVoxelIndex, VoxelData pVoxelData);
+
+		void onVoxelsInBoxUpdated(IntegerVector3<VoxelGrid::VoxelCoordType> pBoxMinVoxelCoords, IntegerVector3<VoxelGrid::VoxelCoordType> pBoxMaxVoxelCoords);
+
+		void onSparseVoxelOctreeNodesUpdated(SizeType pFirstNodeIndex, SizeType pNumberOfNodes);
+
+		void onSparseVoxelOctreeVoxelBricksUpdated(SizeType pFirstVoxelBrickIndex, SizeType pNumberOfVoxelBricks);
+
+		void onSparseVoxelOctreeVoxelMaterialsUpdated(SizeType pFirstVoxelMaterialIndex, SizeType pNumberOfVoxelMaterials);
+
+		// Grow the AABB of the changed voxels to contain the given AABB
+		void growChangedVoxelsAABB(const Vector3 &pMinPoint, const Vector3 &pMaxPoint);
 
 		RenderPixelKernel *renderPixelKernel;
+		// Reads the voxels from the sparse voxel octree instead of the dense voxel octree. Used while the world is static,
+		// since the sparse voxel octree is built on the host and is too slow to rebuild every frame while the world scrolls
+		RenderPixelKernel *sparseVoxelOctreeRenderPixelKernel;
+		// Find the distance up to which the camera rays of each tile of the backbuffer can not hit a voxel, before the pixels are rendered
+		TraceBeamKernel *traceBeamKernel;
+		TraceBeamKernel *sparseVoxelOctreeTraceBeamKernel;
+		// Moves the hit points of the previous frame into the tiles of the current frame, so that the beams can start from where the rays hit voxels before
+		ReprojectDepthKernel *reprojectDepthKernel;
+		// Stretches the frame over the backbuffer when it is rendered at a lower resolution
+		UpscaleFramebufferKernel *upscaleFramebufferKernel;
+		// Fills in the pixels that are not rendered in a frame in checkerboard rendering
+		ReconstructCheckerboardKernel *reconstructCheckerboardKernel;
 
-		cl_mem kernelVoxelDataBuffer;
 		SizeType textureSize = 16;
 		cl_mem kernelTexturesBuffer;
-		cl_mem kernelUInt8FrameBuffer;
-		bool shouldUpdateVoxelOctreeBuffer = false;
+		// The frames are rendered into these framebuffers and depth buffers in turns, so that the ones of the previous frame can be read while rendering a frame
+		cl_mem kernelUInt8FrameBuffers[2];
+		cl_mem kernelDepthBuffers[2];
+		SizeType currentFrameBufferIndex = 0;
+		cl_mem kernelBeamDistancesBuffer;
+		// The counter of the batches of pixels that the work groups of renderPixel take with persistent threads
+		cl_mem kernelNextRayBatchIndexBuffer;
+		// Whether the pixels are rendered in square batches in Z-order, so that the camera rays of the work items in a SIMD unit are close together
+		const bool isTiledPixelOrderEnabled = true;
+		SizeType numberOfBeamTilesAlongX;
+		SizeType numberOfBeamTilesAlongY;
+
+		// The frames are rendered at a resolution that is scaled down from the backbuffer resolution while they take longer than the target frame time, in microseconds.
+		// The buffers have room for the backbuffer resolution, and only the part of them that the current render resolution needs is used
+		Int64 targetFrameTime;
+		const Float minRenderResolutionScale = 0.5f;
+		// The scale changes in steps, and only after the average frame time has settled, since the depth buffer can not be reprojected in a frame in which it changes
+		const Float renderResolutionScaleStep = 0.0625f;
+		Float renderResolutionScale = 1.0f;
+		Int32 renderResolutionWidth;
+		Int32 renderResolutionHeight;
+		// The exponential moving average of the times between the starts of the frames, in microseconds
+		Float averageFrameTime;
+		Timer frameTimer;
+		cl_mem kernelReprojectedDepthTilesBuffer;
+
+		// The camera of the previous frame
+		CoordinateSpace previousCameraCoordinateSpace;
+		Float previousCameraVerticalFieldOfViewInDegrees;
+		// The previous frame can not be used before the first frame, after a frame in which the world scrolled, since all the voxels may have moved,
+		// or after the render resolution changed
+		bool isPreviousFrameValid = false;
+		// The parity of the pixels that are rendered in the current frame in checkerboard rendering. It changes every frame
+		Int32 checkerboardParity = 0;
+		// The voxels that were added or removed since the previous frame
+		bool haveVoxelsChanged = false;
+		AABB changedVoxelsAABB;
+		// The range of the voxel bricks of the VoxelGrid object that were changed by edits since the sparse voxel octree was updated
+		bool haveVoxelBricksChangedSinceUpdate = false;
+		IntegerVector3<UInt32> minChangedVoxelBrickCoords;
+		IntegerVector3<UInt32> maxChangedVoxelBrickCoords;
+
+		SparseVoxelOctree sparseVoxelOctree;
+		// The buffers have the same sizes as the arrays of the sparse voxel octree, which keep room for the elements that updates move to their ends
+		cl_mem kernelSparseVoxelOctreeNodesBuffer = nullptr;
+		cl_mem kernelSparseVoxelOctreeVoxelBricksBuffer = nullptr;
+		cl_mem kernelSparseVoxelOctreeVoxelBrickFirstMaterialIndicesBuffer = nullptr;
+		cl_mem kernelSparseVoxelOctreeVoxelMaterialsBuffer = nullptr;
+		// The pages of the arrays of the sparse voxel octree that were changed since they were uploaded
+		DirtyMemoryPages dirtySparseVoxelOctreeNodePages;
+		DirtyMemoryPages dirtySparseVoxelOctreeVoxelBrickPages;
+		DirtyMemoryPages dirtySparseVoxelOctreeVoxelBrickFirstMaterialIndexPages;
+		DirtyMemoryPages dirtySparseVoxelOctreeVoxelMaterialPages;
+		// Completes once the last writes of the arrays of the sparse voxel octree have read them. The writes do not block, so the arrays must not be moved before then.
+		// It is NULL if no writes were enqueued
+		cl_event sparseVoxelOctreeUploadEvent = NULL;
+		// The VoxelGrid object is not kept up to date while the world scrolls, so the whole sparse voxel octree is built again once the world is static
+		bool shouldRebuildSparseVoxelOctree = true;
 
 		cl_mem kernelDebugAABBsBuffer;
 		const SizeType maxNumberOfDebugAABBs = 2;
+		// The debug AABBs are written to the device from the part of this array of the backbuffer that the frame is read back into, without waiting for the write.
+		// The in-order command queue reads the part before the frame is read back, and the part is only filled again once the frame has been shown
+		ResizableArray<OpenCLDebugAABBData> debugAABBsPerBackbuffer;
 
 		Program *program;
-		Framebuffer *backbuffer = nullptr;
+		// The frames are read back from the device into these backbuffers in turns, without waiting for the read to finish. There is one backbuffer
+		// for every frame in the read back pipeline. All the backbuffers have the same resolution
+		SizeType readBackPipelineDepth;
+		ResizableArray<Framebuffer*> backbuffers;
+		// A buffer over the pixel memory of each backbuffer, which the final frame is written into on the device. It is mapped to read the frame back,
+		// which needs no copy on CPU devices and integrated GPUs, and lets discrete GPUs copy straight into pinned memory
+		ResizableArray<cl_mem> kernelBackbufferBuffers;
+		// The pointer that each backbuffer buffer is mapped to, which is nullptr while it is not mapped
+		ResizableArray<void*> mappedBackbufferPointers;
+		// The event of the map of each backbuffer buffer, which is NULL if the backbuffer is not being read into
+		ResizableArray<cl_event> backbufferReadBackEvents;
+		SizeType currentBackbufferIndex = 0;
 		SizeType numberOfBackbufferPixels;
 	};
 }
@@ -0,0 +1,20 @@
+#ifndef FORGE_RENDERER_H
+#define FORGE_RENDERER_H
+
+namespace forge
+{
+	// Base class for the renderers that draw the voxel grid to the window
+	class Renderer
+	{
+	public:
+
+		virtual ~Renderer() {}
+
+		virtual void shutdown() = 0;
+
+		// Render a new frame and display it in the window
+		virtual void render() = 0;
+	};
+}
+
+#endif